@@ -44,6 +44,11 @@ if( ENABLE_SANITIZERS )
   endif()
 endif()
 
+option( SAPPHIRE_PROFILING "Compile in the tick profiler timers" ON )
+if( SAPPHIRE_PROFILING )
+  add_compile_definitions( SAPPHIRE_PROFILING )
+endif()
+
 # C++ standard
 set( CMAKE_CXX_STANDARD 17 )
 set( CMAKE_CXX_STANDARD_REQUIRED ON )
@@ -0,0 +1,28 @@
+CREATE TABLE IF NOT EXISTS `marketlisting` (
+  `ListingId` bigint(20) UNSIGNED NOT NULL,
+  `CatalogId` int(10) UNSIGNED NOT NULL,
+  `SellerCharacterId` bigint(20) UNSIGNED NOT NULL,
+  `RetainerId` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+  `RetainerName` varchar(32) DEFAULT NULL,
+  `ItemId` bigint(20) UNSIGNED NOT NULL DEFAULT '0',
+  `Stack` int(10) UNSIGNED NOT NULL,
+  `UnitPrice` int(10) UNSIGNED NOT NULL,
+  `Hq` tinyint(1) NOT NULL DEFAULT '0',
+  `Stain` tinyint(3) UNSIGNED NOT NULL DEFAULT '0',
+  `ListDate` int(10) UNSIGNED NOT NULL,
+  `UPDATE_DATE` datetime DEFAULT CURRENT_TIMESTAMP,
+  PRIMARY KEY (`ListingId`),
+  KEY `CatalogId` (`CatalogId`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
+
+CREATE TABLE IF NOT EXISTS `markethistory` (
+  `SaleId` bigint(20) UNSIGNED NOT NULL AUTO_INCREMENT,
+  `CatalogId` int(10) UNSIGNED NOT NULL,
+  `UnitPrice` int(10) UNSIGNED NOT NULL,
+  `Stack` int(10) UNSIGNED NOT NULL,
+  `Hq` tinyint(1) NOT NULL DEFAULT '0',
+  `BuyerName` varchar(32) DEFAULT NULL,
+  `SaleDate` int(10) UNSIGNED NOT NULL,
+  PRIMARY KEY (`SaleId`),
+  KEY `CatalogId` (`CatalogId`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
@@ -380,28 +380,15 @@ void PlayerMinimal::saveAsNew()
   insertDbGlobalItem( feet, feetUid );
 
 
-  g_charaDb.execute( "INSERT INTO charaitemgearset (storageId, CharacterId, "
-                     "container_" + std::to_string( GearSetSlot::MainHand ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Body ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Hands ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Legs ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Feet ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Neck ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Ear ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Wrist ) + ", "
-                     "container_" + std::to_string( GearSetSlot::Ring1 ) + ", UPDATE_DATE ) "
-                     "VALUES ( " +
-                     std::to_string( InventoryType::GearSet0 ) + ", " +
-                     std::to_string( m_characterId ) + ", " +
-                     std::to_string( uniqueId ) + ", " +
-                     std::to_string( bodyUid ) + ", " +
-                     std::to_string( handsUid ) + ", " +
-                     std::to_string( legsUid ) + ", " +
-                     std::to_string( feetUid ) + ", " +
-                     std::to_string( 0 ) + ", " +
-                     std::to_string( 0 ) + ", " +
-                     std::to_string( 0 ) + ", " +
-                     std::to_string( 0 ) + ", NOW());" );
+  auto stmtGearSet = g_charaDb.getPreparedStatement( Db::ZoneDbStatements::CHARA_ITEMGEARSET_INS );
+  stmtGearSet->setInt( 1, InventoryType::GearSet0 );
+  stmtGearSet->setUInt64( 2, m_characterId );
+  stmtGearSet->setUInt64( 3, uniqueId );
+  stmtGearSet->setUInt64( 4, bodyUid );
+  stmtGearSet->setUInt64( 5, handsUid );
+  stmtGearSet->setUInt64( 6, legsUid );
+  stmtGearSet->setUInt64( 7, feetUid );
+  g_charaDb.directExecute( stmtGearSet );
 
   //        "(AccountId, CharacterId, EntityId, Name, Hp, Mp, "
   //        "Customize, Voice, IsNewGame, TerritoryType, PosX, PosY, PosZ, PosR, ModelEquip, "
@@ -479,8 +466,8 @@ void PlayerMinimal::createCurrencyDbContainer() const
 
 uint64_t PlayerMinimal::getNextUId64() const
 {
-  g_charaDb.directExecute( std::string( "INSERT INTO uniqueiddata( IdName ) VALUES( 'NOT_SET' );" ) );
-  auto res = g_charaDb.query( "SELECT LAST_INSERT_ID();" );
+  auto res = g_charaDb.directQueryTransaction( { g_charaDb.getPreparedStatement( Db::ZoneDbStatements::UNIQUEID_INS ) },
+                                               g_charaDb.getPreparedStatement( Db::ZoneDbStatements::UNIQUEID_SEL_LAST_INSERT_ID ) );
 
   if( !res || !res->next() )
     return 0;
@@ -50,7 +50,10 @@ bool SapphireApi::login( const std::string& username, const std::string& pass, s
   pSession->setAccountId( accountId );
   pSession->setSessionId( sessionId.c_str() );
 
-  m_sessionMap[ sessionId ] = pSession;
+  {
+    std::lock_guard< std::mutex > lock( m_sessionMutex );
+    m_sessionMap[ sessionId ] = pSession;
+  }
   sId = sessionId;
 
   return true;
@@ -64,6 +67,7 @@ bool SapphireApi::insertSession( const uint32_t accountId, std::string& sId )
   pSession->setAccountId( accountId );
   pSession->setSessionId( sId.c_str() );
 
+  std::lock_guard< std::mutex > lock( m_sessionMutex );
   m_sessionMap[ sId ] = pSession;
 
   return true;
@@ -71,6 +75,8 @@ bool SapphireApi::insertSession( const uint32_t accountId, std::string& sId )
 
 bool SapphireApi::createAccount( const std::string& username, const std::string& pass, std::string& sId )
 {
+  std::unique_lock< std::mutex > createLock( m_createMutex );
+
   // get account from login name
   auto stmt = g_charaDb.getPreparedStatement( Db::ZoneDbStatements::ACCOUNT_SEL_BY_NAME );
   stmt->setString( 1, username );
@@ -96,6 +102,7 @@ bool SapphireApi::createAccount( const std::string& username, const std::string&
 
   // store the account to the db
   g_charaDb.directExecute( stmtInsert );
+  createLock.unlock();
 
 
   if( !login( username, pass, sId ) )
@@ -110,6 +117,8 @@ int SapphireApi::createCharacter( const uint32_t accountId, const std::string& n
 {
   Api::PlayerMinimal newPlayer;
 
+  std::lock_guard< std::mutex > createLock( m_createMutex );
+
   newPlayer.setAccountId( accountId );
   newPlayer.setId( getNextEntityId() );
   newPlayer.setCharacterId( getNextCharaId() );
@@ -194,20 +203,35 @@ void SapphireApi::deleteCharacter( std::string name, const uint32_t accountId )
 
   auto id = deletePlayer.getCharacterId();
 
-  g_charaDb.execute( "DELETE FROM charainfo WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM characlass WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charaglobalitem WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charainfoblacklist WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charainfofriendlist WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charainfolinkshell WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charainfosearch WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charaitemcrystal WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charaiteminventory WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charaitemgearset WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charaquest WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charainfoachievement WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charaitemcurrency WHERE CharacterId = " + std::to_string( id ) + ";" );
-  g_charaDb.execute( "DELETE FROM charamonsternote WHERE CharacterId = " + std::to_string( id ) + ";" );
+  static const Db::ZoneDbStatements deleteStatements[] =
+  {
+    Db::ZoneDbStatements::CHARA_DEL,
+    Db::ZoneDbStatements::CHARA_CLASS_DEL_ALL,
+    Db::ZoneDbStatements::CHARA_ITEMGLOBAL_DEL_ALL,
+    Db::ZoneDbStatements::CHARA_BLACKLIST_DEL,
+    Db::ZoneDbStatements::CHARA_FRIENDLIST_DEL,
+    Db::ZoneDbStatements::CHARA_LINKSHELL_DEL,
+    Db::ZoneDbStatements::CHARA_SEARCHINFO_DEL,
+    Db::ZoneDbStatements::CHARA_ITEMCRYSTAL_DEL,
+    Db::ZoneDbStatements::CHARA_ITEMINV_DEL,
+    Db::ZoneDbStatements::CHARA_ITEMGEARSET_DEL,
+    Db::ZoneDbStatements::CHARA_QUEST_DEL_ALL,
+    Db::ZoneDbStatements::CHARA_ACHIEV_DEL,
+    Db::ZoneDbStatements::CHARA_CURRENCYINV_DEL,
+    Db::ZoneDbStatements::CHARA_MONSTERNOTE_DEL,
+  };
+
+  std::vector< std::shared_ptr< Db::PreparedStatement > > stmts;
+  stmts.reserve( std::size( deleteStatements ) );
+  for( auto index : deleteStatements )
+  {
+    auto stmt = g_charaDb.getPreparedStatement( index );
+    stmt->setUInt64( 1, id );
+    stmts.push_back( stmt );
+  }
+
+  // all or nothing, a partially deleted character can't be loaded anymore
+  g_charaDb.directExecuteTransaction( stmts );
 }
 
 std::vector< PlayerMinimal > SapphireApi::getCharList( uint32_t accountId )
@@ -252,7 +276,8 @@ uint32_t SapphireApi::getNextEntityId()
 {
   uint32_t charId = 0;
 
-  auto pQR = g_charaDb.query( "SELECT MAX(EntityId) FROM charainfo" );
+  auto stmt = g_charaDb.getPreparedStatement( Db::ZoneDbStatements::CHARA_SEL_MAX_ENTITYID );
+  auto pQR = g_charaDb.query( stmt );
 
   if( !pQR || !pQR->next() )
     return 0x00200001;
@@ -268,7 +293,8 @@ uint64_t SapphireApi::getNextCharaId()
 {
   uint64_t contentId = 0;
 
-  auto pQR = g_charaDb.query( "SELECT MAX(CharacterId) FROM charainfo" );
+  auto stmt = g_charaDb.getPreparedStatement( Db::ZoneDbStatements::CHARA_SEL_MAX_CHARACTERID );
+  auto pQR = g_charaDb.query( stmt );
 
   if( !pQR || !pQR->next() )
     return 0x0040000001000001;
@@ -282,6 +308,7 @@ uint64_t SapphireApi::getNextCharaId()
 
 int SapphireApi::checkSession( const std::string& sId )
 {
+  std::lock_guard< std::mutex > lock( m_sessionMutex );
   auto it = m_sessionMap.find( sId );
 
   if( it == m_sessionMap.end() )
@@ -293,6 +320,7 @@ int SapphireApi::checkSession( const std::string& sId )
 
 bool SapphireApi::removeSession( const std::string& sId )
 {
+  std::lock_guard< std::mutex > lock( m_sessionMutex );
   auto it = m_sessionMap.find( sId );
 
   if( it != m_sessionMap.end() )
@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 #include "PlayerMinimal.h"
 
 namespace Sapphire::Api
@@ -43,5 +44,11 @@ namespace Sapphire::Api
 
     SessionMap m_sessionMap;
 
+  private:
+    // requests are handled on several server threads
+    std::mutex m_sessionMutex;
+    // new ids are derived from the current maximum, creation has to be serialized
+    std::mutex m_createMutex;
+
   };
 }
@@ -87,6 +87,7 @@ void reloadConfig()
   // setup api config
   m_config.network.listenPort = pConfig->getValue< uint16_t >( "Network", "ListenPort", 80 );
   m_config.network.listenIP = pConfig->getValue< std::string >( "Network", "ListenIp", "0.0.0.0" );
+  m_config.network.threads = pConfig->getValue< uint16_t >( "Network", "Threads", 4 );
 }
 
 void print_request_info( shared_ptr< HttpServer::Request > request )
@@ -138,8 +139,16 @@ bool loadSettings( int32_t argc, char* argv[] )
 
   server.config.port = m_config.network.listenPort;
   server.config.address = m_config.network.listenIP;
+  server.config.thread_pool_size = std::max< uint16_t >( m_config.network.threads, 1 );
+
+  // sheets are loaded lazily and that cache isn't thread safe, load everything the handlers use up front
+  g_exdData.getRow< Excel::ClassJob >( 0 );
+  g_exdData.getRow< Excel::Item >( 0 );
+  g_exdData.getRow< Excel::Race >( 0 );
+  g_exdData.getRow< Excel::TerritoryType >( 0 );
 
   Logger::info( "Database: Connected to {0}:{1}", m_config.global.database.host, m_config.global.database.port );
+  Logger::info( "Handling requests on {0} threads", server.config.thread_pool_size );
 
   return true;
 }
@@ -725,17 +734,17 @@ int main( int argc, char* argv[] )
 
   Logger::setLogLevel( m_config.global.general.logLevel );
 
+  server.exact_resource[ "/sapphire-api/lobby/createAccount" ][ "POST" ] = &createAccount;
+  server.exact_resource[ "/sapphire-api/lobby/login" ][ "POST" ] = &login;
+  server.exact_resource[ "/sapphire-api/lobby/deleteCharacter" ][ "POST" ] = &deleteCharacter;
+  server.exact_resource[ "/sapphire-api/lobby/createCharacter" ][ "POST" ] = &createCharacter;
+  server.exact_resource[ "/sapphire-api/lobby/insertSession" ][ "POST" ] = &insertSession;
+  server.exact_resource[ "/sapphire-api/lobby/checkNameTaken" ][ "POST" ] = &checkNameTaken;
+  server.exact_resource[ "/sapphire-api/lobby/checkSession" ][ "POST" ] = &checkSession;
+  server.exact_resource[ "/sapphire-api/lobby/getNextEntityId" ][ "POST" ] = &getNextCharId;
+  server.exact_resource[ "/sapphire-api/lobby/getNextCharaId" ][ "POST" ] = &getNextContentId;
+  server.exact_resource[ "/sapphire-api/lobby/getCharacterList" ][ "POST" ] = &getCharacterList;
   server.resource[ "^/ZoneName/([0-9]+)$" ][ "GET" ] = &getZoneName;
-  server.resource[ "^/sapphire-api/lobby/createAccount" ][ "POST" ] = &createAccount;
-  server.resource[ "^/sapphire-api/lobby/login" ][ "POST" ] = &login;
-  server.resource[ "^/sapphire-api/lobby/deleteCharacter" ][ "POST" ] = &deleteCharacter;
-  server.resource[ "^/sapphire-api/lobby/createCharacter" ][ "POST" ] = &createCharacter;
-  server.resource[ "^/sapphire-api/lobby/insertSession" ][ "POST" ] = &insertSession;
-  server.resource[ "^/sapphire-api/lobby/checkNameTaken" ][ "POST" ] = &checkNameTaken;
-  server.resource[ "^/sapphire-api/lobby/checkSession" ][ "POST" ] = &checkSession;
-  server.resource[ "^/sapphire-api/lobby/getNextEntityId" ][ "POST" ] = &getNextCharId;
-  server.resource[ "^/sapphire-api/lobby/getNextCharaId" ][ "POST" ] = &getNextContentId;
-  server.resource[ "^/sapphire-api/lobby/getCharacterList" ][ "POST" ] = &getCharacterList;
   server.resource[ "^(/frontier-api/ffxivsupport/view/get_init)(.*)" ][ "GET" ] = &get_init;
   server.resource[ "^(/frontier-api/ffxivsupport/information/get_headline_all)(.*)" ][ "GET" ] = &get_headline_all;
 
@@ -760,7 +769,7 @@ void default_resource_send( const HttpServer& server, const shared_ptr< HttpServ
                             const shared_ptr< ifstream >& ifs )
 {
   //read and send 128 KB at a time
-  static vector< char > buffer( 131072 ); // Safe when server is running on one thread
+  thread_local vector< char > buffer( 131072 ); // One buffer per server thread
   streamsize read_length;
   if( ( read_length = ifs->read( &buffer[ 0 ], buffer.size() ).gcount() ) > 0 )
   {
@@ -108,6 +108,8 @@ namespace SimpleWeb {
             }
             
             asio::streambuf streambuf;
+            //Bytes of the next request(s) a pipelining client sent along with this one
+            std::string pipelined;
         };
         
         class Config {
@@ -143,6 +145,11 @@ namespace SimpleWeb {
             }
         };
     public:
+        /// Resources matched on the exact request path, looked up before the regex resources.
+        /// Warning: do not add or remove resources after start() is called
+        std::unordered_map<std::string, std::map<std::string,
+            std::function<void(std::shared_ptr<typename ServerBase<socket_type>::Response>, std::shared_ptr<typename ServerBase<socket_type>::Request>)> > > exact_resource;
+
         /// Warning: do not add or remove resources after start() is called
         std::map<regex_orderable, std::map<std::string,
             std::function<void(std::shared_ptr<typename ServerBase<socket_type>::Response>, std::shared_ptr<typename ServerBase<socket_type>::Request>)> > > resource;
@@ -235,11 +242,27 @@ namespace SimpleWeb {
             return timer;
         }
         
-        void read_request_and_content(const std::shared_ptr<socket_type> &socket) {
+        //Moves whatever was read past the content into request->pipelined, it belongs to the next request
+        void split_pipelined(const std::shared_ptr<Request> &request, size_t content_length) {
+            if(request->streambuf.size()<=content_length)
+                return;
+
+            auto data=request->streambuf.data();
+            std::string buffered(asio::buffers_begin(data), asio::buffers_end(data));
+            request->streambuf.consume(buffered.size());
+            request->streambuf.sputn(buffered.data(), static_cast< std::streamsize >(content_length));
+            request->pipelined=buffered.substr(content_length);
+        }
+
+        void read_request_and_content(const std::shared_ptr<socket_type> &socket, const std::string &pipelined=std::string()) {
             //Create new streambuf (Request::streambuf) for async_read_until()
             //shared_ptr is used to pass temporary objects to the asynchronous functions
             std::shared_ptr<Request> request(new Request(*socket));
 
+            //Start from what was left over from the previous request, async_read_until() completes right away if it holds a full header
+            if(!pipelined.empty())
+                request->streambuf.sputn(pipelined.data(), static_cast< std::streamsize >(pipelined.size()));
+
             //Set timeout on the following asio::async-read or write function
             auto timer=this->get_timeout_timer(socket, config.timeout_request);
                         
@@ -284,11 +307,15 @@ namespace SimpleWeb {
                                     on_error(request, ec);
                             });
                         }
-                        else
+                        else {
+                            this->split_pipelined(request, static_cast< size_t >(content_length));
                             this->find_resource(socket, request);
+                        }
                     }
-                    else
+                    else {
+                        this->split_pipelined(request, 0);
                         this->find_resource(socket, request);
+                    }
                 }
                 else if(on_error)
                     on_error(request, ec);
@@ -345,6 +372,15 @@ namespace SimpleWeb {
                     return;
                 }
             }
+            //Exact path match, no regex evaluation needed
+            auto exact_it=exact_resource.find(request->path);
+            if(exact_it!=exact_resource.end()) {
+                auto it=exact_it->second.find(request->method);
+                if(it!=exact_it->second.end()) {
+                    write_response(socket, request, it->second);
+                    return;
+                }
+            }
             //Find path- and method-match, and call write_response
             for(auto &regex_method: resource) {
                 auto it=regex_method.second.find(request->method);
@@ -391,7 +427,7 @@ namespace SimpleWeb {
                                 return;
                         }
                         if(http_version>1.05)
-                            this->read_request_and_content(response->socket);
+                            this->read_request_and_content(response->socket, request->pipelined);
                     }
                     else if(on_error)
                         on_error(request, ec);
@@ -45,6 +45,7 @@ namespace Sapphire::Common::Config
       uint16_t disconnectTimeout;
 
       float inRangeDistance;
+      uint32_t visibleActorBudget;
     } network;
 
     struct Housing
@@ -62,6 +63,7 @@ namespace Sapphire::Common::Config
     struct Navigation
     {
       std::string meshPath;
+      uint32_t pathWorkers;
     } navigation;
 
     struct Map
@@ -69,6 +71,14 @@ namespace Sapphire::Common::Config
       bool eagerENpcEObjCache;
     } map;
 
+    struct Profiler
+    {
+      // seconds between tick profile log lines, 0 disables them
+      uint32_t logInterval;
+      // json file rewritten with every log line and on shutdown, empty disables it
+      std::string dumpPath;
+    } profiler;
+
     std::string motd;
     bool skipOpening;
   };
@@ -81,6 +91,11 @@ namespace Sapphire::Common::Config
     {
       std::string listenIp;
       uint16_t listenPort;
+
+      uint16_t restPoolSize;
+      uint16_t restTimeout;
+      uint16_t restKeepAlive;
+      uint16_t restWorkers;
     } network;
 
     bool allowNoSessionConnect;
@@ -95,6 +110,7 @@ namespace Sapphire::Common::Config
     {
       std::string listenIP;
       uint16_t listenPort;
+      uint16_t threads;
     } network;
   };
 }
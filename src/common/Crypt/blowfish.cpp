@@ -5,6 +5,7 @@
 // Converted to C++ class 5/96, Jim Conger
 
 #include <cstdint>
+#include <cstring>
 #include "blowfish.h"
 #include "blowfish.h2"  // holds the random digit tables
 
@@ -21,7 +22,7 @@ BlowFish::BlowFish()
 
 BlowFish::~BlowFish()
 {
-  delete PArray;
+  delete[] PArray;
   delete[] SBoxes;
 }
 
@@ -170,7 +171,7 @@ void BlowFish::initialize( BYTE key[], int32_t keybytes )
 }
 
 // get output length, which must be even MOD 8
-DWORD BlowFish::GetOutputLength( DWORD lInputLong )
+DWORD BlowFish::GetOutputLength( DWORD lInputLong ) const
 {
   DWORD lVal;
 
@@ -273,3 +274,84 @@ void BlowFish::Decode( BYTE* pInput, BYTE* pOutput, DWORD lSize )
   }
 }
 
+
+// block routines used by the segment functions, the key schedule is passed in explicitly
+// so the compiler can keep it in registers across the whole segment instead of reloading
+// the member pointers for every block
+#define BF_F( S, x ) ((((S)[ 0 ][ (x) >> 24 ] + (S)[ 1 ][ ( (x) >> 16 ) & 0xFF ]) ^ (S)[ 2 ][ ( (x) >> 8 ) & 0xFF ]) + (S)[ 3 ][ (x) & 0xFF ])
+#define BF_ROUND( a, b, n ) ( (a) ^= BF_F( S, b ) ^ P[ n ] )
+
+static inline void bfEncipherBlock( const DWORD* __restrict P, const DWORD ( * __restrict S )[ 256 ], BYTE* pBlock )
+{
+  DWORD l, r;
+  std::memcpy( &l, pBlock, 4 );
+  std::memcpy( &r, pBlock + 4, 4 );
+
+  l ^= P[ 0 ];
+  BF_ROUND( r, l, 1 );  BF_ROUND( l, r, 2 );
+  BF_ROUND( r, l, 3 );  BF_ROUND( l, r, 4 );
+  BF_ROUND( r, l, 5 );  BF_ROUND( l, r, 6 );
+  BF_ROUND( r, l, 7 );  BF_ROUND( l, r, 8 );
+  BF_ROUND( r, l, 9 );  BF_ROUND( l, r, 10 );
+  BF_ROUND( r, l, 11 ); BF_ROUND( l, r, 12 );
+  BF_ROUND( r, l, 13 ); BF_ROUND( l, r, 14 );
+  BF_ROUND( r, l, 15 ); BF_ROUND( l, r, 16 );
+  r ^= P[ 17 ];
+
+  std::memcpy( pBlock, &r, 4 );
+  std::memcpy( pBlock + 4, &l, 4 );
+}
+
+static inline void bfDecipherBlock( const DWORD* __restrict P, const DWORD ( * __restrict S )[ 256 ], BYTE* pBlock )
+{
+  DWORD l, r;
+  std::memcpy( &l, pBlock, 4 );
+  std::memcpy( &r, pBlock + 4, 4 );
+
+  l ^= P[ 17 ];
+  BF_ROUND( r, l, 16 ); BF_ROUND( l, r, 15 );
+  BF_ROUND( r, l, 14 ); BF_ROUND( l, r, 13 );
+  BF_ROUND( r, l, 12 ); BF_ROUND( l, r, 11 );
+  BF_ROUND( r, l, 10 ); BF_ROUND( l, r, 9 );
+  BF_ROUND( r, l, 8 );  BF_ROUND( l, r, 7 );
+  BF_ROUND( r, l, 6 );  BF_ROUND( l, r, 5 );
+  BF_ROUND( r, l, 4 );  BF_ROUND( l, r, 3 );
+  BF_ROUND( r, l, 2 );  BF_ROUND( l, r, 1 );
+  r ^= P[ 0 ];
+
+  std::memcpy( pBlock, &r, 4 );
+  std::memcpy( pBlock + 4, &l, 4 );
+}
+
+#undef BF_ROUND
+#undef BF_F
+
+// Encrypts a whole segment in place. Behaves like Encode( pData, pData, lSize ): an uneven
+// tail is padded with null bytes, so the buffer must hold GetOutputLength( lSize ) bytes.
+DWORD BlowFish::EncodeSegment( BYTE* pData, DWORD lSize ) const
+{
+  const DWORD* P = PArray;
+  const DWORD ( *S )[ 256 ] = SBoxes;
+
+  DWORD lOutSize = GetOutputLength( lSize );
+  if( lOutSize != lSize )
+    std::memset( pData + lSize, 0, lOutSize - lSize );
+
+  BYTE* pEnd = pData + lOutSize;
+  for( ; pData != pEnd; pData += 8 )
+    bfEncipherBlock( P, S, pData );
+
+  return lOutSize;
+}
+
+// Decrypts a whole segment in place. Like Decode, a trailing partial block is processed as
+// a full block, so the buffer must hold GetOutputLength( lSize ) bytes.
+void BlowFish::DecodeSegment( BYTE* pData, DWORD lSize ) const
+{
+  const DWORD* P = PArray;
+  const DWORD ( *S )[ 256 ] = SBoxes;
+
+  BYTE* pEnd = pData + GetOutputLength( lSize );
+  for( ; pData != pEnd; pData += 8 )
+    bfDecipherBlock( P, S, pData );
+}
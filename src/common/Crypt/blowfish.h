@@ -28,14 +28,24 @@ public:
 
   ~BlowFish();
 
+  // owns raw key schedule arrays, copying would double free them
+  BlowFish( const BlowFish& ) = delete;
+
+  BlowFish& operator=( const BlowFish& ) = delete;
+
   void initialize( BYTE key[], int32_t keybytes );
 
-  DWORD GetOutputLength( DWORD lInputLong );
+  DWORD GetOutputLength( DWORD lInputLong ) const;
 
   DWORD Encode( BYTE* pInput, BYTE* pOutput, DWORD lSize );
 
   void Decode( BYTE* pInput, BYTE* pOutput, DWORD lSize );
 
+  // in place variants for whole segments, the buffer must hold GetOutputLength( lSize ) bytes
+  DWORD EncodeSegment( BYTE* pData, DWORD lSize ) const;
+
+  void DecodeSegment( BYTE* pData, DWORD lSize ) const;
+
 };
 
 // choose a byte order for your hardware
@@ -1,6 +1,9 @@
 #include "DbWorker.h"
+#include "DbConnection.h"
 #include "Operation.h"
 #include "Util/LockedWaitQueue.h"
+#include "Util/Profiler.h"
+#include "Logging/Logger.h"
 
 using namespace Sapphire::Common;
 
@@ -25,6 +28,9 @@ void Sapphire::Db::DbWorker::workerThread()
   if( !m_queue )
     return;
 
+  std::vector< std::shared_ptr< Operation > > batch;
+  batch.reserve( MaxBatchSize );
+
   while( true )
   {
     std::shared_ptr< Operation > operation = nullptr;
@@ -34,7 +40,112 @@ void Sapphire::Db::DbWorker::workerThread()
     if( m_cancelationToken || !operation )
       return;
 
-    operation->setConnection( m_pConn );
-    operation->call();
+    batch.push_back( std::move( operation ) );
+
+    // take along whatever queued up in the meantime so it shares one commit
+    while( batch.size() < MaxBatchSize && m_queue->pop( operation ) )
+      batch.push_back( std::move( operation ) );
+
+    executeBatch( batch );
+    batch.clear();
+  }
+}
+
+void Sapphire::Db::DbWorker::executeBatch( std::vector< std::shared_ptr< Operation > >& batch )
+{
+  SAPPHIRE_PROFILE_SCOPE( "db.asyncBatch" );
+
+  // a single operation is left to autocommit, wrapping it would only add round trips
+  bool transaction = batch.size() > 1;
+
+  if( transaction )
+  {
+    try
+    {
+      m_pConn->beginTransaction();
+    }
+    catch( std::runtime_error& e )
+    {
+      Logger::error( "[DbWorker] Failed to start batch transaction: {0}", e.what() );
+      transaction = false;
+    }
+  }
+
+  if( !transaction )
+  {
+    // autocommit, every operation stands on its own
+    for( auto& operation : batch )
+      operation->complete( runOperation( *operation ) );
+    return;
+  }
+
+  // every operation runs behind a savepoint, one that fails is rolled back on its own and the rest still commit
+  std::vector< bool > succeeded( batch.size(), false );
+  bool committed = true;
+  for( size_t i = 0; i < batch.size(); ++i )
+  {
+    auto& operation = *batch[ i ];
+
+    // jobs take their own connections, nothing they do is part of the transaction
+    const bool inTransaction = operation.getConnectionUse() != Operation::ConnectionUse::None;
+
+    if( inTransaction && !m_pConn->execute( "SAVEPOINT batch_operation" ) )
+    {
+      committed = false;
+      break;
+    }
+
+    succeeded[ i ] = runOperation( operation );
+    if( succeeded[ i ] || !inTransaction )
+      continue;
+
+    // fails if the server already rolled back the whole transaction, e.g. on a deadlock
+    if( !m_pConn->execute( "ROLLBACK TO SAVEPOINT batch_operation" ) )
+    {
+      committed = false;
+      break;
+    }
+  }
+
+  try
+  {
+    if( committed )
+      m_pConn->commitTransaction();
+  }
+  catch( std::runtime_error& e )
+  {
+    Logger::error( "[DbWorker] Failed to commit batch of {0} operations: {1}", batch.size(), e.what() );
+    committed = false;
+  }
+
+  if( !committed )
+  {
+    Logger::error( "[DbWorker] Rolling back batch of {0} operations", batch.size() );
+    try
+    {
+      m_pConn->rollbackTransaction();
+    }
+    catch( std::runtime_error& e )
+    {
+      Logger::error( "[DbWorker] Rollback failed: {0}", e.what() );
+    }
+  }
+
+  for( size_t i = 0; i < batch.size(); ++i )
+    batch[ i ]->complete( committed && succeeded[ i ] );
+}
+
+bool Sapphire::Db::DbWorker::runOperation( Operation& operation )
+{
+  operation.setConnection( m_pConn );
+
+  try
+  {
+    return operation.call();
+  }
+  catch( std::runtime_error& e )
+  {
+    Logger::error( "[DbWorker] Operation failed: {0}", e.what() );
+    return false;
   }
 }
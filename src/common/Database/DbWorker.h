@@ -3,6 +3,7 @@
 #include <atomic>
 #include <thread>
 #include <memory>
+#include <vector>
 
 #include "Util/LockedWaitQueue.h"
 
@@ -14,6 +15,9 @@ namespace Sapphire::Db
   class DbWorker
   {
   public:
+    // upper bound of queued operations executed under a single commit
+    static constexpr size_t MaxBatchSize = 64;
+
     DbWorker( Common::Util::LockedWaitQueue< std::shared_ptr< Operation > >* newQueue, DbConnection* connection );
 
     ~DbWorker();
@@ -24,6 +28,11 @@ namespace Sapphire::Db
 
     void workerThread();
 
+    void executeBatch( std::vector< std::shared_ptr< Operation > >& batch );
+
+    // false if the operation failed or threw
+    bool runOperation( Operation& operation );
+
     std::thread m_workerThread;
 
     std::atomic< bool > m_cancelationToken;
@@ -6,9 +6,12 @@
 #include "ZoneDbConnection.h"
 
 #include "Logging/Logger.h"
+#include "Util/Profiler.h"
 
 #include <stdexcept>
 #include <thread>
+#include <future>
+#include <atomic>
 
 class PingOperation : public Sapphire::Db::Operation
 {
@@ -19,9 +22,30 @@ class PingOperation : public Sapphire::Db::Operation
   }
 };
 
+class FlushOperation : public Sapphire::Db::Operation
+{
+public:
+  std::future< void > getFuture()
+  {
+    return m_promise.get_future();
+  }
+
+private:
+  bool execute() override
+  {
+    return true;
+  }
+
+  void complete( bool committed ) override
+  {
+    m_promise.set_value();
+  }
+
+  std::promise< void > m_promise;
+};
+
 template< class T >
 Sapphire::Db::DbWorkerPool< T >::DbWorkerPool() :
-  m_queue( new Common::Util::LockedWaitQueue< std::shared_ptr< Operation > >() ),
   m_asyncThreads( 0 ),
   m_synchThreads( 0 )
 {
@@ -30,7 +54,8 @@ Sapphire::Db::DbWorkerPool< T >::DbWorkerPool() :
 template< class T >
 Sapphire::Db::DbWorkerPool< T >::~DbWorkerPool()
 {
-  m_queue->cancel();
+  for( auto& queue : m_queues )
+    queue->cancel();
 }
 
 template< class T >
@@ -69,6 +94,8 @@ template< class T >
 void Sapphire::Db::DbWorkerPool< T >::close()
 {
   Logger::info( "[DbPool] Closing down DatabasePool {0}", getDatabaseName() );
+  // pending writes would be dropped along with their workers otherwise
+  flush();
   m_connections[ IDX_ASYNC ].clear();
   m_connections[ IDX_SYNCH ].clear();
   Logger::info( "[DbPool] All connections on DatabasePool {0} closed.", getDatabaseName() );
@@ -100,6 +127,8 @@ template< class T >
 std::shared_ptr< Mysql::ResultSet >
 Sapphire::Db::DbWorkerPool< T >::query( const std::string& sql, std::shared_ptr< T > connection, bool streaming )
 {
+  SAPPHIRE_PROFILE_SCOPE( "db.query" );
+
   if( !connection )
     connection = getFreeConnection();
 
@@ -110,6 +139,8 @@ template< class T >
 std::shared_ptr< Mysql::PreparedResultSet >
 Sapphire::Db::DbWorkerPool< T >::query( std::shared_ptr< PreparedStatement > stmt )
 {
+  SAPPHIRE_PROFILE_SCOPE( "db.query" );
+
   auto connection = getFreeConnection();
   return std::static_pointer_cast< Mysql::PreparedResultSet >( connection->query( stmt ) );
 }
@@ -151,9 +182,8 @@ void Sapphire::Db::DbWorkerPool< T >::keepAlive()
     }
   }
 
-  const auto count = m_connections[ IDX_ASYNC ].size();
-  for( uint8_t i = 0; i < count; ++i )
-    enqueue( std::make_shared< PingOperation >() );
+  for( auto& queue : m_queues )
+    queue->push( std::make_shared< PingOperation >() );
 }
 
 template< class T >
@@ -166,7 +196,8 @@ uint32_t Sapphire::Db::DbWorkerPool< T >::openConnections( InternalIndex type, u
       switch( type )
       {
         case IDX_ASYNC:
-          return std::make_shared< T >( m_queue.get(), m_connectionInfo );
+          m_queues.push_back( std::make_unique< Common::Util::LockedWaitQueue< std::shared_ptr< Operation > > >() );
+          return std::make_shared< T >( m_queues.back().get(), m_connectionInfo );
         case IDX_SYNCH:
           return std::make_shared< T >( m_connectionInfo );
         default:
@@ -177,7 +208,10 @@ uint32_t Sapphire::Db::DbWorkerPool< T >::openConnections( InternalIndex type, u
     if( uint32_t error = connection->open() )
     {
       // Failed to open a connection or invalid version, abort and cleanup
+      connection.reset();
       m_connections[ type ].clear();
+      if( type == IDX_ASYNC )
+        m_queues.clear();
       return error;
     }
     m_connections[ type ].push_back( connection );
@@ -187,9 +221,87 @@ uint32_t Sapphire::Db::DbWorkerPool< T >::openConnections( InternalIndex type, u
 }
 
 template< class T >
-void Sapphire::Db::DbWorkerPool< T >::enqueue( std::shared_ptr< Operation > op )
+void Sapphire::Db::DbWorkerPool< T >::enqueue( std::shared_ptr< Operation > op, uint64_t orderKey )
 {
-  m_queue->push( op );
+  if( m_queues.empty() )
+  {
+    // no async connections configured, run it in place
+    std::shared_ptr< T > connection;
+    if( op->getConnectionUse() != Operation::ConnectionUse::None )
+    {
+      connection = getFreeConnection();
+      op->setConnection( connection.get() );
+    }
+
+    bool success = op->call();
+
+    if( op->getConnectionUse() == Operation::ConnectionUse::Held )
+      connection->unlock();
+
+    op->complete( success );
+    return;
+  }
+
+  m_queues[ orderKey % m_queues.size() ]->push( op );
+}
+
+template< class T >
+void Sapphire::Db::DbWorkerPool< T >::flush()
+{
+  std::vector< Common::Util::LockedWaitQueue< std::shared_ptr< Operation > >* > queues;
+  for( auto& queue : m_queues )
+    queues.push_back( queue.get() );
+
+  flushQueues( queues );
+}
+
+template< class T >
+void Sapphire::Db::DbWorkerPool< T >::flush( uint64_t orderKey )
+{
+  if( m_queues.empty() )
+    return;
+
+  flushQueues( { m_queues[ orderKey % m_queues.size() ].get() } );
+}
+
+template< class T >
+void Sapphire::Db::DbWorkerPool< T >::flushAsync( std::function< void() > done )
+{
+  if( m_queues.empty() )
+  {
+    done();
+    return;
+  }
+
+  // whichever queue reaches its barrier last reports back
+  auto pending = std::make_shared< std::atomic< size_t > >( m_queues.size() );
+  auto callback = std::make_shared< std::function< void() > >( std::move( done ) );
+
+  for( auto& queue : m_queues )
+  {
+    queue->push( std::make_shared< JobTask >( []() {}, [ pending, callback ]()
+    {
+      if( --*pending == 0 )
+        ( *callback )();
+    } ) );
+  }
+}
+
+template< class T >
+void Sapphire::Db::DbWorkerPool< T >::flushQueues( const std::vector< Common::Util::LockedWaitQueue< std::shared_ptr< Operation > >* >& queues )
+{
+  std::vector< std::future< void > > pending;
+
+  for( auto queue : queues )
+  {
+    auto op = std::make_shared< FlushOperation >();
+    pending.push_back( op->getFuture() );
+    queue->push( op );
+  }
+
+  // a queue cancelled in the meantime drops the barrier, which breaks the promise and still wakes us up
+  for( auto& future : pending )
+    future.wait();
 }
 
 template< class T >
@@ -222,22 +334,39 @@ const std::string& Sapphire::Db::DbWorkerPool< T >::getDatabaseName() const
 }
 
 template< class T >
-void Sapphire::Db::DbWorkerPool< T >::execute( const std::string& sql )
+void Sapphire::Db::DbWorkerPool< T >::execute( const std::string& sql, uint64_t orderKey )
 {
   auto task = std::make_shared< StatementTask >( sql );
-  enqueue( task );
+  enqueue( task, orderKey );
 }
 
 template< class T >
-void Sapphire::Db::DbWorkerPool< T >::execute( std::shared_ptr< PreparedStatement > stmt )
+void Sapphire::Db::DbWorkerPool< T >::execute( std::shared_ptr< PreparedStatement > stmt, uint64_t orderKey )
 {
   auto task = std::make_shared< PreparedStatementTask >( stmt );
-  enqueue( task );
+  enqueue( task, orderKey );
+}
+
+template< class T >
+void Sapphire::Db::DbWorkerPool< T >::queryAsync( std::shared_ptr< PreparedStatement > stmt, ResultHandler handler,
+                                                  std::function< void() > done, uint64_t orderKey )
+{
+  auto task = std::make_shared< PreparedQueryTask >( std::move( stmt ), std::move( handler ), std::move( done ) );
+  enqueue( task, orderKey );
+}
+
+template< class T >
+void Sapphire::Db::DbWorkerPool< T >::post( std::function< void() > job, std::function< void() > done, uint64_t orderKey )
+{
+  auto task = std::make_shared< JobTask >( std::move( job ), std::move( done ) );
+  enqueue( task, orderKey );
 }
 
 template< class T >
 void Sapphire::Db::DbWorkerPool< T >::directExecute( const std::string& sql )
 {
+  SAPPHIRE_PROFILE_SCOPE( "db.directExecute" );
+
   auto connection = getFreeConnection();
   connection->execute( sql );
   connection->unlock();
@@ -246,9 +375,78 @@ void Sapphire::Db::DbWorkerPool< T >::directExecute( const std::string& sql )
 template< class T >
 void Sapphire::Db::DbWorkerPool< T >::directExecute( std::shared_ptr< PreparedStatement > stmt )
 {
+  SAPPHIRE_PROFILE_SCOPE( "db.directExecute" );
+
   auto connection = getFreeConnection();
   connection->execute( stmt );
   connection->unlock();
 }
 
+template< class T >
+bool Sapphire::Db::DbWorkerPool< T >::directExecuteTransaction( const std::vector< std::shared_ptr< PreparedStatement > >& stmts )
+{
+  SAPPHIRE_PROFILE_SCOPE( "db.transaction" );
+
+  auto connection = getFreeConnection();
+  bool result = executeTransaction( connection, stmts );
+  connection->unlock();
+  return result;
+}
+
+template< class T >
+std::shared_ptr< Mysql::PreparedResultSet >
+Sapphire::Db::DbWorkerPool< T >::directQueryTransaction( const std::vector< std::shared_ptr< PreparedStatement > >& stmts,
+                                                         std::shared_ptr< PreparedStatement > stmt )
+{
+  SAPPHIRE_PROFILE_SCOPE( "db.transaction" );
+
+  auto connection = getFreeConnection();
+  if( !executeTransaction( connection, stmts ) )
+  {
+    connection->unlock();
+    return nullptr;
+  }
+
+  // the query releases the connection, same as query( stmt )
+  return std::static_pointer_cast< Mysql::PreparedResultSet >( connection->query( stmt ) );
+}
+
+template< class T >
+bool Sapphire::Db::DbWorkerPool< T >::executeTransaction( const std::shared_ptr< T >& connection,
+                                                          const std::vector< std::shared_ptr< PreparedStatement > >& stmts )
+{
+  try
+  {
+    connection->beginTransaction();
+
+    for( auto& stmt : stmts )
+    {
+      if( !connection->execute( stmt ) )
+      {
+        Logger::error( "[DbPool] Statement {0} failed, rolling back transaction", stmt ? stmt->getIndex() : 0 );
+        connection->rollbackTransaction();
+        return false;
+      }
+    }
+
+    connection->commitTransaction();
+    return true;
+  }
+  catch( std::runtime_error& e )
+  {
+    Logger::error( e.what() );
+
+    // the connection goes back to the pool, it must not be left inside the failed transaction
+    try
+    {
+      connection->rollbackTransaction();
+    }
+    catch( std::runtime_error& rollbackError )
+    {
+      Logger::error( "[DbPool] Rollback failed: {0}", rollbackError.what() );
+    }
+    return false;
+  }
+}
+
 template class Sapphire::Db::DbWorkerPool< Sapphire::Db::ZoneDbConnection >;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -49,21 +50,51 @@ namespace Sapphire::Db
       return m_connectionInfo;
     }
 
-    // Async execution
-    void execute( const std::string& sql );
+    // Async execution, operations sharing an order key run on the same connection in the order they were queued
+    void execute( const std::string& sql, uint64_t orderKey = 0 );
 
-    void execute( std::shared_ptr< PreparedStatement > stmt );
+    void execute( std::shared_ptr< PreparedStatement > stmt, uint64_t orderKey = 0 );
+
+    // Blocks until every async operation queued so far has been committed
+    void flush();
+
+    // Blocks until every async operation queued so far under orderKey has been committed
+    void flush( uint64_t orderKey );
+
+    // Calls done on a worker thread once every async operation queued so far has been committed, without blocking
+    void flushAsync( std::function< void() > done );
 
     // Sync execution
     void directExecute( const std::string& sql );
 
     void directExecute( std::shared_ptr< PreparedStatement > stmt );
 
+    // Sync execution of several statements in a single transaction, rolled back if any of them fails
+    bool directExecuteTransaction( const std::vector< std::shared_ptr< PreparedStatement > >& stmts );
+
+    // Same as directExecuteTransaction, followed by a query on the same connection so it can read per connection
+    // state such as LAST_INSERT_ID(). Returns nullptr if the transaction was rolled back
+    std::shared_ptr< Mysql::PreparedResultSet >
+    directQueryTransaction( const std::vector< std::shared_ptr< PreparedStatement > >& stmts,
+                            std::shared_ptr< PreparedStatement > stmt );
+
     std::shared_ptr< Mysql::ResultSet >
     query( const std::string& sql, std::shared_ptr< T > connection = nullptr, bool streaming = DbConnection::DEFAULT_STREAMING );
 
     std::shared_ptr< Mysql::PreparedResultSet > query( std::shared_ptr< PreparedStatement > stmt );
 
+    using ResultHandler = std::function< void( std::shared_ptr< Mysql::PreparedResultSet > ) >;
+
+    // Async query, queued like execute() so it sees every write queued before it under orderKey. The result
+    // is handed to handler on the worker thread and released afterwards, handlers must not hold on to it.
+    // done is called on the worker thread once the batch the query ran in has been committed or rolled back
+    void queryAsync( std::shared_ptr< PreparedStatement > stmt, ResultHandler handler,
+                     std::function< void() > done = nullptr, uint64_t orderKey = 0 );
+
+    // Runs job on the worker thread of orderKey, for loads that need several dependent queries of their own.
+    // done is called the same way as for queryAsync
+    void post( std::function< void() > job, std::function< void() > done = nullptr, uint64_t orderKey = 0 );
+
     using PreparedStatementIndex = typename T::Statements;
 
     std::shared_ptr< PreparedStatement > getPreparedStatement( PreparedStatementIndex index );
@@ -75,13 +106,20 @@ namespace Sapphire::Db
   private:
     uint32_t openConnections( InternalIndex type, uint8_t numConnections );
 
-    void enqueue( std::shared_ptr< Operation > op );
+    void enqueue( std::shared_ptr< Operation > op, uint64_t orderKey );
+
+    void flushQueues( const std::vector< Common::Util::LockedWaitQueue< std::shared_ptr< Operation > >* >& queues );
 
     std::shared_ptr< T > getFreeConnection();
 
+    // runs stmts in one transaction on a connection the caller holds, rolls back on any failure
+    bool executeTransaction( const std::shared_ptr< T >& connection,
+                             const std::vector< std::shared_ptr< PreparedStatement > >& stmts );
+
     const std::string& getDatabaseName() const;
 
-    std::unique_ptr< Common::Util::LockedWaitQueue< std::shared_ptr< Operation > > > m_queue;
+    // one queue per async connection, declared before the connections so their workers are joined first
+    std::vector< std::unique_ptr< Common::Util::LockedWaitQueue< std::shared_ptr< Operation > > > > m_queues;
     std::array< std::vector< std::shared_ptr< T > >, IDX_SIZE > m_connections;
     ConnectionInfo m_connectionInfo;
     uint8_t m_asyncThreads;
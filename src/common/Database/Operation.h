@@ -9,6 +9,14 @@ namespace Sapphire::Db
   class Operation
   {
   public:
+    // how an operation run in place, without an async worker, treats the sync connection it is given
+    enum class ConnectionUse
+    {
+      Held,       // the caller unlocks it afterwards
+      Released,   // queries release it along with their result
+      None        // takes its own connections, must not be handed one
+    };
+
     Operation() :
       m_pConn( nullptr )
     {
@@ -18,14 +26,25 @@ namespace Sapphire::Db
     {
     }
 
-    virtual int call()
+    // false if the operation failed
+    virtual bool call()
     {
-      execute();
-      return 0;
+      return execute();
     }
 
     virtual bool execute() = 0;
 
+    // called by the worker once the batch containing this operation has been committed, or with false
+    // if this operation failed or the batch as a whole could not be committed
+    virtual void complete( bool committed )
+    {
+    }
+
+    virtual ConnectionUse getConnectionUse() const
+    {
+      return ConnectionUse::Held;
+    }
+
     virtual void setConnection( DbConnection* pCon )
     {
       m_pConn = pCon;
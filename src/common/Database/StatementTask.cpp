@@ -3,6 +3,8 @@
 #include "Operation.h"
 #include "DbConnection.h"
 #include "PreparedStatement.h"
+#include "MySqlPreparedResultSet.h"
+#include "Logging/Logger.h"
 
 Sapphire::Db::StatementTask::StatementTask( const std::string& sql, bool async )
 {
@@ -68,3 +70,64 @@ bool Sapphire::Db::PreparedStatementTask::execute()
 
   return m_pConn->execute( m_stmt );
 }
+
+Sapphire::Db::PreparedQueryTask::PreparedQueryTask( std::shared_ptr< PreparedStatement > stmt, ResultHandler handler,
+                                                    std::function< void() > done ) :
+  m_stmt( std::move( stmt ) ),
+  m_handler( std::move( handler ) ),
+  m_done( std::move( done ) )
+{
+}
+
+bool Sapphire::Db::PreparedQueryTask::execute()
+{
+  auto result = std::static_pointer_cast< Mysql::PreparedResultSet >( m_pConn->query( m_stmt ) );
+
+  try
+  {
+    if( m_handler )
+      m_handler( result );
+  }
+  catch( std::exception& e )
+  {
+    // an escaping exception would take the worker thread down with it
+    Logger::error( "[DbWorker] Result handler for statement {0} failed: {1}", m_stmt->getIndex(), e.what() );
+    return false;
+  }
+
+  return result != nullptr;
+}
+
+void Sapphire::Db::PreparedQueryTask::complete( bool committed )
+{
+  // the result has been handled either way
+  if( m_done )
+    m_done();
+}
+
+Sapphire::Db::JobTask::JobTask( std::function< void() > job, std::function< void() > done ) :
+  m_job( std::move( job ) ),
+  m_done( std::move( done ) )
+{
+}
+
+bool Sapphire::Db::JobTask::execute()
+{
+  try
+  {
+    m_job();
+  }
+  catch( std::exception& e )
+  {
+    Logger::error( "[DbWorker] Job failed: {0}", e.what() );
+    return false;
+  }
+
+  return true;
+}
+
+void Sapphire::Db::JobTask::complete( bool committed )
+{
+  if( m_done )
+    m_done();
+}
@@ -3,6 +3,12 @@
 #include <string>
 #include "Operation.h"
 #include <memory>
+#include <functional>
+
+namespace Mysql
+{
+  class PreparedResultSet;
+}
 
 namespace Sapphire::Db
 {
@@ -38,4 +44,49 @@ namespace Sapphire::Db
     bool m_hasResult;
   };
 
-}
\ No newline at end of file
+  // runs a query on the worker, the result is handed to the handler there and released right after
+  class PreparedQueryTask :
+    public Operation
+  {
+  public:
+    using ResultHandler = std::function< void( std::shared_ptr< Mysql::PreparedResultSet > ) >;
+
+    PreparedQueryTask( std::shared_ptr< PreparedStatement > stmt, ResultHandler handler, std::function< void() > done );
+
+    bool execute() override;
+
+    void complete( bool committed ) override;
+
+    ConnectionUse getConnectionUse() const override
+    {
+      return ConnectionUse::Released;
+    }
+
+  private:
+    std::shared_ptr< PreparedStatement > m_stmt;
+    ResultHandler m_handler;
+    std::function< void() > m_done;
+  };
+
+  // runs a job on the worker, for loads that need several dependent queries
+  class JobTask :
+    public Operation
+  {
+  public:
+    JobTask( std::function< void() > job, std::function< void() > done );
+
+    bool execute() override;
+
+    void complete( bool committed ) override;
+
+    ConnectionUse getConnectionUse() const override
+    {
+      return ConnectionUse::None;
+    }
+
+  private:
+    std::function< void() > m_job;
+    std::function< void() > m_done;
+  };
+
+}
@@ -34,7 +34,7 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
                     "GrandCompanyRank, Discovery, GMRank, EquipDisplayFlags, Unlocks, CFPenaltyUntil, "
                     "Pose "
                     "FROM charainfo WHERE CharacterId = ?;",
-                    CONNECTION_SYNC );
+                    CONNECTION_BOTH );
 
 
   prepareStatement( CHARA_UP,
@@ -141,7 +141,7 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
                     "UPDATE charainfosearch SET SelectRegion = ? WHERE CharacterId = ?;", CONNECTION_ASYNC );
   prepareStatement( CHARA_SEARCHINFO_UP_SEARCHCOMMENT,
                     "UPDATE charainfosearch SET SearchComment = ? WHERE CharacterId = ?;", CONNECTION_ASYNC );
-  prepareStatement( CHARA_SEL_SEARCHINFO, "SELECT * FROM charainfosearch WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_SEL_SEARCHINFO, "SELECT * FROM charainfosearch WHERE CharacterId = ?;", CONNECTION_BOTH );
 
   /// QUEST INFO
   prepareStatement( CHARA_QUEST_INS,
@@ -157,11 +157,11 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
   prepareStatement( CHARA_QUEST_DEL, "DELETE FROM charaquest WHERE CharacterId = ? AND QuestId = ?;",
                     CONNECTION_ASYNC );
 
-  prepareStatement( CHARA_SEL_QUEST, "SELECT * FROM charaquest WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_SEL_QUEST, "SELECT * FROM charaquest WHERE CharacterId = ?;", CONNECTION_BOTH );
 
   /// CLASS INFO
   prepareStatement( CHARA_CLASS_SEL, "SELECT ClassIdx, Exp, Lvl, BorrowAction FROM characlass WHERE CharacterId = ?;",
-                    CONNECTION_SYNC );
+                    CONNECTION_BOTH );
   prepareStatement( CHARA_CLASS_INS, "INSERT INTO characlass ( CharacterId, ClassIdx, Exp, Lvl, BorrowAction ) VALUES( ?,?,?,?,? );",
                     CONNECTION_BOTH );
   prepareStatement( CHARA_CLASS_UP, "UPDATE characlass SET Exp = ?, Lvl = ?, BorrowAction = ? WHERE CharacterId = ? AND ClassIdx = ?;",
@@ -180,7 +180,11 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
   /// ITEM GLOBAL
   prepareStatement( CHARA_ITEMGLOBAL_INS,
                     "INSERT INTO charaglobalitem ( CharacterId, ItemId, catalogId, stack, UPDATE_DATE ) VALUES ( ?, ?, ?, ?, NOW() );",
-                    CONNECTION_SYNC );
+                    CONNECTION_BOTH );
+
+  prepareStatement( CHARA_ITEMGLOBAL_INS_FLAGS,
+                    "INSERT INTO charaglobalitem ( CharacterId, ItemId, catalogId, stack, flags, UPDATE_DATE ) VALUES ( ?, ?, ?, ?, ?, NOW() );",
+                    CONNECTION_BOTH );
 
   prepareStatement( CHARA_ITEMGLOBAL_SELECT,
                     "SELECT catalogId, stack, reservedFlag, signatureId, flags, durability, refine, materia_0, materia_1, "
@@ -219,7 +223,7 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
                                                   "Category_6, Category_7, Category_8, "
                                                   "Category_9, Category_10, Category_11 FROM charamonsternote "
                                                   "WHERE CharacterId = ?;",
-                    CONNECTION_SYNC );
+                    CONNECTION_BOTH );
 
   /// CHARA ACHIEVEMENT
   prepareStatement( CHARA_ACHIEV_INS,
@@ -236,7 +240,7 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
 
   prepareStatement( CHARA_ACHIEV_SEL, "SELECT UnlockList, ProgressData, HistoryList FROM charainfoachievement "
                                           "WHERE CharacterId = ?;",
-                    CONNECTION_SYNC );
+                    CONNECTION_BOTH );
 
 
   /// CHARA FRIENDLIST
@@ -253,7 +257,7 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
 
   prepareStatement( CHARA_FRIENDLIST_SEL, "SELECT CharacterIdList, InviteDataList FROM charainfofriendlist "
                                            "WHERE CharacterId = ?;",
-                     CONNECTION_SYNC );
+                     CONNECTION_BOTH );
 
   /// CHARA BLACKLIST
   prepareStatement( CHARA_BLACKLIST_INS,
@@ -268,14 +272,14 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
 
   prepareStatement( CHARA_BLACKLIST_SEL, "SELECT CharacterIdList FROM charainfoblacklist "
                                           " WHERE CharacterId = ?;",
-                     CONNECTION_SYNC );
+                     CONNECTION_BOTH );
 
   /// CHARA LINKSHELL
   prepareStatement( CHARA_LINKSHELL_INS,
                     "INSERT INTO infolinkshell ( LinkshellId, MasterCharacterId, CharacterIdList, "
                     "LinkshellName, LeaderIdList, InviteIdList, UPDATE_DATE ) "
                     " VALUES ( ?, ?, ?, ?, ?, ?, NOW() );",
-                    CONNECTION_SYNC );
+                    CONNECTION_BOTH );
 
   /// ZONE QUERIES
   prepareStatement( ZONE_SEL_BNPCS_BY_TERI,
@@ -421,6 +425,38 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
                     "DELETE FROM fcmember WHERE FcMemberId = ?;",
                     CONNECTION_BOTH );
 
+  prepareStatement( MARKET_LISTING_SEL_ALL,
+                    "SELECT ListingId, CatalogId, SellerCharacterId, RetainerId, RetainerName, ItemId, Stack, UnitPrice, "
+                            "Hq, Stain, ListDate "
+                    "FROM marketlisting "
+                    "ORDER BY ListingId ASC;",
+                    CONNECTION_SYNC );
+
+  prepareStatement( MARKET_LISTING_INS,
+                    "INSERT INTO marketlisting ( ListingId, CatalogId, SellerCharacterId, RetainerId, RetainerName, ItemId, "
+                                "Stack, UnitPrice, Hq, Stain, ListDate, UPDATE_DATE ) VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, NOW() );",
+                    CONNECTION_BOTH );
+
+  prepareStatement( MARKET_LISTING_UP,
+                    "UPDATE marketlisting SET Stack = ?, UnitPrice = ?, UPDATE_DATE = NOW() WHERE ListingId = ?;",
+                    CONNECTION_BOTH );
+
+  prepareStatement( MARKET_LISTING_DEL,
+                    "DELETE FROM marketlisting WHERE ListingId = ?;",
+                    CONNECTION_BOTH );
+
+  // the newest page of an item's history, MarketMgr keeps 20 sales per item
+  prepareStatement( MARKET_HISTORY_SEL_ITEM,
+                    "SELECT CatalogId, UnitPrice, Stack, Hq, BuyerName, SaleDate "
+                    "FROM markethistory "
+                    "WHERE CatalogId = ? "
+                    "ORDER BY SaleId DESC LIMIT 20;",
+                    CONNECTION_BOTH );
+
+  prepareStatement( MARKET_HISTORY_INS,
+                    "INSERT INTO markethistory ( CatalogId, UnitPrice, Stack, Hq, BuyerName, SaleDate ) VALUES ( ?, ?, ?, ?, ?, ? );",
+                    CONNECTION_BOTH );
+
   prepareStatement( ACCOUNT_SEL_BY_NAME_PASS,
                     "SELECT account_id FROM accounts WHERE account_name = ? AND account_pass = ?;",
                     CONNECTION_SYNC );
@@ -445,4 +481,47 @@ void Sapphire::Db::ZoneDbConnection::doPrepareStatements()
                     "SELECT CharacterId FROM charainfo WHERE Name = ?;",
                     CONNECTION_SYNC );
 
+  prepareStatement( CHARA_SEL_BY_ENTITYID,
+                    "SELECT CharacterId FROM charainfo WHERE EntityId = ?;",
+                    CONNECTION_BOTH );
+
+  prepareStatement( CHARA_SEL_MAX_ENTITYID,
+                    "SELECT MAX(EntityId) FROM charainfo;",
+                    CONNECTION_SYNC );
+
+  prepareStatement( CHARA_SEL_MAX_CHARACTERID,
+                    "SELECT MAX(CharacterId) FROM charainfo;",
+                    CONNECTION_SYNC );
+
+  /// starting gearset: main hand, body, hands, legs, feet
+  prepareStatement( CHARA_ITEMGEARSET_INS,
+                    "INSERT INTO charaitemgearset ( storageId, CharacterId, container_0, container_3, container_4, "
+                    "container_6, container_7, UPDATE_DATE ) VALUES ( ?, ?, ?, ?, ?, ?, ?, NOW() );",
+                    CONNECTION_SYNC );
+
+  /// LAST_INSERT_ID() is per connection, both have to run on the same one
+  prepareStatement( UNIQUEID_INS,
+                    "INSERT INTO uniqueiddata( IdName ) VALUES( 'NOT_SET' );",
+                    CONNECTION_SYNC );
+
+  prepareStatement( UNIQUEID_SEL_LAST_INSERT_ID,
+                    "SELECT LAST_INSERT_ID();",
+                    CONNECTION_SYNC );
+
+  /// CHARACTER DELETION
+  prepareStatement( CHARA_DEL, "DELETE FROM charainfo WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_CLASS_DEL_ALL, "DELETE FROM characlass WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_ITEMGLOBAL_DEL_ALL, "DELETE FROM charaglobalitem WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_BLACKLIST_DEL, "DELETE FROM charainfoblacklist WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_FRIENDLIST_DEL, "DELETE FROM charainfofriendlist WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_LINKSHELL_DEL, "DELETE FROM charainfolinkshell WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_SEARCHINFO_DEL, "DELETE FROM charainfosearch WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_ITEMCRYSTAL_DEL, "DELETE FROM charaitemcrystal WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_ITEMINV_DEL, "DELETE FROM charaiteminventory WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_ITEMGEARSET_DEL, "DELETE FROM charaitemgearset WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_QUEST_DEL_ALL, "DELETE FROM charaquest WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_ACHIEV_DEL, "DELETE FROM charainfoachievement WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_CURRENCYINV_DEL, "DELETE FROM charaitemcurrency WHERE CharacterId = ?;", CONNECTION_SYNC );
+  prepareStatement( CHARA_MONSTERNOTE_DEL, "DELETE FROM charamonsternote WHERE CharacterId = ?;", CONNECTION_SYNC );
+
 }
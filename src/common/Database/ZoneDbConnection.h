@@ -73,6 +73,7 @@ namespace Sapphire::Db
 
     CHARA_ITEMGLOBAL_SELECT,
     CHARA_ITEMGLOBAL_INS,
+    CHARA_ITEMGLOBAL_INS_FLAGS,
     CHARA_ITEMGLOBAL_UP,
     CHARA_ITEMGLOBAL_DELETE,
 
@@ -129,12 +130,40 @@ namespace Sapphire::Db
     FC_MEMBERS_UP,
     FC_MEMBERS_DEL,
 
+    MARKET_LISTING_SEL_ALL,
+    MARKET_LISTING_INS,
+    MARKET_LISTING_UP,
+    MARKET_LISTING_DEL,
+    MARKET_HISTORY_SEL_ITEM,
+    MARKET_HISTORY_INS,
+
     ACCOUNT_SEL_BY_NAME_PASS,
     ACCOUNT_SEL_BY_NAME,
     ACCOUNT_SEL_MAX_ID,
     ACCOUNT_INS,
     CHARA_SEL_BY_ACCOUNT_ID,
     CHARA_SEL_BY_NAME,
+    CHARA_SEL_BY_ENTITYID,
+    CHARA_SEL_MAX_ENTITYID,
+    CHARA_SEL_MAX_CHARACTERID,
+    CHARA_ITEMGEARSET_INS,
+    UNIQUEID_INS,
+    UNIQUEID_SEL_LAST_INSERT_ID,
+
+    CHARA_DEL,
+    CHARA_CLASS_DEL_ALL,
+    CHARA_ITEMGLOBAL_DEL_ALL,
+    CHARA_BLACKLIST_DEL,
+    CHARA_FRIENDLIST_DEL,
+    CHARA_LINKSHELL_DEL,
+    CHARA_SEARCHINFO_DEL,
+    CHARA_ITEMCRYSTAL_DEL,
+    CHARA_ITEMINV_DEL,
+    CHARA_ITEMGEARSET_DEL,
+    CHARA_QUEST_DEL_ALL,
+    CHARA_ACHIEV_DEL,
+    CHARA_CURRENCYINV_DEL,
+    CHARA_MONSTERNOTE_DEL,
 
     MAX_STATEMENTS
   };
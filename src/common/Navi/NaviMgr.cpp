@@ -1,10 +1,18 @@
 #include "NaviMgr.h"
 #include <Navi/NaviProvider.h>
+#include <Navi/PathJobPool.h>
 #include <Service.h>
 #include <filesystem>
 
 using namespace Sapphire;
 
+Common::Navi::NaviMgr::NaviMgr( const std::string& naviPath, uint32_t pathWorkers ) :
+  m_naviPath( naviPath )
+{
+  if( pathWorkers > 0 )
+    m_pJobPool = std::make_shared< PathJobPool >( pathWorkers );
+}
+
 bool Common::Navi::NaviMgr::setupTerritory( const std::string& bgPath, uint32_t guid )
 {
   std::string bg = getBgName( bgPath );
@@ -13,7 +21,7 @@ bool Common::Navi::NaviMgr::setupTerritory( const std::string& bgPath, uint32_t
   if( m_naviProviderTerritoryMap.find( guid ) != m_naviProviderTerritoryMap.end() )
     return true;
 
-  auto provider = std::make_shared< Common::Navi::NaviProvider >( bg );
+  auto provider = std::make_shared< Common::Navi::NaviProvider >( bg, m_pJobPool );
 
   if( provider->init( m_naviPath ) )
   {
@@ -5,16 +5,19 @@
 #include <string>
 #include <unordered_map>
 #include <cstdint>
+#include <memory>
 
 namespace Sapphire::Common::Navi
 {
+  class PathJobPool;
+
   class NaviMgr
   {
   public:
-    NaviMgr( const std::string& naviPath ) : m_naviPath( naviPath )
-    {
-
-    };
+    /*!
+     * @param pathWorkers threads running requested path searches, with 0 they are searched on the calling thread
+     */
+    NaviMgr( const std::string& naviPath, uint32_t pathWorkers = 0 );
 
     virtual ~NaviMgr() = default;
 
@@ -24,6 +27,9 @@ namespace Sapphire::Common::Navi
   private:
     std::string getBgName( const std::string& bgPath );
 
+    // shared with every provider, null when path searches run on the calling thread
+    std::shared_ptr< PathJobPool > m_pJobPool;
+
     std::unordered_map< uint32_t, NaviProviderPtr > m_naviProviderTerritoryMap;
 
     std::string m_naviPath;
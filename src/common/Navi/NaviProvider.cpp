@@ -5,24 +5,49 @@
 
 #include "NavMeshCacheIO.h"
 #include "NaviProvider.h"
+#include "PathJobPool.h"
 
 #include <recastnavigation/Detour/Include/DetourNavMesh.h>
 #include <recastnavigation/Detour/Include/DetourNavMeshQuery.h>
 #include <DetourCommon.h>
 #include <recastnavigation/Recast/Include/Recast.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <thread>
 #include <Service.h>
 
-Sapphire::Common::Navi::NaviProvider::NaviProvider( const std::string& internalName ) :
+Sapphire::Common::Navi::NaviProvider::NaviProvider( const std::string& internalName, std::shared_ptr< PathJobPool > pJobPool ) :
   m_naviMesh( nullptr ),
   m_naviMeshQuery( nullptr ),
-  m_internalName( internalName )
+  m_internalName( internalName ),
+  m_pJobPool( std::move( pJobPool ) )
 {
   // Set defaults
   m_polyFindRange[ 0 ] = 20;
   m_polyFindRange[ 1 ] = 20;
   m_polyFindRange[ 2 ] = 20;
+
+  m_pathFilter.setIncludeFlags( 0xffff );
+  m_pathFilter.setExcludeFlags( 0 );
+
+  if( m_pJobPool )
+    m_workerQueries.resize( m_pJobPool->getWorkerCount(), nullptr );
+}
+
+Sapphire::Common::Navi::NaviProvider::~NaviProvider()
+{
+  // workers still searching reference this provider
+  {
+    std::unique_lock< std::mutex > lock( m_pathResultMutex );
+    m_pathJobsDone.wait( lock, [ this ] { return m_pathJobsInFlight == 0; } );
+  }
+
+  for( auto pQuery : m_workerQueries )
+  {
+    if( pQuery )
+      dtFreeNavMeshQuery( pQuery );
+  }
 }
 
 bool Sapphire::Common::Navi::NaviProvider::init( const std::string& naviPath )
@@ -38,44 +63,9 @@ bool Sapphire::Common::Navi::NaviProvider::init( const std::string& naviPath )
     if( !loadMesh( baseMesh.string() ) )
       return false;
 
-    m_pCrowd = std::make_unique< dtCrowd >();
-
-    if( !m_pCrowd->init( 1000, 10.f, m_naviMesh ) )
+    if( !initCrowd( INITIAL_CROWD_CAPACITY ) )
       return false;
 
-    dtObstacleAvoidanceParams params;
-    // Use mostly default settings, copy from dtCrowd.
-    memcpy(&params, m_pCrowd->getObstacleAvoidanceParams(0), sizeof(dtObstacleAvoidanceParams));
-
-    // Low (11)
-    params.velBias = 0.5f;
-    params.adaptiveDivs = 5;
-    params.adaptiveRings = 2;
-    params.adaptiveDepth = 1;
-    m_pCrowd->setObstacleAvoidanceParams(0, &params);
-
-    // Medium (22)
-    params.velBias = 0.5f;
-    params.adaptiveDivs = 5;
-    params.adaptiveRings = 2;
-    params.adaptiveDepth = 2;
-    m_pCrowd->setObstacleAvoidanceParams(1, &params);
-
-    // Good (45)
-    params.velBias = 0.5f;
-    params.adaptiveDivs = 7;
-    params.adaptiveRings = 2;
-    params.adaptiveDepth = 3;
-    m_pCrowd->setObstacleAvoidanceParams(2, &params);
-
-    // High (66)
-    params.velBias = 0.5f;
-    params.adaptiveDivs = 7;
-    params.adaptiveRings = 3;
-    params.adaptiveDepth = 3;
-
-    m_pCrowd->setObstacleAvoidanceParams(3, &params);
-
     m_vod = dtAllocObstacleAvoidanceDebugData();
     m_vod->init( 2048 );
 
@@ -87,6 +77,106 @@ bool Sapphire::Common::Navi::NaviProvider::init( const std::string& naviPath )
   return false;
 }
 
+bool Sapphire::Common::Navi::NaviProvider::initCrowd( int32_t capacity )
+{
+  auto pCrowd = std::make_unique< dtCrowd >();
+
+  if( !pCrowd->init( capacity, 10.f, m_naviMesh ) )
+    return false;
+
+  dtObstacleAvoidanceParams params;
+  // Use mostly default settings, copy from dtCrowd.
+  memcpy(&params, pCrowd->getObstacleAvoidanceParams(0), sizeof(dtObstacleAvoidanceParams));
+
+  // Low (11)
+  params.velBias = 0.5f;
+  params.adaptiveDivs = 5;
+  params.adaptiveRings = 2;
+  params.adaptiveDepth = 1;
+  pCrowd->setObstacleAvoidanceParams(0, &params);
+
+  // Medium (22)
+  params.velBias = 0.5f;
+  params.adaptiveDivs = 5;
+  params.adaptiveRings = 2;
+  params.adaptiveDepth = 2;
+  pCrowd->setObstacleAvoidanceParams(1, &params);
+
+  // Good (45)
+  params.velBias = 0.5f;
+  params.adaptiveDivs = 7;
+  params.adaptiveRings = 2;
+  params.adaptiveDepth = 3;
+  pCrowd->setObstacleAvoidanceParams(2, &params);
+
+  // High (66)
+  params.velBias = 0.5f;
+  params.adaptiveDivs = 7;
+  params.adaptiveRings = 3;
+  params.adaptiveDepth = 3;
+
+  pCrowd->setObstacleAvoidanceParams(3, &params);
+
+  m_pCrowd = std::move( pCrowd );
+  m_crowdCapacity = capacity;
+
+  return true;
+}
+
+bool Sapphire::Common::Navi::NaviProvider::growCrowd()
+{
+  if( m_crowdCapacity >= MAX_CROWD_CAPACITY )
+    return false;
+
+  auto pOldCrowd = std::move( m_pCrowd );
+  auto oldCapacity = m_crowdCapacity;
+
+  if( !initCrowd( std::min( m_crowdCapacity * 2, MAX_CROWD_CAPACITY ) ) )
+  {
+    m_pCrowd = std::move( pOldCrowd );
+    m_crowdCapacity = oldCapacity;
+    return false;
+  }
+
+  // move every agent over, ids handed out stay the same
+  for( size_t id = 0; id < m_agentSlots.size(); ++id )
+  {
+    auto& index = m_agentSlots[ id ];
+    if( index == -1 )
+      continue;
+
+    auto ag = pOldCrowd->getAgent( index );
+    index = m_pCrowd->addAgent( ag->npos, &ag->params );
+
+    if( index == -1 )
+    {
+      m_freeAgentIds.push_back( static_cast< int32_t >( id ) );
+      --m_agentCount;
+      continue;
+    }
+
+    if( ag->targetRef != 0 && ag->targetState != DT_CROWDAGENT_TARGET_NONE )
+      m_pCrowd->requestMoveTarget( index, ag->targetRef, ag->targetPos );
+  }
+
+  Logger::debug( "[{}] Crowd grown from {} to {} agents", m_internalName, oldCapacity, m_crowdCapacity );
+
+  return true;
+}
+
+int32_t Sapphire::Common::Navi::NaviProvider::getCrowdIndex( int32_t naviAgentId ) const
+{
+  if( naviAgentId < 0 || naviAgentId >= static_cast< int32_t >( m_agentSlots.size() ) )
+    return -1;
+
+  return m_agentSlots[ naviAgentId ];
+}
+
+int32_t Sapphire::Common::Navi::NaviProvider::getAgentCount() const
+{
+  return m_agentCount;
+}
+
 bool Sapphire::Common::Navi::NaviProvider::hasNaviMesh() const
 {
   return m_naviMesh != nullptr;
@@ -279,7 +369,7 @@ Sapphire::Common::Vector3
   dtPolyRef startRef;
   dtPolyRef randomRef;
 
-  status = m_naviMeshQuery->findNearestPoly( spos, polyPickExt, &filter, &startRef, snearest );
+  status = findNearestPoly( m_naviMeshQuery, spos, polyPickExt, &filter, &startRef, snearest );
 
   if( dtStatusFailed( status ) )
   {
@@ -325,7 +415,7 @@ Sapphire::Common::Vector3
 
   dtPolyRef startRef;
 
-  status = m_naviMeshQuery->findNearestPoly( spos, polyPickExt, &filter, &startRef, snearest );
+  status = findNearestPoly( m_naviMeshQuery, spos, polyPickExt, &filter, &startRef, snearest );
 
   if( dtStatusFailed( status ) )
   {
@@ -334,7 +424,7 @@ Sapphire::Common::Vector3
     polyPickExt[ 1 ] = 500.0f;
     polyPickExt[ 2 ] = 0.1f;
 
-    status = m_naviMeshQuery->findNearestPoly( spos, polyPickExt, &filter, &startRef, snearest );
+    status = findNearestPoly( m_naviMeshQuery, spos, polyPickExt, &filter, &startRef, snearest );
 
     if( dtStatusFailed( status ) )
     {
@@ -355,170 +445,321 @@ std::vector< Sapphire::Common::Vector3 >
   Sapphire::Common::Navi::NaviProvider::findFollowPath( const Common::Vector3& startPos,
                                                        const Common::Vector3& endPos )
 {
+  // no mesh means no path, same as when no poly is found
   if( !m_naviMesh || !m_naviMeshQuery )
-    throw std::runtime_error( "No navimesh loaded" );
-
-  auto resultCoords = std::vector< Common::Vector3 >();
+    return {};
 
-  dtPolyRef startRef, endRef = 0;
+  dtPolyRef startRef = 0, endRef = 0;
 
   float spos[ 3 ] = { startPos.x, startPos.y, startPos.z };
   float epos[ 3 ] = { endPos.x, endPos.y, endPos.z };
 
-  dtQueryFilter filter;
-  filter.setIncludeFlags( 0xffff );
-  filter.setExcludeFlags( 0 );
-
-  m_naviMeshQuery->findNearestPoly( spos, m_polyFindRange, &filter, &startRef, 0 );
-  m_naviMeshQuery->findNearestPoly( epos, m_polyFindRange, &filter, &endRef, 0 );
+  findNearestPoly( m_naviMeshQuery, spos, m_polyFindRange, &m_pathFilter, &startRef, nullptr );
+  findNearestPoly( m_naviMeshQuery, epos, m_polyFindRange, &m_pathFilter, &endRef, nullptr );
 
   // Couldn't find any close polys to navigate from
   if( !startRef || !endRef )
-    return resultCoords;
+    return {};
+
+  std::vector< Common::Vector3 > path;
+  if( m_queryCache.getPath( startRef, endRef, spos, epos, path ) )
+    return path;
 
   dtPolyRef polys[ MAX_POLYS ];
   int32_t numPolys = 0;
 
-  m_naviMeshQuery->findPath( startRef, endRef, spos, epos, &filter, polys, &numPolys, MAX_POLYS );
+  m_naviMeshQuery->findPath( startRef, endRef, spos, epos, &m_pathFilter, polys, &numPolys, MAX_POLYS );
 
-  // Check if we got polys back for navigation
-  if( numPolys )
+  path = buildSmoothPath( m_naviMeshQuery, startRef, spos, epos, polys, numPolys );
+  m_queryCache.putPath( startRef, endRef, spos, epos, path );
+
+  return path;
+}
+
+dtStatus Sapphire::Common::Navi::NaviProvider::findNearestPoly( dtNavMeshQuery* navQuery, const float* pos, const float* halfExtents,
+                                                               const dtQueryFilter* filter, dtPolyRef* nearestRef, float* nearestPt )
+{
+  NaviQueryCache::NearestPoly nearest;
+  const auto includeFlags = filter->getIncludeFlags();
+  const auto excludeFlags = filter->getExcludeFlags();
+  if( m_queryCache.getNearestPoly( pos, halfExtents, includeFlags, excludeFlags, nearest ) )
   {
-    // Iterate over the path to find smooth path on the detail mesh surface.
-    memcpy( polys, polys, sizeof( dtPolyRef )*numPolys );
-    int32_t npolys = numPolys;
+    *nearestRef = nearest.ref;
+    if( nearestPt )
+      dtVcopy( nearestPt, nearest.pos );
+    return DT_SUCCESS;
+  }
 
-    float iterPos[3], targetPos[3];
-    m_naviMeshQuery->closestPointOnPoly( startRef, spos, iterPos, 0 );
-    m_naviMeshQuery->closestPointOnPoly( polys[ npolys - 1 ], epos, targetPos, 0 );
+  nearest.ref = 0;
+  auto status = navQuery->findNearestPoly( pos, halfExtents, filter, &nearest.ref, nearest.pos );
+  *nearestRef = nearest.ref;
+  if( nearestPt )
+    dtVcopy( nearestPt, nearest.pos );
 
-    //Logger::debug( "IterPos: {0} {1} {2}; TargetPos: {3} {4} {5}",
-    //               iterPos[ 0 ], iterPos[ 1 ], iterPos[ 2 ],
-    //               targetPos[ 0 ], targetPos[ 1 ], targetPos[ 2 ] );
+  // misses are not remembered, the point may end up on a tile that is not built yet
+  if( dtStatusSucceed( status ) && nearest.ref )
+    m_queryCache.putNearestPoly( pos, halfExtents, includeFlags, excludeFlags, nearest );
 
-    // todo: adjust these for the actor radius
-    const float STEP_SIZE = 0.5f;
-    const float SLOP = 0.15f;
+  return status;
+}
 
-    int32_t numSmoothPath = 0;
-    float smoothPath[ MAX_SMOOTH * 3 ];
+std::vector< Sapphire::Common::Vector3 >
+  Sapphire::Common::Navi::NaviProvider::buildSmoothPath( dtNavMeshQuery* navQuery, dtPolyRef startRef, const float* spos,
+                                                        const float* epos, dtPolyRef* polys, int32_t numPolys )
+{
+  auto resultCoords = std::vector< Common::Vector3 >();
 
-    dtVcopy( &smoothPath[ numSmoothPath * 3 ], iterPos );
-    numSmoothPath++;
+  // Check if we got polys back for navigation
+  if( !numPolys )
+    return resultCoords;
 
-    // Move towards target a small advancement at a time until target reached or
-    // when ran out of memory to store the path.
-    while( npolys && numSmoothPath < MAX_SMOOTH )
-    {
-      // Find location to steer towards.
-      float steerPos[ 3 ];
-      uint8_t steerPosFlag;
-      dtPolyRef steerPosRef;
+  // Iterate over the path to find smooth path on the detail mesh surface.
+  int32_t npolys = numPolys;
 
-      if( !getSteerTarget( m_naviMeshQuery, iterPos, targetPos, SLOP,
-                           polys, npolys, steerPos, steerPosFlag, steerPosRef ) )
-        break;
+  float iterPos[3], targetPos[3];
+  navQuery->closestPointOnPoly( startRef, spos, iterPos, 0 );
+  navQuery->closestPointOnPoly( polys[ npolys - 1 ], epos, targetPos, 0 );
+
+  //Logger::debug( "IterPos: {0} {1} {2}; TargetPos: {3} {4} {5}",
+  //               iterPos[ 0 ], iterPos[ 1 ], iterPos[ 2 ],
+  //               targetPos[ 0 ], targetPos[ 1 ], targetPos[ 2 ] );
+
+  // todo: adjust these for the actor radius
+  const float STEP_SIZE = 0.5f;
+  const float SLOP = 0.15f;
+
+  int32_t numSmoothPath = 0;
+  float smoothPath[ MAX_SMOOTH * 3 ];
+
+  dtVcopy( &smoothPath[ numSmoothPath * 3 ], iterPos );
+  numSmoothPath++;
+
+  // Move towards target a small advancement at a time until target reached or
+  // when ran out of memory to store the path.
+  while( npolys && numSmoothPath < MAX_SMOOTH )
+  {
+    // Find location to steer towards.
+    float steerPos[ 3 ];
+    uint8_t steerPosFlag;
+    dtPolyRef steerPosRef;
+
+    if( !getSteerTarget( navQuery, iterPos, targetPos, SLOP,
+                         polys, npolys, steerPos, steerPosFlag, steerPosRef ) )
+      break;
+
+    bool endOfPath = ( steerPosFlag & DT_STRAIGHTPATH_END ) ? true : false;
+    bool offMeshConnection = ( steerPosFlag & DT_STRAIGHTPATH_OFFMESH_CONNECTION ) ? true : false;
 
-      bool endOfPath = ( steerPosFlag & DT_STRAIGHTPATH_END ) ? true : false;
-      bool offMeshConnection = ( steerPosFlag & DT_STRAIGHTPATH_OFFMESH_CONNECTION ) ? true : false;
-
-      // Find movement delta.
-      float delta[ 3 ], len;
-      dtVsub( delta, steerPos, iterPos );
-      len = dtMathSqrtf( dtVdot( delta, delta ) );
-      // If the steer target is end of path or off-mesh link, do not move past the location.
-      if( ( endOfPath || offMeshConnection ) && len < STEP_SIZE )
-        len = 1;
-      else
-        len = STEP_SIZE / len;
-      float moveTgt[ 3 ];
-      dtVmad( moveTgt, iterPos, delta, len );
-
-      // Move
-      float result[ 3 ];
-      dtPolyRef visited[ 16 ];
-      int32_t nvisited = 0;
-      m_naviMeshQuery->moveAlongSurface( polys[ 0 ], iterPos, moveTgt, &filter,
-                                         result, visited, &nvisited, 16 );
-
-      npolys = fixupCorridor( polys, npolys, MAX_POLYS, visited, nvisited );
-      npolys = fixupShortcuts( polys, npolys, m_naviMeshQuery );
-
-      float h = 0;
-      m_naviMeshQuery->getPolyHeight( polys[0], result, &h );
-      result[ 1 ] = h;
-      dtVcopy( iterPos, result );
-
-      // Handle end of path and off-mesh links when close enough.
-      if( endOfPath && inRange( iterPos, steerPos, SLOP, 1.0f ) )
+    // Find movement delta.
+    float delta[ 3 ], len;
+    dtVsub( delta, steerPos, iterPos );
+    len = dtMathSqrtf( dtVdot( delta, delta ) );
+    // If the steer target is end of path or off-mesh link, do not move past the location.
+    if( ( endOfPath || offMeshConnection ) && len < STEP_SIZE )
+      len = 1;
+    else
+      len = STEP_SIZE / len;
+    float moveTgt[ 3 ];
+    dtVmad( moveTgt, iterPos, delta, len );
+
+    // Move
+    float result[ 3 ];
+    dtPolyRef visited[ 16 ];
+    int32_t nvisited = 0;
+    navQuery->moveAlongSurface( polys[ 0 ], iterPos, moveTgt, &m_pathFilter,
+                                result, visited, &nvisited, 16 );
+
+    npolys = fixupCorridor( polys, npolys, MAX_POLYS, visited, nvisited );
+    npolys = fixupShortcuts( polys, npolys, navQuery );
+
+    float h = 0;
+    navQuery->getPolyHeight( polys[0], result, &h );
+    result[ 1 ] = h;
+    dtVcopy( iterPos, result );
+
+    // Handle end of path and off-mesh links when close enough.
+    if( endOfPath && inRange( iterPos, steerPos, SLOP, 1.0f ) )
+    {
+      // Reached end of path.
+      dtVcopy( iterPos, targetPos );
+      if( numSmoothPath < MAX_SMOOTH )
       {
-        // Reached end of path.
-        dtVcopy( iterPos, targetPos );
-        if( numSmoothPath < MAX_SMOOTH )
-        {
-          dtVcopy( &smoothPath[ numSmoothPath * 3 ], iterPos );
-          numSmoothPath++;
-        }
-        break;
+        dtVcopy( &smoothPath[ numSmoothPath * 3 ], iterPos );
+        numSmoothPath++;
       }
-      else if( offMeshConnection && inRange( iterPos, steerPos, SLOP, 1.0f ) )
-      {
-        // Reached off-mesh connection.
-        float startPos[ 3 ], endPos[ 3 ];
+      break;
+    }
+    else if( offMeshConnection && inRange( iterPos, steerPos, SLOP, 1.0f ) )
+    {
+      // Reached off-mesh connection.
+      float startPos[ 3 ], endPos[ 3 ];
 
-        // Advance the path up to and over the off-mesh connection.
-        dtPolyRef prevRef = 0, polyRef = polys[ 0 ];
-        int32_t npos = 0;
-        while( npos < npolys && polyRef != steerPosRef )
-        {
-          prevRef = polyRef;
-          polyRef = polys[ npos ];
-          npos++;
-        }
-        for( int32_t i = npos; i < npolys; ++i )
-          polys[ i - npos ] = polys[ i ];
-        npolys -= npos;
+      // Advance the path up to and over the off-mesh connection.
+      dtPolyRef prevRef = 0, polyRef = polys[ 0 ];
+      int32_t npos = 0;
+      while( npos < npolys && polyRef != steerPosRef )
+      {
+        prevRef = polyRef;
+        polyRef = polys[ npos ];
+        npos++;
+      }
+      for( int32_t i = npos; i < npolys; ++i )
+        polys[ i - npos ] = polys[ i ];
+      npolys -= npos;
 
-        // Handle the connection.
-        dtStatus status = m_naviMesh->getOffMeshConnectionPolyEndPoints( prevRef, polyRef, startPos, endPos );
-        if( dtStatusSucceed( status ) )
+      // Handle the connection.
+      dtStatus status = m_naviMesh->getOffMeshConnectionPolyEndPoints( prevRef, polyRef, startPos, endPos );
+      if( dtStatusSucceed( status ) )
+      {
+        if( numSmoothPath < MAX_SMOOTH )
         {
-          if( numSmoothPath < MAX_SMOOTH )
+          dtVcopy( &smoothPath[ numSmoothPath * 3 ], startPos );
+          numSmoothPath++;
+          // Hack to make the dotted path not visible during off-mesh connection.
+          if( numSmoothPath & 1 )
           {
             dtVcopy( &smoothPath[ numSmoothPath * 3 ], startPos );
             numSmoothPath++;
-            // Hack to make the dotted path not visible during off-mesh connection.
-            if( numSmoothPath & 1 )
-            {
-              dtVcopy( &smoothPath[ numSmoothPath * 3 ], startPos );
-              numSmoothPath++;
-            }
           }
-          // Move position at the other side of the off-mesh link.
-          dtVcopy( iterPos, endPos );
-          float eh = 0.0f;
-          m_naviMeshQuery->getPolyHeight( polys[ 0 ], iterPos, &eh );
-          iterPos[ 1 ] = eh;
         }
-      }
-
-      // Store results.
-      if( numSmoothPath < MAX_SMOOTH )
-      {
-        dtVcopy( &smoothPath[ numSmoothPath * 3 ], iterPos );
-        numSmoothPath++;
+        // Move position at the other side of the off-mesh link.
+        dtVcopy( iterPos, endPos );
+        float eh = 0.0f;
+        navQuery->getPolyHeight( polys[ 0 ], iterPos, &eh );
+        iterPos[ 1 ] = eh;
       }
     }
 
-    for( int32_t i = 0; i < numSmoothPath; i += 3 )
+    // Store results.
+    if( numSmoothPath < MAX_SMOOTH )
     {
-      resultCoords.emplace_back( Common::Vector3{ smoothPath[ i ], smoothPath[ i + 1 ], smoothPath[ i + 2 ] } );
+      dtVcopy( &smoothPath[ numSmoothPath * 3 ], iterPos );
+      numSmoothPath++;
     }
   }
 
+  for( int32_t i = 0; i < numSmoothPath; i += 3 )
+  {
+    resultCoords.emplace_back( Common::Vector3{ smoothPath[ i ], smoothPath[ i + 1 ], smoothPath[ i + 2 ] } );
+  }
+
   return resultCoords;
 }
 
+void Sapphire::Common::Navi::NaviProvider::requestFollowPath( const Common::Vector3& startPos, const Common::Vector3& endPos,
+                                                             PathCallback callback )
+{
+  {
+    std::lock_guard< std::mutex > lock( m_pathResultMutex );
+    ++m_pathJobsInFlight;
+  }
+
+  if( !m_pJobPool || !m_naviMesh )
+  {
+    finishPathJob( std::move( callback ), findFollowPath( startPos, endPos ) );
+    return;
+  }
+
+  m_pJobPool->push( [ this, startPos, endPos, callback = std::move( callback ) ]() mutable
+  {
+    finishPathJob( std::move( callback ), runPathJob( startPos, endPos ) );
+  } );
+}
+
+std::vector< Sapphire::Common::Vector3 >
+  Sapphire::Common::Navi::NaviProvider::runPathJob( const Common::Vector3& startPos, const Common::Vector3& endPos )
+{
+  auto& pQuery = m_workerQueries[ PathJobPool::getWorkerIndex() ];
+  if( !pQuery )
+  {
+    pQuery = dtAllocNavMeshQuery();
+    pQuery->init( m_naviMesh, 2048 );
+  }
+
+  float spos[ 3 ] = { startPos.x, startPos.y, startPos.z };
+  float epos[ 3 ] = { endPos.x, endPos.y, endPos.z };
+
+  dtPolyRef startRef = 0, endRef = 0;
+  uint32_t meshVersion = 0;
+  bool started = false;
+
+  // the lock is only held for one slice at a time so a tile cache update never waits for a whole search
+  while( true )
+  {
+    // step aside for a pending tile cache update, overlapping slices of several workers could starve it otherwise
+    while( m_meshUpdatePending.load( std::memory_order_acquire ) )
+      std::this_thread::yield();
+
+    std::shared_lock< std::shared_mutex > lock( m_meshMutex );
+
+    // tiles rebuilt since the last slice may have invalidated the refs of the search, start over on the new ones
+    if( !started || meshVersion != m_meshVersion )
+    {
+      started = true;
+      meshVersion = m_meshVersion;
+      startRef = endRef = 0;
+
+      findNearestPoly( pQuery, spos, m_polyFindRange, &m_pathFilter, &startRef, nullptr );
+      findNearestPoly( pQuery, epos, m_polyFindRange, &m_pathFilter, &endRef, nullptr );
+
+      if( !startRef || !endRef )
+        return {};
+
+      std::vector< Common::Vector3 > path;
+      if( m_queryCache.getPath( startRef, endRef, spos, epos, path ) )
+        return path;
+
+      if( dtStatusFailed( pQuery->initSlicedFindPath( startRef, endRef, spos, epos, &m_pathFilter ) ) )
+        return {};
+    }
+
+    auto status = pQuery->updateSlicedFindPath( PATH_SLICE_ITERATIONS, nullptr );
+    if( dtStatusInProgress( status ) )
+      continue;
+
+    dtPolyRef polys[ MAX_POLYS ];
+    int32_t numPolys = 0;
+
+    if( dtStatusFailed( status ) || dtStatusFailed( pQuery->finalizeSlicedFindPath( polys, &numPolys, MAX_POLYS ) ) )
+      return {};
+
+    // still under the lock, a tile cache update can not clear the cache between building and storing the path
+    auto path = buildSmoothPath( pQuery, startRef, spos, epos, polys, numPolys );
+    m_queryCache.putPath( startRef, endRef, spos, epos, path );
+
+    return path;
+  }
+}
+
+void Sapphire::Common::Navi::NaviProvider::finishPathJob( PathCallback callback, std::vector< Common::Vector3 > path )
+{
+  std::lock_guard< std::mutex > lock( m_pathResultMutex );
+  m_pathResults.push_back( { std::move( callback ), std::move( path ) } );
+  --m_pathJobsInFlight;
+
+  // notified under the lock, the destructor may otherwise be done before this returns
+  m_pathJobsDone.notify_all();
+}
+
+void Sapphire::Common::Navi::NaviProvider::dispatchPathResults()
+{
+  std::vector< PathResult > results;
+  {
+    std::lock_guard< std::mutex > lock( m_pathResultMutex );
+    if( m_pathResults.empty() )
+      return;
+
+    results.swap( m_pathResults );
+  }
+
+  // callbacks may request new paths, those arrive next update
+  for( auto& result : results )
+  {
+    if( result.callback )
+      result.callback( std::move( result.path ) );
+  }
+}
+
 bool Sapphire::Common::Navi::NaviProvider::loadMesh( const std::string& path )
 {
   std::ifstream fp( path, std::ios::binary );
@@ -675,7 +916,7 @@ bool Sapphire::Common::Navi::NaviProvider::loadMesh( const std::string& path )
   return true;
 }
 
-int32_t Sapphire::Common::Navi::NaviProvider::addAgent( const Common::Vector3& pos, float radius, float speed )
+dtCrowdAgentParams Sapphire::Common::Navi::NaviProvider::makeAgentParams( float radius, float speed )
 {
   dtCrowdAgentParams params{};
   std::memset( &params, 0, sizeof( params ) );
@@ -693,46 +934,93 @@ int32_t Sapphire::Common::Navi::NaviProvider::addAgent( const Common::Vector3& p
   params.separationWeight = 2.0f;
   params.obstacleAvoidanceType = 3;
 
+  return params;
+}
+
+int32_t Sapphire::Common::Navi::NaviProvider::addAgent( const Common::Vector3& pos, float radius, float speed )
+{
+  if( m_agentCount >= m_crowdCapacity && !growCrowd() )
+  {
+    Logger::warn( "[{}] Crowd is full ({} agents)", m_internalName, m_agentCount );
+    return -1;
+  }
+
+  auto params = makeAgentParams( radius, speed );
 
   float position[] = { pos.x, pos.y, pos.z };
-  return m_pCrowd->addAgent( position, &params );
+  auto index = m_pCrowd->addAgent( position, &params );
+  if( index == -1 )
+    return -1;
+
+  int32_t naviAgentId;
+  if( !m_freeAgentIds.empty() )
+  {
+    naviAgentId = m_freeAgentIds.back();
+    m_freeAgentIds.pop_back();
+    m_agentSlots[ naviAgentId ] = index;
+  }
+  else
+  {
+    naviAgentId = static_cast< int32_t >( m_agentSlots.size() );
+    m_agentSlots.push_back( index );
+  }
+
+  ++m_agentCount;
+  return naviAgentId;
 }
 
 void Sapphire::Common::Navi::NaviProvider::updateAgentParameters( int32_t naviAgentId, float radius, bool isRunning, float speed )
 {
-  if( naviAgentId == -1 )
+  auto index = getCrowdIndex( naviAgentId );
+  if( index == -1 )
     return;
-  dtCrowdAgentParams params{};
-  std::memset( &params, 0, sizeof( params ) );
-  params.height = 3.f;
-  params.maxAcceleration = 40.f;
-  params.maxSpeed = speed;
-  params.radius = radius;
-  params.collisionQueryRange = speed * 0.5f;
-  params.pathOptimizationRange = speed * 3.0f;
-  params.updateFlags = 0;
-  params.updateFlags |= DT_CROWD_ANTICIPATE_TURNS |
-                    DT_CROWD_OPTIMIZE_VIS |
-                    DT_CROWD_OPTIMIZE_TOPO |
-                    DT_CROWD_OBSTACLE_AVOIDANCE;
-  params.separationWeight = 2.0f;
-  params.obstacleAvoidanceType = 3;
-  m_pCrowd->updateAgentParameters( naviAgentId, &params );
+
+  auto params = makeAgentParams( radius, speed );
+  m_pCrowd->updateAgentParameters( index, &params );
 }
 
 void Sapphire::Common::Navi::NaviProvider::update( float timeInSeconds )
 {
+  if( m_tileCacheDirty )
+  {
+    m_meshUpdatePending.store( true, std::memory_order_release );
+    {
+      std::unique_lock< std::shared_mutex > lock( m_meshMutex );
+
+      bool upToDate = false;
+      m_tileCache->update( timeInSeconds, m_naviMesh, &upToDate );
+      m_tileCacheDirty = !upToDate;
+      ++m_meshVersion;
+
+      // rebuilt tiles hand out new refs
+      m_queryCache.clear();
+    }
+    m_meshUpdatePending.store( false, std::memory_order_release );
+  }
+
+  dispatchPathResults();
+
+  // nothing to move
+  if( m_agentCount == 0 )
+    return;
+
   dtCrowdAgentDebugInfo info{};
   info.idx = -1;
   info.vod = m_vod;
 
-  m_tileCache->update( timeInSeconds, m_naviMesh );
   m_pCrowd->update( timeInSeconds, &info );
 }
 
 void Sapphire::Common::Navi::NaviProvider::removeAgent( int32_t naviAgentId )
 {
-  m_pCrowd->removeAgent( naviAgentId );
+  auto index = getCrowdIndex( naviAgentId );
+  if( index == -1 )
+    return;
+
+  m_pCrowd->removeAgent( index );
+  m_agentSlots[ naviAgentId ] = -1;
+  m_freeAgentIds.push_back( naviAgentId );
+  --m_agentCount;
 }
 
 void Sapphire::Common::Navi::NaviProvider::calcVel( float* vel, const float* pos, const float* tgt, const float speed )
@@ -745,7 +1033,11 @@ void Sapphire::Common::Navi::NaviProvider::calcVel( float* vel, const float* pos
 
 void Sapphire::Common::Navi::NaviProvider::resetMoveTarget( int32_t naviAgentId )
 {
-  m_pCrowd->resetMoveTarget( naviAgentId );
+  auto index = getCrowdIndex( naviAgentId );
+  if( index == -1 )
+    return;
+
+  m_pCrowd->resetMoveTarget( index );
 }
 
 void Sapphire::Common::Navi::NaviProvider::setMoveTarget( int32_t naviAgentId,
@@ -761,7 +1053,7 @@ void Sapphire::Common::Navi::NaviProvider::setMoveTarget( int32_t naviAgentId,
 
   dtPolyRef ref;
 
-  auto status = m_naviMeshQuery->findNearestPoly( p, halfExtents, filter, &ref, nullptr );
+  auto status = findNearestPoly( m_naviMeshQuery, p, halfExtents, filter, &ref, nullptr );
 
   if( !dtStatusSucceed( status ) )
   {
@@ -771,16 +1063,30 @@ void Sapphire::Common::Navi::NaviProvider::setMoveTarget( int32_t naviAgentId,
     return;
   }
 
-  const dtCrowdAgent* ag = m_pCrowd->getAgent( naviAgentId );
-  if( ag && ag->active )
+  auto index = getCrowdIndex( naviAgentId );
+  if( index == -1 )
+    return;
+
+  const dtCrowdAgent* ag = m_pCrowd->getAgent( index );
+  if( !ag || !ag->active )
+    return;
+
+  // roaming states set their target every tick, only a new target is worth a new crowd path request
+  if( ag->targetRef == ref && ag->targetState != DT_CROWDAGENT_TARGET_NONE && ag->targetState != DT_CROWDAGENT_TARGET_FAILED )
   {
-    m_pCrowd->requestMoveTarget( naviAgentId, ref, p );
+    const float dx = ag->targetPos[ 0 ] - p[ 0 ];
+    const float dy = ag->targetPos[ 1 ] - p[ 1 ];
+    const float dz = ag->targetPos[ 2 ] - p[ 2 ];
+    if( dx * dx + dy * dy + dz * dz < 0.01f )
+      return;
   }
+
+  m_pCrowd->requestMoveTarget( index, ref, p );
 }
 
 Sapphire::Common::Vector3 Sapphire::Common::Navi::NaviProvider::getAgentPos( int32_t naviAgentId )
 {
-  const dtCrowdAgent* ag = m_pCrowd->getAgent( naviAgentId );
+  const dtCrowdAgent* ag = m_pCrowd->getAgent( getCrowdIndex( naviAgentId ) );
   if( !ag )
     return { 0.f, 0.f, 0.f };
   return { ag->npos[ 0 ], ag->npos[ 1 ], ag->npos[ 2 ] };
@@ -788,7 +1094,7 @@ Sapphire::Common::Vector3 Sapphire::Common::Navi::NaviProvider::getAgentPos( int
 
 float Sapphire::Common::Navi::NaviProvider::getAgentSpeed( int32_t naviAgentId )
 {
-  const dtCrowdAgent* ag = m_pCrowd->getAgent( naviAgentId );
+  const dtCrowdAgent* ag = m_pCrowd->getAgent( getCrowdIndex( naviAgentId ) );
   if( !ag )
     return 0.f;
 
@@ -803,15 +1109,15 @@ float Sapphire::Common::Navi::NaviProvider::getAgentSpeed( int32_t naviAgentId )
 
 bool Sapphire::Common::Navi::NaviProvider::isAgentActive( int32_t naviAgentId ) const
 {
-  const dtCrowdAgent* ag = m_pCrowd->getAgent( naviAgentId );
+  const dtCrowdAgent* ag = m_pCrowd->getAgent( getCrowdIndex( naviAgentId ) );
   return ag && ag->active;
 
 }
 
 bool Sapphire::Common::Navi::NaviProvider::hasTargetState( int32_t naviAgentId ) const
 {
-  const dtCrowdAgent* ag = m_pCrowd->getAgent( naviAgentId );
-  return ag->targetState != DT_CROWDAGENT_TARGET_NONE;
+  const dtCrowdAgent* ag = m_pCrowd->getAgent( getCrowdIndex( naviAgentId ) );
+  return ag && ag->targetState != DT_CROWDAGENT_TARGET_NONE;
 }
 
 int32_t Sapphire::Common::Navi::NaviProvider::updateAgentPosition( int32_t naviAgentId, const Common::Vector3& pos, float radius, float speed )
@@ -824,7 +1130,7 @@ int32_t Sapphire::Common::Navi::NaviProvider::updateAgentPosition( int32_t naviA
 
 void Sapphire::Common::Navi::NaviProvider::addAgentUpdateFlag( int32_t naviAgentId, uint8_t flags )
 {
-  auto ag = m_pCrowd->getEditableAgent( naviAgentId );
+  auto ag = m_pCrowd->getEditableAgent( getCrowdIndex( naviAgentId ) );
 
   if( !ag )
     return;
@@ -834,7 +1140,7 @@ void Sapphire::Common::Navi::NaviProvider::addAgentUpdateFlag( int32_t naviAgent
 
 void Sapphire::Common::Navi::NaviProvider::removeAgentUpdateFlag( int32_t naviAgentId, uint8_t flags )
 {
-  auto ag = m_pCrowd->getEditableAgent( naviAgentId );
+  auto ag = m_pCrowd->getEditableAgent( getCrowdIndex( naviAgentId ) );
 
   if( !ag )
     return;
@@ -853,6 +1159,7 @@ void Sapphire::Common::Navi::NaviProvider::toggleBox( dtObstacleRef& obstacleRef
   {
     m_tileCache->removeObstacle( obstacleRef );
     obstacleRef = 0;
+    m_tileCacheDirty = true;
   }
 
   if( enabled && obstacleRef == 0 )
@@ -861,6 +1168,8 @@ void Sapphire::Common::Navi::NaviProvider::toggleBox( dtObstacleRef& obstacleRef
     if( dtStatusFailed( status ) )
       Logger::error( "[Navmesh] addBoxObstacle failed (request queue full?) at X:{} Y:{} Z:{}",
                      pos.x, pos.y, pos.z );
+    else
+      m_tileCacheDirty = true;
   }
   else if( !enabled && obstacleRef != 0 )
   {
@@ -868,6 +1177,7 @@ void Sapphire::Common::Navi::NaviProvider::toggleBox( dtObstacleRef& obstacleRef
     m_tileCache->removeObstacle( obstacleRef );
     // RESET: Clear the handle so the system knows the door is "free"
     obstacleRef = 0;
+    m_tileCacheDirty = true;
   }
 }
 
@@ -879,6 +1189,7 @@ void Sapphire::Common::Navi::NaviProvider::toggleObstacle( dtObstacleRef& obstac
   {
     m_tileCache->removeObstacle( obstacleRef );
     obstacleRef = 0;
+    m_tileCacheDirty = true;
   }
 
   if( enabled && obstacleRef == 0 )
@@ -887,6 +1198,8 @@ void Sapphire::Common::Navi::NaviProvider::toggleObstacle( dtObstacleRef& obstac
     if( dtStatusFailed( status ) )
       Logger::error( "[Navmesh] addObstacle failed (request queue full?) at X:{} Y:{} Z:{}",
                      pos.x, pos.y, pos.z );
+    else
+      m_tileCacheDirty = true;
   }
   else if( !enabled && obstacleRef != 0 )
   {
@@ -894,6 +1207,7 @@ void Sapphire::Common::Navi::NaviProvider::toggleObstacle( dtObstacleRef& obstac
     m_tileCache->removeObstacle( obstacleRef );
     // RESET: Clear the handle so the system knows the door is "free"
     obstacleRef = 0;
+    m_tileCacheDirty = true;
   }
 }
 
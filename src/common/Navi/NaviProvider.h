@@ -11,11 +11,21 @@
 
 #include "FastLZ/fastlz.h"
 
+#include "NaviQueryCache.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+
 namespace Sapphire::Common::Navi
 {
   const int32_t MAX_POLYS = 32;
   const int32_t MAX_SMOOTH = 2048;
 
+  class PathJobPool;
+
   /** 1. Memory Allocator for Tile Cache **/
   struct LinearAllocator : public dtTileCacheAlloc {
     unsigned char* buffer;
@@ -92,11 +102,21 @@ namespace Sapphire::Common::Navi
     static const int EXPECTED_LAYERS_PER_TILE = 4;
     static const int MAX_LAYERS = 32;
 
+    // the crowd starts with this many agent slots and doubles when full, up to the maximum
+    static const int32_t INITIAL_CROWD_CAPACITY = 64;
+    static const int32_t MAX_CROWD_CAPACITY = 1024;
+
+    // astar iterations a path job runs before it lets go of the mesh, bounds how long a tile cache update can be held up
+    static const int32_t PATH_SLICE_ITERATIONS = 64;
+
     static const int TILECACHESET_MAGIC = 'T' << 24 | 'S' << 16 | 'E' << 8 | 'T';//'TSET';
     static const int TILECACHESET_VERSION = 1;
 
   public:
-    explicit NaviProvider( const std::string& internalName );
+    using PathCallback = std::function< void( std::vector< Common::Vector3 > ) >;
+
+    explicit NaviProvider( const std::string& internalName, std::shared_ptr< PathJobPool > pJobPool = nullptr );
+    ~NaviProvider();
 
     bool init( const std::string& naviPath );
     bool loadMesh( const std::string& path );
@@ -107,6 +127,14 @@ namespace Sapphire::Common::Navi
 
     std::vector< Common::Vector3 > findFollowPath( const Common::Vector3& startPos,
                                                               const Common::Vector3& endPos );
+
+    /*!
+     * @brief Searches a follow path on a path worker
+     *
+     * The callback is run from update() on the tick after the search finished, with an empty path if there is none.
+     * Without workers or a mesh the result still only arrives with the next update().
+     */
+    void requestFollowPath( const Common::Vector3& startPos, const Common::Vector3& endPos, PathCallback callback );
     Common::Vector3 findRandomPositionInCircle( const Common::Vector3& startPos,
                                                            float maxRadius );
 
@@ -118,6 +146,9 @@ namespace Sapphire::Common::Navi
 
     void removeAgent( int32_t naviAgentId );
 
+    // agents currently in the crowd
+    int32_t getAgentCount() const;
+
     void update( float timeInSeconds );
 
     static void calcVel( float* vel, const float* pos, const float* tgt, const float speed );
@@ -139,6 +170,7 @@ namespace Sapphire::Common::Navi
     void updateAgentParameters( int32_t naviAgentId, float radius, bool isRunning, float speed );
     const dtNavMesh* getNavMesh() const { return m_naviMesh; }
     const dtTileCache* getTileCache() const { return m_tileCache; }
+    const NaviQueryCache& getQueryCache() const { return m_queryCache; }
 
     std::string getNaviPath() const { return m_naviPath; }
 
@@ -163,7 +195,58 @@ namespace Sapphire::Common::Navi
 
     float m_polyFindRange[ 3 ];
 
+    // agent ids handed out are indices into this, they stay the same when the crowd is regrown. -1 for free ids
+    std::vector< int32_t > m_agentSlots;
+    std::vector< int32_t > m_freeAgentIds;
+    int32_t m_agentCount{ 0 };
+    int32_t m_crowdCapacity{ 0 };
+
+    // set when obstacles changed, the tile cache only needs updating until it has rebuilt the affected tiles
+    bool m_tileCacheDirty{ false };
+
+    std::shared_ptr< PathJobPool > m_pJobPool;
+    dtQueryFilter m_pathFilter;
+
+    // path workers read the mesh under a shared lock, tile cache updates take it exclusively
+    std::shared_mutex m_meshMutex;
+    std::atomic< bool > m_meshUpdatePending{ false };
+    // bumped with every tile cache update, searches in flight restart against the rebuilt tiles
+    uint32_t m_meshVersion{ 0 };
+
+    // nearest polys and paths, cleared whenever tiles are rebuilt
+    NaviQueryCache m_queryCache;
+
+    // one query per path worker, each is only ever touched by its own worker
+    std::vector< dtNavMeshQuery* > m_workerQueries;
+
+    struct PathResult
+    {
+      PathCallback callback;
+      std::vector< Common::Vector3 > path;
+    };
+
+    std::mutex m_pathResultMutex;
+    std::condition_variable m_pathJobsDone;
+    std::vector< PathResult > m_pathResults;
+    int32_t m_pathJobsInFlight{ 0 };
+
   private:
+    bool initCrowd( int32_t capacity );
+    bool growCrowd();
+    int32_t getCrowdIndex( int32_t naviAgentId ) const;
+    static dtCrowdAgentParams makeAgentParams( float radius, float speed );
+
+    // findNearestPoly going through the query cache
+    dtStatus findNearestPoly( dtNavMeshQuery* navQuery, const float* pos, const float* halfExtents, const dtQueryFilter* filter,
+                              dtPolyRef* nearestRef, float* nearestPt );
+
+    std::vector< Common::Vector3 > runPathJob( const Common::Vector3& startPos, const Common::Vector3& endPos );
+    void finishPathJob( PathCallback callback, std::vector< Common::Vector3 > path );
+    void dispatchPathResults();
+
+    std::vector< Common::Vector3 > buildSmoothPath( dtNavMeshQuery* navQuery, dtPolyRef startRef, const float* spos, const float* epos,
+                                                    dtPolyRef* polys, int32_t numPolys );
+
     int32_t fixupCorridor( dtPolyRef* path, int32_t npath, int32_t maxPath, const dtPolyRef* visited, int32_t nvisited );
     int32_t fixupShortcuts( dtPolyRef* path, int32_t npath, dtNavMeshQuery* navQuery );
     inline bool inRange( const float* v1, const float* v2, const float r, const float h );
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <Common.h>
+#include "recastnavigation/Detour/Include/DetourNavMesh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Sapphire::Common::Navi
+{
+  /*!
+   * @brief Fixed capacity map dropping the least recently used entry when full
+   */
+  template< typename Key, typename Value, typename Hash >
+  class LruCache
+  {
+  public:
+    explicit LruCache( size_t capacity ) :
+      m_capacity( capacity )
+    {
+      m_index.reserve( capacity );
+    }
+
+    bool get( const Key& key, Value& value )
+    {
+      auto it = m_index.find( key );
+      if( it == m_index.end() )
+        return false;
+
+      m_entries.splice( m_entries.begin(), m_entries, it->second );
+      value = it->second->second;
+      return true;
+    }
+
+    void put( const Key& key, Value value )
+    {
+      auto it = m_index.find( key );
+      if( it != m_index.end() )
+      {
+        it->second->second = std::move( value );
+        m_entries.splice( m_entries.begin(), m_entries, it->second );
+        return;
+      }
+
+      if( m_entries.size() >= m_capacity )
+      {
+        m_index.erase( m_entries.back().first );
+        m_entries.pop_back();
+      }
+
+      m_entries.emplace_front( key, std::move( value ) );
+      m_index.emplace( key, m_entries.begin() );
+    }
+
+    void clear()
+    {
+      m_entries.clear();
+      m_index.clear();
+    }
+
+    size_t size() const
+    {
+      return m_entries.size();
+    }
+
+  private:
+    using Entry = std::pair< Key, Value >;
+
+    size_t m_capacity;
+    std::list< Entry > m_entries;
+    std::unordered_map< Key, typename std::list< Entry >::iterator, Hash > m_index;
+  };
+
+  /*!
+   * @brief Nearest poly and follow path results of one navmesh
+   *
+   * Positions are snapped to a grid for the keys, so queries from the same spawn or path point hit the same entry.
+   * Refs are only valid for the tiles they were found on, the owner clears the cache whenever the tile cache rebuilt tiles.
+   * All methods lock, the cache is shared by the tick and the path workers.
+   */
+  class NaviQueryCache
+  {
+  public:
+    // grid nearest poly lookups are snapped to, in yalms
+    static constexpr float NEAREST_POLY_GRID = 0.5f;
+    // grid path start and end points are snapped to, in yalms
+    static constexpr float PATH_GRID = 1.f;
+
+    static const size_t NEAREST_POLY_CAPACITY = 1024;
+    static const size_t PATH_CAPACITY = 256;
+
+    struct NearestPoly
+    {
+      dtPolyRef ref;
+      float pos[ 3 ];
+    };
+
+    NaviQueryCache() :
+      m_nearestPolys( NEAREST_POLY_CAPACITY ),
+      m_paths( PATH_CAPACITY )
+    {
+    }
+
+    bool getNearestPoly( const float* pos, const float* halfExtents, uint16_t includeFlags, uint16_t excludeFlags,
+                         NearestPoly& result )
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      if( !m_nearestPolys.get( makePolyKey( pos, halfExtents, includeFlags, excludeFlags ), result ) )
+      {
+        ++m_misses;
+        return false;
+      }
+
+      ++m_hits;
+      return true;
+    }
+
+    void putNearestPoly( const float* pos, const float* halfExtents, uint16_t includeFlags, uint16_t excludeFlags,
+                         const NearestPoly& result )
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_nearestPolys.put( makePolyKey( pos, halfExtents, includeFlags, excludeFlags ), result );
+    }
+
+    bool getPath( dtPolyRef startRef, dtPolyRef endRef, const float* spos, const float* epos, std::vector< Common::Vector3 >& path )
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      if( !m_paths.get( makePathKey( startRef, endRef, spos, epos ), path ) )
+      {
+        ++m_misses;
+        return false;
+      }
+
+      ++m_hits;
+      return true;
+    }
+
+    void putPath( dtPolyRef startRef, dtPolyRef endRef, const float* spos, const float* epos, const std::vector< Common::Vector3 >& path )
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_paths.put( makePathKey( startRef, endRef, spos, epos ), path );
+    }
+
+    void clear()
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_nearestPolys.clear();
+      m_paths.clear();
+    }
+
+    uint64_t getHits() const
+    {
+      return m_hits;
+    }
+
+    uint64_t getMisses() const
+    {
+      return m_misses;
+    }
+
+  private:
+    struct PolyKey
+    {
+      int32_t pos[ 3 ];
+      int32_t extents[ 3 ];
+      // filters with different flags may pick different polys for the same point
+      uint16_t includeFlags;
+      uint16_t excludeFlags;
+
+      bool operator==( const PolyKey& other ) const
+      {
+        return std::equal( pos, pos + 3, other.pos ) && std::equal( extents, extents + 3, other.extents ) &&
+               includeFlags == other.includeFlags && excludeFlags == other.excludeFlags;
+      }
+    };
+
+    struct PathKey
+    {
+      dtPolyRef startRef;
+      dtPolyRef endRef;
+      int32_t start[ 3 ];
+      int32_t end[ 3 ];
+
+      bool operator==( const PathKey& other ) const
+      {
+        return startRef == other.startRef && endRef == other.endRef &&
+               std::equal( start, start + 3, other.start ) && std::equal( end, end + 3, other.end );
+      }
+    };
+
+    static size_t hashCombine( size_t seed, uint64_t value )
+    {
+      return seed ^ ( std::hash< uint64_t >()( value ) + 0x9e3779b97f4a7c15 + ( seed << 6 ) + ( seed >> 2 ) );
+    }
+
+    struct PolyKeyHash
+    {
+      size_t operator()( const PolyKey& key ) const
+      {
+        size_t seed = hashCombine( key.includeFlags, key.excludeFlags );
+        for( auto value : key.pos )
+          seed = hashCombine( seed, static_cast< uint32_t >( value ) );
+        for( auto value : key.extents )
+          seed = hashCombine( seed, static_cast< uint32_t >( value ) );
+        return seed;
+      }
+    };
+
+    struct PathKeyHash
+    {
+      size_t operator()( const PathKey& key ) const
+      {
+        size_t seed = hashCombine( key.startRef, key.endRef );
+        for( auto value : key.start )
+          seed = hashCombine( seed, static_cast< uint32_t >( value ) );
+        for( auto value : key.end )
+          seed = hashCombine( seed, static_cast< uint32_t >( value ) );
+        return seed;
+      }
+    };
+
+    static void snap( const float* pos, float grid, int32_t* out )
+    {
+      for( int32_t i = 0; i < 3; ++i )
+        out[ i ] = static_cast< int32_t >( std::floor( pos[ i ] / grid ) );
+    }
+
+    static PolyKey makePolyKey( const float* pos, const float* halfExtents, uint16_t includeFlags, uint16_t excludeFlags )
+    {
+      PolyKey key{};
+      key.includeFlags = includeFlags;
+      key.excludeFlags = excludeFlags;
+      snap( pos, NEAREST_POLY_GRID, key.pos );
+      snap( halfExtents, NEAREST_POLY_GRID, key.extents );
+      return key;
+    }
+
+    static PathKey makePathKey( dtPolyRef startRef, dtPolyRef endRef, const float* spos, const float* epos )
+    {
+      PathKey key{};
+      key.startRef = startRef;
+      key.endRef = endRef;
+      snap( spos, PATH_GRID, key.start );
+      snap( epos, PATH_GRID, key.end );
+      return key;
+    }
+
+    std::mutex m_mutex;
+    LruCache< PolyKey, NearestPoly, PolyKeyHash > m_nearestPolys;
+    LruCache< PathKey, std::vector< Common::Vector3 >, PathKeyHash > m_paths;
+
+    std::atomic< uint64_t > m_hits{ 0 };
+    std::atomic< uint64_t > m_misses{ 0 };
+  };
+
+}
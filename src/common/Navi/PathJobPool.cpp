@@ -0,0 +1,71 @@
+#include "PathJobPool.h"
+
+#include <algorithm>
+
+namespace
+{
+  thread_local int32_t s_workerIndex = -1;
+}
+
+Sapphire::Common::Navi::PathJobPool::PathJobPool( uint32_t workerCount )
+{
+  workerCount = std::max( 1u, workerCount );
+
+  m_workers.reserve( workerCount );
+  for( uint32_t i = 0; i < workerCount; ++i )
+    m_workers.emplace_back( &PathJobPool::workerThread, this, i );
+}
+
+Sapphire::Common::Navi::PathJobPool::~PathJobPool()
+{
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_shutdown = true;
+  }
+  m_condition.notify_all();
+
+  for( auto& worker : m_workers )
+    worker.join();
+}
+
+void Sapphire::Common::Navi::PathJobPool::push( Job job )
+{
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_jobs.push_back( std::move( job ) );
+  }
+  m_condition.notify_one();
+}
+
+uint32_t Sapphire::Common::Navi::PathJobPool::getWorkerCount() const
+{
+  return static_cast< uint32_t >( m_workers.size() );
+}
+
+int32_t Sapphire::Common::Navi::PathJobPool::getWorkerIndex()
+{
+  return s_workerIndex;
+}
+
+void Sapphire::Common::Navi::PathJobPool::workerThread( uint32_t index )
+{
+  s_workerIndex = static_cast< int32_t >( index );
+
+  while( true )
+  {
+    Job job;
+    {
+      std::unique_lock< std::mutex > lock( m_mutex );
+      m_condition.wait( lock, [ this ] { return m_shutdown || !m_jobs.empty(); } );
+
+      // jobs still queued at shutdown are finished first, their owners wait for them
+      if( m_jobs.empty() )
+        return;
+
+      job = std::move( m_jobs.front() );
+      m_jobs.pop_front();
+    }
+
+    job();
+  }
+}
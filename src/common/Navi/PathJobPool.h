@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Sapphire::Common::Navi
+{
+  /*!
+   * @brief Worker threads running path searches for every NaviProvider
+   *
+   * Workers are numbered, a provider keeps one dtNavMeshQuery per worker index so a query is never shared between threads.
+   */
+  class PathJobPool
+  {
+  public:
+    using Job = std::function< void() >;
+
+    explicit PathJobPool( uint32_t workerCount );
+    ~PathJobPool();
+
+    void push( Job job );
+
+    uint32_t getWorkerCount() const;
+
+    // index of the calling worker, -1 when not called from one of the workers
+    static int32_t getWorkerIndex();
+
+  private:
+    void workerThread( uint32_t index );
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque< Job > m_jobs;
+    bool m_shutdown{ false };
+
+    std::vector< std::thread > m_workers;
+
+    PathJobPool( PathJobPool const& ) = delete;
+    PathJobPool& operator=( PathJobPool const& ) = delete;
+  };
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 
@@ -95,11 +96,23 @@ namespace Sapphire::Network::Packets
       return {};
     }
 
+    /**
+    * @brief Writes the packet as sent, segment header first, to pDest
+    * @param pDest buffer of at least getSize() bytes
+    */
+    virtual void writeData( uint8_t* pDest ) const
+    {
+      auto data = getData();
+      memcpy( pDest, data.data(), std::min( data.size(), getSize() ) );
+    }
+
   protected:
     /** The segment header */
     FFXIVARR_PACKET_SEGMENT_HEADER m_segHdr;
     uint16_t m_segmentType;
     std::size_t m_alignedSize;
+    /** The source actor is filled in per connection, like the target */
+    bool m_sourceIsRecipient{ false };
 
   public:
     virtual size_t getContentSize()
@@ -182,6 +195,23 @@ namespace Sapphire::Network::Packets
       return m_segHdr.target_actor;
     };
 
+    /**
+    * @brief Marks the source actor as the recipient, used for packets shared between connections.
+    * @param sourceIsRecipient true to have each packet container set the source to its target.
+    */
+    void setSourceIsRecipient( bool sourceIsRecipient )
+    {
+      m_sourceIsRecipient = sourceIsRecipient;
+    };
+
+    /**
+    * @brief Gets whether the source actor is set to the recipient on send.
+    */
+    bool isSourceRecipient() const
+    {
+      return m_sourceIsRecipient;
+    };
+
     /** Initializes the fields of the segment header structure */
     virtual void initializeSegmentHeader( void )
     {
@@ -264,6 +294,23 @@ namespace Sapphire::Network::Packets
       return data;
     }
 
+    void writeData( uint8_t* pDest ) const override
+    {
+      auto segmentHeaderSize = sizeof( FFXIVARR_PACKET_SEGMENT_HEADER );
+      auto ipcHeaderSize = sizeof( FFXIVARR_IPC_HEADER );
+
+      // a segment header taken from a parsed packet may be shorter than the structure
+      if( getSize() < segmentHeaderSize + ipcHeaderSize + sizeof( m_data ) )
+      {
+        FFXIVPacketBase::writeData( pDest );
+        return;
+      }
+
+      memcpy( pDest, &m_segHdr, segmentHeaderSize );
+      memcpy( pDest + segmentHeaderSize, &m_ipcHdr, ipcHeaderSize );
+      memcpy( pDest + segmentHeaderSize + ipcHeaderSize, &m_data, sizeof( m_data ) );
+    }
+
     T1 ipcType() override
     {
       return static_cast< T1 >( m_data._ServerIpcType );
@@ -364,4 +411,41 @@ namespace Sapphire::Network::Packets
     std::vector< uint8_t > m_data;
   };
 
+  /**
+  * A packet serialized once, to be queued on many connections. The bytes are shared and never
+  * change, each container patches the segment header in its own send buffer only.
+  */
+  class FFXIVSharedPacket : public FFXIVPacketBase
+  {
+  public:
+    explicit FFXIVSharedPacket( const FFXIVPacketBase& packet ) :
+      FFXIVPacketBase( packet ),
+      m_pData( std::make_shared< const std::vector< uint8_t > >( packet.getData() ) )
+    {
+    }
+
+    size_t getContentSize() override
+    {
+      return m_pData->size() - sizeof( FFXIVARR_PACKET_SEGMENT_HEADER );
+    }
+
+    std::vector< uint8_t > getContent() override
+    {
+      return { m_pData->begin() + sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ), m_pData->end() };
+    }
+
+    std::vector< uint8_t > getData() const override
+    {
+      return *m_pData;
+    }
+
+    void writeData( uint8_t* pDest ) const override
+    {
+      memcpy( pDest, m_pData->data(), std::min( m_pData->size(), getSize() ) );
+    }
+
+  private:
+    std::shared_ptr< const std::vector< uint8_t > > m_pData;
+  };
+
 }
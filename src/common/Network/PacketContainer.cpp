@@ -32,8 +32,7 @@ void Network::Packets::PacketContainer::addPacket( Network::Packets::FFXIVPacket
 
 void Network::Packets::PacketContainer::fillSendBuffer( std::vector< uint8_t >& sendBuffer )
 {
-  std::vector< uint8_t > tempBuffer( m_ipcHdr.size, 0 );
-  memset( &tempBuffer[ 0 ], 0, m_ipcHdr.size );
+  sendBuffer.assign( m_ipcHdr.size, 0 );
 
   using namespace std::chrono;
   auto ms = duration_cast< milliseconds >( system_clock::now().time_since_epoch() );
@@ -50,28 +49,33 @@ void Network::Packets::PacketContainer::fillSendBuffer( std::vector< uint8_t >&
   {
     auto pPacket = ( *it );
 
-    if( m_segmentTargetOverride != 0 && pPacket->getSegmentType() == SEGMENTTYPE_IPC )
-    {
-      pPacket->setTargetActor( m_segmentTargetOverride );
-    }
-
-    // get aligned and original packet data size for offset and copy
+    // get aligned packet size for the offset
     auto packetAlignedSize = pPacket->getAlignedSize();
-    auto packetOriginalSize = pPacket->getSize();
+
+    // copy packet data into buffer
+    auto pSegment = &sendBuffer[ 0 ] + sizeof( FFXIVARR_PACKET_HEADER ) + offset;
+    pPacket->writeData( pSegment );
+
+    // the segment header is patched in the copy, the same packet may be queued on several connections at once
+    FFXIVARR_PACKET_SEGMENT_HEADER segHdr;
+    memcpy( &segHdr, pSegment, sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ) );
 
     // set packet size in seg header to aligned size
-    pPacket->setSize( packetAlignedSize );
+    segHdr.size = static_cast< uint32_t >( packetAlignedSize );
 
-    // copy packet data into buffer
-    auto data = pPacket->getData();
-    memcpy( &tempBuffer[ 0 ] + sizeof( FFXIVARR_PACKET_HEADER ) + offset, &data[ 0 ], packetOriginalSize );
+    if( m_segmentTargetOverride != 0 && segHdr.type == SEGMENTTYPE_IPC )
+    {
+      if( pPacket->isSourceRecipient() )
+        segHdr.source_actor = m_segmentTargetOverride;
+      segHdr.target_actor = m_segmentTargetOverride;
+    }
+
+    memcpy( pSegment, &segHdr, sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ) );
 
     offset += packetAlignedSize;
   }
 
-  memcpy( &tempBuffer[ 0 ], &m_ipcHdr, sizeof( FFXIVARR_PACKET_HEADER ) );
-
-  sendBuffer.assign( &tempBuffer[ 0 ], &tempBuffer[ 0 ] + m_ipcHdr.size );
+  memcpy( &sendBuffer[ 0 ], &m_ipcHdr, sizeof( FFXIVARR_PACKET_HEADER ) );
 }
 
 std::string Network::Packets::PacketContainer::toString()
@@ -11,6 +11,14 @@ namespace Sapphire::Network::Packets
 {
 
   using FFXIVPacketBasePtr = std::shared_ptr< FFXIVPacketBase >;
+
+  /*!
+   * @brief Packs queued packets into one send buffer
+   *
+   * With a segment target override every ipc segment is addressed to that id in the buffer,
+   * packets marked with setSourceIsRecipient get it as source too. Packets themselves are never
+   * modified, so one packet can be shared between many connections.
+   */
   class PacketContainer
   {
   public:
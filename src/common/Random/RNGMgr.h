@@ -3,6 +3,7 @@
 
 #include <array>
 #include <algorithm>
+#include <atomic>
 #include <random>
 #include <memory>
 #include <type_traits>
@@ -10,60 +11,62 @@
 
 #include <Logging/Logger.h>
 
+#include "Xoshiro256.h"
+
 namespace Sapphire::Common::Random
 {
+  class RNGMgr;
+
   /*!
    * @brief Generator object that is used on multiple state situations
+   *
+   * Only holds the range, values are drawn from the engine of the calling thread.
    */
   template< typename T, typename = typename std::enable_if< std::is_arithmetic< T >::value, T >::type >
   class RandGenerator
   {
   public:
-    RandGenerator( std::shared_ptr< std::mt19937 > pEngine, T minRange = std::numeric_limits< T >::min(), T maxRange = std::numeric_limits< T >::max() )
-      : m_engine( pEngine ), m_fpuDist( minRange, maxRange ), m_intDist( minRange, maxRange )
+    RandGenerator( RNGMgr& rngMgr, T minRange = std::numeric_limits< T >::min(), T maxRange = std::numeric_limits< T >::max() )
+      : m_rngMgr( rngMgr ), m_minRange( minRange ), m_maxRange( maxRange )
     {
 
     }
 
-    // returns a single value for T type on set ranges, deducing real or integer distribution from given numeric type
-    T next()
-    {
-      if constexpr( std::is_integral< T >::value )
-        return m_intDist( *m_engine );
+    // returns a single value for T type on set ranges, integers include maxRange, reals do not
+    T next();
 
-      return static_cast< T >( m_fpuDist( *m_engine ) );
-    }
-
-    // returns an array of size nSize with values type T on set ranges, deducing real or integer distribution from given numeric type
+    // returns an array of size nSize with values type T on set ranges
     template< std::size_t nSize >
     const std::array< T, nSize > nextCount()
     {
       std::array< T, nSize > _valPush;
-
-      for( auto i = 0; i < nSize; ++i )
-      {
-        if constexpr( std::is_integral< T >::value )
-          _valPush[ i ] = ( m_intDist( *m_engine ) );
-        else
-          _valPush[ i ] = ( m_fpuDist( *m_engine ) );
-      }
-
+      fill( _valPush.data(), nSize );
       return _valPush;
     }
 
+    // writes count values on set ranges to pOut
+    void fill( T* pOut, std::size_t count );
+
   protected:
-    std::uniform_real_distribution<> m_fpuDist;
-    std::uniform_int_distribution<> m_intDist;
-    std::shared_ptr< std::mt19937 > m_engine;
+    RNGMgr& m_rngMgr;
+    T m_minRange;
+    T m_maxRange;
   };
 
   class RNGMgr
   {
   public:
-    // Constructs a manager to supply states for random integer and float distribution using a Mersenne Twister engine
-    RNGMgr()
+    using Engine = Xoshiro256;
+
+    // Constructs a manager seeded from the random device, use setSeed for reproducible streams
+    RNGMgr() :
+      m_seed( engineSeed() )
+    {
+    }
+
+    explicit RNGMgr( uint64_t seed ) :
+      m_seed( seed )
     {
-      m_engine = std::make_shared< std::mt19937 >( *engineSeed< std::mt19937::state_size >() );
     }
 
     virtual ~RNGMgr() = default;
@@ -71,6 +74,33 @@ namespace Sapphire::Common::Random
     RNGMgr( const RNGMgr& pRNGMgr ) = delete;
     RNGMgr& operator=( const RNGMgr& pRNGMgr ) = delete;
 
+    /*!
+     * @brief Reseeds every stream, threads pick up a new stream on their next draw
+     * Streams are handed to threads in the order they first draw, so runs are only reproducible
+     * with the same thread layout. Use createEngine for streams that have to match exactly.
+     */
+    void setSeed( uint64_t seed )
+    {
+      m_seed = seed;
+      m_nextThreadStream = 0;
+      ++m_generation;
+    }
+
+    uint64_t getSeed() const
+    {
+      return m_seed;
+    }
+
+    /*!
+     * @brief Creates an engine for a fixed stream of the current seed, e.g. one per territory
+     * @param Id of the stream, the same seed and id always give the same values
+     * @return Engine owned by the caller
+     */
+    Engine createEngine( uint64_t streamId ) const
+    {
+      return Engine( Engine::mix( m_seed ^ Engine::mix( streamId ) ) );
+    }
+
     /*!
      * @brief Creates a state with specified parameters for multiple uses
      * @tparam Numeric type to be used for the generator
@@ -81,7 +111,7 @@ namespace Sapphire::Common::Random
     template< typename T, typename = typename std::enable_if< std::is_arithmetic< T >::value, T >::type >
     RandGenerator< T > getRandGenerator( T minRange, T maxRange )
     {
-      return RandGenerator< T >( m_engine, minRange, maxRange );
+      return RandGenerator< T >( *this, minRange, maxRange );
     }
 
     /*!
@@ -92,36 +122,94 @@ namespace Sapphire::Common::Random
     template< typename T, typename = typename std::enable_if< std::is_arithmetic< T >::value, T >::type >
     RandGenerator< T > getRandGenerator()
     {
-      return RandGenerator< T >( m_engine );
+      return RandGenerator< T >( *this );
     }
 
-    std::shared_ptr< std::mt19937 > getRNGEngine()
+    /*!
+     * @brief Engine of the calling thread, must not be handed to other threads
+     * Every thread gets its own stream on first use, so drawing never needs a lock.
+     */
+    Engine& getRNGEngine()
     {
-      return m_engine;
+      struct ThreadEngine
+      {
+        Engine engine;
+        const RNGMgr* pOwner{ nullptr };
+        uint32_t generation{ 0 };
+      };
+      thread_local ThreadEngine threadEngine;
+
+      const auto generation = m_generation.load( std::memory_order_relaxed );
+      if( threadEngine.pOwner != this || threadEngine.generation != generation )
+      {
+        threadEngine.engine = createEngine( ThreadStreamFlag | m_nextThreadStream++ );
+        threadEngine.pOwner = this;
+        threadEngine.generation = generation;
+      }
+
+      return threadEngine.engine;
     }
 
-  private:
+    /*!
+     * @brief Writes count random values to pOut, drawing from the thread engine once per call
+     * Meant for batches such as damage variance, critical / direct hit rolls or loot.
+     */
+    template< typename T, typename = typename std::enable_if< std::is_arithmetic< T >::value, T >::type >
+    void fill( T* pOut, std::size_t count, T minRange, T maxRange )
+    {
+      auto& engine = getRNGEngine();
+      for( std::size_t i = 0; i < count; ++i )
+        pOut[ i ] = sample( engine, minRange, maxRange );
+    }
 
-    template< std::size_t STATE_SIZE >
-    std::unique_ptr< std::seed_seq > engineSeed()
+    // single value in [ minRange, maxRange ] for integers and [ minRange, maxRange ) for reals
+    template< typename T, typename = typename std::enable_if< std::is_arithmetic< T >::value, T >::type >
+    static T sample( Engine& engine, T minRange, T maxRange )
     {
-      // initialize mt engine with manually seeded random_device
+      if constexpr( std::is_integral< T >::value )
+      {
+        if( maxRange <= minRange )
+          return minRange;
 
-      std::array< uint32_t, STATE_SIZE > seedArray;
-      std::random_device rd;
+        // wraps correctly for signed types as well
+        const auto span = static_cast< uint64_t >( maxRange ) - static_cast< uint64_t >( minRange );
+        if( span < std::numeric_limits< uint32_t >::max() )
+          return static_cast< T >( minRange + static_cast< T >( engine.nextBounded( static_cast< uint32_t >( span + 1 ) ) ) );
 
-      // check if kernel can supply sufficiently non-deterministic output
+        if( span == std::numeric_limits< uint64_t >::max() )
+          return static_cast< T >( engine() );
 
-      //if( rd.entropy() == 0.f )
-      //  Logger::error( "Kernel random device entropy reported zero - Random number generator may be poor quality" );
+        return static_cast< T >( static_cast< uint64_t >( minRange ) + engine() % ( span + 1 ) );
+      }
+      else
+        return static_cast< T >( minRange + ( maxRange - minRange ) * engine.nextDouble() );
+    }
 
-      std::generate_n( seedArray.data(), seedArray.size(), std::ref( rd ) );
-      auto pSeq = std::make_unique< std::seed_seq >( std::begin( seedArray ), std::end( seedArray ) );
+  private:
+    // thread streams never collide with the ids given to createEngine by callers
+    static constexpr uint64_t ThreadStreamFlag = uint64_t{ 1 } << 63;
 
-      return pSeq;
+    static uint64_t engineSeed()
+    {
+      std::random_device rd;
+      return ( static_cast< uint64_t >( rd() ) << 32 ) | rd();
     }
 
-    std::shared_ptr< std::mt19937 > m_engine;
+    std::atomic< uint64_t > m_seed;
+    std::atomic< uint64_t > m_nextThreadStream{ 0 };
+    std::atomic< uint32_t > m_generation{ 1 };
   };
 
+  template< typename T, typename U >
+  T RandGenerator< T, U >::next()
+  {
+    return RNGMgr::sample( m_rngMgr.getRNGEngine(), m_minRange, m_maxRange );
+  }
+
+  template< typename T, typename U >
+  void RandGenerator< T, U >::fill( T* pOut, std::size_t count )
+  {
+    m_rngMgr.fill( pOut, count, m_minRange, m_maxRange );
+  }
+
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace Sapphire::Common::Random
+{
+  /*!
+   * @brief xoshiro256** generator, 32 bytes of state and a few cycles per value
+   *
+   * Satisfies UniformRandomBitGenerator, so it works with std::shuffle and the std distributions.
+   * Seeding runs the seed through splitmix64 as recommended by the authors, so close seeds still give unrelated streams.
+   */
+  class Xoshiro256
+  {
+  public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256( uint64_t seed = 0 )
+    {
+      this->seed( seed );
+    }
+
+    void seed( uint64_t seed )
+    {
+      for( auto& word : m_state )
+        word = splitMix64( seed );
+    }
+
+    static constexpr result_type min()
+    {
+      return 0;
+    }
+
+    static constexpr result_type max()
+    {
+      return std::numeric_limits< result_type >::max();
+    }
+
+    result_type operator()()
+    {
+      const auto result = rotl( m_state[ 1 ] * 5, 7 ) * 9;
+      const auto t = m_state[ 1 ] << 17;
+
+      m_state[ 2 ] ^= m_state[ 0 ];
+      m_state[ 3 ] ^= m_state[ 1 ];
+      m_state[ 1 ] ^= m_state[ 2 ];
+      m_state[ 0 ] ^= m_state[ 3 ];
+
+      m_state[ 2 ] ^= t;
+      m_state[ 3 ] = rotl( m_state[ 3 ], 45 );
+
+      return result;
+    }
+
+    // upper half of the next value, the upper bits are the strongest
+    uint32_t next32()
+    {
+      return static_cast< uint32_t >( operator()() >> 32 );
+    }
+
+    // uniform in [ 0, 1 )
+    double nextDouble()
+    {
+      return static_cast< double >( operator()() >> 11 ) * ( 1.0 / 9007199254740992.0 );
+    }
+
+    // uniform in [ 0, range ), unbiased ( Lemire )
+    uint32_t nextBounded( uint32_t range )
+    {
+      auto product = static_cast< uint64_t >( next32() ) * range;
+      auto low = static_cast< uint32_t >( product );
+      if( low < range )
+      {
+        const auto threshold = static_cast< uint32_t >( -range ) % range;
+        while( low < threshold )
+        {
+          product = static_cast< uint64_t >( next32() ) * range;
+          low = static_cast< uint32_t >( product );
+        }
+      }
+      return static_cast< uint32_t >( product >> 32 );
+    }
+
+    // splitmix64 finalizer, spreads every input bit over the whole result
+    static uint64_t mix( uint64_t z )
+    {
+      z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9;
+      z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111eb;
+      return z ^ ( z >> 31 );
+    }
+
+  private:
+    static uint64_t rotl( uint64_t x, int k )
+    {
+      return ( x << k ) | ( x >> ( 64 - k ) );
+    }
+
+    static uint64_t splitMix64( uint64_t& x )
+    {
+      return mix( x += 0x9e3779b97f4a7c15 );
+    }
+
+    uint64_t m_state[ 4 ];
+  };
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Sapphire::Common::Util
+{
+
+  // Hash map split into independently locked shards. Lookups only take a shared lock on a single shard,
+  // so readers never wait on each other and a writer only holds up readers of the shard it modifies.
+  template< class K, class V, size_t ShardCount = 16 >
+  class ConcurrentMap
+  {
+  public:
+    // returns a copy of the value, or a default constructed V if the key is unknown
+    V find( const K& key ) const;
+
+    bool contains( const K& key ) const;
+
+    // inserts the value, replacing an existing one
+    void set( const K& key, V value );
+
+    // inserts the value only if the key is unknown, returns false otherwise
+    bool insert( const K& key, V value );
+
+    bool erase( const K& key );
+
+    void clear();
+
+    std::size_t size() const;
+
+    // copy of every value, shards are visited one after another so this is not an atomic snapshot
+    std::vector< V > values() const;
+
+  private:
+    struct Shard
+    {
+      mutable std::shared_mutex mutex;
+      std::unordered_map< K, V > map;
+    };
+
+    Shard& getShard( const K& key )
+    {
+      return m_shards[ std::hash< K >{}( key ) % ShardCount ];
+    }
+
+    const Shard& getShard( const K& key ) const
+    {
+      return m_shards[ std::hash< K >{}( key ) % ShardCount ];
+    }
+
+    std::array< Shard, ShardCount > m_shards;
+    std::atomic< std::size_t > m_size{ 0 };
+  };
+
+  template< class K, class V, size_t ShardCount >
+  V ConcurrentMap< K, V, ShardCount >::find( const K& key ) const
+  {
+    auto& shard = getShard( key );
+    std::shared_lock< std::shared_mutex > lock( shard.mutex );
+
+    auto it = shard.map.find( key );
+    if( it == shard.map.end() )
+      return V{};
+
+    return it->second;
+  }
+
+  template< class K, class V, size_t ShardCount >
+  bool ConcurrentMap< K, V, ShardCount >::contains( const K& key ) const
+  {
+    auto& shard = getShard( key );
+    std::shared_lock< std::shared_mutex > lock( shard.mutex );
+    return shard.map.count( key ) != 0;
+  }
+
+  template< class K, class V, size_t ShardCount >
+  void ConcurrentMap< K, V, ShardCount >::set( const K& key, V value )
+  {
+    auto& shard = getShard( key );
+    std::unique_lock< std::shared_mutex > lock( shard.mutex );
+
+    auto result = shard.map.insert_or_assign( key, std::move( value ) );
+    if( result.second )
+      ++m_size;
+  }
+
+  template< class K, class V, size_t ShardCount >
+  bool ConcurrentMap< K, V, ShardCount >::insert( const K& key, V value )
+  {
+    auto& shard = getShard( key );
+    std::unique_lock< std::shared_mutex > lock( shard.mutex );
+
+    if( !shard.map.try_emplace( key, std::move( value ) ).second )
+      return false;
+
+    ++m_size;
+    return true;
+  }
+
+  template< class K, class V, size_t ShardCount >
+  bool ConcurrentMap< K, V, ShardCount >::erase( const K& key )
+  {
+    auto& shard = getShard( key );
+    std::unique_lock< std::shared_mutex > lock( shard.mutex );
+
+    if( shard.map.erase( key ) == 0 )
+      return false;
+
+    --m_size;
+    return true;
+  }
+
+  template< class K, class V, size_t ShardCount >
+  void ConcurrentMap< K, V, ShardCount >::clear()
+  {
+    for( auto& shard : m_shards )
+    {
+      std::unique_lock< std::shared_mutex > lock( shard.mutex );
+      m_size -= shard.map.size();
+      shard.map.clear();
+    }
+  }
+
+  template< class K, class V, size_t ShardCount >
+  std::size_t ConcurrentMap< K, V, ShardCount >::size() const
+  {
+    return m_size;
+  }
+
+  template< class K, class V, size_t ShardCount >
+  std::vector< V > ConcurrentMap< K, V, ShardCount >::values() const
+  {
+    std::vector< V > result;
+    result.reserve( m_size );
+
+    for( auto& shard : m_shards )
+    {
+      std::shared_lock< std::shared_mutex > lock( shard.mutex );
+      for( const auto& entry : shard.map )
+        result.push_back( entry.second );
+    }
+
+    return result;
+  }
+
+}
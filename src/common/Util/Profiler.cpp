@@ -0,0 +1,295 @@
+#include "Profiler.h"
+#include "Util.h"
+
+#include <Logging/Logger.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <nlohmann/json.hpp>
+
+using namespace Sapphire::Common::Util;
+
+namespace
+{
+  // samples a thread can record between two collect() calls, has to be a power of two
+  constexpr size_t RingSize = 8192;
+
+  struct Sample
+  {
+    uint64_t key;
+    uint32_t us;
+    Profiler::ZoneId zone;
+  };
+
+  // single producer ( the owning thread ) / single consumer ( collect() ) ring
+  struct ThreadRing
+  {
+    std::array< Sample, RingSize > samples;
+    std::atomic< size_t > head{ 0 };
+    std::atomic< size_t > tail{ 0 };
+    std::atomic< bool > alive{ true };
+  };
+
+  struct Window
+  {
+    std::array< uint32_t, ProfileWindowSize > samples{};
+    size_t next{ 0 };
+    size_t filled{ 0 };
+    uint64_t count{ 0 };
+    uint64_t totalUs{ 0 };
+    uint64_t lastRecordMs{ 0 };
+
+    void add( uint32_t us, uint64_t nowMs )
+    {
+      samples[ next ] = us;
+      next = ( next + 1 ) % ProfileWindowSize;
+      filled = std::min( filled + 1, ProfileWindowSize );
+      ++count;
+      totalUs += us;
+      lastRecordMs = nowMs;
+    }
+  };
+
+  struct ProfilerState
+  {
+    std::mutex zoneMutex;
+    std::vector< std::string > zones;
+
+    std::mutex ringMutex;
+    std::vector< std::shared_ptr< ThreadRing > > rings;
+
+    std::mutex windowMutex;
+    std::map< std::pair< Profiler::ZoneId, uint64_t >, Window > windows;
+
+    std::atomic< uint64_t > dropped{ 0 };
+  };
+
+  ProfilerState& getState()
+  {
+    static ProfilerState state;
+    return state;
+  }
+
+  // registers the ring of the calling thread on first use, the ring is released once drained after the thread exits
+  struct ThreadRingHandle
+  {
+    std::shared_ptr< ThreadRing > ring;
+
+    ThreadRingHandle() :
+      ring( std::make_shared< ThreadRing >() )
+    {
+      auto& state = getState();
+      std::lock_guard< std::mutex > lock( state.ringMutex );
+      state.rings.push_back( ring );
+    }
+
+    ~ThreadRingHandle()
+    {
+      ring->alive = false;
+    }
+  };
+
+  ThreadRing& getThreadRing()
+  {
+    thread_local ThreadRingHandle handle;
+    return *handle.ring;
+  }
+
+  uint64_t percentile( std::vector< uint32_t >& sorted, double fraction )
+  {
+    if( sorted.empty() )
+      return 0;
+
+    const auto index = std::min( sorted.size() - 1, static_cast< size_t >( fraction * static_cast< double >( sorted.size() ) ) );
+    return sorted[ index ];
+  }
+}
+
+Profiler::ZoneId Profiler::registerZone( const char* name )
+{
+  auto& state = getState();
+  std::lock_guard< std::mutex > lock( state.zoneMutex );
+
+  auto it = std::find( state.zones.begin(), state.zones.end(), name );
+  if( it != state.zones.end() )
+    return static_cast< ZoneId >( it - state.zones.begin() );
+
+  state.zones.emplace_back( name );
+  return static_cast< ZoneId >( state.zones.size() - 1 );
+}
+
+void Profiler::record( ZoneId zone, uint64_t key, uint64_t us )
+{
+  auto& ring = getThreadRing();
+
+  const auto head = ring.head.load( std::memory_order_relaxed );
+  if( head - ring.tail.load( std::memory_order_acquire ) >= RingSize )
+  {
+    getState().dropped.fetch_add( 1, std::memory_order_relaxed );
+    return;
+  }
+
+  const auto clamped = static_cast< uint32_t >( std::min< uint64_t >( us, std::numeric_limits< uint32_t >::max() ) );
+  ring.samples[ head & ( RingSize - 1 ) ] = { key, clamped, zone };
+  ring.head.store( head + 1, std::memory_order_release );
+}
+
+void Profiler::collect()
+{
+  auto& state = getState();
+
+  std::vector< std::shared_ptr< ThreadRing > > rings;
+  {
+    std::lock_guard< std::mutex > lock( state.ringMutex );
+    rings = state.rings;
+  }
+
+  const auto nowMs = getTimeMs();
+  bool foundDead = false;
+
+  {
+    std::lock_guard< std::mutex > lock( state.windowMutex );
+
+    for( auto& ring : rings )
+    {
+      // read before draining, a dead ring does not receive anything after this
+      const bool alive = ring->alive.load( std::memory_order_acquire );
+
+      auto tail = ring->tail.load( std::memory_order_relaxed );
+      const auto head = ring->head.load( std::memory_order_acquire );
+
+      for( ; tail != head; ++tail )
+      {
+        const auto& sample = ring->samples[ tail & ( RingSize - 1 ) ];
+        state.windows[ { sample.zone, sample.key } ].add( sample.us, nowMs );
+      }
+
+      ring->tail.store( tail, std::memory_order_release );
+      foundDead |= !alive;
+    }
+  }
+
+  if( foundDead )
+  {
+    std::lock_guard< std::mutex > lock( state.ringMutex );
+    state.rings.erase( std::remove_if( state.rings.begin(), state.rings.end(), []( const std::shared_ptr< ThreadRing >& ring )
+    {
+      return !ring->alive && ring->tail == ring->head;
+    } ), state.rings.end() );
+  }
+}
+
+std::vector< ProfileStats > Profiler::getStats()
+{
+  auto& state = getState();
+
+  std::vector< std::string > zones;
+  {
+    std::lock_guard< std::mutex > lock( state.zoneMutex );
+    zones = state.zones;
+  }
+
+  std::vector< ProfileStats > result;
+  std::vector< uint32_t > sorted;
+
+  std::lock_guard< std::mutex > lock( state.windowMutex );
+  result.reserve( state.windows.size() );
+
+  for( const auto& [ id, window ] : state.windows )
+  {
+    sorted.assign( window.samples.begin(), window.samples.begin() + window.filled );
+    std::sort( sorted.begin(), sorted.end() );
+
+    ProfileStats stats;
+    stats.zone = zones[ id.first ];
+    stats.key = id.second;
+    stats.count = window.count;
+    stats.totalUs = window.totalUs;
+    stats.p50Us = percentile( sorted, 0.5 );
+    stats.p99Us = percentile( sorted, 0.99 );
+    stats.maxUs = sorted.empty() ? 0 : sorted.back();
+    result.push_back( std::move( stats ) );
+  }
+
+  std::sort( result.begin(), result.end(), []( const ProfileStats& left, const ProfileStats& right )
+  {
+    return left.zone != right.zone ? left.zone < right.zone : left.key < right.key;
+  } );
+
+  return result;
+}
+
+uint64_t Profiler::getDropped()
+{
+  return getState().dropped.load( std::memory_order_relaxed );
+}
+
+void Profiler::reset()
+{
+  auto& state = getState();
+  std::lock_guard< std::mutex > lock( state.windowMutex );
+  state.windows.clear();
+  state.dropped = 0;
+}
+
+void Profiler::prune( uint64_t idleMs )
+{
+  auto& state = getState();
+  const auto nowMs = getTimeMs();
+
+  std::lock_guard< std::mutex > lock( state.windowMutex );
+  for( auto it = state.windows.begin(); it != state.windows.end(); )
+  {
+    if( it->first.second != 0 && nowMs - it->second.lastRecordMs > idleMs )
+      it = state.windows.erase( it );
+    else
+      ++it;
+  }
+}
+
+std::string Profiler::toJson()
+{
+  auto zones = nlohmann::json::array();
+
+  for( const auto& stats : getStats() )
+  {
+    zones.push_back( {
+      { "zone", stats.zone },
+      { "key", stats.key },
+      { "count", stats.count },
+      { "totalUs", stats.totalUs },
+      { "p50Us", stats.p50Us },
+      { "p99Us", stats.p99Us },
+      { "maxUs", stats.maxUs }
+    } );
+  }
+
+  nlohmann::json dump = {
+    { "time", getTimeSeconds() },
+    { "window", ProfileWindowSize },
+    { "dropped", getDropped() },
+    { "zones", zones }
+  };
+
+  return dump.dump( 2 );
+}
+
+bool Profiler::dumpJson( const std::string& path )
+{
+  std::ofstream file( path, std::ios::trunc );
+  if( !file )
+  {
+    Logger::error( "Unable to write profile dump to {0}", path );
+    return false;
+  }
+
+  file << toJson() << '\n';
+  return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Sapphire::Common::Util
+{
+
+  // recent samples per zone / key the percentiles are computed from
+  constexpr size_t ProfileWindowSize = 512;
+
+  // rolling timings of one profiled zone, key is 0 unless the zone is split up ( e.g. by territory guid )
+  struct ProfileStats
+  {
+    std::string zone;
+    uint64_t key{ 0 };
+    // samples seen since the last reset, the percentiles only cover the most recent ProfileWindowSize of them
+    uint64_t count{ 0 };
+    uint64_t totalUs{ 0 };
+    uint64_t p50Us{ 0 };
+    uint64_t p99Us{ 0 };
+    uint64_t maxUs{ 0 };
+  };
+
+  /*!
+   * Scoped timer facility for the server tick.
+   *
+   * Timers write into a ring owned by the recording thread, so recording never takes a lock.
+   * collect() drains every ring into per zone / key windows and is meant to be called once per tick
+   * by the thread driving the update loop. A full ring drops the sample and counts it instead of blocking.
+   *
+   * Use the SAPPHIRE_PROFILE_SCOPE macros, they compile to nothing without SAPPHIRE_PROFILING.
+   */
+  class Profiler
+  {
+  public:
+    using ZoneId = uint16_t;
+
+    // returns the id of the zone with the given name, registering it if needed
+    static ZoneId registerZone( const char* name );
+
+    static void record( ZoneId zone, uint64_t key, uint64_t us );
+
+    // moves recorded samples from all thread rings into the rolling windows
+    static void collect();
+
+    // stats of every zone / key, sorted by zone name and key
+    static std::vector< ProfileStats > getStats();
+
+    // samples dropped because a thread ring was full
+    static uint64_t getDropped();
+
+    static void reset();
+
+    // drops windows of keys that did not record anything for the given time, e.g. destroyed instances
+    static void prune( uint64_t idleMs );
+
+    static std::string toJson();
+
+    static bool dumpJson( const std::string& path );
+  };
+
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer( Profiler::ZoneId zone, uint64_t key = 0 ) :
+      m_zone( zone ),
+      m_key( key ),
+      m_start( std::chrono::steady_clock::now() )
+    {
+    }
+
+    ~ScopedTimer()
+    {
+      const auto elapsed = std::chrono::steady_clock::now() - m_start;
+      Profiler::record( m_zone, m_key, std::chrono::duration_cast< std::chrono::microseconds >( elapsed ).count() );
+    }
+
+    ScopedTimer( const ScopedTimer& ) = delete;
+    ScopedTimer& operator=( const ScopedTimer& ) = delete;
+
+  private:
+    Profiler::ZoneId m_zone;
+    uint64_t m_key;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+}
+
+#define SAPPHIRE_PROFILE_CONCAT_IMPL( a, b ) a##b
+#define SAPPHIRE_PROFILE_CONCAT( a, b ) SAPPHIRE_PROFILE_CONCAT_IMPL( a, b )
+
+#ifdef SAPPHIRE_PROFILING
+#define SAPPHIRE_PROFILE_SCOPE_KEY( name, key ) \
+  static const auto SAPPHIRE_PROFILE_CONCAT( profileZone_, __LINE__ ) = ::Sapphire::Common::Util::Profiler::registerZone( name ); \
+  ::Sapphire::Common::Util::ScopedTimer SAPPHIRE_PROFILE_CONCAT( profileTimer_, __LINE__ )( SAPPHIRE_PROFILE_CONCAT( profileZone_, __LINE__ ), key )
+#else
+#define SAPPHIRE_PROFILE_SCOPE_KEY( name, key )
+#endif
+
+#define SAPPHIRE_PROFILE_SCOPE( name ) SAPPHIRE_PROFILE_SCOPE_KEY( name, 0 )
@@ -0,0 +1,9 @@
+#include "Version.h"
+
+namespace Sapphire::Version
+{
+
+  const std::string GIT_HASH = "e77a63737be809bdceead2b8dc39b8d4119b5694";
+  const std::string VERSION = "heads/master-d";
+
+} /* Sapphire::Version */
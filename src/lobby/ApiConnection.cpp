@@ -0,0 +1,244 @@
+#include "ApiConnection.h"
+
+#include <Util/Util.h>
+
+using namespace Sapphire;
+
+namespace
+{
+  int64_t nowMs()
+  {
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+      std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+}
+
+Lobby::ApiConnection::ApiConnection( asio::io_context& ioContext, const std::string& host, const std::string& port ) :
+  m_ioContext( ioContext ),
+  m_socket( ioContext ),
+  m_resolver( ioContext ),
+  m_host( host ),
+  m_port( port ),
+  m_lastActive( nowMs() )
+{
+}
+
+void Lobby::ApiConnection::post( const std::string& path, const std::string& body, Callback callback )
+{
+  std::string request = "POST " + path + " HTTP/1.1\r\n"
+                        "Host: " + m_host + "\r\n"
+                        "Content-Type: application/json\r\n"
+                        "Content-Length: " + std::to_string( body.size() ) + "\r\n\r\n" + body;
+
+  ++m_pendingCount;
+  m_lastActive = nowMs();
+
+  asio::post( m_ioContext, [ self = shared_from_this(), request = std::move( request ), callback = std::move( callback ) ]() mutable
+  {
+    if( !self->m_open )
+    {
+      --self->m_pendingCount;
+      callback( asio::error::operation_aborted, false, {} );
+      return;
+    }
+
+    self->m_pending.push_back( { std::move( callback ), self->m_answered } );
+    self->m_writeQueue.push_back( std::move( request ) );
+
+    if( !self->m_connected )
+    {
+      // the first request opens the connection, later ones wait in the queue until it is up
+      if( self->m_pending.size() == 1 )
+        self->connect();
+      return;
+    }
+
+    self->write();
+    self->read();
+  } );
+}
+
+void Lobby::ApiConnection::close()
+{
+  m_open = false;
+  asio::post( m_ioContext, [ self = shared_from_this() ]()
+  {
+    self->fail( asio::error::operation_aborted );
+  } );
+}
+
+bool Lobby::ApiConnection::isOpen() const
+{
+  return m_open;
+}
+
+uint32_t Lobby::ApiConnection::getPendingCount() const
+{
+  return m_pendingCount;
+}
+
+std::chrono::steady_clock::time_point Lobby::ApiConnection::getLastActive() const
+{
+  return std::chrono::steady_clock::time_point( std::chrono::milliseconds( m_lastActive.load() ) );
+}
+
+void Lobby::ApiConnection::connect()
+{
+  m_resolver.async_resolve( m_host, m_port,
+                            [ self = shared_from_this() ]( const asio::error_code& ec, asio::ip::tcp::resolver::results_type results )
+  {
+    if( ec )
+    {
+      self->fail( ec );
+      return;
+    }
+
+    asio::async_connect( self->m_socket, results, [ self ]( const asio::error_code& ec, const asio::ip::tcp::endpoint& )
+    {
+      if( ec )
+      {
+        self->fail( ec );
+        return;
+      }
+
+      // a close while connecting has failed the requests already
+      if( !self->m_open )
+        return;
+
+      self->m_socket.set_option( asio::ip::tcp::no_delay( true ) );
+      self->m_connected = true;
+      self->write();
+      self->read();
+    } );
+  } );
+}
+
+void Lobby::ApiConnection::write()
+{
+  if( m_writing || m_writeQueue.empty() )
+    return;
+
+  m_writing = true;
+  asio::async_write( m_socket, asio::buffer( m_writeQueue.front() ),
+                     [ self = shared_from_this() ]( const asio::error_code& ec, size_t )
+  {
+    self->m_writing = false;
+    if( ec )
+    {
+      self->fail( ec );
+      return;
+    }
+
+    self->m_writeQueue.pop_front();
+    self->write();
+  } );
+}
+
+void Lobby::ApiConnection::read()
+{
+  if( m_reading || m_pending.empty() )
+    return;
+
+  m_reading = true;
+  asio::async_read_until( m_socket, asio::dynamic_buffer( m_readBuffer ), "\r\n\r\n",
+                          [ self = shared_from_this() ]( const asio::error_code& ec, size_t headerSize )
+  {
+    if( ec )
+    {
+      self->m_reading = false;
+      self->fail( ec );
+      return;
+    }
+
+    auto header = self->m_readBuffer.substr( 0, headerSize );
+    self->m_readBuffer.erase( 0, headerSize );
+
+    // "HTTP/1.1 200 OK"
+    uint16_t status = 0;
+    auto statusStart = header.find( ' ' );
+    if( statusStart != std::string::npos )
+      status = static_cast< uint16_t >( std::strtoul( header.c_str() + statusStart + 1, nullptr, 10 ) );
+
+    // the api always sends a length with a body, a response without one has none
+    size_t contentLength = 0;
+    bool closeAfter = false;
+    auto lowerHeader = Common::Util::toLowerCopy( header );
+
+    auto lengthPos = lowerHeader.find( "\r\ncontent-length:" );
+    if( lengthPos != std::string::npos )
+      contentLength = std::strtoull( header.c_str() + lengthPos + 17, nullptr, 10 );
+
+    auto connectionPos = lowerHeader.find( "\r\nconnection:" );
+    if( connectionPos != std::string::npos )
+    {
+      auto lineEnd = lowerHeader.find( "\r\n", connectionPos + 2 );
+      closeAfter = lowerHeader.substr( connectionPos, lineEnd - connectionPos ).find( "close" ) != std::string::npos;
+    }
+
+    self->readContent( status, contentLength, closeAfter );
+  } );
+}
+
+void Lobby::ApiConnection::readContent( uint16_t status, size_t contentLength, bool closeAfter )
+{
+  if( m_readBuffer.size() >= contentLength )
+  {
+    auto content = m_readBuffer.substr( 0, contentLength );
+    m_readBuffer.erase( 0, contentLength );
+    complete( status, std::move( content ), closeAfter );
+    return;
+  }
+
+  asio::async_read( m_socket, asio::dynamic_buffer( m_readBuffer ), asio::transfer_exactly( contentLength - m_readBuffer.size() ),
+                    [ self = shared_from_this(), status, contentLength, closeAfter ]( const asio::error_code& ec, size_t )
+  {
+    if( ec )
+    {
+      self->m_reading = false;
+      self->fail( ec );
+      return;
+    }
+
+    self->readContent( status, contentLength, closeAfter );
+  } );
+}
+
+void Lobby::ApiConnection::complete( uint16_t status, std::string content, bool closeAfter )
+{
+  m_reading = false;
+  m_answered = true;
+  m_lastActive = nowMs();
+
+  auto pending = std::move( m_pending.front() );
+  m_pending.pop_front();
+  --m_pendingCount;
+
+  pending.callback( {}, pending.reused, { status, std::move( content ) } );
+
+  // the api will not answer anything sent after this one
+  if( closeAfter )
+  {
+    m_open = false;
+    fail( asio::error::connection_reset );
+    return;
+  }
+
+  read();
+}
+
+void Lobby::ApiConnection::fail( const asio::error_code& ec )
+{
+  m_open = false;
+  m_connected = false;
+
+  asio::error_code ignored;
+  m_socket.close( ignored );
+  m_writeQueue.clear();
+
+  auto pending = std::move( m_pending );
+  m_pending.clear();
+  m_pendingCount -= static_cast< uint32_t >( pending.size() );
+
+  for( auto& entry : pending )
+    entry.callback( ec, entry.reused, {} );
+}
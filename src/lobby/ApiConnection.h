@@ -0,0 +1,95 @@
+#ifndef _APICONNECTION_H_
+#define _APICONNECTION_H_
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Sapphire::Lobby
+{
+  struct ApiResponse
+  {
+    uint16_t status{ 0 };
+    std::string content;
+  };
+
+  /*!
+   * @brief One keep-alive connection to the lobby api, requests are pipelined on it
+   *
+   * A request is written as soon as it is queued, without waiting for the responses before it,
+   * and the responses are matched to the requests in the order they were sent.
+   * All socket work happens on the io context passed in, the callbacks run there too.
+   * If the connection fails every request still waiting on it fails with it.
+   */
+  class ApiConnection : public std::enable_shared_from_this< ApiConnection >
+  {
+  public:
+    // reused is true if the connection had answered a request before this one was sent
+    using Callback = std::function< void( const asio::error_code& ec, bool reused, ApiResponse response ) >;
+
+    ApiConnection( asio::io_context& ioContext, const std::string& host, const std::string& port );
+
+    /*!
+     * @brief Queues a POST request, may be called from any thread
+     * @param callback called on the io thread with the response or the error the connection failed with
+     */
+    void post( const std::string& path, const std::string& body, Callback callback );
+
+    // closes the socket, every request still waiting fails, may be called from any thread
+    void close();
+
+    bool isOpen() const;
+
+    // requests sent or queued that have not been answered yet
+    uint32_t getPendingCount() const;
+
+    std::chrono::steady_clock::time_point getLastActive() const;
+
+  private:
+    struct Pending
+    {
+      Callback callback;
+      bool reused;
+    };
+
+    void connect();
+
+    void write();
+
+    void read();
+
+    void readContent( uint16_t status, size_t contentLength, bool closeAfter );
+
+    void complete( uint16_t status, std::string content, bool closeAfter );
+
+    void fail( const asio::error_code& ec );
+
+    asio::io_context& m_ioContext;
+    asio::ip::tcp::socket m_socket;
+    asio::ip::tcp::resolver m_resolver;
+    std::string m_host;
+    std::string m_port;
+
+    // io thread only
+    bool m_connected{ false };
+    bool m_writing{ false };
+    bool m_reading{ false };
+    bool m_answered{ false };
+    std::deque< std::string > m_writeQueue;
+    std::deque< Pending > m_pending;
+    std::string m_readBuffer;
+
+    std::atomic< bool > m_open{ true };
+    std::atomic< uint32_t > m_pendingCount{ 0 };
+    std::atomic< int64_t > m_lastActive;
+  };
+
+  using ApiConnectionPtr = std::shared_ptr< ApiConnection >;
+}
+
+#endif
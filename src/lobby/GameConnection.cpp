@@ -12,8 +12,8 @@
 #include <Crypt/blowfish.h>
 #include <Config/ConfigMgr.h>
 
-#include <utility>
-
+#include <array>
+#include <optional>
 #include <utility>
 
 #include "ServerLobby.h"
@@ -35,6 +35,7 @@ extern Lobby::RestConnector g_restConnector;
 Lobby::GameConnection::GameConnection( Sapphire::Network::HivePtr pHive,
                                        Sapphire::Network::AcceptorPtr pAcceptor ) :
   Sapphire::Network::Connection( std::move( pHive ) ),
+  m_pBlowfish( std::make_unique< BlowFish >() ),
   m_pAcceptor( std::move( pAcceptor ) ),
   m_bEncryptionInitialized( false )
 {
@@ -45,6 +46,21 @@ Lobby::GameConnection::~GameConnection()
 
 }
 
+template< typename Request, typename Callback >
+void Lobby::GameConnection::requestApi( Request request, Callback callback )
+{
+  // the connection is kept alive until the callback ran, the callback always runs on the strand packets are handled on
+  auto self = std::static_pointer_cast< GameConnection, Connection >( shared_from_this() );
+  g_restConnector.post( [ self, request, callback ]() mutable
+  {
+    auto result = request();
+    self->getStrand().post( [ self, result, callback ]() mutable
+    {
+      callback( result );
+    } );
+  } );
+}
+
 
 // overwrite the parents onConnect for our game socket needs
 void Lobby::GameConnection::onAccept( const std::string& host, uint16_t port )
@@ -114,7 +130,7 @@ Lobby::GameConnection::sendError( uint32_t requestNumber, uint32_t clientTimeVal
   errorPacket->data().errorCode = errorCode;
   errorPacket->data().errorMessageNo = messageId;
 
-  LobbyPacketContainer pRP( m_encKey );
+  LobbyPacketContainer pRP( m_pBlowfish.get() );
   pRP.addPacket( errorPacket );
   sendPacket( pRP );
 }
@@ -127,7 +143,7 @@ void Lobby::GameConnection::serviceLogin( FFXIVARR_PACKET_RAW& packet, uint32_t
 
   //Logger::info( "requestNumber [{0}]", requestNumber );
   Logger::info( "[accountId#{0}] ReqCharList", m_pSession->getAccountID() );
-  LobbyPacketContainer pRP( m_encKey );
+  LobbyPacketContainer pRP( m_pBlowfish.get() );
 
   auto serverListPacket = makeLobbyPacket< FFXIVIpcDistWorldInfo >( tmpId );
   serverListPacket->data().requestNumber = requestNumber;
@@ -147,8 +163,17 @@ void Lobby::GameConnection::serviceLogin( FFXIVARR_PACKET_RAW& packet, uint32_t
 
   sendPacket( pRP );
 
-  auto charList = g_restConnector.getCharList( m_pSession->getSessionId() );
+  std::string sessionId( m_pSession->getSessionId() );
+  requestApi( [ sessionId ]() { return g_restConnector.getCharList( sessionId ); },
+              [ this, requestNumber, clientTimeValue, tmpId ]( const CharList& charList )
+              {
+                sendCharList( charList, requestNumber, clientTimeValue, tmpId );
+              } );
+}
 
+void Lobby::GameConnection::sendCharList( const CharList& charList, uint32_t requestNumber,
+                                          uint32_t clientTimeValue, uint32_t tmpId )
+{
   int32_t charIndex = -1;
   uint8_t usedCharaIndex = 0;
 
@@ -171,7 +196,7 @@ void Lobby::GameConnection::serviceLogin( FFXIVARR_PACKET_RAW& packet, uint32_t
 
       usedCharaIndex = charIndex;
 
-      auto& charEntry = charList[ charIndex ];
+      const auto& charEntry = charList[ charIndex ];
       details.characterId = std::get< 2 >( charEntry );
       details.playerId = std::get< 1 >( charEntry );
       details.worldId = g_serverLobby.getConfig().global.general.worldID;
@@ -201,7 +226,7 @@ void Lobby::GameConnection::serviceLogin( FFXIVARR_PACKET_RAW& packet, uint32_t
 
     m_pSession->setCharaIndex( usedCharaIndex );
 
-    LobbyPacketContainer pRP1( m_encKey );
+    LobbyPacketContainer pRP1( m_pBlowfish.get() );
     pRP1.addPacket( charListPacket );
     sendPacket( pRP1 );
   }
@@ -222,9 +247,20 @@ void Lobby::GameConnection::gameLogin( FFXIVARR_PACKET_RAW& packet, uint32_t tmp
 
   Logger::info( "[accountId#{0}] GameLogin: characterId#{1} playerId#{2}", m_pSession->getAccountID(), characterId, playerId );
 
+  std::string sessionId( m_pSession->getSessionId() );
+  requestApi( [ sessionId ]() { return g_restConnector.getCharList( sessionId ); },
+              [ this, characterId, characterIndex, operation, requestNumber, clientTimeValue, tmpId ]( const CharList& charList )
+              {
+                sendGameLoginReply( charList, characterId, characterIndex, operation, requestNumber, clientTimeValue, tmpId );
+              } );
+}
+
+void Lobby::GameConnection::sendGameLoginReply( const CharList& charList, uint64_t characterId, uint8_t characterIndex,
+                                                uint8_t operation, uint32_t requestNumber, uint32_t clientTimeValue,
+                                                uint32_t tmpId )
+{
   uint64_t ticketId = -1;
   std::string logInCharName;
-  auto charList = g_restConnector.getCharList( m_pSession->getSessionId() );
 
   for( auto& listEntry : charList )
   {
@@ -243,7 +279,7 @@ void Lobby::GameConnection::gameLogin( FFXIVARR_PACKET_RAW& packet, uint32_t tmp
 
   Logger::info( "[accountId#{0}] Logging in as {1} ticketId ({2})", m_pSession->getAccountID(), logInCharName, ticketId );
 
-  LobbyPacketContainer pRP( m_encKey );
+  LobbyPacketContainer pRP( m_pBlowfish.get() );
 
   auto enterWorldPacket = makeLobbyPacket< FFXIVIpcGameLoginReply >( tmpId );
   enterWorldPacket->data().characterId = characterId;
@@ -263,18 +299,30 @@ void Lobby::GameConnection::gameLogin( FFXIVARR_PACKET_RAW& packet, uint32_t tmp
 bool Lobby::GameConnection::login( FFXIVARR_PACKET_RAW& packet, uint32_t tmpId )
 {
   auto loginPacket = LobbyChannelPacket< Client::FFXIVIpcLogin >( packet );
-  LobbySessionPtr pSession = g_serverLobby.getSession( loginPacket.data().sessionId );
 
   Logger::info( "Login request from session: {0}", loginPacket.data().sessionId );
   Logger::info( "Client version: {0}", loginPacket.data().version );
 
+  std::array< char, sizeof( Client::FFXIVIpcLogin::sessionId ) > sessionId{};
+  memcpy( sessionId.data(), loginPacket.data().sessionId, sessionId.size() );
+
+  requestApi( [ sessionId ]() mutable { return g_serverLobby.getSession( sessionId.data() ); },
+              [ this, sessionId, tmpId ]( LobbySessionPtr pSession ) mutable
+              {
+                onLogin( pSession, sessionId.data(), tmpId );
+              } );
+  return false;
+}
+
+void Lobby::GameConnection::onLogin( LobbySessionPtr pSession, char* sessionId, uint32_t tmpId )
+{
   if( g_serverLobby.getConfig().allowNoSessionConnect && !pSession )
   {
     auto session = make_LobbySession();
     session->setAccountID( 0 );
-    session->setSessionId( loginPacket.data().sessionId );
+    session->setSessionId( sessionId );
     pSession = session;
-    Logger::info( "Allowed connection with no session: {0}", loginPacket.data().sessionId );
+    Logger::info( "Allowed connection with no session: {0}", sessionId );
   }
 
   if( pSession )
@@ -290,18 +338,15 @@ bool Lobby::GameConnection::login( FFXIVARR_PACKET_RAW& packet, uint32_t tmpId )
     serviceIdInfoPacket->data().accountArray[ 0 ].accountId = 0x002E4A2B;
     sprintf( serviceIdInfoPacket->data().accountArray[ 0 ].accountName, "%s", Common::SERVICE_ACCOUNT_DEFAULT_NAME.c_str() );
 
-    LobbyPacketContainer pRP( m_encKey );
+    LobbyPacketContainer pRP( m_pBlowfish.get() );
     pRP.addPacket( serviceIdInfoPacket );
     sendPacket( pRP );
   }
   else
   {
-    Logger::info( "Could not retrieve session: {0}", loginPacket.data().sessionId );
+    Logger::info( "Could not retrieve session: {0}", sessionId );
     sendError( 1, 0, 5006, 13001, tmpId );
-
-    return true;
   }
-  return false;
 }
 
 bool Lobby::GameConnection::charaMake( FFXIVARR_PACKET_RAW& packet, uint32_t tmpId )
@@ -326,48 +371,70 @@ bool Lobby::GameConnection::charaMake( FFXIVARR_PACKET_RAW& packet, uint32_t tmp
 
     Logger::info( "[accountId#{0}] Character Operation CHARAOPE_RESERVENAME: {1}", m_pSession->getAccountID(), name );
 
-    LobbyPacketContainer pRP( m_encKey );
-
     m_pSession->newCharName = name;
 
-    if( g_restConnector.checkNameTaken( m_pSession->newCharName ) )
+    // no content id when the name is taken
+    requestApi( [ name ]() -> std::optional< uint64_t >
+                {
+                  if( g_restConnector.checkNameTaken( name ) )
+                    return std::nullopt;
+                  return g_restConnector.getNextContentId();
+                },
+                [ this, requestNumber, clientTimeValue, tmpId ]( std::optional< uint64_t > newContentId )
     {
-      sendError( requestNumber, clientTimeValue, 3074, 13004, tmpId );
-      return true;
-    }
-    uint64_t newContentId = g_restConnector.getNextContentId();
-
-    auto charCreatePacket = makeLobbyPacket< FFXIVIpcCharaMakeReply >( tmpId );
-    charCreatePacket->data().chrArray[0].characterId = newContentId;
-    charCreatePacket->data().chrArray[0].chrIndex = m_pSession->getCharaIndex() + 1; 
-    charCreatePacket->data().chrArray[0].worldId = g_serverLobby.getConfig().global.general.worldID;
-    strcpy( charCreatePacket->data().chrArray[0].chrName, m_pSession->newCharName.c_str() );
-    strcpy( charCreatePacket->data().chrArray[0].worldSetName, g_serverLobby.getConfig().worldName.c_str() );
-    charCreatePacket->data().optionParam = Client::CharacterOperation::CHARAOPE_RESERVENAME;
-    charCreatePacket->data().requestNumber = requestNumber;
-    charCreatePacket->data().clientTimeValue = clientTimeValue;
-    charCreatePacket->data().endOfList = 1;
-    charCreatePacket->data().count = 1;
-    pRP.addPacket( charCreatePacket );
-    sendPacket( pRP );
+      if( !newContentId )
+      {
+        sendError( requestNumber, clientTimeValue, 3074, 13004, tmpId );
+        return;
+      }
+
+      LobbyPacketContainer pRP( m_pBlowfish.get() );
+
+      auto charCreatePacket = makeLobbyPacket< FFXIVIpcCharaMakeReply >( tmpId );
+      charCreatePacket->data().chrArray[0].characterId = *newContentId;
+      charCreatePacket->data().chrArray[0].chrIndex = m_pSession->getCharaIndex() + 1; 
+      charCreatePacket->data().chrArray[0].worldId = g_serverLobby.getConfig().global.general.worldID;
+      strcpy( charCreatePacket->data().chrArray[0].chrName, m_pSession->newCharName.c_str() );
+      strcpy( charCreatePacket->data().chrArray[0].worldSetName, g_serverLobby.getConfig().worldName.c_str() );
+      charCreatePacket->data().optionParam = Client::CharacterOperation::CHARAOPE_RESERVENAME;
+      charCreatePacket->data().requestNumber = requestNumber;
+      charCreatePacket->data().clientTimeValue = clientTimeValue;
+      charCreatePacket->data().endOfList = 1;
+      charCreatePacket->data().count = 1;
+      pRP.addPacket( charCreatePacket );
+      sendPacket( pRP );
+    } );
   }
   else if( characterOperation == Client::CharacterOperation::CHARAOPE_MAKECHARA ) //Character creation finalize
   {
     std::string charDetails( charaMakePacket.data().charaMakeData );
     Logger::info( "[accountId#{0}] Character Operation CHARAOPE_MAKECHARA: {1}", m_pSession->getAccountID(), charDetails );
 
-    if( g_restConnector.createCharacter( m_pSession->getSessionId(), m_pSession->newCharName, charDetails ) !=
-        -1 )
+    std::string sessionId( m_pSession->getSessionId() );
+    std::string name = m_pSession->newCharName;
+
+    // no entity id when the api did not create the character
+    requestApi( [ sessionId, name, charDetails ]() -> std::optional< uint32_t >
+                {
+                  if( g_restConnector.createCharacter( sessionId, name, charDetails ) == -1 )
+                    return std::nullopt;
+                  return g_restConnector.getNextCharId();
+                },
+                [ this, characterId, requestNumber, clientTimeValue, tmpId ]( std::optional< uint32_t > newId )
     {
-      LobbyPacketContainer pRP( m_encKey );
+      if( !newId )
+      {
+        sendError( requestNumber, clientTimeValue, 5006, 13001, tmpId );
+        return;
+      }
 
-      uint8_t newCharaIndex = m_pSession->getCharaIndex() + 1;
+      LobbyPacketContainer pRP( m_pBlowfish.get() );
 
-      uint32_t newId = g_restConnector.getNextCharId();
+      uint8_t newCharaIndex = m_pSession->getCharaIndex() + 1;
       m_pSession->setCharaIndex( newCharaIndex );
 
       Logger::info( "[accountId#{0}] index {1} charaterId {2}", m_pSession->getAccountID(), newCharaIndex, characterId );
-      Logger::info( "[accountId#{0}] index {1} playerId {2}", m_pSession->getAccountID(), newCharaIndex, newId );
+      Logger::info( "[accountId#{0}] index {1} playerId {2}", m_pSession->getAccountID(), newCharaIndex, *newId );
 
       auto charCreatePacket = makeLobbyPacket< FFXIVIpcCharaMakeReply >( tmpId );
       charCreatePacket->data().chrArray[0].playerId = characterId;
@@ -383,20 +450,23 @@ bool Lobby::GameConnection::charaMake( FFXIVARR_PACKET_RAW& packet, uint32_t tmp
       charCreatePacket->data().count = 1;
       pRP.addPacket( charCreatePacket );
       sendPacket( pRP );
-    }
-    else
-    {
-      sendError( requestNumber, clientTimeValue, 5006, 13001, tmpId );
-    }
+    } );
   }
   else if( characterOperation == Client::CharacterOperation::CHARAOPE_DELETECHARA ) //Character delete
   {
     std::string name = std::string( charaMakePacket.data().chracterName );
     Logger::info( "[accountId#{0}] Character Operation CHARAOPE_DELETECHARA: {1}", m_pSession->getAccountID(), name );
 
+    std::string sessionId( m_pSession->getSessionId() );
 
-    if( g_restConnector.deleteCharacter( m_pSession->getSessionId(), name ) )
+    requestApi( [ sessionId, name ]() { return g_restConnector.deleteCharacter( sessionId, name ); },
+                [ this, name, requestNumber, clientTimeValue, tmpId ]( bool deleted )
     {
+      if( !deleted )
+      {
+        sendError( requestNumber, clientTimeValue, 5006, 13001, tmpId );
+        return;
+      }
 
       auto charCreatePacket = makeLobbyPacket< FFXIVIpcCharaMakeReply >( tmpId );
       strcpy( charCreatePacket->data().chrArray[0].chrName, name.c_str() );
@@ -407,14 +477,10 @@ bool Lobby::GameConnection::charaMake( FFXIVARR_PACKET_RAW& packet, uint32_t tmp
       charCreatePacket->data().endOfList = 1;
       charCreatePacket->data().count = 1;
 
-      LobbyPacketContainer pRP( m_encKey );
+      LobbyPacketContainer pRP( m_pBlowfish.get() );
       pRP.addPacket( charCreatePacket );
       sendPacket( pRP );
-    }
-    else
-    {
-      sendError( requestNumber, clientTimeValue, 5006, 13001, tmpId );
-    }
+    } );
   }
   else
   {
@@ -442,7 +508,7 @@ void Lobby::GameConnection::debugLogin( FFXIVARR_PACKET_RAW& packet, uint32_t tm
   strcpy( debugLoginReplPacket->data().frontendHost, g_serverLobby.getConfig().global.network.zoneHost.c_str() );
   strcpy( debugLoginReplPacket->data().worldSetName, g_serverLobby.getConfig().worldName.c_str() );
 
-  LobbyPacketContainer pRP( m_encKey );
+  LobbyPacketContainer pRP( m_pBlowfish.get() );
   pRP.addPacket( debugLoginReplPacket );
   sendPacket( pRP );
 }
@@ -466,7 +532,7 @@ void Lobby::GameConnection::debugLogin2( FFXIVARR_PACKET_RAW& packet, uint32_t t
   strcpy( debugLoginReplPacket->data().frontendHost, g_serverLobby.getConfig().global.network.zoneHost.c_str() );
   strcpy( debugLoginReplPacket->data().worldSetName, g_serverLobby.getConfig().worldName.c_str() );
 
-  LobbyPacketContainer pRP( m_encKey );
+  LobbyPacketContainer pRP( m_pBlowfish.get() );
   pRP.addPacket( debugLoginReplPacket );
   sendPacket( pRP );
 }
@@ -554,6 +620,7 @@ void Lobby::GameConnection::generateEncryptionKey( uint32_t key, const std::stri
   m_baseKey.version = Common::FFXIV_ENC_VERSION;
   std::memcpy( m_baseKey.keyPhrase, keyPhrase.c_str(), keyPhrase.size() );
   Common::Util::md5( m_baseKey.rawKey, m_encKey, sizeof( m_baseKey ) );
+  m_pBlowfish->initialize( m_encKey, 0x10 );
 }
 
 void Lobby::GameConnection::handlePackets( const Network::Packets::FFXIVARR_PACKET_HEADER& ipcHeader,
@@ -564,10 +631,7 @@ void Lobby::GameConnection::handlePackets( const Network::Packets::FFXIVARR_PACK
 
     if( m_bEncryptionInitialized && inPacket.segHdr.type == 3 )
     {
-      BlowFish blowfish;
-      blowfish.initialize( m_encKey, 0x10 );
-      blowfish.Decode( ( uint8_t* ) ( &inPacket.data[ 0 ] ), ( uint8_t* ) ( &inPacket.data[ 0 ] ),
-                       static_cast< uint32_t >( inPacket.data.size() ) - 0x10 );
+      m_pBlowfish->DecodeSegment( &inPacket.data[ 0 ], static_cast< uint32_t >( inPacket.data.size() ) - 0x10 );
     }
 
     switch( inPacket.segHdr.type )
@@ -581,9 +645,7 @@ void Lobby::GameConnection::handlePackets( const Network::Packets::FFXIVARR_PACK
         auto pe1 = std::make_shared< FFXIVRawPacket >( 0x0A, 0x290, 0, 0 );
         *reinterpret_cast< uint32_t* >( &pe1->data()[ 0 ] ) = 0xE0003C2A;
 
-        BlowFish blowfish;
-        blowfish.initialize( m_encKey, 0x10 );
-        blowfish.Encode( &pe1->data()[ 0 ], &pe1->data()[ 0 ], 0x280 );
+        m_pBlowfish->EncodeSegment( &pe1->data()[ 0 ], 0x280 );
 
         sendSinglePacket( pe1 );
         break;
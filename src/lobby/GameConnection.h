@@ -11,9 +11,12 @@
 #include <asio.hpp>
 #include <map>
 #include "LobbyPacketContainer.h"
+#include "RestConnector.h"
 
 #include "Forwards.h"
 
+class BlowFish;
+
 #define DECLARE_HANDLER( x ) void x( Packets::GamePacketPtr pInPacket, Entity::PlayerPtr pPlayer )
 
 namespace Sapphire::Lobby
@@ -27,6 +30,9 @@ namespace Sapphire::Lobby
     // encryption key
     uint8_t m_encKey[0x10];
 
+    // cipher context keyed from m_encKey, the key schedule is only built once per connection
+    std::unique_ptr< BlowFish > m_pBlowfish;
+
     // base key, the encryption key is generated from this
     union
     {
@@ -50,6 +56,17 @@ namespace Sapphire::Lobby
     Common::Util::LockedQueue< Network::Packets::GamePacketPtr > m_outQueue;
     std::vector< uint8_t > m_packets;
 
+    // runs request on the api workers, callback continues on this connection's strand with its result
+    template< typename Request, typename Callback >
+    void requestApi( Request request, Callback callback );
+
+    void onLogin( LobbySessionPtr pSession, char* sessionId, uint32_t tmpId );
+
+    void sendCharList( const CharList& charList, uint32_t requestNumber, uint32_t clientTimeValue, uint32_t tmpId );
+
+    void sendGameLoginReply( const CharList& charList, uint64_t characterId, uint8_t characterIndex, uint8_t operation,
+                             uint32_t requestNumber, uint32_t clientTimeValue, uint32_t tmpId );
+
   public:
     GameConnection( Network::HivePtr pHive, Network::AcceptorPtr pAcceptor );
 
@@ -8,12 +8,12 @@ using namespace Sapphire;
 using namespace Sapphire::Common;
 using namespace Sapphire::Network::Packets;
 
-LobbyPacketContainer::LobbyPacketContainer( uint8_t* encKey )
+LobbyPacketContainer::LobbyPacketContainer( const BlowFish* pCipher )
 {
   memset( &m_header, 0, sizeof( Sapphire::Network::Packets::FFXIVARR_PACKET_HEADER ) );
   m_header.size = sizeof( Sapphire::Network::Packets::FFXIVARR_PACKET_HEADER );
 
-  m_encKey = encKey;
+  m_pCipher = pCipher;
 
   memset( m_dataBuf.data(), 0, 0x1570 );
 }
@@ -27,13 +27,9 @@ void LobbyPacketContainer::addPacket( FFXIVPacketBasePtr pEntry )
 {
   memcpy( m_dataBuf.data() + m_header.size, &pEntry->getData()[ 0 ], pEntry->getSize() );
 
-  // encryption key is set, we want to encrypt this packet
-  if( m_encKey != nullptr )
-  {
-    BlowFish blowfish;
-    blowfish.initialize( m_encKey, 0x10 );
-    blowfish.Encode( m_dataBuf.data() + m_header.size + 0x10, m_dataBuf.data() + m_header.size + 0x10, static_cast< uint32_t >( pEntry->getSize() ) - 0x10 );
-  }
+  // cipher is set, we want to encrypt this packet
+  if( m_pCipher != nullptr )
+    m_pCipher->EncodeSegment( m_dataBuf.data() + m_header.size + 0x10, static_cast< uint32_t >( pEntry->getSize() ) - 0x10 );
 
   m_header.size += static_cast< uint32_t >( pEntry->getSize() );
   m_header.count++;
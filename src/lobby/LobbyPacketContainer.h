@@ -10,6 +10,8 @@
 
 #include "Forwards.h"
 
+class BlowFish;
+
 namespace Sapphire::Network::Packets
 {
 
@@ -18,7 +20,7 @@ namespace Sapphire::Network::Packets
   class LobbyPacketContainer
   {
   public:
-    LobbyPacketContainer( uint8_t* encKey = nullptr );
+    LobbyPacketContainer( const BlowFish* pCipher = nullptr );
 
     ~LobbyPacketContainer();
 
@@ -31,7 +33,7 @@ namespace Sapphire::Network::Packets
   private:
     Sapphire::Network::Packets::FFXIVARR_PACKET_HEADER m_header;
 
-    uint8_t* m_encKey;
+    const BlowFish* m_pCipher;
 
     std::vector< FFXIVPacketBasePtr > m_entryList;
 
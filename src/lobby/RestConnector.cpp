@@ -3,6 +3,8 @@
 #include "ServerLobby.h"
 #include <Logging/Logger.h>
 #include <Crypt/base64.h>
+#include <algorithm>
+#include <future>
 #include <iomanip>
 #include <memory>
 
@@ -10,8 +12,6 @@
 
 using namespace Sapphire;
 
-typedef std::vector< std::tuple< std::string, uint32_t, uint64_t, std::string > > CharList;
-
 Lobby::RestConnector::RestConnector()
 {
 
@@ -19,39 +19,190 @@ Lobby::RestConnector::RestConnector()
 
 Lobby::RestConnector::~RestConnector()
 {
+  stop();
+}
+
+void Lobby::RestConnector::start( uint16_t workerCount )
+{
+  workerCount = std::max< uint16_t >( 1, workerCount );
+
+  if( !m_ioThread.joinable() )
+  {
+    m_ioContext.restart();
+    m_pWork = std::make_unique< asio::executor_work_guard< asio::io_context::executor_type > >( m_ioContext.get_executor() );
+    m_ioThread = std::thread( [ this ]() { m_ioContext.run(); } );
+  }
+
+  std::lock_guard< std::mutex > lock( m_taskMutex );
+  m_shutdown = false;
+  while( m_workers.size() < workerCount )
+    m_workers.emplace_back( &RestConnector::workerThread, this );
+}
+
+void Lobby::RestConnector::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( m_taskMutex );
+    m_shutdown = true;
+  }
+  m_taskCondition.notify_all();
+
+  for( auto& worker : m_workers )
+    worker.join();
+  m_workers.clear();
+
+  // nothing waits on a connection anymore, closing them lets the io thread run out of work
+  resetPool();
+  m_pWork.reset();
+  if( m_ioThread.joinable() )
+    m_ioThread.join();
+}
+
+void Lobby::RestConnector::post( Task task )
+{
+  {
+    std::lock_guard< std::mutex > lock( m_taskMutex );
+    m_tasks.push_back( std::move( task ) );
+  }
+  m_taskCondition.notify_one();
+}
+
+void Lobby::RestConnector::workerThread()
+{
+  while( true )
+  {
+    Task task;
+    {
+      std::unique_lock< std::mutex > lock( m_taskMutex );
+      m_taskCondition.wait( lock, [ this ] { return m_shutdown || !m_tasks.empty(); } );
+
+      if( m_tasks.empty() )
+        return;
+
+      task = std::move( m_tasks.front() );
+      m_tasks.pop_front();
+    }
+
+    task();
+  }
+}
+
+Lobby::ApiConnectionPtr Lobby::RestConnector::acquireConnection()
+{
+  std::lock_guard< std::mutex > lock( m_poolMutex );
+  auto now = std::chrono::steady_clock::now();
+
+  // anything idle past the keep-alive window was most likely closed by the api
+  ApiConnectionPtr pBest;
+  for( auto it = m_connections.begin(); it != m_connections.end(); )
+  {
+    auto& pConnection = *it;
+    if( !pConnection->isOpen() ||
+        ( pConnection->getPendingCount() == 0 && now - pConnection->getLastActive() >= std::chrono::seconds( keepAliveTime ) ) )
+    {
+      pConnection->close();
+      it = m_connections.erase( it );
+      continue;
+    }
 
+    if( !pBest || pConnection->getPendingCount() < pBest->getPendingCount() )
+      pBest = pConnection;
+    ++it;
+  }
+
+  // a busy connection only gets another request once the pool is full, the request is pipelined behind the others
+  if( pBest && ( pBest->getPendingCount() == 0 || m_connections.size() >= std::max< uint16_t >( 1, poolSize ) ) )
+    return pBest;
+
+  auto portPos = restHost.rfind( ':' );
+  auto host = portPos != std::string::npos ? restHost.substr( 0, portPos ) : restHost;
+  auto port = portPos != std::string::npos ? restHost.substr( portPos + 1 ) : std::string( "80" );
+
+  auto pConnection = std::make_shared< ApiConnection >( m_ioContext, host, port );
+  m_connections.push_back( pConnection );
+  return pConnection;
 }
 
-HttpResponse Lobby::RestConnector::requestApi( std::string endpoint, std::string data )
+void Lobby::RestConnector::resetPool()
 {
-  HttpClient client( restHost );
+  std::lock_guard< std::mutex > lock( m_poolMutex );
+  for( auto& pConnection : m_connections )
+    pConnection->close();
+  m_connections.clear();
+}
 
+asio::error_code Lobby::RestConnector::send( const ApiConnectionPtr& pConnection, const std::string& path, const std::string& data,
+                                            bool& reused, ApiResponse& response )
+{
+  struct Result
+  {
+    asio::error_code ec;
+    bool reused{ false };
+    ApiResponse response;
+  };
+
+  auto pPromise = std::make_shared< std::promise< Result > >();
+  auto future = pPromise->get_future();
+
+  pConnection->post( path, data, [ pPromise ]( const asio::error_code& ec, bool reused, ApiResponse response )
+  {
+    pPromise->set_value( { ec, reused, std::move( response ) } );
+  } );
+
+  if( requestTimeout != 0 && future.wait_for( std::chrono::seconds( requestTimeout ) ) != std::future_status::ready )
+  {
+    // the requests pipelined behind this one would wait just as long, they fail with it
+    pConnection->close();
+    reused = false;
+    return asio::error::make_error_code( asio::error::timed_out );
+  }
+
+  auto result = future.get();
+  reused = result.reused;
+  response = std::move( result.response );
+  return result.ec;
+}
+
+std::optional< Lobby::ApiResponse > Lobby::RestConnector::requestApi( const std::string& endpoint, const std::string& data, bool idempotent )
+{
   std::string reqstr = "/sapphire-api/lobby/" + endpoint;
 
-  HttpResponse r;
-  try
+  ApiResponse response;
+  bool reused = false;
+  auto ec = send( acquireConnection(), reqstr, data, reused, response );
+  if( !ec )
+    return response;
+
+  // a request that failed after it was sent may still have been applied by the api
+  if( !reused || !idempotent )
   {
-    r = client.request( "POST", reqstr, data );
+    Logger::error( "{0} failed, Api is not reachable: {1}", endpoint, ec.message() );
+    return std::nullopt;
   }
-  catch( std::exception& e )
+
+  // a pooled connection can be closed by the api between requests, retry once on a fresh one
+  Logger::debug( "{0} failed on pooled connection, reconnecting: {1}", endpoint, ec.message() );
+  ec = send( acquireConnection(), reqstr, data, reused, response );
+  if( ec )
   {
-    Logger::error( "{0} failed, Api is not reachable: {1}", endpoint, e.what() );
-    return nullptr;
+    Logger::error( "{0} failed, Api is not reachable: {1}", endpoint, ec.message() );
+    return std::nullopt;
   }
-  return r;
+
+  return response;
 }
 
 Lobby::LobbySessionPtr Lobby::RestConnector::getSession( char* sId )
 {
   std::string json_string = "{\"sId\": \"" + std::string( sId ) + "\",\"secret\": \"" + serverSecret + "\"}";
 
-  HttpResponse r = requestApi( "checkSession", json_string );
+  auto r = requestApi( "checkSession", json_string, true );
 
-  if( r == nullptr )
+  if( !r )
     return nullptr;
 
-  std::string content = std::string( std::istreambuf_iterator< char >( r->content ), {} );
-  if( r->status_code.find( "200" ) != std::string::npos )
+  const auto& content = r->content;
+  if( r->status == 200 )
   {
     nlohmann::json json;  
 
@@ -87,13 +238,13 @@ bool Lobby::RestConnector::checkNameTaken( std::string name )
 {
   std::string json_string = "{\"name\": \"" + name + "\",\"secret\": \"" + serverSecret + "\"}";
 
-  HttpResponse r = requestApi( "checkNameTaken", json_string );
+  auto r = requestApi( "checkNameTaken", json_string, true );
 
-  if( r == nullptr )
+  if( !r )
     return true;
 
-  std::string content = std::string( std::istreambuf_iterator< char >( r->content ), {} );
-  if( r->status_code.find( "200" ) != std::string::npos )
+  const auto& content = r->content;
+  if( r->status == 200 )
   {
     auto json = nlohmann::json();
 
@@ -121,13 +272,13 @@ uint32_t Lobby::RestConnector::getNextCharId()
 {
   std::string json_string = "{\"secret\": \"" + serverSecret + "\"}";
 
-  HttpResponse r = requestApi( "getNextEntityId", json_string );
+  auto r = requestApi( "getNextEntityId", json_string );
 
-  if( r == nullptr )
+  if( !r )
     return -1;
 
-  std::string content = std::string( std::istreambuf_iterator< char >( r->content ), {} );
-  if( r->status_code.find( "200" ) != std::string::npos )
+  const auto& content = r->content;
+  if( r->status == 200 )
   {
     auto json = nlohmann::json();
 
@@ -160,13 +311,13 @@ uint64_t Lobby::RestConnector::getNextContentId()
 {
   std::string json_string = "{\"secret\": \"" + serverSecret + "\"}";
 
-  HttpResponse r = requestApi( "getNextCharaId", json_string );
+  auto r = requestApi( "getNextCharaId", json_string );
 
-  if( r == nullptr )
+  if( !r )
     return -1;
 
-  std::string content = std::string( std::istreambuf_iterator< char >( r->content ), {} );
-  if( r->status_code.find( "200" ) != std::string::npos )
+  const auto& content = r->content;
+  if( r->status == 200 )
   {
     auto json = nlohmann::json();
 
@@ -195,19 +346,19 @@ uint64_t Lobby::RestConnector::getNextContentId()
   }
 }
 
-CharList Lobby::RestConnector::getCharList( char* sId )
+Lobby::CharList Lobby::RestConnector::getCharList( const std::string& sId )
 {
   std::string json_string = "{\"sId\": \"" + std::string( sId ) + "\",\"secret\": \"" + serverSecret + "\"}";
 
-  HttpResponse r = requestApi( "getCharacterList", json_string );
+  auto r = requestApi( "getCharacterList", json_string, true );
 
   CharList list;
-  if( r == nullptr )
+  if( !r )
     return list;
 
-  std::string content = std::string( std::istreambuf_iterator< char >( r->content ), {} );
+  const auto& content = r->content;
   //Logger::debug( content );
-  if( r->status_code.find( "200" ) != std::string::npos )
+  if( r->status == 200 )
   {
     auto json = nlohmann::json();
 
@@ -251,18 +402,18 @@ CharList Lobby::RestConnector::getCharList( char* sId )
   }
 }
 
-bool Lobby::RestConnector::deleteCharacter( char* sId, std::string name )
+bool Lobby::RestConnector::deleteCharacter( const std::string& sId, std::string name )
 {
   std::string json_string =
     "{\"sId\": \"" + std::string( sId ) + "\",\"secret\": \"" + serverSecret + "\",\"name\": \"" + name + "\"}";
 
-  HttpResponse r = requestApi( "deleteCharacter", json_string );
+  auto r = requestApi( "deleteCharacter", json_string );
 
-  if( r == nullptr )
+  if( !r )
     return false;
 
-  std::string content = std::string( std::istreambuf_iterator< char >( r->content ), {} );
-  if( r->status_code.find( "200" ) != std::string::npos )
+  const auto& content = r->content;
+  if( r->status == 200 )
   {
     auto json = nlohmann::json();
     try
@@ -285,20 +436,20 @@ bool Lobby::RestConnector::deleteCharacter( char* sId, std::string name )
   }
 }
 
-int Lobby::RestConnector::createCharacter( char* sId, std::string name, std::string infoJson )
+int Lobby::RestConnector::createCharacter( const std::string& sId, std::string name, std::string infoJson )
 {
   std::string json_string =
     "{\"sId\": \"" + std::string( sId ) + "\",\"secret\": \"" + serverSecret + "\",\"name\": \"" + name +
     "\",\"infoJson\": \"" + Common::Util::base64Encode( ( uint8_t* ) infoJson.c_str(), infoJson.length() ) + "\"}";
 
-  HttpResponse r = requestApi( "createCharacter", json_string );
+  auto r = requestApi( "createCharacter", json_string );
 
-  if( r == nullptr )
+  if( !r )
     return -1;
 
-  std::string content = std::string( std::istreambuf_iterator< char >( r->content ), {} );
+  const auto& content = r->content;
   //Logger::debug( content );
-  if( r->status_code.find( "200" ) != std::string::npos )
+  if( r->status == 200 )
   {
     auto json = nlohmann::json();
 
@@ -3,13 +3,19 @@
 
 #include <string>
 #include <map>
-
-#include "client_http.hpp"
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "ApiConnection.h"
 #include "Forwards.h"
 
-using HttpClient = SimpleWeb::Client< SimpleWeb::HTTP >;
-using HttpResponse = std::shared_ptr< SimpleWeb::ClientBase< SimpleWeb::HTTP >::Response >;
-
 namespace Sapphire
 {
   class Session;
@@ -19,22 +25,55 @@ namespace Sapphire::Lobby
 {
   class LobbySession;
 
+  // name, entity id, content id, info json
+  using CharList = std::vector< std::tuple< std::string, uint32_t, uint64_t, std::string > >;
+
   class RestConnector
   {
   public:
+    using Task = std::function< void() >;
+
     RestConnector();
 
     ~RestConnector();
 
-    HttpResponse requestApi( std::string endpoint, std::string data );
+    /*!
+     * @brief Sends a request to the lobby api and waits for the response.
+     *
+     * Requests go to an idle pooled connection, or a new one while the pool is not full.
+     * Once every connection is busy they are pipelined on the one with the fewest waiting.
+     * Only idempotent requests are retried when a pooled connection turns out to be closed,
+     * anything that creates or deletes data is sent exactly once.
+     */
+    std::optional< ApiResponse > requestApi( const std::string& endpoint, const std::string& data, bool idempotent = false );
+
+    /*!
+     * @brief Starts the worker threads api requests are run on and the thread their connections run on.
+     */
+    void start( uint16_t workerCount );
+
+    /*!
+     * @brief Finishes queued tasks and joins the workers, then closes the api connections.
+     */
+    void stop();
+
+    /*!
+     * @brief Queues a task on the api workers, the caller never waits for the api.
+     */
+    void post( Task task );
+
+    /*!
+     * @brief Closes all api connections, called when the rest host changes.
+     */
+    void resetPool();
 
     LobbySessionPtr getSession( char* sId );
 
-    int32_t createCharacter( char* sId, std::string name, std::string infoJson );
+    int32_t createCharacter( const std::string& sId, std::string name, std::string infoJson );
 
-    std::vector< std::tuple< std::string, uint32_t, uint64_t, std::string>> getCharList( char* sId );
+    CharList getCharList( const std::string& sId );
 
-    bool deleteCharacter( char* sId, std::string name );
+    bool deleteCharacter( const std::string& sId, std::string name );
 
     bool checkNameTaken( std::string name );
 
@@ -45,6 +84,35 @@ namespace Sapphire::Lobby
     std::string serverSecret;
     std::string restHost;
 
+    // maximum number of keep-alive connections held open to the api server
+    uint16_t poolSize{ 4 };
+    // per request timeout in seconds, 0 disables it
+    uint16_t requestTimeout{ 5 };
+    // idle connections older than this (in seconds) are not reused, keep below the api server's request timeout
+    uint16_t keepAliveTime{ 4 };
+
+  private:
+    ApiConnectionPtr acquireConnection();
+
+    // sends one request and waits for it, at most requestTimeout seconds
+    asio::error_code send( const ApiConnectionPtr& pConnection, const std::string& path, const std::string& data,
+                          bool& reused, ApiResponse& response );
+
+    void workerThread();
+
+    asio::io_context m_ioContext;
+    std::unique_ptr< asio::executor_work_guard< asio::io_context::executor_type > > m_pWork;
+    std::thread m_ioThread;
+
+    std::mutex m_poolMutex;
+    std::vector< ApiConnectionPtr > m_connections;
+
+    std::mutex m_taskMutex;
+    std::condition_variable m_taskCondition;
+    std::deque< Task > m_tasks;
+    bool m_shutdown{ false };
+    std::vector< std::thread > m_workers;
+
   };
 }
 
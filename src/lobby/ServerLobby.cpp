@@ -76,6 +76,8 @@ namespace Sapphire::Lobby
 
     Logger::info( "Lobby server running on {0}:{1}", m_ip, m_port );
 
+    g_restConnector.start( m_config.network.restWorkers );
+
     std::vector< std::thread > threadGroup;
 
     threadGroup.emplace_back( std::bind( &Sapphire::Network::Hive::run, hive.get() ) );
@@ -84,6 +86,8 @@ namespace Sapphire::Lobby
       if( thread.joinable() )
         thread.join();
 
+    g_restConnector.stop();
+
   }
 
   bool ServerLobby::loadSettings( int32_t argc, char* argv[] )
@@ -116,6 +120,10 @@ namespace Sapphire::Lobby
 
     m_config.network.listenIp = m_pConfig->getValue< std::string >( "Network", "ListenIp", "0.0.0.0" );
     m_config.network.listenPort = m_pConfig->getValue< uint16_t >( "Network", "ListenPort", 54994 );
+    m_config.network.restPoolSize = m_pConfig->getValue< uint16_t >( "Network", "RestPoolSize", 4 );
+    m_config.network.restTimeout = m_pConfig->getValue< uint16_t >( "Network", "RestTimeout", 5 );
+    m_config.network.restKeepAlive = m_pConfig->getValue< uint16_t >( "Network", "RestKeepAlive", 4 );
+    m_config.network.restWorkers = m_pConfig->getValue< uint16_t >( "Network", "RestWorkers", 2 );
 
     std::vector< std::string > args( argv + 1, argv + argc );
     for( size_t i = 0; i + 1 < args.size(); i += 2 )
@@ -163,6 +171,10 @@ namespace Sapphire::Lobby
     g_restConnector.restHost = m_config.global.network.restHost + ":" +
                                std::to_string( m_config.global.network.restPort );
     g_restConnector.serverSecret = m_config.global.general.serverSecret;
+    g_restConnector.poolSize = m_config.network.restPoolSize;
+    g_restConnector.requestTimeout = m_config.network.restTimeout;
+    g_restConnector.keepAliveTime = m_config.network.restKeepAlive;
+    g_restConnector.resetPool();
 
     return true;
   }
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <asio.hpp>
+#include <nlohmann/json.hpp>
+
+#include <Logging/Logger.h>
+#include <Util/Util.h>
+
+#include "Bench.h"
+
+using namespace Sapphire;
+
+namespace
+{
+  struct Endpoint
+  {
+    const char* name;
+    bool needsSession;
+  };
+
+  // read only lobby endpoints, every one of them runs prepared statements against the database
+  const Endpoint endpoints[] =
+  {
+    { "checkNameTaken", false },
+    { "getNextEntityId", false },
+    { "getNextCharaId", false },
+    { "checkSession", true },
+    { "getCharacterList", true },
+  };
+
+  constexpr size_t endpointCount = sizeof( endpoints ) / sizeof( endpoints[ 0 ] );
+
+  struct ClientResult
+  {
+    // request latencies in microseconds, per endpoint
+    std::array< std::vector< uint32_t >, endpointCount > latencies;
+    uint64_t errors{ 0 };
+  };
+
+  /*!
+   * @brief One keep-alive connection to the api, requests are sent one after another
+   */
+  class ApiClient
+  {
+  public:
+    ApiClient( asio::io_context& io, const asio::ip::tcp::resolver::results_type& endpoints ) :
+      m_socket( io )
+    {
+      asio::connect( m_socket, endpoints );
+      m_socket.set_option( asio::ip::tcp::no_delay( true ) );
+    }
+
+    // returns the status code, the body is written to content
+    uint32_t post( const std::string& path, const std::string& body, std::string& content )
+    {
+      std::string request = "POST " + path + " HTTP/1.1\r\n"
+                            "Host: api\r\n"
+                            "Content-Type: application/json\r\n"
+                            "Content-Length: " + std::to_string( body.size() ) + "\r\n\r\n" + body;
+      asio::write( m_socket, asio::buffer( request ) );
+
+      auto headerEnd = asio::read_until( m_socket, asio::dynamic_buffer( m_buffer ), "\r\n\r\n" );
+      std::string header = m_buffer.substr( 0, headerEnd );
+      m_buffer.erase( 0, headerEnd );
+
+      uint32_t status = 0;
+      auto statusStart = header.find( ' ' );
+      if( statusStart != std::string::npos )
+        status = static_cast< uint32_t >( std::stoul( header.substr( statusStart + 1, 3 ) ) );
+
+      size_t contentLength = 0;
+      auto lengthPos = Common::Util::toLowerCopy( header ).find( "content-length:" );
+      if( lengthPos != std::string::npos )
+        contentLength = std::stoul( header.substr( lengthPos + 15 ) );
+
+      if( m_buffer.size() < contentLength )
+        asio::read( m_socket, asio::dynamic_buffer( m_buffer ), asio::transfer_exactly( contentLength - m_buffer.size() ) );
+
+      content = m_buffer.substr( 0, contentLength );
+      m_buffer.erase( 0, contentLength );
+      return status;
+    }
+
+  private:
+    asio::ip::tcp::socket m_socket;
+    std::string m_buffer;
+  };
+
+  std::string makeBody( const Endpoint& endpoint, const std::string& secret, const std::string& sessionId, uint32_t seq )
+  {
+    nlohmann::json json = { { "secret", secret } };
+    if( endpoint.needsSession )
+      json[ "sId" ] = sessionId;
+    if( std::string( endpoint.name ) == "checkNameTaken" )
+      json[ "name" ] = "Load Test" + std::to_string( seq % 1000 );
+    return json.dump();
+  }
+
+  // logs in with the given account, creating it when the login fails
+  std::string getSessionId( asio::io_context& io, const asio::ip::tcp::resolver::results_type& resolved,
+                            const std::string& user, const std::string& pass )
+  {
+    ApiClient client( io, resolved );
+    nlohmann::json json = { { "username", user }, { "pass", pass } };
+    std::string content;
+
+    if( client.post( "/sapphire-api/lobby/login", json.dump(), content ) != 200 &&
+        client.post( "/sapphire-api/lobby/createAccount", json.dump(), content ) != 200 )
+      return {};
+
+    return nlohmann::json::parse( content )[ "sId" ].get< std::string >();
+  }
+
+  uint32_t percentile( const std::vector< uint32_t >& sorted, double fraction )
+  {
+    if( sorted.empty() )
+      return 0;
+    return sorted[ std::min( sorted.size() - 1, static_cast< size_t >( sorted.size() * fraction ) ) ];
+  }
+}
+
+int32_t Sapphire::Bench::runApi( const Options& options )
+{
+  auto host = options.getString( "host", "127.0.0.1" );
+  auto port = options.getString( "port", "80" );
+  auto secret = options.getString( "secret", "default" );
+  auto user = options.getString( "user", "" );
+  auto pass = options.getString( "pass", "" );
+  auto clients = std::max( 1u, options.getUInt( "clients", 16 ) );
+  auto duration = std::max( 1u, options.getUInt( "duration", 10 ) );
+
+  asio::io_context io;
+  asio::ip::tcp::resolver resolver( io );
+  asio::ip::tcp::resolver::results_type resolved;
+  try
+  {
+    resolved = resolver.resolve( host, port );
+  }
+  catch( std::exception& e )
+  {
+    Logger::error( "Could not resolve {0}:{1}: {2}", host, port, e.what() );
+    return 1;
+  }
+
+  std::string sessionId;
+  if( !user.empty() )
+  {
+    try
+    {
+      sessionId = getSessionId( io, resolved, user, pass );
+    }
+    catch( std::exception& e )
+    {
+      Logger::error( "Login failed: {0}", e.what() );
+    }
+
+    if( sessionId.empty() )
+    {
+      Logger::error( "Could not log in as {0}", user );
+      return 1;
+    }
+  }
+
+  std::vector< const Endpoint* > mix;
+  for( const auto& endpoint : endpoints )
+  {
+    if( !endpoint.needsSession || !sessionId.empty() )
+      mix.push_back( &endpoint );
+  }
+
+  Logger::info( "{0} clients against {1}:{2} for {3}s, {4} endpoints", clients, host, port, duration, mix.size() );
+
+  std::atomic< bool > running{ true };
+  std::vector< ClientResult > results( clients );
+  std::vector< std::thread > threads;
+
+  Bench::Stopwatch stopwatch;
+  for( uint32_t i = 0; i < clients; ++i )
+  {
+    threads.emplace_back( [ &, i ]()
+    {
+      auto& result = results[ i ];
+      std::unique_ptr< ApiClient > pClient;
+      std::string content;
+
+      // every client starts at a different endpoint so the mix stays even
+      for( uint32_t seq = i; running; ++seq )
+      {
+        auto& endpoint = *mix[ seq % mix.size() ];
+        auto index = static_cast< size_t >( &endpoint - endpoints );
+        try
+        {
+          if( !pClient )
+            pClient = std::make_unique< ApiClient >( io, resolved );
+
+          Bench::Stopwatch request;
+          auto status = pClient->post( std::string( "/sapphire-api/lobby/" ) + endpoint.name,
+                                       makeBody( endpoint, secret, sessionId, seq ), content );
+          if( status != 200 )
+            ++result.errors;
+          else
+            result.latencies[ index ].push_back( static_cast< uint32_t >( request.elapsedSeconds() * 1000000 ) );
+        }
+        catch( std::exception& )
+        {
+          // the api closed the connection, reconnect on the next request
+          ++result.errors;
+          pClient.reset();
+        }
+      }
+    } );
+  }
+
+  std::this_thread::sleep_for( std::chrono::seconds( duration ) );
+  running = false;
+  for( auto& thread : threads )
+    thread.join();
+  auto seconds = stopwatch.elapsedSeconds();
+
+  uint64_t total = 0;
+  uint64_t errors = 0;
+  for( size_t e = 0; e < endpointCount; ++e )
+  {
+    std::vector< uint32_t > latencies;
+    for( auto& result : results )
+      latencies.insert( latencies.end(), result.latencies[ e ].begin(), result.latencies[ e ].end() );
+
+    if( latencies.empty() )
+      continue;
+
+    std::sort( latencies.begin(), latencies.end() );
+    total += latencies.size();
+    Logger::info( "  {0:<18} {1:>10.0f} req/s  p50 {2:>7}us  p99 {3:>7}us  max {4:>7}us",
+                  endpoints[ e ].name, latencies.size() / seconds, percentile( latencies, 0.5 ),
+                  percentile( latencies, 0.99 ), latencies.back() );
+  }
+
+  for( auto& result : results )
+    errors += result.errors;
+
+  Logger::info( "  {0:<18} {1:>10.0f} req/s  {2} errors", "total", total / seconds, errors );
+  return errors == 0 ? 0 : 1;
+}
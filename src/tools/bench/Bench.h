@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Sapphire::Bench
+{
+  /*!
+   * @brief "--name value" options following the benchmark name
+   */
+  class Options
+  {
+  public:
+    Options( int32_t argc, char* argv[] );
+
+    uint32_t getUInt( const std::string& name, uint32_t defaultValue ) const;
+
+    std::string getString( const std::string& name, const std::string& defaultValue ) const;
+
+  private:
+    std::map< std::string, std::string > m_values;
+  };
+
+  class Stopwatch
+  {
+  public:
+    Stopwatch() :
+      m_start( std::chrono::steady_clock::now() )
+    {
+    }
+
+    double elapsedSeconds() const
+    {
+      return std::chrono::duration< double >( std::chrono::steady_clock::now() - m_start ).count();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  // comma separated list of numbers, "64,512,4096"
+  std::vector< uint32_t > parseList( const std::string& value );
+
+  int32_t runCrypt( const Options& options );
+
+  int32_t runApi( const Options& options );
+
+  int32_t runChat( const Options& options );
+
+  int32_t runContentFinder( const Options& options );
+
+  int32_t runLoot( const Options& options );
+
+  int32_t runRng( const Options& options );
+
+  int32_t runCalcStats( const Options& options );
+
+  int32_t runInRange( const Options& options );
+
+  int32_t runMarket( const Options& options );
+
+}
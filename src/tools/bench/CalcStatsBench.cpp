@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <Exd/ExdData.h>
+#include <Logging/Logger.h>
+#include <Random/RNGMgr.h>
+#include <Service.h>
+
+#include "Actor/Chara.h"
+#include "Math/CalcStats.h"
+
+#include "Bench.h"
+
+using namespace Sapphire;
+using namespace Sapphire::Math;
+
+namespace
+{
+  // a level 50 gladiator with fixed stats, nothing of it touches the world
+  class BenchChara : public Entity::Chara
+  {
+  public:
+    BenchChara() :
+      Chara( Common::ObjKind::BattleNpc )
+    {
+      setClass( Common::ClassJob::Gladiator );
+      setStatValue( Common::BaseParam::Strength, 400 );
+      setStatValue( Common::BaseParam::AttackPower, 400 );
+      setStatValue( Common::BaseParam::Determination, 350 );
+      setStatValue( Common::BaseParam::CriticalHit, 500 );
+    }
+
+    uint8_t getLevel() const override
+    {
+      return 50;
+    }
+  };
+
+  struct CalcResult
+  {
+    double seconds;
+    double totalDamage;
+    uint64_t criticals;
+  };
+
+  void accumulate( CalcResult& result, const CalcStats::DamageResult& damage )
+  {
+    result.totalDamage += damage.first;
+    if( damage.second == Common::CalcResultType::TypeCriticalDamageHp )
+      ++result.criticals;
+  }
+
+  // what Action did before: the whole formula for every hit target
+  CalcResult perTarget( const Entity::Chara& chara, uint32_t casts, uint32_t targets )
+  {
+    CalcResult result{};
+    Bench::Stopwatch stopwatch;
+    for( uint32_t c = 0; c < casts; ++c )
+    {
+      for( uint32_t t = 0; t < targets; ++t )
+        accumulate( result, CalcStats::calcActionDamage( chara, 150, Common::BaseParam::Strength, 50.f ) );
+    }
+    result.seconds = stopwatch.elapsedSeconds();
+    return result;
+  }
+
+  CalcResult batch( const Entity::Chara& chara, uint32_t casts, uint32_t targets )
+  {
+    CalcResult result{};
+    std::vector< CalcStats::DamageResult > damage( targets );
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t c = 0; c < casts; ++c )
+    {
+      CalcStats::calcActionDamage( chara, 150, Common::BaseParam::Strength, 50.f, damage.data(), damage.size() );
+      for( const auto& entry : damage )
+        accumulate( result, entry );
+    }
+    result.seconds = stopwatch.elapsedSeconds();
+    return result;
+  }
+
+  void report( const char* name, uint64_t calcs, const CalcResult& result )
+  {
+    Logger::info( "  {0:<10} {1:>12.0f} damage calcs/s {2:>7.1f} ns/calc  ( average {3:.1f}, {4:.2f}% critical )",
+                  name, calcs / result.seconds, result.seconds * 1000000000.0 / calcs,
+                  result.totalDamage / calcs, 100.0 * result.criticals / calcs );
+  }
+}
+
+int32_t Sapphire::Bench::runCalcStats( const Options& options )
+{
+  auto calcs = std::max( 1u, options.getUInt( "calcs", 5000000 ) );
+  auto targetCounts = parseList( options.getString( "targets", "1,8,32" ) );
+  auto dataPath = options.getString( "data", "" );
+
+  Common::Service< Common::Random::RNGMgr >::set( std::make_shared< Common::Random::RNGMgr >( 0x41 ) );
+
+  if( !dataPath.empty() )
+  {
+    auto pExdData = std::make_shared< Data::ExdData >();
+    if( !pExdData->init( dataPath ) )
+    {
+      Logger::error( "Could not load exd data from {0}", dataPath );
+      return 1;
+    }
+    Common::Service< Data::ExdData >::set( pExdData );
+
+    if( !CalcStats::init() )
+      return 1;
+  }
+  else
+    Logger::warn( "No --data given, without the class job tables weapon damage is 0 and so is every result" );
+
+  BenchChara chara;
+
+  for( auto targets : targetCounts )
+  {
+    targets = std::max( 1u, targets );
+    auto casts = std::max( 1u, calcs / targets );
+    const uint64_t total = static_cast< uint64_t >( casts ) * targets;
+
+    Logger::info( "{0} targets per cast, {1} casts", targets, casts );
+    report( "per target", total, perTarget( chara, casts, targets ) );
+    report( "batch", total, batch( chara, casts, targets ) );
+  }
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Logging/Logger.h>
+#include <Network/GamePacket.h>
+#include <Network/PacketContainer.h>
+#include <Network/PacketDef/Chat/ServerChatDef.h>
+
+#include "Bench.h"
+
+using namespace Sapphire;
+using namespace Sapphire::Network::Packets;
+
+namespace
+{
+  using ChatPacket = ChatChannelPacket< Server::FFXIVChatToChannel >;
+
+  // hashing every buffer would cost more than building it, only every this many members are checked
+  const uint32_t CHECKSUM_SAMPLE = 16;
+
+  struct FanOutResult
+  {
+    double seconds;
+    uint64_t checksum;
+  };
+
+  void fillMessage( ChatPacket& packet, uint64_t channelId, const std::string& message )
+  {
+    strcpy( packet.data().message, message.c_str() );
+    strcpy( packet.data().speakerName, "Bench Speaker" );
+    packet.data().channelID = channelId;
+    packet.data().speakerCharacterID = 1;
+    packet.data().speakerEntityID = 1;
+  }
+
+  // the segment without the ipc timestamp, the container header and the packet carry the time
+  uint64_t checksum( const std::vector< uint8_t >& buffer )
+  {
+    const size_t timestamp = sizeof( FFXIVARR_PACKET_HEADER ) + sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ) +
+                             offsetof( FFXIVARR_IPC_HEADER, timestamp );
+
+    uint64_t sum = 0;
+    for( size_t i = sizeof( FFXIVARR_PACKET_HEADER ); i < buffer.size(); ++i )
+    {
+      if( i < timestamp || i >= timestamp + sizeof( uint32_t ) )
+        sum = sum * 31 + buffer[ i ];
+    }
+    return sum;
+  }
+
+  // what ChatChannelMgr did before: one packet per member, addressed to that member
+  FanOutResult fanOutPerMember( const std::vector< uint32_t >& members, uint32_t messages, const std::string& message )
+  {
+    uint64_t sum = 0;
+    std::vector< uint8_t > buffer;
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t m = 0; m < messages; ++m )
+    {
+      for( auto id : members )
+      {
+        auto pPacket = std::make_shared< ChatPacket >( id, id );
+        fillMessage( *pPacket, m, message );
+
+        PacketContainer container( id );
+        container.addPacket( pPacket );
+        container.fillSendBuffer( buffer );
+        if( id % CHECKSUM_SAMPLE == 0 )
+          sum += checksum( buffer );
+      }
+    }
+    return { stopwatch.elapsedSeconds(), sum };
+  }
+
+  // one packet per message, each connection's container addresses it to its member.
+  // serialized makes the packet into the shared bytes once, as ChatChannelMgr does, otherwise every
+  // container serializes the packet again
+  FanOutResult fanOutShared( const std::vector< uint32_t >& members, uint32_t messages, const std::string& message,
+                             bool serialized )
+  {
+    uint64_t sum = 0;
+    std::vector< uint8_t > buffer;
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t m = 0; m < messages; ++m )
+    {
+      auto pChat = std::make_shared< ChatPacket >( 0, 0 );
+      pChat->setSourceIsRecipient( true );
+      fillMessage( *pChat, m, message );
+
+      FFXIVPacketBasePtr pPacket = pChat;
+      if( serialized )
+        pPacket = std::make_shared< FFXIVSharedPacket >( *pChat );
+
+      for( auto id : members )
+      {
+        PacketContainer container( id );
+        container.addPacket( pPacket );
+        container.fillSendBuffer( buffer );
+        if( id % CHECKSUM_SAMPLE == 0 )
+          sum += checksum( buffer );
+      }
+    }
+    return { stopwatch.elapsedSeconds(), sum };
+  }
+
+  void report( const char* name, size_t members, uint32_t messages, const FanOutResult& result )
+  {
+    auto deliveries = static_cast< double >( members ) * messages;
+    Logger::info( "  {0:<12} {1:>10.0f} messages/s {2:>12.0f} deliveries/s {3:>8.1f} ns/delivery  ( checksum {4:016x} )",
+                  name, messages / result.seconds, deliveries / result.seconds,
+                  result.seconds * 1000000000.0 / deliveries, result.checksum );
+  }
+}
+
+int32_t Sapphire::Bench::runChat( const Options& options )
+{
+  auto memberCounts = parseList( options.getString( "members", "500,5000" ) );
+  auto messages = std::max( 1u, options.getUInt( "messages", 200 ) );
+  auto length = std::min( 1000u, options.getUInt( "length", 100 ) );
+
+  std::string message( length, 'a' );
+
+  for( auto count : memberCounts )
+  {
+    std::vector< uint32_t > members;
+    for( uint32_t i = 0; i < count; ++i )
+      members.push_back( 0x10000000 + i );
+
+    Logger::info( "{0} members, {1} messages of {2} characters", count, messages, length );
+
+    // all send the same bytes to every member, so the checksums match
+    report( "per member", members.size(), messages, fanOutPerMember( members, messages, message ) );
+    report( "shared", members.size(), messages, fanOutShared( members, messages, message, false ) );
+    report( "serialized", members.size(), messages, fanOutShared( members, messages, message, true ) );
+  }
+
+  return 0;
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <Common.h>
+#include <Logging/Logger.h>
+
+#include "ContentFinder/ContentFinder.h"
+
+#include "Bench.h"
+
+using namespace Sapphire;
+
+namespace
+{
+  struct Registration
+  {
+    Common::Role role;
+    World::RoleBucket bucket;
+    std::vector< uint32_t > contentIds;
+  };
+
+  struct MatchResult
+  {
+    double seconds;
+    // time spent on each registration, including the matching it triggered, in nanoseconds
+    std::vector< uint32_t > latencies;
+    uint64_t parties;
+    uint64_t matched;
+  };
+
+  using Required = std::array< uint8_t, static_cast< size_t >( World::RoleBucket::Count ) >;
+
+  // the first half are light parties, the rest full parties
+  Required getRequired( uint32_t contentId, uint32_t contentCount )
+  {
+    if( contentId < contentCount / 2 )
+      return { 1, 1, 2 };
+    return { 2, 2, 4 };
+  }
+
+  std::vector< Registration > makeRegistrations( uint32_t count, uint32_t contentCount, uint32_t perPlayer )
+  {
+    std::mt19937 engine( 0xcf );
+    std::uniform_int_distribution< uint32_t > roleRoll( 0, 9 );
+    std::uniform_int_distribution< uint32_t > contentRoll( 0, contentCount - 1 );
+
+    std::vector< Registration > registrations( count );
+    for( auto& registration : registrations )
+    {
+      // 2 in 10 tanks, 2 in 10 healers, the rest dps
+      auto roll = roleRoll( engine );
+      registration.role = roll < 2 ? Common::Role::Tank : roll < 4 ? Common::Role::Healer : Common::Role::Melee;
+      registration.bucket = roll < 2 ? World::RoleBucket::Tank : roll < 4 ? World::RoleBucket::Healer : World::RoleBucket::Dps;
+
+      while( registration.contentIds.size() < perPlayer )
+      {
+        auto contentId = contentRoll( engine );
+        if( std::find( registration.contentIds.begin(), registration.contentIds.end(), contentId ) == registration.contentIds.end() )
+          registration.contentIds.push_back( contentId );
+      }
+    }
+    return registrations;
+  }
+
+  struct OldParty
+  {
+    uint32_t contentId;
+    Required counts{};
+    std::vector< uint32_t > members;
+  };
+
+  // what the content finder did before: every registration scans every queued content for an open slot,
+  // joins all that fit, and a filled party takes its members out of every other content by scanning again
+  MatchResult matchLinear( const std::vector< Registration >& registrations, uint32_t contentCount )
+  {
+    MatchResult result{};
+    result.latencies.reserve( registrations.size() );
+
+    std::unordered_map< uint32_t, OldParty > parties;
+    uint32_t nextRegisterId = 0;
+
+    auto leaveAll = [ & ]( uint32_t playerId, uint32_t exceptId )
+    {
+      for( auto& [ registerId, party ] : parties )
+      {
+        if( registerId == exceptId )
+          continue;
+
+        auto it = std::find( party.members.begin(), party.members.end(), playerId );
+        if( it == party.members.end() )
+          continue;
+
+        party.members.erase( it );
+        --party.counts[ static_cast< size_t >( registrations[ playerId ].bucket ) ];
+      }
+    };
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t playerId = 0; playerId < registrations.size(); ++playerId )
+    {
+      Bench::Stopwatch registration;
+      const auto& player = registrations[ playerId ];
+      const auto bucket = static_cast< size_t >( player.bucket );
+      std::vector< uint32_t > joined;
+
+      for( auto contentId : player.contentIds )
+      {
+        auto required = getRequired( contentId, contentCount );
+        bool found = false;
+
+        for( auto& [ registerId, party ] : parties )
+        {
+          if( party.contentId != contentId || party.counts[ bucket ] >= required[ bucket ] )
+            continue;
+
+          party.members.push_back( playerId );
+          ++party.counts[ bucket ];
+          joined.push_back( registerId );
+          found = true;
+        }
+
+        if( !found )
+        {
+          auto& party = parties[ nextRegisterId ];
+          party.contentId = contentId;
+          party.members.push_back( playerId );
+          ++party.counts[ bucket ];
+          joined.push_back( nextRegisterId++ );
+        }
+      }
+
+      for( auto registerId : joined )
+      {
+        auto partyIt = parties.find( registerId );
+        if( partyIt == parties.end() )
+          continue;
+
+        auto required = getRequired( partyIt->second.contentId, contentCount );
+        if( partyIt->second.counts != required )
+          continue;
+
+        auto members = partyIt->second.members;
+        for( auto member : members )
+          leaveAll( member, registerId );
+
+        ++result.parties;
+        result.matched += members.size();
+        parties.erase( registerId );
+      }
+
+      result.latencies.push_back( static_cast< uint32_t >( registration.elapsedSeconds() * 1000000000 ) );
+    }
+    result.seconds = stopwatch.elapsedSeconds();
+    return result;
+  }
+
+  // current: one matching queue per content with per role buckets, a party is taken as soon as every slot can be filled
+  MatchResult matchBuckets( const std::vector< Registration >& registrations, uint32_t contentCount )
+  {
+    MatchResult result{};
+    result.latencies.reserve( registrations.size() );
+
+    std::vector< std::shared_ptr< World::QueuedContent > > queues;
+    for( uint32_t contentId = 0; contentId < contentCount; ++contentId )
+    {
+      auto queue = std::make_shared< World::QueuedContent >( contentId, contentId );
+      auto required = getRequired( contentId, contentCount );
+      for( size_t bucket = 0; bucket < required.size(); ++bucket )
+        queue->setRequired( static_cast< World::RoleBucket >( bucket ), required[ bucket ] );
+      queues.push_back( queue );
+    }
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t playerId = 0; playerId < registrations.size(); ++playerId )
+    {
+      Bench::Stopwatch registration;
+      const auto& player = registrations[ playerId ];
+
+      auto pQPlayer = std::make_shared< World::QueuedPlayer >( playerId, playerId, 0, player.role, 90, 0 );
+      for( auto contentId : player.contentIds )
+        queues[ contentId ]->queuePlayer( pQPlayer );
+
+      for( auto contentId : player.contentIds )
+      {
+        auto& queue = queues[ contentId ];
+        while( queue->canFillParty() )
+        {
+          auto members = queue->takeParty();
+          for( auto& member : members )
+          {
+            for( auto otherId : registrations[ member->getEntityId() ].contentIds )
+              queues[ otherId ]->withdrawPlayer( member );
+          }
+
+          ++result.parties;
+          result.matched += members.size();
+        }
+      }
+
+      result.latencies.push_back( static_cast< uint32_t >( registration.elapsedSeconds() * 1000000000 ) );
+    }
+    result.seconds = stopwatch.elapsedSeconds();
+    return result;
+  }
+
+  uint32_t percentile( const std::vector< uint32_t >& sorted, double fraction )
+  {
+    if( sorted.empty() )
+      return 0;
+    return sorted[ std::min( sorted.size() - 1, static_cast< size_t >( sorted.size() * fraction ) ) ];
+  }
+
+  void report( const char* name, MatchResult& result )
+  {
+    std::sort( result.latencies.begin(), result.latencies.end() );
+    Logger::info( "  {0:<14} {1:>10.0f} registrations/s  p50 {2:>8}ns  p99 {3:>8}ns  max {4:>9}ns  {5} parties, {6} players matched",
+                  name, result.latencies.size() / result.seconds, percentile( result.latencies, 0.5 ),
+                  percentile( result.latencies, 0.99 ), result.latencies.back(), result.parties, result.matched );
+  }
+}
+
+int32_t Sapphire::Bench::runContentFinder( const Options& options )
+{
+  auto registrations = std::max( 1u, options.getUInt( "registrations", 50000 ) );
+  auto contents = std::max( 1u, options.getUInt( "contents", 40 ) );
+  auto perPlayer = std::min( contents, std::max( 1u, options.getUInt( "perPlayer", 3 ) ) );
+
+  auto list = makeRegistrations( registrations, contents, perPlayer );
+
+  Logger::info( "{0} registrations over {1} contents, {2} contents each", registrations, contents, perPlayer );
+
+  // the old way forms parties differently, the party counts are not expected to match
+  auto buckets = matchBuckets( list, contents );
+  report( "role buckets", buckets );
+  auto linear = matchLinear( list, contents );
+  report( "linear scan", linear );
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Crypt/blowfish.h>
+#include <Logging/Logger.h>
+
+#include "Bench.h"
+
+using namespace Sapphire;
+
+namespace
+{
+  struct CryptResult
+  {
+    double seconds;
+    uint64_t checksum;
+  };
+
+  uint64_t checksum( const std::vector< uint8_t >& data )
+  {
+    uint64_t sum = 0;
+    for( auto value : data )
+      sum = sum * 31 + value;
+    return sum;
+  }
+
+  // what the lobby did before: every segment built its own cipher and key schedule
+  CryptResult decodeWithKeySchedule( uint8_t* key, std::vector< uint8_t >& data, uint32_t size, uint32_t segments )
+  {
+    Bench::Stopwatch stopwatch;
+    for( uint32_t i = 0; i < segments; ++i )
+    {
+      BlowFish blowFish;
+      blowFish.initialize( key, 0x10 );
+      blowFish.Decode( data.data(), data.data(), size );
+    }
+    return { stopwatch.elapsedSeconds(), checksum( data ) };
+  }
+
+  CryptResult decodeCached( BlowFish& blowFish, std::vector< uint8_t >& data, uint32_t size, uint32_t segments )
+  {
+    Bench::Stopwatch stopwatch;
+    for( uint32_t i = 0; i < segments; ++i )
+      blowFish.Decode( data.data(), data.data(), size );
+    return { stopwatch.elapsedSeconds(), checksum( data ) };
+  }
+
+  CryptResult decodeSegment( const BlowFish& blowFish, std::vector< uint8_t >& data, uint32_t size, uint32_t segments )
+  {
+    Bench::Stopwatch stopwatch;
+    for( uint32_t i = 0; i < segments; ++i )
+      blowFish.DecodeSegment( data.data(), size );
+    return { stopwatch.elapsedSeconds(), checksum( data ) };
+  }
+
+  void report( const char* name, uint32_t size, uint32_t segments, const CryptResult& result )
+  {
+    auto perSecond = segments / result.seconds;
+    Logger::info( "  {0:<22} {1:>12.0f} segments/s {2:>9.1f} MB/s  ( checksum {3:016x} )",
+                  name, perSecond, perSecond * size / ( 1024.0 * 1024.0 ), result.checksum );
+  }
+}
+
+int32_t Sapphire::Bench::runCrypt( const Options& options )
+{
+  auto segments = options.getUInt( "segments", 100000 );
+  auto sizes = parseList( options.getString( "sizes", "64,512,4096" ) );
+
+  uint8_t key[ 0x10 ];
+  std::mt19937 engine( 0x5a );
+  for( auto& value : key )
+    value = static_cast< uint8_t >( engine() );
+
+  BlowFish blowFish;
+  blowFish.initialize( key, 0x10 );
+
+  for( auto size : sizes )
+  {
+    // segments are decoded in place, the buffer is sized for the padded block count
+    size = ( size + 7 ) & ~7u;
+    std::vector< uint8_t > data( size );
+    for( auto& value : data )
+      value = static_cast< uint8_t >( engine() );
+
+    Logger::info( "{0} byte segments, {1} each", size, segments );
+
+    // all three run the same number of decodes over the same input, so the checksums match
+    auto source = data;
+    report( "key schedule + Decode", size, segments, decodeWithKeySchedule( key, data, size, segments ) );
+    data = source;
+    report( "cached Decode", size, segments, decodeCached( blowFish, data, size, segments ) );
+    data = source;
+    report( "cached DecodeSegment", size, segments, decodeSegment( blowFish, data, size, segments ) );
+  }
+
+  return 0;
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Common.h>
+#include <Logging/Logger.h>
+
+#include "Actor/GameObject.h"
+#include "Territory/Territory.h"
+
+#include "Bench.h"
+
+using namespace Sapphire;
+
+namespace
+{
+  // territory ticks are 100ms apart, the sweep runs every this many of them
+  const uint32_t SWEEP_TICKS = Territory::IN_RANGE_SWEEP_INTERVAL / 100;
+
+  struct Walker
+  {
+    Entity::GameObjectPtr pActor;
+    float heading;
+  };
+
+  struct MoveResult
+  {
+    double seconds;
+    uint64_t moves;
+    // in range set entries summed over every check
+    uint64_t inRange;
+    // pairs within the in range distance missing from the in range sets, summed over every check
+    uint64_t missed;
+    uint32_t checks;
+  };
+
+  std::vector< Walker > makeWalkers( Territory& territory, uint32_t count, float area )
+  {
+    std::mt19937 engine( 0x50 );
+    std::uniform_real_distribution< float > posRoll( -area / 2, area / 2 );
+    std::uniform_real_distribution< float > headingRoll( 0.f, 6.2832f );
+
+    std::vector< Walker > walkers( count );
+    for( auto& walker : walkers )
+    {
+      // event npcs take no part in the player and bnpc bookkeeping of the territory
+      walker.pActor = std::make_shared< Entity::GameObject >( Common::ObjKind::EventNpc );
+      walker.pActor->setPos( { posRoll( engine ), 0.f, posRoll( engine ) }, false );
+      walker.heading = headingRoll( engine );
+      territory.pushActor( walker.pActor );
+    }
+    return walkers;
+  }
+
+  // a random walk bouncing off the edges of the area, the same for every run
+  void step( std::vector< Walker >& walkers, std::mt19937& engine, float speed, float area )
+  {
+    std::uniform_real_distribution< float > turnRoll( -0.3f, 0.3f );
+
+    for( auto& walker : walkers )
+    {
+      walker.heading += turnRoll( engine );
+      auto pos = walker.pActor->getPos();
+      pos.x += std::cos( walker.heading ) * speed;
+      pos.z += std::sin( walker.heading ) * speed;
+
+      if( std::abs( pos.x ) > area / 2 || std::abs( pos.z ) > area / 2 )
+      {
+        walker.heading += 3.1416f;
+        pos.x = std::clamp( pos.x, -area / 2, area / 2 );
+        pos.z = std::clamp( pos.z, -area / 2, area / 2 );
+      }
+
+      walker.pActor->setPos( pos, false );
+    }
+  }
+
+  void check( const std::vector< Walker >& walkers, float range, MoveResult& result )
+  {
+    const float rangeSq = range * range;
+    for( size_t i = 0; i < walkers.size(); ++i )
+    {
+      const auto& pActor = walkers[ i ].pActor;
+      result.inRange += pActor->getInRangeActorSet().size();
+
+      for( size_t j = i + 1; j < walkers.size(); ++j )
+      {
+        const auto& pOther = walkers[ j ].pActor;
+        auto dx = pActor->getPos().x - pOther->getPos().x;
+        auto dz = pActor->getPos().z - pOther->getPos().z;
+        if( dx * dx + dz * dz <= rangeSq && !pActor->isInRangeSet( pOther ) )
+          ++result.missed;
+      }
+    }
+    ++result.checks;
+  }
+
+  // forced is what Territory did before, every move checks the 3x3 cells around the actor
+  MoveResult run( uint32_t actors, uint32_t ticks, float speed, float area, bool forced )
+  {
+    MoveResult result{};
+
+    auto pTerritory = std::make_shared< Territory >();
+    auto walkers = makeWalkers( *pTerritory, actors, area );
+    const auto range = pTerritory->getInRangeDistance();
+
+    std::mt19937 engine( 0x51 );
+    for( uint32_t tick = 1; tick <= ticks; ++tick )
+    {
+      step( walkers, engine, speed, area );
+
+      Bench::Stopwatch stopwatch;
+      for( auto& walker : walkers )
+        pTerritory->updateActorPosition( *walker.pActor, forced );
+
+      // the walkers stand in for players, which the sweep checks the cells of again
+      if( !forced && tick % SWEEP_TICKS == 0 )
+      {
+        for( auto& walker : walkers )
+        {
+          pTerritory->sweepInRangeSet( *walker.pActor );
+          pTerritory->updateInRangeCells( walker.pActor );
+        }
+      }
+      result.seconds += stopwatch.elapsedSeconds();
+      result.moves += walkers.size();
+
+      if( tick % 10 == 0 )
+        check( walkers, range, result );
+    }
+
+    // the in range sets point at each other
+    for( auto& walker : walkers )
+      walker.pActor->clearInRangeSet();
+
+    return result;
+  }
+
+  void report( const char* name, uint32_t actors, const MoveResult& result )
+  {
+    auto checks = std::max( 1u, result.checks );
+    Logger::info( "  {0:<12} {1:>10.0f} moves/s {2:>8.1f} ns/move  in range {3:>6.1f} per actor  missed {4:.2f} pairs per check",
+                  name, result.moves / result.seconds, result.seconds * 1000000000.0 / result.moves,
+                  static_cast< double >( result.inRange ) / checks / actors, static_cast< double >( result.missed ) / checks );
+  }
+}
+
+int32_t Sapphire::Bench::runInRange( const Options& options )
+{
+  auto actors = std::max( 2u, options.getUInt( "actors", 1000 ) );
+  auto ticks = std::max( 10u, options.getUInt( "ticks", 600 ) );
+  auto area = static_cast< float >( std::max( 10u, options.getUInt( "area", 400 ) ) );
+  // yalms per 100ms tick, 0.6 is about running speed
+  auto speed = options.getUInt( "speed", 6 ) / 10.f;
+
+  Logger::info( "{0} actors moving {1} yalms per tick in {2}x{2} yalms, {3} ticks", actors, speed, area, ticks );
+
+  report( "every move", actors, run( actors, ticks, speed, area, true ) );
+  report( "incremental", actors, run( actors, ticks, speed, area, false ) );
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Logging/Logger.h>
+#include <Random/RNGMgr.h>
+#include <Service.h>
+
+#include "Manager/LootTableMgr.h"
+
+#include "Bench.h"
+
+using namespace Sapphire;
+using namespace Sapphire::World;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  struct RollResult
+  {
+    double seconds;
+    // picks of the heaviest item, item 0 of every table
+    uint64_t heavyPicks;
+    uint64_t picks;
+  };
+
+  Loot::LootTable makeTable( uint32_t itemCount, bool duplicates, std::mt19937& engine )
+  {
+    std::uniform_int_distribution< uint32_t > weightRoll( 1, 1000 );
+
+    Loot::LootTablePool pool{ "bench", true, duplicates, { 1, 3 }, {} };
+    for( uint32_t i = 0; i < itemCount; ++i )
+    {
+      // one heavy item, so both ways can be checked against its expected share
+      auto weight = i == 0 ? 500 * itemCount : weightRoll( engine );
+      pool.items.push_back( { 1000 + i, weight, false, { 1, 1 } } );
+    }
+
+    return { "bench" + std::to_string( itemCount ) + ( duplicates ? "dup" : "" ), { pool } };
+  }
+
+  // what LootTableMgr did before: copy the pool, then a cumulative scan over its items for every pick
+  const Loot::LootTableItem& pickLinear( Common::Random::RNGMgr& rngMgr, const std::vector< Loot::LootTableItem >& items )
+  {
+    uint32_t totalWeight = 0;
+    for( const auto& item : items )
+      totalWeight += item.weight;
+
+    auto roll = rngMgr.getRandGenerator< uint32_t >( 1, totalWeight ).next();
+
+    uint32_t cumulative = 0;
+    for( const auto& item : items )
+    {
+      cumulative += item.weight;
+      if( roll <= cumulative )
+        return item;
+    }
+    return items.back();
+  }
+
+  RollResult rollLinear( Common::Random::RNGMgr& rngMgr, const Loot::LootTable& table, uint32_t rolls )
+  {
+    RollResult result{};
+    const auto heavyId = table.pools.front().items.front().id;
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t r = 0; r < rolls; ++r )
+    {
+      Loot::LootTableResult loot;
+      for( const auto& pool : table.pools )
+      {
+        auto picks = rngMgr.getRandGenerator< uint32_t >( pool.pick.min, pool.pick.max ).next();
+        std::vector< Loot::LootTableItem > available = pool.items;
+
+        for( uint32_t i = 0; i < picks && !available.empty(); ++i )
+        {
+          const auto& item = pickLinear( rngMgr, available );
+          auto quantity = rngMgr.getRandGenerator< uint32_t >( item.quantity.min, item.quantity.max ).next();
+          loot.items.push_back( { item.id, quantity, item.isHq } );
+
+          if( !pool.duplicates )
+          {
+            auto id = item.id;
+            available.erase( std::remove_if( available.begin(), available.end(),
+                                             [ id ]( const auto& x ) { return x.id == id; } ), available.end() );
+          }
+        }
+      }
+
+      result.picks += loot.items.size();
+      result.heavyPicks += std::count_if( loot.items.begin(), loot.items.end(),
+                                         [ heavyId ]( const auto& item ) { return item.id == heavyId; } );
+    }
+    result.seconds = stopwatch.elapsedSeconds();
+    return result;
+  }
+
+  RollResult rollAlias( World::Manager::LootTableMgr& lootTableMgr, const Loot::LootTable& table, uint32_t rolls )
+  {
+    RollResult result{};
+    const auto heavyId = table.pools.front().items.front().id;
+    const auto id = lootTableMgr.getLootTableId( table.lootTable );
+
+    Loot::LootTableResult loot;
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t r = 0; r < rolls; ++r )
+    {
+      loot.items.clear();
+      lootTableMgr.rollLoot( id, loot );
+
+      result.picks += loot.items.size();
+      result.heavyPicks += std::count_if( loot.items.begin(), loot.items.end(),
+                                         [ heavyId ]( const auto& item ) { return item.id == heavyId; } );
+    }
+    result.seconds = stopwatch.elapsedSeconds();
+    return result;
+  }
+
+  void report( const char* name, uint32_t rolls, const RollResult& result )
+  {
+    Logger::info( "  {0:<8} {1:>12.0f} rolls/s {2:>8.1f} ns/roll  heavy item {3:>6.2f}% of {4} picks",
+                  name, rolls / result.seconds, result.seconds * 1000000000.0 / rolls,
+                  100.0 * result.heavyPicks / std::max< uint64_t >( result.picks, 1 ), result.picks );
+  }
+}
+
+int32_t Sapphire::Bench::runLoot( const Options& options )
+{
+  auto rolls = std::max( 1u, options.getUInt( "rolls", 1000000 ) );
+  auto itemCounts = parseList( options.getString( "items", "8,64,512" ) );
+
+  auto pRNGMgr = std::make_shared< Common::Random::RNGMgr >( 0x100 );
+  Common::Service< Common::Random::RNGMgr >::set( pRNGMgr );
+
+  // LootTableMgr reads its tables from json, the generated ones go through the same path
+  std::mt19937 engine( 0x100 );
+  std::vector< Loot::LootTable > tables;
+  auto dir = fs::temp_directory_path() / "sapphire_bench_loot";
+  fs::remove_all( dir );
+  fs::create_directories( dir );
+
+  for( auto itemCount : itemCounts )
+  {
+    for( auto duplicates : { true, false } )
+    {
+      tables.push_back( makeTable( std::max( 2u, itemCount ), duplicates, engine ) );
+      std::ofstream( dir / ( tables.back().lootTable + ".json" ) ) << nlohmann::json( tables.back() ).dump();
+    }
+  }
+
+  World::Manager::LootTableMgr lootTableMgr;
+  auto cached = lootTableMgr.cacheLootTables( dir.string() );
+  fs::remove_all( dir );
+  if( !cached )
+  {
+    Logger::error( "Could not cache the generated loot tables" );
+    return 1;
+  }
+
+  for( const auto& table : tables )
+  {
+    const auto& pool = table.pools.front();
+    uint64_t totalWeight = 0;
+    for( const auto& item : pool.items )
+      totalWeight += item.weight;
+
+    Logger::info( "{0} items, 1-3 picks, duplicates {1}, {2} rolls, heavy item weight {3:.2f}%",
+                  pool.items.size(), pool.duplicates, rolls, 100.0 * pool.items.front().weight / totalWeight );
+
+    // without duplicates the heavy item is picked once per roll at most, the shares of both ways still match
+    report( "linear", rolls, rollLinear( *pRNGMgr, table, rolls ) );
+    report( "alias", rolls, rollAlias( lootTableMgr, table, rolls ) );
+  }
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Logging/Logger.h>
+
+#include "Market/MarketBoard.h"
+
+#include "Bench.h"
+
+using namespace Sapphire;
+
+namespace
+{
+  const char* const Syllables[] =
+  {
+    "al", "ber", "cor", "dra", "el", "fen", "gar", "hy", "is", "jor", "ka", "lun",
+    "mor", "nes", "or", "pel", "qua", "ril", "sen", "tor", "ur", "vel", "wyn", "xi", "yor", "zan"
+  };
+
+  std::vector< World::MarketBoard::Item > makeItems( uint32_t count )
+  {
+    std::mt19937 engine( 0x35 );
+    std::uniform_int_distribution< size_t > syllableRoll( 0, std::size( Syllables ) - 1 );
+    std::uniform_int_distribution< uint32_t > wordRoll( 2, 4 );
+    std::uniform_int_distribution< uint32_t > categoryRoll( 1, 90 );
+    std::uniform_int_distribution< uint32_t > levelRoll( 1, 90 );
+
+    std::vector< World::MarketBoard::Item > items( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+      auto& item = items[ i ];
+      item.catalogId = i + 1;
+      item.itemSearchCategory = static_cast< uint8_t >( categoryRoll( engine ) );
+      item.maxEquipLevel = static_cast< uint8_t >( levelRoll( engine ) );
+      item.itemLevel = static_cast< uint16_t >( item.maxEquipLevel * 7 );
+
+      // two words, "koral morvel"
+      for( uint32_t word = 0; word < 2; ++word )
+      {
+        if( word != 0 )
+          item.name += ' ';
+        for( uint32_t syllables = wordRoll( engine ); syllables > 0; --syllables )
+          item.name += Syllables[ syllableRoll( engine ) ];
+      }
+    }
+    return items;
+  }
+
+  struct Query
+  {
+    std::string searchStr;
+    uint8_t category;
+  };
+
+  // a third browse a category, the rest type part of an item name
+  std::vector< Query > makeQueries( const std::vector< World::MarketBoard::Item >& items, uint32_t count )
+  {
+    std::mt19937 engine( 0x36 );
+    std::uniform_int_distribution< size_t > itemRoll( 0, items.size() - 1 );
+    std::uniform_int_distribution< uint32_t > lengthRoll( 3, 8 );
+    std::uniform_int_distribution< uint32_t > categoryRoll( 1, 90 );
+
+    std::vector< Query > queries( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+      if( i % 3 == 0 )
+      {
+        queries[ i ].category = static_cast< uint8_t >( categoryRoll( engine ) );
+        continue;
+      }
+
+      const auto& name = items[ itemRoll( engine ) ].name;
+      auto length = std::min< size_t >( lengthRoll( engine ), name.size() );
+      std::uniform_int_distribution< size_t > startRoll( 0, name.size() - length );
+      queries[ i ].searchStr = name.substr( startRoll( engine ), length );
+      queries[ i ].category = 0;
+    }
+    return queries;
+  }
+
+  void report( const char* name, uint64_t operations, double seconds, uint64_t checksum )
+  {
+    Logger::info( "  {0:<12} {1:>12.0f} ops/s {2:>10.1f} ns/op  ( checksum {3:016x} )",
+                  name, operations / seconds, seconds * 1000000000.0 / operations, checksum );
+  }
+}
+
+int32_t Sapphire::Bench::runMarket( const Options& options )
+{
+  auto itemCount = std::max( 1u, options.getUInt( "items", 15000 ) );
+  auto listingCount = std::max( 1u, options.getUInt( "listings", 1000000 ) );
+  auto queryCount = std::max( 1u, options.getUInt( "queries", 20000 ) );
+  auto updateCount = std::max( 1u, options.getUInt( "updates", 1000000 ) );
+
+  Logger::info( "{0} items, {1} listings, {2} searches, {3} order book updates", itemCount, listingCount, queryCount, updateCount );
+
+  auto items = makeItems( itemCount );
+  auto queries = makeQueries( items, queryCount );
+
+  World::MarketBoard board;
+  {
+    Bench::Stopwatch stopwatch;
+    board.setItems( items );
+    Logger::info( "  indexed {0} items, {1} name trigrams in {2:.1f} ms", board.getItemCount(), board.getTrigramCount(),
+                  stopwatch.elapsedSeconds() * 1000.0 );
+  }
+
+  std::mt19937 engine( 0x37 );
+  std::uniform_int_distribution< uint32_t > itemRoll( 1, itemCount );
+  std::uniform_int_distribution< uint32_t > priceRoll( 1, 100000 );
+  std::uniform_int_distribution< uint32_t > stackRoll( 1, 99 );
+
+  // listings
+  {
+    uint64_t sum = 0;
+    Bench::Stopwatch stopwatch;
+    for( uint64_t listingId = 1; listingId <= listingCount; ++listingId )
+    {
+      World::MarketListing listing;
+      listing.listingId = listingId;
+      listing.catalogId = itemRoll( engine );
+      listing.unitPrice = priceRoll( engine );
+      listing.stack = stackRoll( engine );
+      listing.hq = listingId % 4 == 0;
+      sum += listing.unitPrice;
+      board.insertListing( std::move( listing ) );
+    }
+    report( "list", listingCount, stopwatch.elapsedSeconds(), sum );
+  }
+
+  // searching, what the client gets for every page of results
+  {
+    uint64_t sum = 0;
+    Bench::Stopwatch stopwatch;
+    for( const auto& query : queries )
+    {
+      for( const auto& result : board.findItems( query.searchStr, query.category, 0, 0 ) )
+        sum = sum * 31 + result.catalogId + result.quantity;
+    }
+    report( "search", queries.size(), stopwatch.elapsedSeconds(), sum );
+  }
+
+  // opening an item, the cheapest 100 listings
+  {
+    uint64_t sum = 0;
+    Bench::Stopwatch stopwatch;
+    for( uint32_t i = 0; i < queryCount; ++i )
+    {
+      for( auto pListing : board.getListings( itemRoll( engine ), 100 ) )
+        sum += pListing->unitPrice;
+    }
+    report( "listings", queryCount, stopwatch.elapsedSeconds(), sum );
+  }
+
+  // repricing, and a sale relisted under a new id, both move the listing in its order book
+  {
+    uint64_t sum = 0;
+    uint64_t nextListingId = listingCount + 1;
+    std::uniform_int_distribution< uint64_t > listingRoll( 1, listingCount );
+    std::vector< uint64_t > listingIds;
+    listingIds.reserve( listingCount );
+    for( uint64_t listingId = 1; listingId <= listingCount; ++listingId )
+      listingIds.push_back( listingId );
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t i = 0; i < updateCount; ++i )
+    {
+      auto& listingId = listingIds[ listingRoll( engine ) - 1 ];
+      auto pListing = board.getListing( listingId );
+
+      if( i % 2 == 0 )
+      {
+        board.updateListing( listingId, pListing->stack, priceRoll( engine ) );
+        sum += pListing->unitPrice;
+        continue;
+      }
+
+      auto listing = *pListing;
+      board.eraseListing( listingId );
+
+      listing.listingId = listingId = nextListingId++;
+      listing.unitPrice = priceRoll( engine );
+      sum += listing.unitPrice;
+      board.insertListing( std::move( listing ) );
+    }
+    report( "update", updateCount, stopwatch.elapsedSeconds(), sum );
+  }
+
+  Logger::info( "  {0} listings left", board.getListingCount() );
+
+  return 0;
+}
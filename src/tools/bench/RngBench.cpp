@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <Logging/Logger.h>
+#include <Random/RNGMgr.h>
+#include <Random/Xoshiro256.h>
+
+#include "Bench.h"
+
+using namespace Sapphire;
+using namespace Sapphire::Common::Random;
+
+namespace
+{
+  struct RngResult
+  {
+    double seconds;
+    uint64_t sum;
+  };
+
+  template< typename Func >
+  RngResult run( uint32_t count, Func&& func )
+  {
+    uint64_t sum = 0;
+    Bench::Stopwatch stopwatch;
+    for( uint32_t i = 0; i < count; ++i )
+      sum += func();
+    return { stopwatch.elapsedSeconds(), sum };
+  }
+
+  // every thread draws count values through func, returns the combined sum
+  template< typename Func >
+  RngResult runThreads( uint32_t threadCount, uint32_t count, Func&& func )
+  {
+    std::atomic< uint64_t > sum{ 0 };
+    std::vector< std::thread > threads;
+
+    Bench::Stopwatch stopwatch;
+    for( uint32_t t = 0; t < threadCount; ++t )
+    {
+      threads.emplace_back( [ & ]()
+      {
+        uint64_t local = 0;
+        for( uint32_t i = 0; i < count; ++i )
+          local += func();
+        sum += local;
+      } );
+    }
+
+    for( auto& thread : threads )
+      thread.join();
+    return { stopwatch.elapsedSeconds(), sum };
+  }
+
+  void report( const char* name, uint64_t values, const RngResult& result )
+  {
+    Logger::info( "  {0:<34} {1:>14.0f} values/s {2:>7.2f} ns/value  ( sum {3} )",
+                  name, values / result.seconds, result.seconds * 1000000000.0 / values, result.sum );
+  }
+}
+
+int32_t Sapphire::Bench::runRng( const Options& options )
+{
+  auto count = std::max( 1u, options.getUInt( "count", 50000000 ) );
+  auto threadCounts = parseList( options.getString( "threads", "1,4" ) );
+
+  RNGMgr rngMgr( 0x39 );
+
+  Logger::info( "raw engine output, {0} values", count );
+  {
+    std::mt19937 mt( 0x39 );
+    report( "mt19937", count, run( count, [ & ]() { return mt(); } ) );
+
+    auto engine = rngMgr.createEngine( 0 );
+    report( "xoshiro256** next32", count, run( count, [ & ]() { return engine.next32(); } ) );
+  }
+
+  Logger::info( "damage roll in [ 95, 105 ], {0} values", count );
+  {
+    // what RandGenerator did before: a distribution over the shared mt19937, built for every roll
+    std::mt19937 mt( 0x39 );
+    report( "mt19937 uniform_int_distribution", count, run( count, [ & ]()
+    {
+      return std::uniform_int_distribution<>( 95, 105 )( mt );
+    } ) );
+
+    report( "RandGenerator on the thread engine", count, run( count, [ & ]()
+    {
+      return rngMgr.getRandGenerator< uint32_t >( 95, 105 ).next();
+    } ) );
+
+    auto& engine = rngMgr.getRNGEngine();
+    report( "RNGMgr::sample", count, run( count, [ & ]() { return RNGMgr::sample< uint32_t >( engine, 95, 105 ); } ) );
+
+    std::vector< uint32_t > batch( 1024 );
+    report( "RNGMgr::fill, 1024 per call", count, run( count / 1024, [ & ]()
+    {
+      rngMgr.fill< uint32_t >( batch.data(), batch.size(), 95, 105 );
+      uint64_t sum = 0;
+      for( auto value : batch )
+        sum += value;
+      return sum;
+    } ) );
+  }
+
+  for( auto threadCount : threadCounts )
+  {
+    threadCount = std::max( 1u, threadCount );
+    const uint64_t values = static_cast< uint64_t >( count ) * threadCount;
+    Logger::info( "{0} threads, {1} damage rolls each", threadCount, count );
+
+    // a single mt19937 shared between threads needs a lock to be safe at all
+    std::mt19937 mt( 0x39 );
+    std::mutex mtMutex;
+    report( "shared mt19937 behind a mutex", values, runThreads( threadCount, count, [ & ]()
+    {
+      std::lock_guard< std::mutex > lock( mtMutex );
+      return std::uniform_int_distribution<>( 95, 105 )( mt );
+    } ) );
+
+    report( "xoshiro256** per thread", values, runThreads( threadCount, count, [ & ]()
+    {
+      return RNGMgr::sample< uint32_t >( rngMgr.getRNGEngine(), 95, 105 );
+    } ) );
+  }
+
+  return 0;
+}
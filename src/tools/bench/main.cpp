@@ -0,0 +1,111 @@
+#include <cstring>
+
+#include <Logging/Logger.h>
+
+#include "Bench.h"
+
+using namespace Sapphire;
+using namespace Sapphire::Bench;
+
+namespace
+{
+  struct BenchEntry
+  {
+    const char* name;
+    const char* description;
+    int32_t ( *run )( const Options& );
+  };
+
+  const BenchEntry benches[] =
+  {
+    { "crypt", "lobby blowfish, key schedule per segment against a cached schedule\n"
+               "\t\t --segments <count> ( default 100000 ) --sizes <bytes,bytes,...> ( default 64,512,4096 )", &runCrypt },
+    { "api", "load test of the lobby api endpoints against a running api server and its database\n"
+             "\t\t --host <host> ( default 127.0.0.1 ) --port <port> ( default 80 ) --secret <serverSecret> ( default default )\n"
+             "\t\t --clients <count> ( default 16 ) --duration <seconds> ( default 10 )\n"
+             "\t\t --user <name> --pass <password> ( adds checkSession and getCharacterList, the account is created if needed )", &runApi },
+    { "chat", "chat channel fan-out, a packet per member against one shared packet\n"
+              "\t\t --members <count,count,...> ( default 500,5000 ) --messages <count> ( default 200 ) --length <characters> ( default 100 )", &runChat },
+    { "cf", "content finder matching, role buckets against the old scan over every queued content\n"
+            "\t\t --registrations <count> ( default 50000 ) --contents <count> ( default 40 ) --perPlayer <count> ( default 3 )", &runContentFinder },
+    { "loot", "loot table rolls, the old cumulative weight scan against the compiled alias tables\n"
+              "\t\t --rolls <count> ( default 1000000 ) --items <count,count,...> ( default 8,64,512 )", &runLoot },
+    { "rng", "random numbers, mt19937 and its distributions against the xoshiro256** thread engines of RNGMgr\n"
+             "\t\t --count <values> ( default 50000000 ) --threads <count,count,...> ( default 1,4 )", &runRng },
+    { "calcstats", "action damage for every target of a cast, the whole formula per target against the batch overload\n"
+                   "\t\t --calcs <count> ( default 5000000 ) --targets <count,count,...> ( default 1,8,32 )\n"
+                   "\t\t --data <sqpack path> ( loads the class job tables, without it weapon damage is 0 )", &runCalcStats },
+    { "inrange", "in range set updates of moving actors, the 3x3 cells checked on every move against the incremental updates\n"
+                 "\t\t --actors <count> ( default 1000 ) --ticks <count> ( default 600 ) --area <yalms> ( default 400 )\n"
+                 "\t\t --speed <tenths of a yalm per tick> ( default 6 )", &runInRange },
+    { "market", "market board listing, item search, opening an item and order book updates on generated items\n"
+                "\t\t --items <count> ( default 15000 ) --listings <count> ( default 1000000 )\n"
+                "\t\t --queries <count> ( default 20000 ) --updates <count> ( default 1000000 )", &runMarket },
+  };
+}
+
+Options::Options( int32_t argc, char* argv[] )
+{
+  for( int32_t i = 0; i + 1 < argc; i += 2 )
+  {
+    if( std::strncmp( argv[ i ], "--", 2 ) == 0 )
+      m_values[ argv[ i ] + 2 ] = argv[ i + 1 ];
+  }
+}
+
+uint32_t Options::getUInt( const std::string& name, uint32_t defaultValue ) const
+{
+  auto it = m_values.find( name );
+  return it != m_values.end() ? static_cast< uint32_t >( std::stoul( it->second ) ) : defaultValue;
+}
+
+std::string Options::getString( const std::string& name, const std::string& defaultValue ) const
+{
+  auto it = m_values.find( name );
+  return it != m_values.end() ? it->second : defaultValue;
+}
+
+std::vector< uint32_t > Sapphire::Bench::parseList( const std::string& value )
+{
+  std::vector< uint32_t > result;
+  size_t start = 0;
+  while( start < value.size() )
+  {
+    auto end = value.find( ',', start );
+    if( end == std::string::npos )
+      end = value.size();
+
+    if( end > start )
+      result.push_back( static_cast< uint32_t >( std::stoul( value.substr( start, end - start ) ) ) );
+    start = end + 1;
+  }
+  return result;
+}
+
+void printUsage()
+{
+  Logger::info( " Usage: bench <benchmark> [options]" );
+  for( const auto& bench : benches )
+    Logger::info( "\t {0}: {1}", bench.name, bench.description );
+}
+
+int main( int32_t argc, char* argv[] )
+{
+  Logger::init( "log/bench" );
+
+  if( argc < 2 )
+  {
+    printUsage();
+    return 1;
+  }
+
+  for( const auto& bench : benches )
+  {
+    if( std::strcmp( argv[ 1 ], bench.name ) == 0 )
+      return bench.run( Options( argc - 2, argv + 2 ) );
+  }
+
+  Logger::error( "Unknown benchmark {0}", argv[ 1 ] );
+  printUsage();
+  return 1;
+}
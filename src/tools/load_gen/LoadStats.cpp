@@ -0,0 +1,225 @@
+#include "LoadStats.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include <Logging/Logger.h>
+
+using namespace Sapphire;
+using namespace Sapphire::LoadGen;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  // log2 of the number of sub buckets per power of two
+  constexpr uint32_t SubBucketBits = 3;
+
+  uint32_t highestBit( uint64_t value )
+  {
+    uint32_t bit = 0;
+    while( value >>= 1 )
+      ++bit;
+    return bit;
+  }
+
+  uint64_t perSecond( uint64_t value, uint64_t elapsedMs )
+  {
+    if( elapsedMs == 0 )
+      return 0;
+    return value * 1000 / elapsedMs;
+  }
+
+  uint64_t tickWait( uint64_t syncUs, uint64_t keepAliveUs )
+  {
+    return syncUs > keepAliveUs ? syncUs - keepAliveUs : 0;
+  }
+}
+
+void LatencyHistogram::record( uint64_t us )
+{
+  m_buckets[ getBucket( us ) ].fetch_add( 1, std::memory_order_relaxed );
+}
+
+LatencyHistogram::Counts LatencyHistogram::snapshot() const
+{
+  Counts counts{};
+  for( size_t i = 0; i < BucketCount; ++i )
+    counts[ i ] = m_buckets[ i ].load( std::memory_order_relaxed );
+  return counts;
+}
+
+uint64_t LatencyHistogram::count( const Counts& counts )
+{
+  uint64_t total = 0;
+  for( auto bucket : counts )
+    total += bucket;
+  return total;
+}
+
+uint64_t LatencyHistogram::percentile( const Counts& counts, double percentile )
+{
+  const auto total = count( counts );
+  if( total == 0 )
+    return 0;
+
+  const auto target = static_cast< uint64_t >( percentile * static_cast< double >( total ) );
+  uint64_t seen = 0;
+
+  for( size_t i = 0; i < BucketCount; ++i )
+  {
+    seen += counts[ i ];
+    if( seen > target || seen == total )
+      return getBucketUpperBound( i );
+  }
+
+  return getBucketUpperBound( BucketCount - 1 );
+}
+
+LatencyHistogram::Counts LatencyHistogram::delta( const Counts& current, const Counts& previous )
+{
+  Counts result{};
+  for( size_t i = 0; i < BucketCount; ++i )
+    result[ i ] = current[ i ] - previous[ i ];
+  return result;
+}
+
+size_t LatencyHistogram::getBucket( uint64_t us )
+{
+  if( us < SubBuckets )
+    return static_cast< size_t >( us );
+
+  const auto msb = highestBit( us );
+  const auto sub = ( us >> ( msb - SubBucketBits ) ) & ( SubBuckets - 1 );
+  const auto bucket = ( msb - SubBucketBits + 1 ) * SubBuckets + sub;
+
+  return std::min< size_t >( bucket, BucketCount - 1 );
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound( size_t bucket )
+{
+  if( bucket < SubBuckets )
+    return bucket;
+
+  const auto msb = bucket / SubBuckets + SubBucketBits - 1;
+  const auto sub = bucket % SubBuckets;
+  const auto width = uint64_t{ 1 } << ( msb - SubBucketBits );
+
+  return ( SubBuckets + sub ) * width + width - 1;
+}
+
+void LoadStats::onQueued()
+{
+  const auto depth = sendQueueDepth.fetch_add( 1, std::memory_order_relaxed ) + 1;
+
+  auto prevMax = sendQueueMax.load( std::memory_order_relaxed );
+  while( depth > prevMax && !sendQueueMax.compare_exchange_weak( prevMax, depth, std::memory_order_relaxed ) )
+  {
+  }
+}
+
+void LoadStats::onSent()
+{
+  sendQueueDepth.fetch_sub( 1, std::memory_order_relaxed );
+}
+
+LoadSample LoadSample::take( const LoadStats& stats, uint64_t timeMs )
+{
+  LoadSample sample;
+  sample.timeMs = timeMs;
+  sample.connecting = stats.connecting;
+  sample.online = stats.online;
+  sample.failed = stats.failed;
+  sample.disconnected = stats.disconnected;
+  sample.bytesIn = stats.bytesIn;
+  sample.bytesOut = stats.bytesOut;
+  sample.segmentsIn = stats.segmentsIn;
+  sample.segmentsOut = stats.segmentsOut;
+  sample.sendQueueDepth = stats.sendQueueDepth;
+  sample.sendQueueMax = stats.sendQueueMax;
+  sample.pendingSyncs = stats.pendingSyncs;
+  sample.login = stats.login.snapshot();
+  sample.sync = stats.sync.snapshot();
+  sample.keepAlive = stats.keepAlive.snapshot();
+  return sample;
+}
+
+LoadReporter::LoadReporter( const LoadStats& stats, const std::string& csvPath ) :
+  m_stats( stats ),
+  m_csvPath( csvPath )
+{
+  m_first = LoadSample::take( m_stats, 0 );
+  m_last = m_first;
+
+  if( m_csvPath.empty() || ( fs::exists( m_csvPath ) && fs::file_size( m_csvPath ) > 0 ) )
+    return;
+
+  std::ofstream csv( m_csvPath );
+  csv << "time_ms,online,connecting,failed,disconnected,bytes_in_per_s,bytes_out_per_s,"
+         "segments_in_per_s,segments_out_per_s,sync_p50_us,sync_p99_us,sync_count,"
+         "keepalive_p50_us,keepalive_p99_us,tick_wait_p50_us,tick_wait_p99_us,"
+         "send_queue_depth,send_queue_max,pending_syncs\n";
+}
+
+void LoadReporter::report( uint64_t timeMs )
+{
+  auto sample = LoadSample::take( m_stats, timeMs );
+  const auto elapsedMs = sample.timeMs - m_last.timeMs;
+
+  const auto sync = LatencyHistogram::delta( sample.sync, m_last.sync );
+  const auto keepAlive = LatencyHistogram::delta( sample.keepAlive, m_last.keepAlive );
+
+  const auto syncP50 = LatencyHistogram::percentile( sync, 0.5 );
+  const auto syncP99 = LatencyHistogram::percentile( sync, 0.99 );
+  const auto keepAliveP50 = LatencyHistogram::percentile( keepAlive, 0.5 );
+  const auto keepAliveP99 = LatencyHistogram::percentile( keepAlive, 0.99 );
+
+  const auto bytesIn = perSecond( sample.bytesIn - m_last.bytesIn, elapsedMs );
+  const auto bytesOut = perSecond( sample.bytesOut - m_last.bytesOut, elapsedMs );
+  const auto segmentsIn = perSecond( sample.segmentsIn - m_last.segmentsIn, elapsedMs );
+  const auto segmentsOut = perSecond( sample.segmentsOut - m_last.segmentsOut, elapsedMs );
+
+  Logger::info( "[{:>6}s] online {} connecting {} failed {} dropped {} | in {:.1f} KB/s {} seg/s | out {:.1f} KB/s {} seg/s",
+                timeMs / 1000, sample.online, sample.connecting, sample.failed, sample.disconnected,
+                bytesIn / 1024.0, segmentsIn, bytesOut / 1024.0, segmentsOut );
+
+  Logger::info( "          sync p50 {}us p99 {}us | keepalive p50 {}us p99 {}us | tick wait p50 {}us p99 {}us | "
+                "send queue {} max {} | pending syncs {}",
+                syncP50, syncP99, keepAliveP50, keepAliveP99,
+                tickWait( syncP50, keepAliveP50 ), tickWait( syncP99, keepAliveP99 ),
+                sample.sendQueueDepth, sample.sendQueueMax, sample.pendingSyncs );
+
+  if( !m_csvPath.empty() )
+  {
+    std::ofstream csv( m_csvPath, std::ios::app );
+    csv << sample.timeMs << ',' << sample.online << ',' << sample.connecting << ','
+        << sample.failed << ',' << sample.disconnected << ','
+        << bytesIn << ',' << bytesOut << ',' << segmentsIn << ',' << segmentsOut << ','
+        << syncP50 << ',' << syncP99 << ',' << LatencyHistogram::count( sync ) << ','
+        << keepAliveP50 << ',' << keepAliveP99 << ','
+        << tickWait( syncP50, keepAliveP50 ) << ',' << tickWait( syncP99, keepAliveP99 ) << ','
+        << sample.sendQueueDepth << ',' << sample.sendQueueMax << ',' << sample.pendingSyncs << '\n';
+  }
+
+  m_last = std::move( sample );
+}
+
+void LoadReporter::summary( uint64_t timeMs )
+{
+  auto sample = LoadSample::take( m_stats, timeMs );
+  const auto elapsedMs = sample.timeMs - m_first.timeMs;
+
+  Logger::info( "Run finished after {}s", elapsedMs / 1000 );
+  Logger::info( "  clients: {} online, {} failed to log in, {} dropped", sample.online, sample.failed, sample.disconnected );
+  Logger::info( "  login:     p50 {}us p99 {}us ( {} logins )",
+                LatencyHistogram::percentile( sample.login, 0.5 ), LatencyHistogram::percentile( sample.login, 0.99 ),
+                LatencyHistogram::count( sample.login ) );
+  Logger::info( "  sync:      p50 {}us p99 {}us ( {} replies, {} unanswered )",
+                LatencyHistogram::percentile( sample.sync, 0.5 ), LatencyHistogram::percentile( sample.sync, 0.99 ),
+                LatencyHistogram::count( sample.sync ), sample.pendingSyncs );
+  Logger::info( "  keepalive: p50 {}us p99 {}us",
+                LatencyHistogram::percentile( sample.keepAlive, 0.5 ), LatencyHistogram::percentile( sample.keepAlive, 0.99 ) );
+  Logger::info( "  traffic:   in {:.1f} KB/s out {:.1f} KB/s, send queue max {}",
+                perSecond( sample.bytesIn, elapsedMs ) / 1024.0, perSecond( sample.bytesOut, elapsedMs ) / 1024.0,
+                sample.sendQueueMax );
+}
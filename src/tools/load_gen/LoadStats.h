@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Sapphire::LoadGen
+{
+
+  /*!
+   * Log-linear latency histogram in microseconds.
+   * Values below 8us get a bucket each, above that every power of two is split into 8 buckets,
+   * which keeps the reported percentiles within 12.5% of the real value.
+   */
+  class LatencyHistogram
+  {
+  public:
+    static constexpr size_t SubBuckets = 8;
+    static constexpr size_t Octaves = 28;
+    static constexpr size_t BucketCount = SubBuckets * Octaves;
+
+    using Counts = std::array< uint64_t, BucketCount >;
+
+    void record( uint64_t us );
+
+    Counts snapshot() const;
+
+    static uint64_t count( const Counts& counts );
+
+    // upper bound in microseconds of the bucket holding the given percentile ( 0.0 - 1.0 )
+    static uint64_t percentile( const Counts& counts, double percentile );
+
+    // counts recorded between two snapshots of the same histogram
+    static Counts delta( const Counts& current, const Counts& previous );
+
+  private:
+    static size_t getBucket( uint64_t us );
+
+    static uint64_t getBucketUpperBound( size_t bucket );
+
+    std::array< std::atomic< uint64_t >, BucketCount > m_buckets{};
+  };
+
+  // counters shared by every simulated client, written from the io threads
+  struct LoadStats
+  {
+    std::atomic< uint32_t > connecting{ 0 };
+    std::atomic< uint32_t > online{ 0 };
+    std::atomic< uint32_t > failed{ 0 };
+    std::atomic< uint32_t > disconnected{ 0 };
+
+    std::atomic< uint64_t > bytesIn{ 0 };
+    std::atomic< uint64_t > bytesOut{ 0 };
+    std::atomic< uint64_t > segmentsIn{ 0 };
+    std::atomic< uint64_t > segmentsOut{ 0 };
+
+    // bundles handed to the sockets that were not written out yet, summed over all clients
+    std::atomic< uint64_t > sendQueueDepth{ 0 };
+    std::atomic< uint64_t > sendQueueMax{ 0 };
+
+    // sync requests still waiting for their reply, summed over all clients
+    std::atomic< uint64_t > pendingSyncs{ 0 };
+
+    // session init -> first zone ipc after the login request
+    LatencyHistogram login;
+    // sync ipc round trip, answered from the world tick
+    LatencyHistogram sync;
+    // keep alive round trip, answered straight from the network thread
+    LatencyHistogram keepAlive;
+
+    void onQueued();
+
+    void onSent();
+  };
+
+  // plain copy of LoadStats used to report one interval
+  struct LoadSample
+  {
+    uint64_t timeMs{ 0 };
+    uint32_t connecting{ 0 };
+    uint32_t online{ 0 };
+    uint32_t failed{ 0 };
+    uint32_t disconnected{ 0 };
+    uint64_t bytesIn{ 0 };
+    uint64_t bytesOut{ 0 };
+    uint64_t segmentsIn{ 0 };
+    uint64_t segmentsOut{ 0 };
+    uint64_t sendQueueDepth{ 0 };
+    uint64_t sendQueueMax{ 0 };
+    uint64_t pendingSyncs{ 0 };
+    LatencyHistogram::Counts login{};
+    LatencyHistogram::Counts sync{};
+    LatencyHistogram::Counts keepAlive{};
+
+    static LoadSample take( const LoadStats& stats, uint64_t timeMs );
+  };
+
+  class LoadReporter
+  {
+  public:
+    explicit LoadReporter( const LoadStats& stats, const std::string& csvPath = "" );
+
+    // logs the activity since the previous call and appends it to the csv file if one was given
+    void report( uint64_t timeMs );
+
+    // logs the totals of the whole run
+    void summary( uint64_t timeMs );
+
+  private:
+    const LoadStats& m_stats;
+    std::string m_csvPath;
+    LoadSample m_first;
+    LoadSample m_last;
+  };
+
+}
@@ -0,0 +1,458 @@
+#include "SimClient.h"
+
+#include <chrono>
+#include <cstring>
+
+#include <Logging/Logger.h>
+#include <Network/GamePacket.h>
+#include <Network/GamePacketParser.h>
+#include <Network/PacketContainer.h>
+#include <Network/PacketDef/Zone/ClientZoneDef.h>
+#include <Util/Util.h>
+
+using namespace Sapphire;
+using namespace Sapphire::LoadGen;
+using namespace Sapphire::Network::Packets;
+using namespace Sapphire::Network::Packets::WorldPackets;
+
+namespace
+{
+  // answer of the world server to a session init, see GameConnection::handlePackets
+  constexpr uint16_t SegmentTypeSessionReady = 0x02;
+  constexpr uint16_t SegmentTypeKeepAliveReply = 0x08;
+
+  // the session init carries the entity id as decimal string after 4 bytes of padding
+  constexpr uint32_t SessionInitSize = 0x38;
+  constexpr uint32_t KeepAliveSize = 0x18;
+
+  uint64_t getSteadyUs()
+  {
+    using namespace std::chrono;
+    return static_cast< uint64_t >( duration_cast< microseconds >( steady_clock::now().time_since_epoch() ).count() );
+  }
+
+  std::shared_ptr< FFXIVRawPacket > makeIpc( uint16_t opcode, size_t payloadSize, uint32_t entityId )
+  {
+    auto size = sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ) + sizeof( FFXIVARR_IPC_HEADER ) + payloadSize;
+    auto packet = std::make_shared< FFXIVRawPacket >( SEGMENTTYPE_IPC, static_cast< uint32_t >( size ), entityId, entityId );
+
+    FFXIVARR_IPC_HEADER ipcHdr{};
+    ipcHdr.reserved = 0x14;
+    ipcHdr.type = opcode;
+    ipcHdr.timestamp = Common::Util::getTimeSeconds();
+    memcpy( packet->data().data(), &ipcHdr, sizeof( ipcHdr ) );
+
+    return packet;
+  }
+}
+
+ClientConnection::ClientConnection( Network::HivePtr hive, SimClient& client, LoadStats& stats, ConnectionType type ) :
+  Network::Connection( std::move( hive ) ),
+  m_client( client ),
+  m_stats( stats ),
+  m_type( type )
+{
+}
+
+void ClientConnection::sendSegments( const std::vector< FFXIVPacketBasePtr >& segments )
+{
+  if( segments.empty() )
+    return;
+
+  PacketContainer container;
+  container.m_ipcHdr.connectionType = m_type;
+
+  for( const auto& segment : segments )
+    container.addPacket( segment );
+
+  std::vector< uint8_t > buffer;
+  container.fillSendBuffer( buffer );
+
+  m_stats.bytesOut.fetch_add( buffer.size(), std::memory_order_relaxed );
+  m_stats.segmentsOut.fetch_add( segments.size(), std::memory_order_relaxed );
+  m_stats.onQueued();
+
+  send( buffer );
+}
+
+void ClientConnection::close()
+{
+  auto self = shared_from_this();
+  getStrand().post( [ self ]()
+  {
+    self->disconnect();
+  } );
+}
+
+void ClientConnection::onConnect( const std::string& host, uint16_t port )
+{
+  // bundles are small and latency is what we measure, don't let nagle hold them back
+  asio::error_code ec;
+  getSocket().set_option( asio::ip::tcp::no_delay( true ), ec );
+
+  m_client.onConnected( m_type );
+}
+
+void ClientConnection::onRecv( std::vector< uint8_t >& buffer )
+{
+  m_stats.bytesIn.fetch_add( buffer.size(), std::memory_order_relaxed );
+  m_packets.insert( std::end( m_packets ), std::begin( buffer ), std::end( buffer ) );
+
+  // the server batches its out queue, so a single read regularly holds several bundles
+  while( !m_packets.empty() )
+  {
+    FFXIVARR_PACKET_HEADER packetHeader{};
+    auto result = getHeader( m_packets, 0, packetHeader );
+
+    std::vector< FFXIVARR_PACKET_RAW > packetList;
+    if( result == Success )
+      result = getPackets( m_packets, sizeof( FFXIVARR_PACKET_HEADER ), packetHeader, packetList );
+
+    if( result == Incomplete )
+      return;
+
+    if( result == Malformed )
+    {
+      Logger::error( "[{}] Malformed bundle from server, dropping connection", m_client.getEntityId() );
+      m_packets.clear();
+      disconnect();
+      m_client.onConnectionLost( m_type );
+      return;
+    }
+
+    m_stats.segmentsIn.fetch_add( packetList.size(), std::memory_order_relaxed );
+
+    for( const auto& packet : packetList )
+      m_client.onSegment( m_type, packet );
+
+    m_packets.erase( m_packets.begin(), m_packets.begin() + packetHeader.size );
+  }
+}
+
+void ClientConnection::onSend( const std::vector< uint8_t >& buffer )
+{
+  m_stats.onSent();
+}
+
+void ClientConnection::onError( const asio::error_code& error )
+{
+  m_client.onConnectionLost( m_type );
+}
+
+SimClient::SimClient( uint32_t entityId, const Trace& trace, const ClientConfig& config, LoadStats& stats ) :
+  m_entityId( entityId ),
+  m_trace( trace ),
+  m_config( config ),
+  m_stats( stats )
+{
+}
+
+void SimClient::start( Network::HivePtr hive )
+{
+  m_pZoneConnection = std::make_shared< ClientConnection >( hive, *this, m_stats, ConnectionType::Zone );
+  m_pChatConnection = std::make_shared< ClientConnection >( hive, *this, m_stats, ConnectionType::Chat );
+
+  m_stats.connecting++;
+  m_loginStartUs = getSteadyUs();
+  m_stateTimeMs = Common::Util::getTimeMs();
+  m_state = State::Connecting;
+
+  try
+  {
+    m_pZoneConnection->connect( m_config.host, m_config.port );
+  }
+  catch( const std::exception& e )
+  {
+    Logger::error( "[{}] Unable to connect to {}:{}: {}", m_entityId, m_config.host, m_config.port, e.what() );
+    fail( State::Connecting );
+  }
+}
+
+void SimClient::stop()
+{
+  const auto prevState = m_state.exchange( State::Closed );
+
+  if( prevState == State::Online )
+    m_stats.online--;
+  else if( prevState != State::Idle && prevState != State::Closed )
+    m_stats.connecting--;
+
+  if( prevState != State::Idle && prevState != State::Closed )
+    shutdown();
+}
+
+void SimClient::update( uint64_t nowMs )
+{
+  const auto state = m_state.load();
+
+  if( state == State::Connecting || state == State::LoggingIn )
+  {
+    if( nowMs - m_stateTimeMs > m_config.loginTimeoutMs )
+    {
+      Logger::warn( "[{}] Login timed out", m_entityId );
+      fail( state );
+    }
+    return;
+  }
+
+  if( state == State::Loading )
+  {
+    if( nowMs < m_loadedAtMs + m_config.settleMs )
+      return;
+
+    auto expected = State::Loading;
+    if( !m_state.compare_exchange_strong( expected, State::Online ) )
+      return;
+
+    m_stats.connecting--;
+    m_stats.online++;
+
+    m_traceStartMs = nowMs;
+    m_traceCursor = 0;
+    m_nextSyncMs = nowMs;
+    m_nextKeepAliveMs = nowMs;
+
+    m_pZoneConnection->sendSegments( { makeFinishLoading() } );
+    return;
+  }
+
+  if( state != State::Online )
+    return;
+
+  std::vector< FFXIVPacketBasePtr > segments;
+
+  playTrace( nowMs, segments );
+
+  if( m_config.syncIntervalMs > 0 && nowMs >= m_nextSyncMs )
+  {
+    m_nextSyncMs = nowMs + m_config.syncIntervalMs;
+
+    const auto sequence = ++m_syncSequence;
+    if( m_pendingSyncs[ sequence % PendingSlots ].exchange( getSteadyUs() ) == 0 )
+      m_stats.pendingSyncs++;
+
+    segments.push_back( makeSync( sequence ) );
+  }
+
+  if( m_config.keepAliveIntervalMs > 0 && nowMs >= m_nextKeepAliveMs )
+  {
+    m_nextKeepAliveMs = nowMs + m_config.keepAliveIntervalMs;
+
+    const auto sequence = ++m_keepAliveSequence;
+    m_pendingKeepAlives[ sequence % PendingSlots ] = getSteadyUs();
+
+    segments.push_back( makeKeepAlive( sequence ) );
+  }
+
+  // everything due in this update goes out as one bundle, like the game client batches its sends
+  m_pZoneConnection->sendSegments( segments );
+}
+
+SimClient::State SimClient::getState() const
+{
+  return m_state;
+}
+
+uint32_t SimClient::getEntityId() const
+{
+  return m_entityId;
+}
+
+void SimClient::onConnected( ConnectionType type )
+{
+  if( type == ConnectionType::Zone )
+    m_pZoneConnection->sendSegments( { makeSessionInit() } );
+  else
+    m_pChatConnection->sendSegments( { makeSessionInit() } );
+}
+
+void SimClient::onSegment( ConnectionType type, const FFXIVARR_PACKET_RAW& segment )
+{
+  if( segment.segHdr.type == SegmentTypeKeepAliveReply && segment.data.size() >= 4 )
+  {
+    uint32_t sequence;
+    memcpy( &sequence, segment.data.data(), sizeof( sequence ) );
+
+    const auto sentUs = m_pendingKeepAlives[ sequence % PendingSlots ].exchange( 0 );
+    if( sentUs != 0 )
+      m_stats.keepAlive.record( getSteadyUs() - sentUs );
+    return;
+  }
+
+  if( type != ConnectionType::Zone )
+    return;
+
+  if( segment.segHdr.type == SegmentTypeSessionReady )
+  {
+    auto expected = State::Connecting;
+    if( !m_state.compare_exchange_strong( expected, State::LoggingIn ) )
+      return;
+
+    m_stateTimeMs = Common::Util::getTimeMs();
+    m_pZoneConnection->sendSegments( { makeLogin() } );
+
+    try
+    {
+      m_pChatConnection->connect( m_config.host, m_config.port );
+    }
+    catch( const std::exception& e )
+    {
+      Logger::error( "[{}] Unable to open chat connection: {}", m_entityId, e.what() );
+    }
+    return;
+  }
+
+  if( segment.segHdr.type != SEGMENTTYPE_IPC || segment.data.size() < sizeof( FFXIVARR_IPC_HEADER ) )
+    return;
+
+  FFXIVARR_IPC_HEADER ipcHdr;
+  memcpy( &ipcHdr, segment.data.data(), sizeof( ipcHdr ) );
+
+  if( ipcHdr.type == Server::SyncReply && segment.data.size() >= sizeof( ipcHdr ) + sizeof( uint32_t ) )
+  {
+    uint32_t sequence;
+    memcpy( &sequence, segment.data.data() + sizeof( ipcHdr ), sizeof( sequence ) );
+
+    const auto sentUs = m_pendingSyncs[ sequence % PendingSlots ].exchange( 0 );
+    if( sentUs != 0 )
+    {
+      m_stats.pendingSyncs--;
+      m_stats.sync.record( getSteadyUs() - sentUs );
+    }
+    return;
+  }
+
+  // the first zone ipc after the login request means the server accepted the player
+  auto expected = State::LoggingIn;
+  if( m_state.compare_exchange_strong( expected, State::Loading ) )
+  {
+    m_stats.login.record( getSteadyUs() - m_loginStartUs );
+    m_loadedAtMs = Common::Util::getTimeMs();
+  }
+}
+
+void SimClient::onConnectionLost( ConnectionType type )
+{
+  const auto prevState = m_state.exchange( State::Closed );
+
+  if( prevState == State::Online )
+  {
+    Logger::warn( "[{}] Lost {} connection", m_entityId, type == ConnectionType::Zone ? "zone" : "chat" );
+    m_stats.online--;
+    m_stats.disconnected++;
+  }
+  else if( prevState != State::Idle && prevState != State::Closed )
+  {
+    Logger::warn( "[{}] Lost {} connection while logging in", m_entityId, type == ConnectionType::Zone ? "zone" : "chat" );
+    m_stats.connecting--;
+    m_stats.failed++;
+  }
+  else
+    return;
+
+  shutdown();
+}
+
+FFXIVPacketBasePtr SimClient::makeSessionInit() const
+{
+  auto packet = std::make_shared< FFXIVRawPacket >( SEGMENTTYPE_SESSIONINIT, SessionInitSize, 0, 0 );
+
+  const auto id = std::to_string( m_entityId );
+  memcpy( packet->data().data() + 4, id.c_str(), std::min( id.size(), packet->data().size() - 5 ) );
+
+  return packet;
+}
+
+FFXIVPacketBasePtr SimClient::makeSync( uint32_t sequence ) const
+{
+  auto packet = makeZonePacket< Client::FFXIVIpcPingHandler >( m_entityId );
+  packet->data().clientTimeValue = sequence;
+  packet->data().position.originEntityId = m_entityId;
+  return packet;
+}
+
+FFXIVPacketBasePtr SimClient::makeKeepAlive( uint32_t sequence ) const
+{
+  auto packet = std::make_shared< FFXIVRawPacket >( SEGMENTTYPE_KEEPALIVE, KeepAliveSize, 0, 0 );
+  auto timeStamp = Common::Util::getTimeSeconds();
+
+  memcpy( packet->data().data(), &sequence, sizeof( sequence ) );
+  memcpy( packet->data().data() + 4, &timeStamp, sizeof( timeStamp ) );
+
+  return packet;
+}
+
+FFXIVPacketBasePtr SimClient::makeLogin() const
+{
+  auto packet = makeZonePacket< Client::FFXIVIpcLoginHandler >( m_entityId );
+  packet->data().clientTimeValue = Common::Util::getTimeSeconds();
+  return packet;
+}
+
+FFXIVPacketBasePtr SimClient::makeFinishLoading() const
+{
+  // the world server treats SetLanguage as the end of a zone change
+  return makeIpc( Client::SetLanguage, 8, m_entityId );
+}
+
+FFXIVPacketBasePtr SimClient::makeTraceSegment( const TraceEvent& event ) const
+{
+  const auto size = sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ) + event.payload.size();
+  auto packet = std::make_shared< FFXIVRawPacket >( event.segmentType, static_cast< uint32_t >( size ), m_entityId, m_entityId );
+
+  auto& data = packet->data();
+  memcpy( data.data(), event.payload.data(), event.payload.size() );
+
+  if( event.selfIdOffset != 0 && event.selfIdOffset + sizeof( uint64_t ) <= data.size() )
+  {
+    const uint64_t selfId = m_entityId;
+    memcpy( data.data() + event.selfIdOffset, &selfId, sizeof( selfId ) );
+  }
+
+  return packet;
+}
+
+void SimClient::playTrace( uint64_t nowMs, std::vector< FFXIVPacketBasePtr >& segments )
+{
+  const auto& events = m_trace.getEvents();
+  if( events.empty() )
+    return;
+
+  if( m_traceCursor >= events.size() )
+  {
+    if( !m_config.loop || nowMs - m_traceStartMs < m_trace.getLengthMs() )
+      return;
+
+    m_traceStartMs = nowMs;
+    m_traceCursor = 0;
+  }
+
+  const auto elapsedMs = nowMs - m_traceStartMs;
+  while( m_traceCursor < events.size() && events[ m_traceCursor ].offsetMs <= elapsedMs )
+    segments.push_back( makeTraceSegment( events[ m_traceCursor++ ] ) );
+}
+
+void SimClient::fail( State expected )
+{
+  if( !m_state.compare_exchange_strong( expected, State::Closed ) )
+    return;
+
+  m_stats.connecting--;
+  m_stats.failed++;
+
+  shutdown();
+}
+
+void SimClient::shutdown()
+{
+  if( m_pZoneConnection )
+    m_pZoneConnection->close();
+  if( m_pChatConnection )
+    m_pChatConnection->close();
+
+  for( auto& slot : m_pendingSyncs )
+  {
+    if( slot.exchange( 0 ) != 0 )
+      m_stats.pendingSyncs--;
+  }
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Network/Connection.h>
+#include <Network/CommonNetwork.h>
+
+#include "LoadStats.h"
+#include "Trace.h"
+
+namespace Sapphire::LoadGen
+{
+
+  // mirrors the connection types the world server reads from the bundle header
+  enum ConnectionType : uint16_t
+  {
+    Zone = 1,
+    Chat = 2
+  };
+
+  struct ClientConfig
+  {
+    std::string host{ "127.0.0.1" };
+    uint16_t port{ 54992 };
+    uint32_t syncIntervalMs{ 1000 };
+    uint32_t keepAliveIntervalMs{ 5000 };
+    // time between the first zone packet after login and the client reporting it finished loading
+    uint32_t settleMs{ 2000 };
+    uint32_t loginTimeoutMs{ 30000 };
+    bool loop{ true };
+  };
+
+  class SimClient;
+
+  // one tcp connection of a simulated client, cuts the received stream into bundles
+  class ClientConnection : public Network::Connection
+  {
+  public:
+    ClientConnection( Network::HivePtr hive, SimClient& client, LoadStats& stats, ConnectionType type );
+
+    // sends all segments in a single bundle
+    void sendSegments( const std::vector< Network::Packets::FFXIVPacketBasePtr >& segments );
+
+    // closes the socket from within the connection strand
+    void close();
+
+  private:
+    void onConnect( const std::string& host, uint16_t port ) override;
+
+    void onRecv( std::vector< uint8_t >& buffer ) override;
+
+    void onSend( const std::vector< uint8_t >& buffer ) override;
+
+    void onError( const asio::error_code& error ) override;
+
+    SimClient& m_client;
+    LoadStats& m_stats;
+    ConnectionType m_type;
+    std::vector< uint8_t > m_packets;
+  };
+
+  using ClientConnectionPtr = std::shared_ptr< ClientConnection >;
+
+  /*!
+   * A single simulated player. Logs in with the given entity id the way the game client does
+   * ( session init on the zone and chat connection, login ipc, finish loading ) and then plays back
+   * the shared trace while measuring sync and keep alive round trips.
+   *
+   * update() is driven from one thread, everything else runs on the hive threads.
+   * Clients have to outlive the hive they were started on.
+   */
+  class SimClient
+  {
+  public:
+    enum class State : uint8_t
+    {
+      Idle,
+      Connecting,
+      LoggingIn,
+      Loading,
+      Online,
+      Closed
+    };
+
+    SimClient( uint32_t entityId, const Trace& trace, const ClientConfig& config, LoadStats& stats );
+
+    void start( Network::HivePtr hive );
+
+    void stop();
+
+    void update( uint64_t nowMs );
+
+    State getState() const;
+
+    uint32_t getEntityId() const;
+
+    // called by the connections
+    void onConnected( ConnectionType type );
+
+    void onSegment( ConnectionType type, const Network::Packets::FFXIVARR_PACKET_RAW& segment );
+
+    void onConnectionLost( ConnectionType type );
+
+  private:
+    static constexpr size_t PendingSlots = 64;
+
+    Network::Packets::FFXIVPacketBasePtr makeSessionInit() const;
+
+    Network::Packets::FFXIVPacketBasePtr makeSync( uint32_t sequence ) const;
+
+    Network::Packets::FFXIVPacketBasePtr makeKeepAlive( uint32_t sequence ) const;
+
+    Network::Packets::FFXIVPacketBasePtr makeLogin() const;
+
+    Network::Packets::FFXIVPacketBasePtr makeFinishLoading() const;
+
+    Network::Packets::FFXIVPacketBasePtr makeTraceSegment( const TraceEvent& event ) const;
+
+    void playTrace( uint64_t nowMs, std::vector< Network::Packets::FFXIVPacketBasePtr >& segments );
+
+    void fail( State expected );
+
+    // closes both connections and forgets about requests still waiting for a reply
+    void shutdown();
+
+    uint32_t m_entityId;
+    const Trace& m_trace;
+    const ClientConfig& m_config;
+    LoadStats& m_stats;
+
+    ClientConnectionPtr m_pZoneConnection;
+    ClientConnectionPtr m_pChatConnection;
+
+    std::atomic< State > m_state{ State::Idle };
+    std::atomic< uint64_t > m_stateTimeMs{ 0 };
+
+    // steady clock time in us at which the login sequence started / loading finished, 0 if not yet
+    uint64_t m_loginStartUs{ 0 };
+    std::atomic< uint64_t > m_loadedAtMs{ 0 };
+
+    uint64_t m_traceStartMs{ 0 };
+    size_t m_traceCursor{ 0 };
+
+    uint64_t m_nextSyncMs{ 0 };
+    uint64_t m_nextKeepAliveMs{ 0 };
+    uint32_t m_syncSequence{ 0 };
+    uint32_t m_keepAliveSequence{ 0 };
+
+    // send times of requests waiting for a reply, indexed by sequence % PendingSlots
+    std::array< std::atomic< uint64_t >, PendingSlots > m_pendingSyncs{};
+    std::array< std::atomic< uint64_t >, PendingSlots > m_pendingKeepAlives{};
+  };
+
+  using SimClientPtr = std::unique_ptr< SimClient >;
+
+}
@@ -0,0 +1,322 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <Logging/Logger.h>
+#include <Network/CommonNetwork.h>
+#include <Network/GamePacket.h>
+#include <Network/PacketDef/Zone/ClientZoneDef.h>
+
+using namespace Sapphire;
+using namespace Sapphire::LoadGen;
+using namespace Sapphire::Network::Packets;
+using namespace Sapphire::Network::Packets::WorldPackets;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  // capture files start with a per set header, segments follow right after it
+  constexpr size_t CaptureHeaderSize = 0x18;
+
+  // the default trace walks one lap around its circle in this time before it loops
+  constexpr uint64_t DefaultLapMs = 60000;
+
+  template< class T >
+  std::vector< uint8_t > makeIpcPayload( const ZoneChannelPacket< T >& packet )
+  {
+    auto data = packet.getData();
+    data.erase( data.begin(), data.begin() + sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ) );
+    return data;
+  }
+
+  std::vector< uint8_t > readFile( const fs::path& path )
+  {
+    std::ifstream file( path, std::ios::binary );
+    return std::vector< uint8_t >( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+  }
+}
+
+bool Trace::load( const std::string& path )
+{
+  m_events.clear();
+  m_lengthMs = 0;
+
+  if( !fs::exists( path ) )
+  {
+    Logger::error( "Trace {} does not exist", path );
+    return false;
+  }
+
+  const bool loaded = fs::is_directory( path ) ? loadCapture( path ) : loadScript( path );
+  if( !loaded || m_events.empty() )
+  {
+    Logger::error( "No events loaded from trace {}", path );
+    return false;
+  }
+
+  std::stable_sort( m_events.begin(), m_events.end(), []( const TraceEvent& left, const TraceEvent& right )
+  {
+    return left.offsetMs < right.offsetMs;
+  } );
+
+  m_lengthMs = m_events.back().offsetMs;
+
+  Logger::info( "Loaded {} events spanning {}ms from {}", m_events.size(), m_lengthMs, path );
+  return true;
+}
+
+bool Trace::loadCapture( const std::string& path )
+{
+  std::vector< std::pair< uint64_t, fs::path > > sets;
+
+  for( const auto& entry : fs::directory_iterator( path ) )
+  {
+    if( !entry.is_regular_file() )
+      continue;
+
+    // same naming as the capture folders the replay command reads
+    const auto fileName = entry.path().filename().string();
+    if( fileName.size() < 14 || !std::all_of( fileName.begin(), fileName.begin() + 14, ::isdigit ) )
+      continue;
+
+    const auto unixTime = std::stoull( fileName.substr( 0, 14 ) );
+    if( unixTime > 1000000000 )
+      sets.emplace_back( unixTime, entry.path() );
+  }
+
+  if( sets.empty() )
+    return false;
+
+  std::sort( sets.begin(), sets.end() );
+  const auto startTime = sets.front().first;
+
+  for( const auto& [ setTime, setPath ] : sets )
+  {
+    const auto data = readFile( setPath );
+
+    size_t offset = CaptureHeaderSize;
+    while( offset + sizeof( FFXIVARR_PACKET_SEGMENT_HEADER ) <= data.size() )
+    {
+      FFXIVARR_PACKET_SEGMENT_HEADER segHdr{};
+      memcpy( &segHdr, data.data() + offset, sizeof( segHdr ) );
+
+      if( segHdr.size < sizeof( segHdr ) || offset + segHdr.size > data.size() )
+      {
+        Logger::warn( "Truncated segment in {} at offset {:X}", setPath.string(), offset );
+        break;
+      }
+
+      // session setup and keep alives are handled by the client itself
+      if( segHdr.type == SEGMENTTYPE_IPC )
+      {
+        TraceEvent event;
+        event.offsetMs = setTime - startTime;
+        event.segmentType = segHdr.type;
+        event.payload.assign( data.begin() + offset + sizeof( segHdr ), data.begin() + offset + segHdr.size );
+        m_events.push_back( std::move( event ) );
+      }
+
+      offset += segHdr.size;
+    }
+  }
+
+  return true;
+}
+
+bool Trace::loadScript( const std::string& path )
+{
+  std::ifstream file( path );
+  if( !file )
+    return false;
+
+  std::string line;
+  uint32_t lineNumber = 0;
+
+  while( std::getline( file, line ) )
+  {
+    ++lineNumber;
+
+    const auto start = line.find_first_not_of( " \t\r" );
+    if( start == std::string::npos || line[ start ] == '#' )
+      continue;
+
+    std::istringstream stream( line.substr( start ) );
+    uint64_t offsetMs = 0;
+    std::string command;
+
+    if( !( stream >> offsetMs >> command ) )
+    {
+      Logger::error( "{}:{}: expected \"<offsetMs> <command> [args]\"", path, lineNumber );
+      return false;
+    }
+
+    std::string args;
+    std::getline( stream >> std::ws, args );
+
+    if( !parseCommand( offsetMs, command, args ) )
+    {
+      Logger::error( "{}:{}: invalid command \"{}\"", path, lineNumber, line );
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Trace::parseCommand( uint64_t offsetMs, const std::string& command, const std::string& args )
+{
+  std::istringstream stream( args );
+
+  if( command == "move" )
+  {
+    float x, y, z;
+    float dir = 0.f;
+    if( !( stream >> x >> y >> z ) )
+      return false;
+    stream >> dir;
+
+    addMove( offsetMs, x, y, z, dir );
+    return true;
+  }
+
+  if( command == "chat" )
+  {
+    if( args.empty() )
+      return false;
+
+    addChat( offsetMs, args );
+    return true;
+  }
+
+  if( command == "action" )
+  {
+    uint32_t actionId;
+    uint64_t targetId = 0;
+    if( !( stream >> actionId ) )
+      return false;
+    stream >> targetId;
+
+    addAction( offsetMs, actionId, targetId );
+    return true;
+  }
+
+  if( command == "ipc" )
+  {
+    std::string opcode;
+    std::string hex;
+    if( !( stream >> opcode ) )
+      return false;
+    stream >> hex;
+
+    if( hex.size() % 2 != 0 )
+      return false;
+
+    FFXIVARR_IPC_HEADER ipcHdr{};
+    ipcHdr.reserved = 0x14;
+    ipcHdr.type = static_cast< uint16_t >( std::stoul( opcode, nullptr, 0 ) );
+
+    TraceEvent event;
+    event.offsetMs = offsetMs;
+    event.segmentType = SEGMENTTYPE_IPC;
+    event.payload.resize( sizeof( ipcHdr ) );
+    memcpy( event.payload.data(), &ipcHdr, sizeof( ipcHdr ) );
+
+    for( size_t i = 0; i < hex.size(); i += 2 )
+      event.payload.push_back( static_cast< uint8_t >( std::stoul( hex.substr( i, 2 ), nullptr, 16 ) ) );
+
+    m_events.push_back( std::move( event ) );
+    return true;
+  }
+
+  return false;
+}
+
+void Trace::makeDefault( const float origin[ 3 ], float radius, uint32_t moveIntervalMs, uint32_t chatIntervalMs,
+                         uint32_t actionIntervalMs, uint32_t actionId )
+{
+  m_events.clear();
+
+  if( moveIntervalMs > 0 )
+  {
+    for( uint64_t time = 0; time < DefaultLapMs; time += moveIntervalMs )
+    {
+      const auto angle = static_cast< float >( 2.0 * M_PI * static_cast< double >( time ) / DefaultLapMs );
+      addMove( time, origin[ 0 ] + radius * std::cos( angle ), origin[ 1 ], origin[ 2 ] + radius * std::sin( angle ),
+               angle + static_cast< float >( M_PI / 2 ) );
+    }
+  }
+
+  if( chatIntervalMs > 0 )
+  {
+    uint32_t count = 0;
+    for( uint64_t time = chatIntervalMs; time < DefaultLapMs; time += chatIntervalMs )
+      addChat( time, "load test message " + std::to_string( ++count ) );
+  }
+
+  if( actionIntervalMs > 0 )
+  {
+    for( uint64_t time = actionIntervalMs; time < DefaultLapMs; time += actionIntervalMs )
+      addAction( time, actionId, 0 );
+  }
+
+  std::stable_sort( m_events.begin(), m_events.end(), []( const TraceEvent& left, const TraceEvent& right )
+  {
+    return left.offsetMs < right.offsetMs;
+  } );
+
+  m_lengthMs = DefaultLapMs;
+}
+
+const std::vector< TraceEvent >& Trace::getEvents() const
+{
+  return m_events;
+}
+
+uint64_t Trace::getLengthMs() const
+{
+  return m_lengthMs;
+}
+
+void Trace::addMove( uint64_t offsetMs, float x, float y, float z, float dir )
+{
+  auto packet = ZoneChannelPacket< Client::FFXIVIpcUpdatePosition >( 0 );
+  auto& data = packet.data();
+  data.dir = dir;
+  data.dirBeforeSlip = dir;
+  data.pos = { x, y, z };
+
+  m_events.push_back( { offsetMs, SEGMENTTYPE_IPC, makeIpcPayload( packet ), 0 } );
+}
+
+void Trace::addChat( uint64_t offsetMs, const std::string& message )
+{
+  auto packet = ZoneChannelPacket< Client::FFXIVIpcChatHandler >( 0 );
+  auto& data = packet.data();
+  data.chatType = Common::ChatType::Say;
+  strncpy( data.message, message.c_str(), sizeof( data.message ) - 1 );
+
+  m_events.push_back( { offsetMs, SEGMENTTYPE_IPC, makeIpcPayload( packet ), 0 } );
+}
+
+void Trace::addAction( uint64_t offsetMs, uint32_t actionId, uint64_t targetId )
+{
+  auto packet = ZoneChannelPacket< Client::FFXIVIpcActionRequest >( 0 );
+  auto& data = packet.data();
+  data.ActionKind = 1;
+  data.ActionKey = actionId;
+  data.RequestId = static_cast< uint32_t >( m_events.size() );
+  data.Target = targetId;
+
+  uint32_t selfIdOffset = 0;
+  if( targetId == 0 )
+    selfIdOffset = sizeof( FFXIVARR_IPC_HEADER ) + offsetof( Client::FFXIVIpcActionRequest, Target );
+
+  m_events.push_back( { offsetMs, SEGMENTTYPE_IPC, makeIpcPayload( packet ), selfIdOffset } );
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Sapphire::LoadGen
+{
+
+  struct TraceEvent
+  {
+    // time since the start of the trace
+    uint64_t offsetMs{ 0 };
+    uint16_t segmentType{ 0 };
+    // segment content without the segment header, for ipc segments this starts with the ipc header
+    std::vector< uint8_t > payload;
+    // offset into the payload that receives the entity id of the sending client, 0 if none
+    uint32_t selfIdOffset{ 0 };
+  };
+
+  /*!
+   * Client -> server traffic played back by every simulated client.
+   *
+   * A trace is either a capture folder in the layout Session::startReplay reads
+   * ( one file per packet set, named after its millisecond timestamp, segments starting at 0x18 )
+   * or a text script with one "<offsetMs> <command> [args]" line per event:
+   *
+   *   move <x> <y> <z> [dir]
+   *   chat <message>
+   *   action <actionId> [targetId]     targets the client itself if no target is given
+   *   ipc <opcode> [hex payload]
+   */
+  class Trace
+  {
+  public:
+    // loads a capture folder or a script file, returns false if nothing could be loaded
+    bool load( const std::string& path );
+
+    // walks a circle around origin, chats and casts at the given intervals, 0 disables a behaviour
+    void makeDefault( const float origin[ 3 ], float radius, uint32_t moveIntervalMs, uint32_t chatIntervalMs,
+                      uint32_t actionIntervalMs, uint32_t actionId );
+
+    const std::vector< TraceEvent >& getEvents() const;
+
+    // offset of the last event, the trace restarts after this when looping
+    uint64_t getLengthMs() const;
+
+  private:
+    bool loadCapture( const std::string& path );
+
+    bool loadScript( const std::string& path );
+
+    bool parseCommand( uint64_t offsetMs, const std::string& command, const std::string& args );
+
+    void addMove( uint64_t offsetMs, float x, float y, float z, float dir );
+
+    void addChat( uint64_t offsetMs, const std::string& message );
+
+    void addAction( uint64_t offsetMs, uint32_t actionId, uint64_t targetId );
+
+    std::vector< TraceEvent > m_events;
+    uint64_t m_lengthMs{ 0 };
+  };
+
+}
@@ -0,0 +1,235 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <Logging/Logger.h>
+#include <Network/Hive.h>
+#include <Util/Util.h>
+
+#include "LoadStats.h"
+#include "SimClient.h"
+#include "Trace.h"
+
+using namespace Sapphire;
+using namespace Sapphire::LoadGen;
+
+namespace
+{
+  std::atomic< bool > running{ true };
+
+  void onSignal( int32_t )
+  {
+    running = false;
+  }
+
+  std::vector< std::string > split( const std::string& value, char delimiter )
+  {
+    std::vector< std::string > parts;
+    std::istringstream stream( value );
+    std::string part;
+    while( std::getline( stream, part, delimiter ) )
+    {
+      if( !part.empty() )
+        parts.push_back( part );
+    }
+    return parts;
+  }
+}
+
+void printUsage()
+{
+  Logger::info( " Usage: load_gen --first-id <entityId> --clients <count> [options]" );
+  Logger::info( "\t --host <worldHost> ( default 127.0.0.1 )" );
+  Logger::info( "\t --port <worldPort> ( default 54992 )" );
+  Logger::info( "\t --ids <id,id,...> ( entity ids to log in with instead of --first-id / --clients )" );
+  Logger::info( "\t --trace <captureFolder|scriptFile> ( default: walk, chat and cast in a loop )" );
+  Logger::info( "\t --duration <seconds> ( default 0, run until interrupted )" );
+  Logger::info( "\t --ramp <clients per second> ( default 10 )" );
+  Logger::info( "\t --threads <io threads> ( default hardware concurrency )" );
+  Logger::info( "\t --interval <report seconds> ( default 5 )" );
+  Logger::info( "\t --csv <path> ( append one row per report interval )" );
+  Logger::info( "\t --loop <0|1> ( restart the trace when it ends, default 1 )" );
+  Logger::info( "\t --sync <ms> --keepalive <ms> ( request intervals, default 1000 / 5000 )" );
+  Logger::info( "\t --settle <ms> ( wait after login before the client reports it finished loading, default 2000 )" );
+  Logger::info( " Default trace options:" );
+  Logger::info( "\t --origin <x,y,z> --radius <yalms> ( circle to walk, default 0,0,0 / 10 )" );
+  Logger::info( "\t --move <ms> --chat <ms> --action <ms> ( 0 disables, default 250 / 10000 / 2500 )" );
+  Logger::info( "\t --action-id <actionId> ( default 7 )" );
+}
+
+int main( int32_t argc, char* argv[] )
+{
+  Logger::init( "log/load_gen" );
+
+  ClientConfig config;
+  std::vector< uint32_t > ids;
+  uint32_t firstId = 0;
+  uint32_t clientCount = 0;
+  std::string tracePath;
+  std::string csvPath;
+  uint32_t duration = 0;
+  uint32_t ramp = 10;
+  uint32_t threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+  uint32_t interval = 5;
+
+  float origin[ 3 ] = { 0.f, 0.f, 0.f };
+  float radius = 10.f;
+  uint32_t moveInterval = 250;
+  uint32_t chatInterval = 10000;
+  uint32_t actionInterval = 2500;
+  uint32_t actionId = 7;
+
+  std::vector< std::string > args( argv + 1, argv + argc );
+  for( uint32_t i = 0; i + 1 < args.size(); i += 2 )
+  {
+    auto arg = std::string( args[ i ] );
+    auto val = std::string( args[ i + 1 ] );
+
+    // trim '-' from start of arg
+    arg = arg.erase( 0, arg.find_first_not_of( '-' ) );
+    if( arg == "host" )
+      config.host = val;
+    else if( arg == "port" )
+      config.port = static_cast< uint16_t >( std::stoul( val ) );
+    else if( arg == "first-id" )
+      firstId = std::stoul( val );
+    else if( arg == "clients" )
+      clientCount = std::stoul( val );
+    else if( arg == "ids" )
+    {
+      for( const auto& id : split( val, ',' ) )
+        ids.push_back( std::stoul( id ) );
+    }
+    else if( arg == "trace" )
+      tracePath = val;
+    else if( arg == "duration" )
+      duration = std::stoul( val );
+    else if( arg == "ramp" )
+      ramp = std::max( 1ul, std::stoul( val ) );
+    else if( arg == "threads" )
+      threadCount = std::max( 1ul, std::stoul( val ) );
+    else if( arg == "interval" )
+      interval = std::max( 1ul, std::stoul( val ) );
+    else if( arg == "csv" )
+      csvPath = val;
+    else if( arg == "loop" )
+      config.loop = val != "0";
+    else if( arg == "sync" )
+      config.syncIntervalMs = std::stoul( val );
+    else if( arg == "keepalive" )
+      config.keepAliveIntervalMs = std::stoul( val );
+    else if( arg == "settle" )
+      config.settleMs = std::stoul( val );
+    else if( arg == "origin" )
+    {
+      auto parts = split( val, ',' );
+      for( size_t axis = 0; axis < 3 && axis < parts.size(); ++axis )
+        origin[ axis ] = std::stof( parts[ axis ] );
+    }
+    else if( arg == "radius" )
+      radius = std::stof( val );
+    else if( arg == "move" )
+      moveInterval = std::stoul( val );
+    else if( arg == "chat" )
+      chatInterval = std::stoul( val );
+    else if( arg == "action" )
+      actionInterval = std::stoul( val );
+    else if( arg == "action-id" )
+      actionId = std::stoul( val );
+  }
+
+  if( ids.empty() && firstId != 0 )
+  {
+    for( uint32_t i = 0; i < clientCount; ++i )
+      ids.push_back( firstId + i );
+  }
+
+  if( ids.empty() )
+  {
+    printUsage();
+    return 0;
+  }
+
+  Trace trace;
+  if( !tracePath.empty() )
+  {
+    if( !trace.load( tracePath ) )
+      return 1;
+  }
+  else
+    trace.makeDefault( origin, radius, moveInterval, chatInterval, actionInterval, actionId );
+
+  std::signal( SIGINT, onSignal );
+  std::signal( SIGTERM, onSignal );
+
+  LoadStats stats;
+  LoadReporter reporter( stats, csvPath );
+
+  auto hive = std::make_shared< Network::Hive >();
+
+  std::vector< std::thread > threadGroup;
+  for( uint32_t i = 0; i < threadCount; ++i )
+    threadGroup.emplace_back( std::bind( &Network::Hive::run, hive.get() ) );
+
+  std::vector< SimClientPtr > clients;
+  clients.reserve( ids.size() );
+  for( auto id : ids )
+    clients.push_back( std::make_unique< SimClient >( id, trace, config, stats ) );
+
+  Logger::info( "Starting {} clients against {}:{} at {} logins per second on {} threads",
+                clients.size(), config.host, config.port, ramp, threadCount );
+
+  const auto startMs = Common::Util::getTimeMs();
+  auto nextReportMs = startMs + interval * 1000;
+  uint64_t lastReportMs = 0;
+  size_t started = 0;
+
+  while( running )
+  {
+    const auto nowMs = Common::Util::getTimeMs();
+    const auto elapsedMs = nowMs - startMs;
+
+    // ramp logins up instead of opening every session in the same tick
+    const auto due = std::min< size_t >( clients.size(), elapsedMs * ramp / 1000 + 1 );
+    while( started < due )
+      clients[ started++ ]->start( hive );
+
+    for( size_t i = 0; i < started; ++i )
+      clients[ i ]->update( nowMs );
+
+    if( nowMs >= nextReportMs )
+    {
+      reporter.report( elapsedMs );
+      lastReportMs = elapsedMs;
+      nextReportMs += interval * 1000;
+    }
+
+    if( duration != 0 && elapsedMs >= duration * 1000ull )
+      break;
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+  }
+
+  const auto endMs = Common::Util::getTimeMs() - startMs;
+  if( endMs - lastReportMs >= 1000 )
+    reporter.report( endMs );
+  reporter.summary( endMs );
+
+  for( auto& client : clients )
+    client->stop();
+
+  // give the connections a moment to close so the server logs the players out
+  std::this_thread::sleep_for( std::chrono::milliseconds( 500 ) );
+
+  hive->stop();
+  for( auto& thread : threadGroup )
+  {
+    if( thread.joinable() )
+      thread.join();
+  }
+
+  return 0;
+}
@@ -290,7 +290,7 @@ namespace Sapphire::World::AI
       while( m_results.size() < count && !remaining.empty() )
       {
         // idk
-        std::shuffle( remaining.begin(), remaining.end(), *RNGMgr.getRNGEngine() );
+        std::shuffle( remaining.begin(), remaining.end(), RNGMgr.getRNGEngine() );
 
         auto pChara = remaining.back();
         CharaEntry entry{};
@@ -364,7 +364,7 @@ void Action::Action::start()
     data.TargetPos[ 2 ] = Common::Util::floatToUInt16( m_pos.z );
     data.Dir = m_rot;
 
-    server().queueForPlayers( m_pSource->getInRangePlayerIds( m_pSource->isPlayer() ), castPacket );
+    server().queueForInRangePlayers( *m_pSource, m_pSource->isPlayer(), castPacket );
 
     if( player )
       player->setCondition( PlayerCondition::Casting );
@@ -437,7 +437,7 @@ void Action::Action::interrupt()
     // todo: use the correct interrupt effect for players locked out
     auto control = makeActorControl( m_pSource->getId(), ActorControlType::CastInterrupt, 0x219, 1, m_id, interruptEffect );
 
-    server().queueForPlayers( m_pSource->getInRangePlayerIds( true ), control );
+    server().queueForInRangePlayers( *m_pSource, true, control );
   }
 
   onInterrupt();
@@ -511,10 +511,13 @@ void Action::Action::execute()
 
 std::pair< uint32_t, Common::CalcResultType > Action::Action::calcDamage( uint32_t potency )
 {
-  // NOTE: we truncate the float to uint32_t here (not round it), the game works the same way (supposedly)
-  auto truncate = []( const std::pair< float, Common::CalcResultType >& dmg ) {
-    return std::make_pair( static_cast< uint32_t >( dmg.first ), dmg.second );
-  };
+  std::vector< std::pair< uint32_t, Common::CalcResultType > > results;
+  calcDamage( potency, 1, results );
+  return results.front();
+}
+
+void Action::Action::calcDamage( uint32_t potency, size_t count, std::vector< std::pair< uint32_t, Common::CalcResultType > >& results )
+{
 
   Common::BaseParam calcStat = Common::BaseParam::Strength;
   switch( static_cast< Common::ClassJob >( m_actionData->data().UseClassJob ) )
@@ -548,16 +551,22 @@ std::pair< uint32_t, Common::CalcResultType > Action::Action::calcDamage( uint32
     wepDmg = m_pSource->getMagicalWeaponDamage();
 
 
+  std::vector< Math::CalcStats::DamageResult > damage( count );
+
   // todo: do we still need that player check for auto attacks?
-  if( auto player = m_pSource->getAsPlayer() )
+  if( m_pSource->isPlayer() && ( getId() == 7 || getId() == 8 ) )
   {
-    // is auto attack
-    if( getId() == 7 || getId() == 8 )
-      return truncate( Math::CalcStats::calcAutoAttackDamage( *m_pSource->getAsPlayer(), calcStat, wepDmg ) );
+    for( auto& result : damage )
+      result = Math::CalcStats::calcAutoAttackDamage( *m_pSource->getAsPlayer(), calcStat, wepDmg );
   }
+  else
+    Math::CalcStats::calcActionDamage( *m_pSource, potency, calcStat, wepDmg, damage.data(), count );
 
-  return truncate( Math::CalcStats::calcActionDamage( *m_pSource, potency, calcStat, wepDmg ) );
-  }
+  // NOTE: we truncate the float to uint32_t here (not round it), the game works the same way (supposedly)
+  results.resize( count );
+  for( size_t i = 0; i < count; ++i )
+    results[ i ] = std::make_pair( static_cast< uint32_t >( damage[ i ].first ), damage[ i ].second );
+}
 
 std::pair< uint32_t, Common::CalcResultType > Action::Action::calcHealing( uint32_t potency )
 {
@@ -619,11 +628,18 @@ void Action::Action::buildActionResults()
   bool shouldRestoreMP = true;
   bool shouldApplyComboSucceedEffect = true;
 
-  for( auto& actor : m_hitActors )
+  // every target takes the same formula, only the rolls differ
+  std::vector< std::pair< uint32_t, Common::CalcResultType > > damageResults;
+  if( m_lutEntry.potency > 0 )
+    calcDamage( isCorrectCombo() ? m_lutEntry.comboPotency : m_lutEntry.potency, m_hitActors.size(), damageResults );
+
+  for( size_t i = 0; i < m_hitActors.size(); ++i )
   {
+    auto& actor = m_hitActors[ i ];
+
     if( m_lutEntry.potency > 0 )
     {
-      auto dmg = calcDamage( isCorrectCombo() ? m_lutEntry.comboPotency : m_lutEntry.potency );
+      const auto& dmg = damageResults[ i ];
       m_actionResultBuilder->damage( m_pSource, actor, dmg.first, dmg.second );
 
       if( isCorrectCombo() && shouldApplyComboSucceedEffect )
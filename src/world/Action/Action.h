@@ -144,6 +144,9 @@ namespace Sapphire::World::Action
 
     std::pair< uint32_t, Common::CalcResultType > calcDamage( uint32_t potency );
 
+    // rolls the damage for count targets at once
+    void calcDamage( uint32_t potency, size_t count, std::vector< std::pair< uint32_t, Common::CalcResultType > >& results );
+
     std::pair< uint32_t, Common::CalcResultType > calcHealing( uint32_t potency );
 
 
@@ -59,13 +59,13 @@ void Action::EventAction::start()
   {
     auto pPlayer = m_pSource->getAsPlayer();
     
-    server().queueForPlayers( m_pSource->getInRangePlayerIds( true ), control );
+    server().queueForInRangePlayers( *m_pSource, true, control );
 
     if( pPlayer->hasCondition( PlayerCondition::InNpcEvent ) )
       pPlayer->removeCondition( PlayerCondition::InNpcEvent );
   }
   else
-    server().queueForPlayers( m_pSource->getInRangePlayerIds(), control );
+    server().queueForInRangePlayers( *m_pSource, false, control );
 }
 
 void Action::EventAction::execute()
@@ -99,10 +99,10 @@ void Action::EventAction::execute()
     if( m_pSource->isPlayer() )
     {
       //m_pSource->getAsPlayer()->unsetStateFlag( PlayerStateFlag::Occupied2 );
-      server().queueForPlayers( m_pSource->getInRangePlayerIds( true ), control );
+      server().queueForInRangePlayers( *m_pSource, true, control );
     }
     else
-      server().queueForPlayers( m_pSource->getInRangePlayerIds(), control );
+      server().queueForInRangePlayers( *m_pSource, false, control );
   }
   catch( std::exception& e )
   {
@@ -127,13 +127,13 @@ void Action::EventAction::interrupt()
 
       //m_pSource->getAsPlayer()->unsetStateFlag( PlayerStateFlag::NoCombat );
       //m_pSource->getAsPlayer()->unsetStateFlag( PlayerStateFlag::Occupied1 );
-      server().queueForPlayers( m_pSource->getInRangePlayerIds( true ), control );
-      server().queueForPlayers( m_pSource->getInRangePlayerIds( true ), control1 );
+      server().queueForInRangePlayers( *m_pSource, true, control );
+      server().queueForInRangePlayers( *m_pSource, true, control1 );
 
       eventMgr.eventFinish( *m_pSource->getAsPlayer(), m_eventId, 1 );
     }
     else
-      server().queueForPlayers( m_pSource->getInRangePlayerIds(), control );
+      server().queueForInRangePlayers( *m_pSource, false, control );
 
     if( m_onActionInterruptClb )
       m_onActionInterruptClb( *m_pSource->getAsPlayer(), m_eventId, m_additional );
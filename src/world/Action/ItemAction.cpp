@@ -92,7 +92,7 @@ void ItemAction::handleVFXItem()
   effectPacket->setActionId( Common::ItemActionType::ItemActionVFX );
   effectPacket->setDisplayType( Common::ActionEffectDisplayType::ShowItemName );
   effectPacket->addTargetEffect( effect, static_cast< uint64_t >( getSourceChara()->getId() ) );
-  server().queueForPlayers( m_pSource->getInRangePlayerIds( true ), effectPacket );
+  server().queueForInRangePlayers( *m_pSource, true, effectPacket );
 }
 
 void ItemAction::handleCompanionItem()
@@ -57,7 +57,7 @@ void MountAction::start()
   data.TargetPos[ 1 ] = Common::Util::floatToUInt16( pos.y );
   data.TargetPos[ 2 ] = Common::Util::floatToUInt16( pos.z );
   data.Dir = m_pSource->getRot();
-  server().queueForPlayers( m_pSource->getInRangePlayerIds( true ), castPacket );
+  server().queueForInRangePlayers( *m_pSource, true, castPacket );
   player->setCondition( Common::PlayerCondition::Casting );
 
   auto actionStartPkt = makeActorControlSelf( m_pSource->getId(), ActorControlType::ActionStart, 1, getId(), m_recastTimeMs / 10 );
@@ -1,5 +1,6 @@
 #include <Util/Util.h>
 #include <Util/UtilMath.h>
+#include <Util/Profiler.h>
 #include <Network/PacketContainer.h>
 #include <Exd/ExdData.h>
 #include <utility>
@@ -501,17 +502,51 @@ void BNpc::sendPositionUpdate( uint64_t tickCount )
     uint8_t dirS1 = Common::Util::floatToUInt8Rot( s1 );
 
     auto movePacket = std::make_shared< MoveActorPacket >( *getAsChara(), 0x3A, animationType, 0, dirS1 );
-    server().queueForPlayers( getInRangePlayerIds(), movePacket );
+    server().queueMoveForInRangePlayers( *this, movePacket );
   }
+  else
+    server().flushMoveForInRangePlayers( *this );
+
   m_lastPos = m_pos;
   m_lastRot = m_rot;
 }
 
-const std::set< std::shared_ptr< HateListEntry > >& BNpc::getHateList() const
+const std::vector< HateListEntry >& BNpc::getHateList() const
 {
   return m_hateList;
 }
 
+size_t BNpc::hateListIndexOf( uint32_t entityId ) const
+{
+  for( size_t i = 0; i < m_hateList.size(); ++i )
+  {
+    if( m_hateList[ i ].m_entityId == entityId )
+      return i;
+  }
+
+  return m_hateList.size();
+}
+
+void BNpc::hateListRaise( size_t index )
+{
+  if( m_hateListTop >= m_hateList.size() || m_hateList[ index ].m_hateAmount > m_hateList[ m_hateListTop ].m_hateAmount )
+    m_hateListTop = index;
+}
+
+void BNpc::hateListFindTop()
+{
+  m_hateListTop = m_hateList.size();
+  uint32_t maxHate = 0;
+  for( size_t i = 0; i < m_hateList.size(); ++i )
+  {
+    if( m_hateList[ i ].m_hateAmount > maxHate )
+    {
+      maxHate = m_hateList[ i ].m_hateAmount;
+      m_hateListTop = i;
+    }
+  }
+}
+
 void BNpc::hateListClear()
 {
   Network::Util::Packet::sendActorControl( getInRangePlayerIds(), getId(), ToggleWeapon, 0, 1, 1 );
@@ -519,77 +554,57 @@ void BNpc::hateListClear()
 
   for( auto& listEntry : m_hateList )
   {
-    if( isInRangeSet( listEntry->m_pChara ) )
+    if( isInRangeSet( listEntry.m_pChara ) )
     {
-      if( listEntry->m_pChara->isPlayer() )
-        notifyPlayerDeaggro( listEntry->m_pChara );
+      if( listEntry.m_pChara->isPlayer() )
+        notifyPlayerDeaggro( listEntry.m_pChara );
     }
   }
   m_hateList.clear();
+  m_hateListTop = 0;
+  m_hateListDirty = false;
 }
 
 uint32_t BNpc::hateListGetValue( const Sapphire::Entity::CharaPtr& pChara )
 {
-  for( const auto& listEntry : m_hateList )
-  {
-    if( listEntry->m_pChara == pChara )
-    {
-      return listEntry->m_hateAmount;
-    }
-  }
+  auto index = hateListIndexOf( pChara->getId() );
+  if( index == m_hateList.size() )
+    return 0;
 
-  return 0;
+  return m_hateList[ index ].m_hateAmount;
 }
 
 uint32_t BNpc::hateListGetHighestValue()
 {
-  auto it = m_hateList.begin();
-  uint32_t maxHate = 0;
-  std::shared_ptr< HateListEntry > entry;
-  for( ; it != m_hateList.end(); ++it )
-  {
-    if( ( *it )->m_hateAmount > maxHate )
-    {
-      maxHate = ( *it )->m_hateAmount;
-      entry = *it;
-    }
-  }
-
-  if( entry && maxHate != 0 )
-    return entry->m_hateAmount;
+  if( m_hateListTop >= m_hateList.size() )
+    return 0;
 
-  return 0;
+  return m_hateList[ m_hateListTop ].m_hateAmount;
 }
 
 CharaPtr BNpc::hateListGetHighest()
 {
-  auto it = m_hateList.begin();
-  uint32_t maxHate = 0;
-  std::shared_ptr< HateListEntry > entry;
-  for( ; it != m_hateList.end(); ++it )
-  {
-    if( ( *it )->m_hateAmount > maxHate )
-    {
-      maxHate = ( *it )->m_hateAmount;
-      entry = *it;
-    }
-  }
-
-  if( entry && maxHate != 0 )
-    return entry->m_pChara;
+  if( m_hateListTop >= m_hateList.size() || m_hateList[ m_hateListTop ].m_hateAmount == 0 )
+    return nullptr;
 
-  return nullptr;
+  return m_hateList[ m_hateListTop ].m_pChara;
 }
 
 void BNpc::hateListAdd( const CharaPtr& pChara, int32_t hateAmount )
 {
   if( hateAmount > 0 )
   {
-    auto hateEntry = std::make_shared< HateListEntry >();
-    hateEntry->m_hateAmount = hateAmount;
-    hateEntry->m_pChara = pChara;
+    auto index = hateListIndexOf( pChara->getId() );
+    if( index != m_hateList.size() )
+    {
+      m_hateList[ index ].m_hateAmount += hateAmount;
+      hateListRaise( index );
+      return;
+    }
+
+    m_hateList.push_back( { pChara->getId(), static_cast< uint32_t >( hateAmount ), pChara } );
+    hateListRaise( m_hateList.size() - 1 );
 
-    m_hateList.insert( hateEntry );
     if( pChara->isPlayer() )
     {
       auto pPlayer = pChara->getAsPlayer();
@@ -609,30 +624,30 @@ void BNpc::hateListAddDelayed( const CharaPtr& pChara, int32_t hateAmount )
 
 void BNpc::hateListUpdate( const CharaPtr& pChara, int32_t hateAmount )
 {
-  bool hasEntry = false;
+  auto index = hateListIndexOf( pChara->getId() );
 
-  for( const auto& listEntry : m_hateList )
+  if( index != m_hateList.size() )
   {
-    if( listEntry->m_pChara == pChara )
+    auto& listEntry = m_hateList[ index ];
+    auto currentHate = listEntry.m_hateAmount;
+    if( hateAmount >= 0 || currentHate > static_cast< uint32_t >( abs( hateAmount ) ) )
+      listEntry.m_hateAmount += hateAmount;
+    else
+      listEntry.m_hateAmount = 0;
+
+    if( hateAmount >= 0 )
+      hateListRaise( index );
+    else if( index == m_hateListTop )
+      hateListFindTop();
+
+    if( auto player = pChara->getAsPlayer() )
     {
-      auto currentHate = listEntry->m_hateAmount;
-      if( hateAmount >= 0 || currentHate > abs( hateAmount ) )
-        listEntry->m_hateAmount += hateAmount;
-      else
-        listEntry->m_hateAmount = 0;
-      hasEntry = true;
-
-      if( auto player = pChara->getAsPlayer() )
-      {
-        player->hateListLetterUpdate( *this );
-        World::Manager::PlayerMgr::sendDebug( *player, "New Aggro: {}, Aggro gained: {}", listEntry->m_hateAmount,
-                                              hateAmount );
-      }
-      break;
+      player->hateListLetterUpdate( *this );
+      World::Manager::PlayerMgr::sendDebug( *player, "New Aggro: {}, Aggro gained: {}", listEntry.m_hateAmount,
+                                            hateAmount );
     }
   }
-
-  if( !hasEntry )
+  else
   {
     hateListAdd( pChara, hateAmount );
   }
@@ -642,19 +657,24 @@ void BNpc::hateListUpdate( const CharaPtr& pChara, int32_t hateAmount )
 
 void BNpc::hateListRemove( const CharaPtr& pChara )
 {
-  for( const auto& listEntry : m_hateList )
-  {
-    if( listEntry->m_pChara == pChara )
-    {
-      m_hateList.erase( listEntry );
+  auto index = hateListIndexOf( pChara->getId() );
+  if( index == m_hateList.size() )
+    return;
 
-      if( pChara->isPlayer() )
-      {
-        PlayerPtr tmpPlayer = pChara->getAsPlayer();
-        tmpPlayer->onMobDeaggro( *this );
-      }
-      return;
-    }
+  const auto last = m_hateList.size() - 1;
+  if( index != last )
+    m_hateList[ index ] = std::move( m_hateList[ last ] );
+  m_hateList.pop_back();
+
+  if( m_hateListTop == index )
+    hateListFindTop();
+  else if( m_hateListTop == last )
+    m_hateListTop = index;
+
+  if( pChara->isPlayer() )
+  {
+    PlayerPtr tmpPlayer = pChara->getAsPlayer();
+    tmpPlayer->onMobDeaggro( *this );
   }
 }
 
@@ -670,17 +690,17 @@ void BNpc::setTriggerOwnerId( uint32_t triggerOwnerId )
 
 bool BNpc::hateListHasActor( const Sapphire::Entity::CharaPtr& pChara )
 {
-  return std::any_of( m_hateList.begin(), m_hateList.end(),
-                      [ pChara ]( const auto& entry ) { return entry->m_pChara == pChara; } );
+  return hateListIndexOf( pChara->getId() ) != m_hateList.size();
 }
 
 std::vector< CharaPtr > BNpc::getHateList()
 {
-  std::vector< CharaPtr > hateList = {};
+  std::vector< CharaPtr > hateList;
+  hateList.reserve( m_hateList.size() );
 
   for( auto& entry : m_hateList )
   {
-    hateList.push_back( entry->m_pChara );
+    hateList.push_back( entry.m_pChara );
   }
 
   return hateList;
@@ -688,12 +708,22 @@ std::vector< CharaPtr > BNpc::getHateList()
 
 void BNpc::hateListUpdatePlayers()
 {
+  m_hateListDirty = true;
+}
+
+void BNpc::hateListFlush()
+{
+  if( !m_hateListDirty )
+    return;
+
+  m_hateListDirty = false;
+
   for( const auto& listEntry : m_hateList )
   {
     // update entire hatelist for all players who are on aggro with this bnpc
-    if( listEntry->m_pChara->isPlayer() )
+    if( listEntry.m_pChara->isPlayer() )
     {
-      auto pPlayer = listEntry->m_pChara->getAsPlayer();
+      auto pPlayer = listEntry.m_pChara->getAsPlayer();
       Network::Util::Packet::sendHateList( *pPlayer );
     }
   }
@@ -784,6 +814,8 @@ void BNpc::onTick()
 
 void BNpc::update( uint64_t tickCount )
 {
+  SAPPHIRE_PROFILE_SCOPE( "bnpc.update" );
+
   Chara::update( tickCount );
 
   checkAggro();
@@ -792,6 +824,8 @@ void BNpc::update( uint64_t tickCount )
   sendPositionUpdate( tickCount );
 
   m_fsm->update( *this, tickCount );
+
+  hateListFlush();
 }
 
 void BNpc::restHp()
@@ -839,19 +873,25 @@ void BNpc::onDeath()
   auto& exdData = Common::Service< Data::ExdData >::ref();
   auto paramGrowthInfo = exdData.getRow< Excel::ParamGrow >( m_level );
 
-  for( const auto& pHateEntry : m_hateList )
+  std::vector< Entity::PlayerPtr > players;
+  for( const auto& hateEntry : m_hateList )
   {
-    auto pPlayer = pHateEntry->m_pChara->getAsPlayer();
-    if( pPlayer )
-    {
-      // todo: get this outta here!
-      taskMgr.queueTask( makeLootBNpcTask( *pPlayer, "testTable", 2000 ) );
+    if( auto pPlayer = hateEntry.m_pChara->getAsPlayer() )
+      players.push_back( pPlayer );
+  }
 
-      playerMgr.sendDebug( *pPlayer, ( "Killed Layout ID: " + std::to_string( getLayoutId() ) ) );
+  // todo: get this outta here!
+  auto lootResults = lootTableMgr.rollLoot( lootTableMgr.getLootTableId( "testTable" ), players.size() );
 
-      playerMgr.onMobKill( *pPlayer, *this );
-      playerMgr.onGainExp( *pPlayer, paramGrowthInfo->data().BaseExp );
-    }
+  for( size_t i = 0; i < players.size(); ++i )
+  {
+    auto& pPlayer = players[ i ];
+    taskMgr.queueTask( makeLootBNpcTask( *pPlayer, std::move( lootResults[ i ] ), 2000 ) );
+
+    playerMgr.sendDebug( *pPlayer, ( "Killed Layout ID: " + std::to_string( getLayoutId() ) ) );
+
+    playerMgr.onMobKill( *pPlayer, *this );
+    playerMgr.onGainExp( *pPlayer, paramGrowthInfo->data().BaseExp );
   }
 
   hateListClear();
@@ -1112,7 +1152,7 @@ void BNpc::setOwner( const CharaPtr& m_pChara )
   auto setOwnerPacket = makeZonePacket< FFXIVIpcFirstAttack >( getId() );
   setOwnerPacket->data().Type = 0x01;
   setOwnerPacket->data().Id = targetId;
-  server().queueForPlayers( getInRangePlayerIds(), setOwnerPacket );
+  server().queueForInRangePlayers( *this, false, setOwnerPacket );
 }
 
 void BNpc::setLevelId( uint32_t levelId )
@@ -1130,6 +1170,26 @@ uint32_t BNpc::getFlags() const
   return m_flags;
 }
 
+void BNpc::wakeNaviAgent( Common::Navi::NaviProvider& naviProvider )
+{
+  if( getAgentId() != -1 )
+    return;
+
+  setAgentId( naviProvider.addAgent( getPos(), getRadius(), getCurrentSpeed() ) );
+
+  if( getAgentId() != -1 && m_naviIsPathing )
+    naviProvider.setMoveTarget( getAgentId(), m_naviTarget );
+}
+
+void BNpc::sleepNaviAgent( Common::Navi::NaviProvider& naviProvider )
+{
+  if( getAgentId() == -1 )
+    return;
+
+  naviProvider.removeAgent( getAgentId() );
+  setAgentId( -1 );
+}
+
 bool BNpc::hasFlag( uint32_t flag ) const
 {
   return m_flags & flag;
@@ -1151,6 +1211,7 @@ void BNpc::resetFlags( uint32_t flags )
     Logger::debug( "{} {} Pathing deactivated", m_id, getAgentId() );
     auto pNaviProvider = pZone->getNaviProvider();
     pNaviProvider->removeAgent( getAgentId() );
+    setAgentId( -1 );
     setPathingActive( false );
   }
   else if( pZone && ( oldFlags & Entity::Immobile ) == Entity::Immobile &&
@@ -1181,6 +1242,7 @@ void BNpc::setFlag( uint32_t flag )
     Logger::debug( "{} {} Pathing deactivated", m_id, getAgentId() );
     auto pNaviProvider = pZone->getNaviProvider();
     pNaviProvider->removeAgent( getAgentId() );
+    setAgentId( -1 );
     setPathingActive( false );
   }
   else if( pZone && ( oldFlags & Entity::Immobile ) == Entity::Immobile &&
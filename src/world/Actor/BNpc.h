@@ -14,6 +14,7 @@ namespace Sapphire::Entity
 {
 
   struct HateListEntry {
+    uint32_t m_entityId;
     uint32_t m_hateAmount;
     CharaPtr m_pChara;
   };
@@ -108,6 +109,12 @@ namespace Sapphire::Entity
 
     bool moveTo( const Entity::Chara& targetChara );
 
+    // adds the crowd agent of a dormant bnpc back to the crowd, resuming the path it was on
+    void wakeNaviAgent( Common::Navi::NaviProvider& naviProvider );
+
+    // removes the crowd agent while no player is around, the bnpc keeps its position and path target
+    void sleepNaviAgent( Common::Navi::NaviProvider& naviProvider );
+
     void sendPositionUpdate( uint64_t tickCount );
 
     BNpcState getState() const;
@@ -115,7 +122,7 @@ namespace Sapphire::Entity
 
     float getCurrentSpeed() const;
 
-    const std::set< std::shared_ptr< HateListEntry > >& getHateList() const;
+    const std::vector< HateListEntry >& getHateList() const;
     void hateListClear();
     uint32_t hateListGetValue( const Sapphire::Entity::CharaPtr& pChara );
     uint32_t hateListGetHighestValue();
@@ -126,7 +133,9 @@ namespace Sapphire::Entity
     void hateListRemove( const CharaPtr& pChara );
     bool hateListHasActor( const CharaPtr& pChara );
     std::vector< CharaPtr > getHateList() override;
+    // marks the hate list for sending, players get it once per update no matter how often it changed
     void hateListUpdatePlayers();
+    void hateListFlush();
 
     void aggro( const CharaPtr& pChara );
     void deaggro( const CharaPtr& pChara );
@@ -198,6 +207,11 @@ namespace Sapphire::Entity
     void setCanSwapTarget( bool value );
 
   private:
+    size_t hateListIndexOf( uint32_t entityId ) const;
+    // call after the hate of the entry at index went up
+    void hateListRaise( size_t index );
+    void hateListFindTop();
+
     uint32_t m_bNpcBaseId;
     uint32_t m_bNpcNameId;
     uint64_t m_weaponMain;
@@ -241,7 +255,11 @@ namespace Sapphire::Entity
     uint64_t m_lastPosUpdate{0};
 
     BNpcState m_state;
-    std::set< std::shared_ptr< HateListEntry > > m_hateList;
+    // flat and keyed by entity id, a scan over a few dozen entries beats any tree
+    std::vector< HateListEntry > m_hateList;
+    // index of the entry with the most hate, only rescanned when that entry loses hate or leaves
+    size_t m_hateListTop{ 0 };
+    bool m_hateListDirty{ false };
     bool m_canSwapTarget{ true };
 
     uint64_t m_naviLastUpdate;
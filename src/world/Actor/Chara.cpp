@@ -557,7 +557,7 @@ void Chara::autoAttack( CharaPtr pTarget )
     effectEntry.Arg2 = 0x71;
     effectPacket->addTargetEffect( effectEntry );
 
-    server().queueForPlayers( getInRangePlayerIds(), effectPacket );
+    server().queueForInRangePlayers( *this, false, effectPacket );
 
     pTarget->takeDamage( damage, false );
   }
@@ -798,7 +798,7 @@ void Chara::sendStatusEffectUpdate()
     slot++;
   }
 
-  server().queueForPlayers( getInRangePlayerIds( isPlayer() ), statusEffectList );
+  server().queueForInRangePlayers( *this, isPlayer(), statusEffectList );
 }
 
 void Chara::updateStatusEffects()
@@ -1110,34 +1110,52 @@ void Chara::knockback( const Vector3& origin, float distance, bool ignoreNav )
   auto kbPos = Common::Util::getKnockbackPosition( origin, m_pos, distance );
   auto& teriMgr = Common::Service< Manager::TerritoryMgr >::ref();
   auto pTeri = teriMgr.getTerritoryByGuId( getTerritoryId() );
+  auto pNav = pTeri->getNaviProvider();
 
-  if( !ignoreNav )
+  if( !ignoreNav && pNav && pNav->hasNaviMesh() )
   {
-    auto pNav = pTeri->getNaviProvider();
-    auto path = pNav->findFollowPath( m_pos, kbPos );
+    // searched on a path worker, the position is moved onto the path once it is back next tick
+    std::weak_ptr< Chara > weakChara = getAsChara();
+    auto territoryId = getTerritoryId();
 
-    Vector3 navPos{ origin };
-    float prevDistance{ 1000.f };
-    for( const auto& point : path )
+    pNav->requestFollowPath( m_pos, kbPos, [ weakChara, territoryId, kbPos ]( std::vector< Vector3 > path )
     {
-      auto navDist = Common::Util::distance( kbPos, point );
-      if( navDist < prevDistance )
+      auto pChara = weakChara.lock();
+      if( !pChara || pChara->getTerritoryId() != territoryId || path.empty() )
+        return;
+
+      auto& teriMgr = Common::Service< Manager::TerritoryMgr >::ref();
+      auto pTeri = teriMgr.getTerritoryByGuId( territoryId );
+      if( !pTeri )
+        return;
+
+      Vector3 navPos{ path.front() };
+      float prevDistance{ 1000.f };
+      for( const auto& point : path )
       {
-        navPos = point;
-        prevDistance = navDist;
+        auto navDist = Common::Util::distance( kbPos, point );
+        if( navDist < prevDistance )
+        {
+          navPos = point;
+          prevDistance = navDist;
+        }
       }
-    }
-    setPos( navPos );
+      pChara->setPos( navPos );
+
+      // speed needs to be reset properly here
+      auto pNav = pTeri->getNaviProvider();
+      if( !pChara->isPlayer() && pNav )
+        pChara->setAgentId( pNav->updateAgentPosition( pChara->getAgentId(), pChara->getPos(), pChara->getRadius(),
+                                                       pNav->getAgentSpeed( pChara->getAgentId() ) ) );
 
-    // speed needs to be reset properly here
-    if( !isPlayer() )
-      setAgentId( pNav->updateAgentPosition( getAgentId(), getPos(), getRadius(), pNav->getAgentSpeed( getAgentId() ) ) );
+      pTeri->updateActorPosition( *pChara );
+    } );
   }
   else
   {
     setPos( kbPos );
+    pTeri->updateActorPosition( *this );
   }
-  pTeri->updateActorPosition( *this );
 
   auto pTransferPacket = makeZonePacket< FFXIVIpcTransfer >( getId() );
   pTransferPacket->data().dir = Common::Util::floatToUInt16Rot( getRot() );
@@ -1147,7 +1165,7 @@ void Chara::knockback( const Vector3& origin, float distance, bool ignoreNav )
   pTransferPacket->data().duration = 1.0f;
 
   // todo: send the correct knockback packet to player
-  server().queueForPlayers( getInRangePlayerIds(),
+  server().queueForInRangePlayers( *this, false,
                             pTransferPacket );
 }
 
@@ -216,10 +216,11 @@ void GameObject::addInRangeActor( GameObjectPtr pActor )
   {
     auto pPlayer = pActor->getAsPlayer();
 
-    spawn( pPlayer );
-
-    // if actor is a player, add it to the in range player set
-    m_inRangePlayers.insert( pPlayer );
+    // charas count against the visible actor budget of the player, the interest manager spawns them
+    if( isChara() )
+      pPlayer->setInterestDirty( true );
+    else
+      showTo( pPlayer );
   }
   else if( pActor->isBattleNpc() )
   {
@@ -244,13 +245,23 @@ void GameObject::removeInRangeActor( GameObject& actor )
   // remove actor from in range actor set
   m_inRangeActor.erase( actor.shared_from_this() );
 
-  // if actor is a player, despawn ourself for him
+  // if we are a player, the actor leaving is despawned for us
   // TODO: move to virtual onRemove?
   if( isPlayer() )
-    actor.despawn( getAsPlayer() );
+  {
+    auto pPlayer = getAsPlayer();
+
+    // nothing is sent if the actor already hid itself when it was told first
+    actor.hideFrom( pPlayer );
 
+    // a free spot in the budget for the next best actor
+    if( actor.isChara() )
+      pPlayer->setInterestDirty( true );
+  }
+
+  // a player leaving no longer sees us
   if( actor.isPlayer() )
-    m_inRangePlayers.erase( actor.getAsPlayer() );
+    hideFrom( actor.getAsPlayer() );
 
   if( actor.isBattleNpc() )
     m_inRangeBNpc.erase( actor.getAsBNpc() );
@@ -318,6 +329,8 @@ void GameObject::clearInRangeSet()
   m_inRangeActor.clear();
   m_inRangePlayers.clear();
   m_inRangeBNpc.clear();
+  m_moveDetail.clear();
+  m_pPendingMove.reset();
 }
 
 /*! \return list of actors currently in range */
@@ -343,6 +356,102 @@ std::set< uint64_t > GameObject::getInRangePlayerIds( bool includeSelf )
   return playerIds;
 }
 
+const std::set< PlayerPtr >& GameObject::getInRangePlayers() const
+{
+  return m_inRangePlayers;
+}
+
+const std::set< GameObjectPtr >& GameObject::getInRangeActorSet() const
+{
+  return m_inRangeActor;
+}
+
+const Vector3& GameObject::getInRangeUpdatePos() const
+{
+  return m_inRangeUpdatePos;
+}
+
+void GameObject::setInRangeUpdatePos( const Vector3& pos )
+{
+  m_inRangeUpdatePos = pos;
+}
+
+void GameObject::showTo( const PlayerPtr& pPlayer )
+{
+  if( !m_inRangePlayers.insert( pPlayer ).second )
+    return;
+
+  spawn( pPlayer );
+}
+
+void GameObject::hideFrom( const PlayerPtr& pPlayer )
+{
+  m_moveDetail.erase( pPlayer );
+  if( m_inRangePlayers.erase( pPlayer ) == 0 )
+    return;
+
+  despawn( pPlayer );
+}
+
+bool GameObject::isShownTo( const PlayerPtr& pPlayer ) const
+{
+  return m_inRangePlayers.find( pPlayer ) != m_inRangePlayers.end();
+}
+
+void GameObject::setMoveDetailFor( const PlayerPtr& pPlayer, MoveDetail detail )
+{
+  auto it = m_moveDetail.find( pPlayer );
+  if( it == m_moveDetail.end() )
+  {
+    if( detail != MoveDetail::Full )
+      m_moveDetail.emplace( pPlayer, MoveObserver{ detail } );
+    return;
+  }
+
+  // a player with withheld updates is kept until the pending move caught it up
+  if( detail == MoveDetail::Full && !it->second.withheld )
+    m_moveDetail.erase( it );
+  else
+    it->second.detail = detail;
+}
+
+MoveDetail GameObject::getMoveDetailFor( const PlayerPtr& pPlayer ) const
+{
+  auto it = m_moveDetail.find( pPlayer );
+  return it != m_moveDetail.end() ? it->second.detail : MoveDetail::Full;
+}
+
+MoveObserver* GameObject::getMoveObserver( const PlayerPtr& pPlayer )
+{
+  auto it = m_moveDetail.find( pPlayer );
+  return it != m_moveDetail.end() ? &it->second : nullptr;
+}
+
+uint32_t GameObject::nextMoveUpdate()
+{
+  return m_moveUpdateCount++;
+}
+
+uint64_t GameObject::getCoarseMoveKey() const
+{
+  // one cell is 32 packet position units, about a yalm, and 16 rotation steps
+  uint64_t key = Common::Util::floatToUInt16( m_pos.x ) >> 5u;
+  key |= static_cast< uint64_t >( Common::Util::floatToUInt16( m_pos.y ) >> 5u ) << 11u;
+  key |= static_cast< uint64_t >( Common::Util::floatToUInt16( m_pos.z ) >> 5u ) << 22u;
+  key |= static_cast< uint64_t >( getRotUInt8() >> 4u ) << 33u;
+  return key;
+}
+
+const Sapphire::Network::Packets::FFXIVPacketBasePtr& GameObject::getPendingMove() const
+{
+  return m_pPendingMove;
+}
+
+void GameObject::setPendingMove( Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket )
+{
+  m_pPendingMove = std::move( pPacket );
+}
+
 uint32_t GameObject::getTerritoryTypeId() const
 {
   return m_territoryTypeId;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Common.h>
+#include <Forwards.h>
 #include <memory>
 
 #include "ForwardsZone.h"
@@ -10,6 +11,24 @@
 
 namespace Sapphire::Entity
 {
+  // how many of the movement updates of an object a player gets, picked by the interest manager
+  enum class MoveDetail : uint8_t
+  {
+    Full,
+    Reduced,
+    Suppressed
+  };
+
+  // what a player not getting every movement update of an object has seen of it
+  struct MoveObserver
+  {
+    MoveDetail detail;
+    // coarse position and rotation last sent to the player
+    uint64_t lastCoarseKey{ 0 };
+    // an update was held back from the player since the last one it got
+    bool withheld{ false };
+  };
+
   /*!
   \class GameObject
   \brief Base class for all actor/objects
@@ -39,11 +58,20 @@ namespace Sapphire::Entity
     uint32_t m_obstacleRef{ 0 };
     /*! list of various actors in range */
     std::set< GameObjectPtr > m_inRangeActor;
+    /*! players this object is spawned for, everything it broadcasts goes to them */
     std::set< PlayerPtr > m_inRangePlayers;
     std::set< BNpcPtr > m_inRangeBNpc;
+    /*! players of m_inRangePlayers not getting every movement update, players missing here get all of them */
+    std::map< PlayerPtr, MoveObserver > m_moveDetail;
+    /*! movement updates broadcast so far, picks the updates players with less detail get */
+    uint32_t m_moveUpdateCount{ 0 };
+    /*! latest movement update withheld from players with less detail, sent to them once the object stops */
+    Network::Packets::FFXIVPacketBasePtr m_pPendingMove;
 
     /*! Parent cell in the zone */
     Common::CellId m_cellId;
+    /*! Position the in range set was last updated at */
+    Common::Vector3 m_inRangeUpdatePos{};
 
   public:
     explicit GameObject( Common::ObjKind type );
@@ -121,6 +149,37 @@ namespace Sapphire::Entity
 
     std::set< uint64_t > getInRangePlayerIds( bool includeSelf = false );
 
+    const std::set< PlayerPtr >& getInRangePlayers() const;
+
+    const std::set< GameObjectPtr >& getInRangeActorSet() const;
+
+    const Common::Vector3& getInRangeUpdatePos() const;
+    void setInRangeUpdatePos( const Common::Vector3& pos );
+
+    // spawn this object for pPlayer and add pPlayer to the players receiving its broadcasts
+    void showTo( const PlayerPtr& pPlayer );
+
+    // counterpart of showTo, does nothing if this object is not shown to pPlayer
+    void hideFrom( const PlayerPtr& pPlayer );
+
+    bool isShownTo( const PlayerPtr& pPlayer ) const;
+
+    void setMoveDetailFor( const PlayerPtr& pPlayer, MoveDetail detail );
+
+    MoveDetail getMoveDetailFor( const PlayerPtr& pPlayer ) const;
+
+    // counts a movement broadcast, returns the index of this one
+    uint32_t nextMoveUpdate();
+
+    // position and rotation snapped to a coarse grid, movement inside one cell is not sent to players with less detail
+    uint64_t getCoarseMoveKey() const;
+
+    // nullptr for players getting every movement update
+    MoveObserver* getMoveObserver( const PlayerPtr& pPlayer );
+
+    const Network::Packets::FFXIVPacketBasePtr& getPendingMove() const;
+    void setPendingMove( Network::Packets::FFXIVPacketBasePtr pPacket );
+
     ////////////////////////////////////////////////////
 
     CharaPtr getAsChara();
@@ -952,6 +952,26 @@ void Player::setLoadingComplete( bool bComplete )
   m_bLoadingComplete = bComplete;
 }
 
+void Player::setInterestDirty( bool dirty )
+{
+  m_interestDirty = dirty;
+}
+
+bool Player::isInterestDirty() const
+{
+  return m_interestDirty;
+}
+
+uint64_t Player::getLastInterestUpdate() const
+{
+  return m_lastInterestUpdate;
+}
+
+void Player::setLastInterestUpdate( uint64_t tickCount )
+{
+  m_lastInterestUpdate = tickCount;
+}
+
 void Player::setSearchInfo( uint8_t selectRegion, uint8_t selectClass, const char* searchMessage )
 {
   m_searchSelectRegion = selectRegion;
@@ -1735,6 +1755,26 @@ void Player::setConnected( bool isConnected )
   m_bIsConnected = isConnected;
 }
 
+void Player::setZoneConnection( const Network::GameConnectionPtr& pZoneCon )
+{
+  m_pZoneConnection = pZoneCon;
+}
+
+void Player::setChatConnection( const Network::GameConnectionPtr& pChatCon )
+{
+  m_pChatConnection = pChatCon;
+}
+
+Network::GameConnectionPtr Player::getZoneConnection() const
+{
+  return m_pZoneConnection.lock();
+}
+
+Network::GameConnectionPtr Player::getChatConnection() const
+{
+  return m_pChatConnection.lock();
+}
+
 void Player::updatePrevTerritory()
 {
   auto& teriMgr = Common::Service< World::Manager::TerritoryMgr >::ref();
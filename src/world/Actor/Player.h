@@ -15,6 +15,11 @@
 #include <queue>
 #include <array>
 
+namespace Mysql
+{
+  class PreparedResultSet;
+}
+
 namespace Sapphire::Entity
 {
 
@@ -84,7 +89,7 @@ namespace Sapphire::Entity
     // Quest
     //////////////////////////////////////////////////////////////////////////////////////////////////////
     /*! load data for currently active quests */
-    bool loadActiveQuests();
+    bool loadActiveQuests( std::shared_ptr< Mysql::PreparedResultSet > res );
 
     /*! update quest ( register it as active quest if new ) */
     void updateQuest( const World::Quest& quest );
@@ -529,29 +534,32 @@ namespace Sapphire::Entity
     /*! generate the update sql based on update flags */
     void updateSql();
 
-    /*! initialize player data from db, by character id */
+    /*! initialize player data from db, by character id, blocks until the player is loaded */
     bool loadFromDb( uint64_t characterId );
 
+    /*! initialize player data from db on the db workers, onLoaded is called on the tick once it is done */
+    void loadFromDbAsync( uint64_t characterId, std::function< void( bool ) > onLoaded );
+
     /*! unload player from logout */
     void unload();
 
     /*! load achievement data */
-    bool loadAchievements();
+    bool loadAchievements( std::shared_ptr< Mysql::PreparedResultSet > res );
 
     /*! load active class data */
-    bool loadClassData();
+    bool loadClassData( std::shared_ptr< Mysql::PreparedResultSet > res );
 
     /*! load search info */
-    bool loadSearchInfo();
+    bool loadSearchInfo( std::shared_ptr< Mysql::PreparedResultSet > res );
 
     /*! load hunting log entries */
-    bool loadHuntingLog();
+    bool loadHuntingLog( std::shared_ptr< Mysql::PreparedResultSet > res );
 
     /*! load friendlist */
-    bool loadFriendList();
+    bool loadFriendList( std::shared_ptr< Mysql::PreparedResultSet > res );
 
     /*! load blacklist */
-    bool loadBlacklist();
+    bool loadBlacklist( std::shared_ptr< Mysql::PreparedResultSet > res );
 
     /*! update latest sync with db */
     bool syncLastDBWrite();
@@ -573,6 +581,14 @@ namespace Sapphire::Entity
     /*! set the loading complete bool */
     void setLoadingComplete( bool bComplete );
 
+    /*! flags the visible actors for re-ranking by the interest manager on the next update */
+    void setInterestDirty( bool dirty );
+    bool isInterestDirty() const;
+
+    /*! time of the last visible actor ranking */
+    uint64_t getLastInterestUpdate() const;
+    void setLastInterestUpdate( uint64_t tickCount );
+
     void setSearchInfo( uint8_t selectRegion, uint8_t selectClass, const char* searchMessage );
 
     const char* getSearchMessage() const;
@@ -698,6 +714,7 @@ namespace Sapphire::Entity
 
     // Inventory Handling
     //////////////////////////////////////////////////////////////////////////////////////////////////////
+    /*! set up the empty containers, loadInventory fills them */
     void initInventory();
 
     void setRunning( bool isRunning );
@@ -801,11 +818,26 @@ namespace Sapphire::Entity
     bool isConnected() const;
     void setConnected( bool isConnected );
 
+    /*! direct handles to the connections of this player, assigned by its session */
+    void setZoneConnection( const Network::GameConnectionPtr& pZoneCon );
+    void setChatConnection( const Network::GameConnectionPtr& pChatCon );
+    Network::GameConnectionPtr getZoneConnection() const;
+    Network::GameConnectionPtr getChatConnection() const;
+
     const Common::CharaLandData& getCharaLandData( Common::LandFlagsSlot slot ) const;
 
   private:
     using InventoryMap = std::map< uint16_t, ItemContainerPtr >;
 
+    /*! runs every query of a load on the db workers, onQueried is called on a worker thread once all are in */
+    void queryFromDb( uint64_t characterId, std::function< void( bool ) > onQueried );
+
+    /*! load the charainfo row */
+    void loadCharaInfo( std::shared_ptr< Mysql::PreparedResultSet > res );
+
+    /*! derive what is not stored from the loaded data, runs on the thread that waited for the load */
+    void finishLoad();
+
     uint64_t m_lastDBWrite;
 
     bool m_bIsLogin;
@@ -908,8 +940,15 @@ namespace Sapphire::Entity
     bool m_bLoadingComplete;
     bool m_bAutoattack;
 
+    bool m_interestDirty{ true };
+    uint64_t m_lastInterestUpdate{ 0 };
+
     bool m_bIsConnected;
 
+    // weakly held, a dropped connection must not be kept alive by its player
+    std::weak_ptr< Network::GameConnection > m_pZoneConnection;
+    std::weak_ptr< Network::GameConnection > m_pChatConnection;
+
     bool m_bNewAdventurer{};
     uint64_t m_onlineStatus;
     uint64_t m_onlineStatusCustom;
@@ -42,7 +42,7 @@ void Player::initInventory()
   const uint8_t inventorySize = 25;
   auto setupContainer = [ this ]( InventoryType type, uint8_t maxSize, const std::string& tableName,
                                   bool isMultiStorage, bool isPersistentStorage = true )
-  { m_storageMap[ type ] = make_ItemContainer( type, maxSize, tableName, isMultiStorage, isPersistentStorage ); };
+  { m_storageMap[ type ] = make_ItemContainer( type, maxSize, tableName, isMultiStorage, isPersistentStorage, getCharacterId() ); };
 
   // main bags
   setupContainer( Bag0, inventorySize, "charaiteminventory", true );
@@ -101,9 +101,6 @@ void Player::initInventory()
   // item hand in container
   // non-persistent container, will not save its contents
   setupContainer( HandIn, 10, "", true, false );
-
-  loadInventory();
-  calculateItemLevel();
 }
 
 void Player::equipWeapon( const Item& item )
@@ -571,7 +568,7 @@ void Player::writeInventory( InventoryType type )
   if( storage->isMultiStorage() )
     query += " AND storageId = " + std::to_string( static_cast< uint16_t >( type ) );
 
-  db.execute( query );
+  db.execute( query, getCharacterId() );
 }
 
 void Player::writeItem( ItemPtr pItem ) const
@@ -587,7 +584,8 @@ void Player::writeItem( ItemPtr pItem ) const
 
   stmt->setInt64( 5, pItem->getUId() );
 
-  db.directExecute( stmt );
+  // item rows are ordered by their owner, same as the containers holding them
+  db.execute( stmt, getCharacterId() );
 }
 
 void Player::writeCurrencyItem( CurrencyType type )
@@ -600,7 +598,7 @@ void Player::writeCurrencyItem( CurrencyType type )
     "UPDATE charaitemcurrency SET container_{0} = {1} WHERE CharacterId = {2};",
     std::to_string( static_cast< int16_t >( type ) - 1 ), std::to_string( money ), std::to_string( getCharacterId() ) );
 
-  db.execute( query );
+  db.execute( query, getCharacterId() );
 }
 
 void Player::deleteItemDb( ItemPtr item ) const
@@ -610,7 +608,7 @@ void Player::deleteItemDb( ItemPtr item ) const
 
   stmt->setInt64( 1, item->getUId() );
 
-  db.directExecute( stmt );
+  db.execute( stmt, getCharacterId() );
 }
 
 
@@ -6,6 +6,8 @@
 #include <Database/DatabaseDef.h>
 #include <Service.h>
 #include <type_traits>
+#include <atomic>
+#include <future>
 
 #include "Network/PacketWrappers/PlayerSetupPacket.h"
 
@@ -24,19 +26,139 @@ using namespace Sapphire::Network::Packets;
 using namespace Sapphire::Network::Packets::WorldPackets::Server;
 using namespace Sapphire::World::Manager;
 
+namespace
+{
+  // shared by the queries of one player load, whichever finishes last reports back
+  struct LoadState
+  {
+    LoadState( uint64_t characterId, size_t pending, std::function< void( bool ) > onQueried ) :
+      characterId( characterId ),
+      pending( static_cast< uint32_t >( pending ) ),
+      onQueried( std::move( onQueried ) )
+    {
+    }
+
+    void finish()
+    {
+      if( --pending != 0 )
+        return;
+
+      if( !valid )
+        Logger::error( "chara#{0} data corrupt!", characterId );
+
+      onQueried( true );
+    }
+
+    uint64_t characterId;
+    std::atomic< uint32_t > pending;
+    std::atomic< bool > valid{ true };
+    std::function< void( bool ) > onQueried;
+  };
+}
+
 bool Player::loadFromDb( uint64_t characterId )
+{
+  std::promise< bool > queried;
+  auto result = queried.get_future();
+  queryFromDb( characterId, [ &queried ]( bool success ) { queried.set_value( success ); } );
+
+  if( !result.get() )
+    return false;
+
+  finishLoad();
+  return true;
+}
+
+void Player::loadFromDbAsync( uint64_t characterId, std::function< void( bool ) > onLoaded )
+{
+  auto pPlayer = getAsPlayer();
+  queryFromDb( characterId, [ pPlayer, onLoaded = std::move( onLoaded ) ]( bool success )
+  {
+    auto& server = Common::Service< World::WorldServer >::ref();
+    server.queueTickTask( [ pPlayer, onLoaded, success ]()
+    {
+      if( success )
+        pPlayer->finishLoad();
+      onLoaded( success );
+    } );
+  } );
+}
+
+void Player::queryFromDb( uint64_t characterId, std::function< void( bool ) > onQueried )
 {
   m_characterId = characterId;
 
   auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_SEL );  
+  auto pPlayer = getAsPlayer();
+  auto found = std::make_shared< bool >( false );
 
-  stmt->set( 1, characterId );
-  auto res = db.query( stmt );
+  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_SEL );
+  stmt->setUInt64( 1, characterId );
 
-  if( !res || !res->next() )
-    return false;
+  // queued under the character id, behind the writes of a previous session of this character
+  db.queryAsync( stmt, [ pPlayer, found ]( std::shared_ptr< Mysql::PreparedResultSet > res )
+  {
+    if( !res || !res->next() )
+      return;
 
+    pPlayer->loadCharaInfo( std::move( res ) );
+    *found = true;
+  },
+  [ pPlayer, found, characterId, onQueried = std::move( onQueried ) ]()
+  {
+    if( !*found )
+    {
+      onQueried( false );
+      return;
+    }
+
+    auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+
+    // the remaining character tables are independent of each other, spreading them over the workers
+    // makes the rest of the load cost about one more round trip
+    using Loader = bool ( Player::* )( std::shared_ptr< Mysql::PreparedResultSet > );
+    const std::pair< Db::ZoneDbStatements, Loader > loaders[] =
+    {
+      { Db::ZoneDbStatements::CHARA_SEL_QUEST, &Player::loadActiveQuests },
+      { Db::ZoneDbStatements::CHARA_CLASS_SEL, &Player::loadClassData },
+      { Db::ZoneDbStatements::CHARA_SEL_SEARCHINFO, &Player::loadSearchInfo },
+      { Db::ZoneDbStatements::CHARA_MONSTERNOTE_SEL, &Player::loadHuntingLog },
+      { Db::ZoneDbStatements::CHARA_FRIENDLIST_SEL, &Player::loadFriendList },
+      { Db::ZoneDbStatements::CHARA_BLACKLIST_SEL, &Player::loadBlacklist },
+      { Db::ZoneDbStatements::CHARA_ACHIEV_SEL, &Player::loadAchievements },
+    };
+
+    // one more for the inventory
+    auto state = std::make_shared< LoadState >( characterId, std::size( loaders ) + 1, onQueried );
+    uint64_t orderKey = characterId;
+
+    for( const auto& [ index, loader ] : loaders )
+    {
+      auto loadStmt = db.getPreparedStatement( index );
+      loadStmt->setUInt64( 1, characterId );
+      db.queryAsync( loadStmt, [ pPlayer, loader = loader, state ]( std::shared_ptr< Mysql::PreparedResultSet > res )
+      {
+        if( !( pPlayer.get()->*loader )( std::move( res ) ) )
+          state->valid = false;
+      },
+      [ state ]() { state->finish(); }, orderKey++ );
+    }
+
+    // item and container rows are written under the character id as well, so whatever was queued before the
+    // charainfo row is through already. The item queries depend on the container rows, one job runs all of them
+    db.post( [ pPlayer, state ]()
+    {
+      pPlayer->initInventory();
+      if( !pPlayer->loadInventory() )
+        state->valid = false;
+      pPlayer->syncLastDBWrite();
+    },
+    [ state ]() { state->finish(); }, characterId );
+  }, characterId );
+}
+
+void Player::loadCharaInfo( std::shared_ptr< Mysql::PreparedResultSet > res )
+{
   m_id = res->getUInt( "EntityId" );
 
   auto name = res->getString( "Name" );
@@ -154,14 +276,11 @@ bool Player::loadFromDb( uint64_t characterId )
   m_mp = res->getUInt( "Mp" );
   m_tp = res->getUInt( "Tp" );
   m_mount = res->getUInt8( "Mount" );
-  res.reset();
-
-  if( !loadActiveQuests() || !loadClassData() || !loadSearchInfo() || !loadHuntingLog() || !loadFriendList() || !loadBlacklist() || !loadAchievements() )
-  {
-    Logger::error( "chara#{0} data corrupt!", m_characterId );
-  }
+}
 
-  initInventory();
+void Player::finishLoad()
+{
+  calculateItemLevel();
 
   m_maxHp = getMaxHp();
   m_maxMp = getMaxMp();
@@ -181,19 +300,10 @@ bool Player::loadFromDb( uint64_t characterId )
 
   if( m_hp == 0 )
     m_status = ActorStatus::Dead;
-
-  syncLastDBWrite();
-
-  return true;
 }
 
-bool Player::loadActiveQuests()
+bool Player::loadActiveQuests( std::shared_ptr< Mysql::PreparedResultSet > res )
 {
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_SEL_QUEST );
-
-  stmt->setUInt64( 1, m_characterId );
-  auto res = db.query( stmt );
   if( !res )
     return false;
 
@@ -220,13 +330,8 @@ bool Player::loadActiveQuests()
 
 }
 
-bool Player::loadAchievements()
+bool Player::loadAchievements( std::shared_ptr< Mysql::PreparedResultSet > res )
 {
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_ACHIEV_SEL );
-
-  stmt->setUInt64( 1, m_characterId );
-  auto res = db.query( stmt );
   if( !res )
     return false;
 
@@ -265,13 +370,9 @@ bool Player::loadAchievements()
   return true;
 }
 
-bool Player::loadClassData()
+bool Player::loadClassData( std::shared_ptr< Mysql::PreparedResultSet > res )
 {
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
   // ClassIdx, Exp, Lvl, BorrowAction
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_CLASS_SEL );
-  stmt->setUInt64( 1, m_characterId );
-  auto res = db.query( stmt );
   if( !res )
     return false;
 
@@ -293,13 +394,8 @@ bool Player::loadClassData()
   return true;
 }
 
-bool Player::loadSearchInfo()
+bool Player::loadSearchInfo( std::shared_ptr< Mysql::PreparedResultSet > res )
 {
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_SEL_SEARCHINFO );
-  stmt->setUInt64( 1, m_characterId );
-  auto res = db.query( stmt );
-
   if( !res || !res->next() )
   {
     Logger::error( "Failed to load search info for character#{}", m_characterId );
@@ -318,13 +414,8 @@ bool Player::loadSearchInfo()
 }
 
 
-bool Player::loadHuntingLog()
+bool Player::loadHuntingLog( std::shared_ptr< Mysql::PreparedResultSet > res )
 {
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_MONSTERNOTE_SEL );
-  stmt->setUInt64( 1, m_characterId );
-  auto res = db.query( stmt );
-
   if( !res || !res->next() )
   {
     Logger::error( "Failed to load hunting log data for character#{}", m_characterId );
@@ -496,7 +587,7 @@ void Player::updateDbChara() const
 
   stmt->setUInt64( 56, m_characterId );
 
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 void Player::updateDbClass() const
@@ -517,7 +608,7 @@ void Player::updateDbClass() const
 
   stmtS->setUInt64( 4, m_characterId );
   stmtS->setInt( 5, classJobIndex );
-  db.execute( stmtS );
+  db.execute( stmtS, m_characterId );
 }
 
 void Player::updateDbMonsterNote()
@@ -535,7 +626,7 @@ void Player::updateDbMonsterNote()
     stmt->setBinary( i + 1, vector );
   }
   stmt->setUInt64( 13, m_characterId );
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 void Player::updateDbFriendList()
@@ -552,7 +643,7 @@ void Player::updateDbFriendList()
   stmt->setBinary( 1, friendIds );
   stmt->setBinary( 2, inviteIds );
   stmt->setUInt64( 3, m_characterId );
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 
@@ -567,7 +658,7 @@ void Player::updateDbBlacklist()
   std::memcpy( blIds.data(), m_blacklist.data(), 1600 );
   stmt->setBinary( 1, blIds );
   stmt->setUInt64( 2, m_characterId );
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 void Player::updateDbAchievement()
@@ -596,7 +687,7 @@ void Player::updateDbAchievement()
   stmt->setBinary( 2, progressList );
   stmt->setBinary( 3, history );
   stmt->setUInt64( 4, m_characterId );
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 
@@ -621,17 +712,17 @@ void Player::updateDbSearchInfo() const
   auto stmtS = db.getPreparedStatement( Db::CHARA_SEARCHINFO_UP_SELECTCLASS );
   stmtS->setInt( 1, m_searchSelectClass );
   stmtS->setUInt64( 2, m_characterId );
-  db.execute( stmtS );
+  db.execute( stmtS, m_characterId );
 
   auto stmtS1 = db.getPreparedStatement( Db::CHARA_SEARCHINFO_UP_SELECTREGION );
   stmtS1->setInt( 1, m_searchSelectRegion );
   stmtS1->setUInt64( 2, m_characterId );
-  db.execute( stmtS1 );
+  db.execute( stmtS1, m_characterId );
 
   auto stmtS2 = db.getPreparedStatement( Db::CHARA_SEARCHINFO_UP_SEARCHCOMMENT );
   stmtS2->setString( 1, std::string( m_searchMessage ) );
   stmtS2->setUInt64( 2, m_characterId );
-  db.execute( stmtS2 );
+  db.execute( stmtS2, m_characterId );
 }
 
 void Player::updateDbAllQuests() const
@@ -655,7 +746,7 @@ void Player::updateDbAllQuests() const
     stmtS3->setInt( 9, 0 );
     stmtS3->setUInt64( 10, m_characterId );
     stmtS3->setInt( 11, m_quests[ i ].getId() );
-    db.execute( stmtS3 );
+    db.execute( stmtS3, m_characterId );
 
   }
 }
@@ -666,7 +757,7 @@ void Player::deleteDbQuest( uint16_t questId ) const
   auto stmt = db.getPreparedStatement( Db::CHARA_QUEST_DEL );
   stmt->setUInt64( 1, m_characterId );
   stmt->setInt( 2, questId );
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 void Player::insertDbQuest( uint16_t questId, uint8_t index, uint8_t seq ) const
@@ -685,7 +776,7 @@ void Player::insertDbQuest( uint16_t questId, uint8_t index, uint8_t seq ) const
   stmt->setInt( 10, 0 );
   stmt->setInt( 11, 0 );
   stmt->setInt( 12, 0 );
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 void Player::insertDbQuest( const World::Quest& quest, uint8_t index ) const
@@ -704,7 +795,7 @@ void Player::insertDbQuest( const World::Quest& quest, uint8_t index ) const
   stmt->setInt( 10, quest.getUI8E() );
   stmt->setInt( 11, quest.getUI8F() );
   stmt->setInt( 12, 0 );
-  db.execute( stmt );
+  db.execute( stmt, m_characterId );
 }
 
 ItemPtr Player::createItem( uint32_t catalogId, uint32_t quantity, bool isHq )
@@ -724,12 +815,13 @@ ItemPtr Player::createItem( uint32_t catalogId, uint32_t quantity, bool isHq )
 
   pItem->setStackSize( quantity );
 
-  db.execute( "INSERT INTO charaglobalitem ( CharacterId, itemId, catalogId, stack, flags ) VALUES ( " +
-               std::to_string( m_characterId ) + ", " +
-               std::to_string( pItem->getUId() ) + ", " +
-               std::to_string( pItem->getId() ) + ", " +
-               std::to_string( quantity ) + ", " +
-               std::to_string( flags ) + ");" );
+  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_ITEMGLOBAL_INS_FLAGS );
+  stmt->setUInt64( 1, m_characterId );
+  stmt->setUInt64( 2, pItem->getUId() );
+  stmt->setUInt( 3, pItem->getId() );
+  stmt->setUInt( 4, quantity );
+  stmt->setUInt( 5, flags );
+  db.execute( stmt, m_characterId );
 
   return pItem;
 }
@@ -843,13 +935,8 @@ bool Player::loadInventory()
   return true;
 }
 
-bool Player::loadFriendList()
+bool Player::loadFriendList( std::shared_ptr< Mysql::PreparedResultSet > res )
 {
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_FRIENDLIST_SEL );
-  stmt->setUInt64( 1, m_characterId );
-  auto res = db.query( stmt );
-
   if( !res || !res->next() )
   {
     Logger::error( "Failed to load friendlist data for character#{}", m_characterId );
@@ -868,13 +955,8 @@ bool Player::loadFriendList()
   return true;
 }
 
-bool Player::loadBlacklist()
+bool Player::loadBlacklist( std::shared_ptr< Mysql::PreparedResultSet > res )
 {
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_BLACKLIST_SEL );
-  stmt->setUInt64( 1, m_characterId );
-  auto res = db.query( stmt );
-
   if( !res || !res->next() )
   {
     Logger::error( "Failed to load blacklist data for character#{}", m_characterId );
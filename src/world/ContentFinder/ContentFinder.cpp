@@ -3,6 +3,12 @@
 #include <Service.h>
 #include "Actor/Player.h"
 
+#include <Util/Profiler.h>
+#include <Util/Util.h>
+
+#include <algorithm>
+#include <set>
+
 #include "Network/GameConnection.h"
 #include "Network/PacketWrappers/ServerNoticePacket.h"
 #include "Network/PacketWrappers/UpdateFindContentPacket.h"
@@ -27,26 +33,43 @@ using namespace Sapphire::Network::Packets::WorldPackets;
 using namespace Sapphire::Network::Packets::WorldPackets::Server;
 using namespace Sapphire::World::Manager;
 
+namespace
+{
+  size_t bucketIndex( World::RoleBucket bucket )
+  {
+    return static_cast< size_t >( bucket );
+  }
+
+  using ShownCounts = std::array< uint8_t, static_cast< size_t >( World::RoleBucket::Count ) >;
+
+  ShownCounts getShownCounts( const World::QueuedContent& queue )
+  {
+    return { queue.getShownCount( World::RoleBucket::Tank ),
+             queue.getShownCount( World::RoleBucket::Healer ),
+             queue.getShownCount( World::RoleBucket::Dps ) };
+  }
+}
+
 void World::ContentFinder::update()
 {
+  if( m_pendingRegisterIds.empty() )
+    return;
+
   auto& exdData = Service< Data::ExdData >::ref();
   auto& server = Service< WorldServer >::ref();
-  for( auto& contentIt : m_queuedContent )
+
+  std::vector< uint32_t > pendingRegisterIds;
+  pendingRegisterIds.swap( m_pendingRegisterIds );
+
+  for( auto registerId : pendingRegisterIds )
   {
-    auto& content = contentIt.second;
+    auto content = findContentByRegisterId( registerId );
+    if( !content )
+      continue;
 
     auto contentState = content->getState();
     switch( contentState )
     {
-      case None:
-        break;
-      case MatchingInProgress:
-        if( content->m_players.empty() )
-        {
-          Logger::info( "[ContentFinder] registerId#{} scheduled for removal, no more players in queue.", content->getRegisterId() );
-          content->setState( ToBeRemoved );
-        }
-        break;
       case MatchingComplete:
       {
         auto contentInfo = exdData.getRow< Excel::InstanceContent >( content->getInstanceId() );
@@ -64,9 +87,6 @@ void World::ContentFinder::update()
         content->setState( WaitingForAccept );
         break;
       }
-
-      case WaitingForAccept:
-        break;
       case Accepted:
       {
         auto& terriMgr = Service< TerritoryMgr >::ref();
@@ -95,18 +115,11 @@ void World::ContentFinder::update()
         content->setState( InProgress );
         break;
       }
-      case InProgress:
-        break;
-      case InProgressRefill:
-        break;
       case ToBeRemoved:
-        auto regId = content->getRegisterId();
-        bool contentRemoved = removeContentByRegisterId( regId );
-        if( contentRemoved )
-        {
-          Logger::info( "[ContentFinder] registerId#{} removed", regId );
-          return;
-        }
+        if( removeContentByRegisterId( registerId ) )
+          Logger::info( "[ContentFinder] registerId#{} removed", registerId );
+        break;
+      default:
         break;
     }
   }
@@ -115,14 +128,12 @@ void World::ContentFinder::update()
 
 void World::ContentFinder::registerContentsRequest( Entity::Player &player, const std::vector< uint32_t >& contentIds )
 {
-  queueForContent( player, contentIds );
-  completeRegistration( player );
+  registerRequest( player, contentIds, false );
 }
 
 void World::ContentFinder::registerContentRequest( Entity::Player &player, uint32_t contentId, uint8_t flags )
 {
-  queueForContent( player, { contentId } );
-  completeRegistration( player, flags );
+  registerRequest( player, { contentId }, false, flags );
 }
 
 void World::ContentFinder::registerRandomContentRequest( Entity::Player &player, uint32_t randomContentTypeId )
@@ -131,27 +142,118 @@ void World::ContentFinder::registerRandomContentRequest( Entity::Player &player,
   auto contentFinderList = exdData.getRows< Excel::ContentFinderCondition >();
   std::vector< uint32_t > idList;
 
-  for( const auto& [ id, instanceContent ] : contentFinderList )
+  // queues are keyed by content finder condition like direct requests, not by the instance content it points to
+  for( const auto& [ id, contentFinderCondition ] : contentFinderList )
   {
-    if( instanceContent->data().RandomContentType == randomContentTypeId )
+    if( contentFinderCondition->data().RandomContentType == randomContentTypeId )
     {
-      if( instanceContent->data().LevelMin <= player.getLevel() )
-        idList.push_back( instanceContent->data().InstanceContentId );
+      if( contentFinderCondition->data().LevelMin <= player.getLevel() )
+        idList.push_back( id );
     }
   }
 
-  queueForContent( player, idList );
-  completeRegistration( player );
+  registerRequest( player, idList, true );
+}
+
+void World::ContentFinder::registerRequest( Entity::Player& player, const std::vector< uint32_t >& contentIds, bool random, uint8_t flags )
+{
+  auto& exdData = Service< Data::ExdData >::ref();
+
+  // a new request replaces whatever the player was still waiting for
+  auto qPlayerIt = m_queuedPlayer.find( player.getId() );
+  if( qPlayerIt != m_queuedPlayer.end() )
+    dequeue( qPlayerIt->second );
+
+  auto pQPlayer = std::make_shared< QueuedPlayer >( player, 0 );
+  pQPlayer->m_random = random;
+  pQPlayer->m_registerTime = Util::getTimeMs();
+
+  if( pQPlayer->getRoleBucket() == RoleBucket::Invalid )
+  {
+    Logger::error( "[{0}][ContentFinder] Unable to register, class job#{1} has no party role.", player.getId(), pQPlayer->m_classJob );
+    rejectRegistration( player );
+    return;
+  }
+
+  for( auto contentId : contentIds )
+  {
+    auto content = exdData.getRow< Excel::ContentFinderCondition >( contentId );
+    if( !content )
+    {
+      Logger::error( "[{0}][ContentFinder] contentId#{1} has no content finder condition, skipped.", player.getId(), contentId );
+      continue;
+    }
+
+    // make sure the player has at least the required level
+    if( player.getLevel() < content->data().LevelMin )
+      continue;
+
+    pQPlayer->m_contentIds.push_back( contentId );
+  }
+
+  if( pQPlayer->m_contentIds.empty() )
+  {
+    Logger::error( "[{0}][ContentFinder] No matching content could be found for {1} requested content{2}.",
+                   player.getId(), contentIds.size(), random ? " ( random )" : "" );
+    rejectRegistration( player );
+    return;
+  }
+
+  m_queuedPlayer[ player.getId() ] = pQPlayer;
+
+  // undersized parties are formed right away
+  if( flags & 0x01 )
+  {
+    formParty( pQPlayer->m_contentIds.front(), { pQPlayer }, FindContentFlag::Undersized );
+    completeRegistration( player, flags );
+    return;
+  }
+
+  queueForContent( pQPlayer, false );
+
+  for( auto contentId : pQPlayer->m_contentIds )
+  {
+    auto queueIt = m_matchingQueues.find( contentId );
+    if( queueIt == m_matchingQueues.end() )
+      continue;
+
+    Logger::info( "[{2}][ContentFinder] Content registered, contentId#{0} registerId#{1}", contentId, queueIt->second->getRegisterId(), player.getId() );
+    PlayerMgr::sendDebug( player, "Content registered, contentId#{0} registerId#{1}", contentId, queueIt->second->getRegisterId() );
+  }
+
+  completeRegistration( player, flags );
+
+  // copied, matching can take the player out of the queues
+  auto contentIdList = pQPlayer->m_contentIds;
+  for( auto contentId : contentIdList )
+  {
+    auto queueIt = m_matchingQueues.find( contentId );
+    if( queueIt != m_matchingQueues.end() )
+      tryMatch( queueIt->second );
+  }
+}
+
+void World::ContentFinder::rejectRegistration( const Entity::Player& player )
+{
+  auto& server = Service< WorldServer >::ref();
+
+  // nothing was queued, clear the registration the client is showing
+  auto updatePacket = makeUpdateFindContent( player.getId(), 0, SetResultFailed2 );
+  server.queueForPlayer( player.getCharacterId(), updatePacket );
 }
 
 void World::ContentFinder::completeRegistration( const Entity::Player &player, uint8_t flags )
 {
   auto& server = Service< WorldServer >::ref();
-  auto queuedContent = m_queuedContent[ m_queuedPlayer[ player.getId() ]->getActiveRegisterId() ];
+  auto queuedContent = findContentByRegisterId( m_queuedPlayer[ player.getId() ]->getActiveRegisterId() );
+  if( !queuedContent )
+    return;
 
   auto& exdData = Service< Data::ExdData >::ref();
 
   auto content = exdData.getRow< Excel::InstanceContent >( queuedContent->getInstanceId() );
+  if( !content )
+    return;
 
   // Undersized
   if( flags & 0x01 )
@@ -163,9 +265,6 @@ void World::ContentFinder::completeRegistration( const Entity::Player &player, u
     auto statusPacket = makeNotifyFindContentStatus( player.getId(), content->data().TerritoryType, 2, queuedContent->m_attackerCount + queuedContent->m_rangeCount,
                                                      queuedContent->m_healerCount, queuedContent->m_tankCount, 0 );
     server.queueForPlayer( player.getCharacterId(), statusPacket );
-
-    queuedContent->m_flags |= FindContentFlag::Undersized;
-    queuedContent->setState( MatchingComplete );
   }
   else
   {
@@ -173,92 +272,285 @@ void World::ContentFinder::completeRegistration( const Entity::Player &player, u
                                                CompleteRegistration, 1, static_cast< uint32_t >( player.getClass() ) );
     server.queueForPlayer( player.getCharacterId(), updatePacket );
 
-    auto statusPacket = makeNotifyFindContentStatus( player.getId(), content->data().TerritoryType, 1, queuedContent->m_attackerCount + queuedContent->m_rangeCount,
-                                                     queuedContent->m_healerCount, queuedContent->m_tankCount, 0xFF );
+    auto statusPacket = makeNotifyFindContentStatus( player.getId(), content->data().TerritoryType, 1, queuedContent->getShownCount( RoleBucket::Dps ),
+                                                     queuedContent->getShownCount( RoleBucket::Healer ), queuedContent->getShownCount( RoleBucket::Tank ), 0xFF );
+    server.queueForPlayer( player.getCharacterId(), statusPacket );
+  }
+}
+
+World::ContentFinder::QueuedContentPtr World::ContentFinder::getMatchingQueue( uint32_t contentId )
+{
+  auto queueIt = m_matchingQueues.find( contentId );
+  if( queueIt != m_matchingQueues.end() )
+    return queueIt->second;
+
+  auto& exdData = Common::Service< Data::ExdData >::ref();
+  auto content = exdData.getRow< Excel::ContentFinderCondition >( contentId );
+  if( !content )
+    return nullptr;
+
+  auto contentMember = exdData.getRow< Excel::ContentMemberType >( content->data().ContentMemberType );
+  if( !contentMember )
+    return nullptr;
+
+  auto queue = std::make_shared< QueuedContent >( getNextRegisterId(), contentId );
+  queue->setRequired( RoleBucket::Tank, contentMember->data().TankCount );
+  queue->setRequired( RoleBucket::Healer, contentMember->data().HealerCount );
+  queue->setRequired( RoleBucket::Dps, contentMember->data().AttackerCount + contentMember->data().RangeCount );
+
+  // no role split, anyone can fill the party
+  if( queue->m_required[ bucketIndex( RoleBucket::Tank ) ] + queue->m_required[ bucketIndex( RoleBucket::Healer ) ] +
+      queue->m_required[ bucketIndex( RoleBucket::Dps ) ] == 0 )
+    queue->setRequired( RoleBucket::Dps, std::max< uint8_t >( contentMember->data().PartyMemberCount, 1 ) );
+
+  m_matchingQueues[ contentId ] = queue;
+  m_queuedContent[ queue->getRegisterId() ] = queue;
+  return queue;
+}
 
-    for( auto& queuedPlayer : queuedContent->m_players )
+void World::ContentFinder::queueForContent( const QueuedPlayerPtr& pQPlayer, bool front )
+{
+  for( auto contentId : pQPlayer->m_contentIds )
+  {
+    auto queue = getMatchingQueue( contentId );
+    if( !queue )
     {
-      server.queueForPlayer( queuedPlayer->getCharacterId(), statusPacket );
+      Logger::error( "[ContentFinder] No matching queue could be generated for contentId#{0}.", contentId );
+      continue;
     }
+
+    const auto shownCounts = getShownCounts( *queue );
+
+    queue->queuePlayer( pQPlayer, front );
+    pQPlayer->setActiveRegisterId( queue->getRegisterId() );
+
+    if( shownCounts != getShownCounts( *queue ) )
+      sendMatchingStatus( *queue, 1, pQPlayer->getEntityId() );
   }
 }
 
-void World::ContentFinder::queueForContent( Entity::Player &player, const std::vector< uint32_t >& contentIds )
+void World::ContentFinder::dequeue( const QueuedPlayerPtr& pQPlayer )
 {
-  for( auto contentId : contentIds )
+  std::vector< uint32_t > registerIds;
+  registerIds.reserve( pQPlayer->m_tickets.size() );
+  for( const auto& ticket : pQPlayer->m_tickets )
+    registerIds.push_back( ticket.first );
+
+  for( auto registerId : registerIds )
+  {
+    auto queue = findContentByRegisterId( registerId );
+    if( !queue )
+      continue;
+
+    const auto shownCounts = getShownCounts( *queue );
+
+    if( !queue->withdrawPlayer( pQPlayer ) )
+      continue;
+
+    Logger::info( "[{2}] Content withdrawn, contentId#{0} registerId#{1}",
+                  queue->getInstanceId(), queue->getRegisterId(), pQPlayer->getEntityId() );
+
+    if( shownCounts != getShownCounts( *queue ) )
+      sendMatchingStatus( *queue, 3 );
+
+    removeIfEmpty( queue );
+  }
+}
+
+void World::ContentFinder::tryMatch( const QueuedContentPtr& queue )
+{
+  SAPPHIRE_PROFILE_SCOPE( "cf.match" );
+
+  if( !queue->canFillParty() )
+    return;
+
+  const auto shownCounts = getShownCounts( *queue );
+
+  while( queue->canFillParty() )
+    matchParty( queue, 0 );
+
+  if( queue->getWaitingCount() > 0 && shownCounts != getShownCounts( *queue ) )
+    sendMatchingStatus( *queue, 1 );
+
+  removeIfEmpty( queue );
+}
+
+World::ContentFinder::QueuedContentPtr World::ContentFinder::matchParty( const QueuedContentPtr& queue, uint32_t flags )
+{
+  auto members = queue->takeParty();
+  const auto now = Util::getTimeMs();
+  uint64_t longestWait = 0;
+
+  for( auto& member : members )
+  {
+    // leave every other queue the player was waiting in
+    dequeue( member );
+    longestWait = std::max( longestWait, now - member->m_registerTime );
+  }
+
+  auto party = formParty( queue->getInstanceId(), members, flags );
+
+  Logger::info( "[ContentFinder] registerId#{0} matched for contentId#{1}, {2} players, longest wait {3}ms",
+                party->getRegisterId(), party->getInstanceId(), members.size(), longestWait );
+  return party;
+}
+
+World::ContentFinder::QueuedContentPtr World::ContentFinder::formParty( uint32_t contentId, const std::vector< QueuedPlayerPtr >& members, uint32_t flags )
+{
+  auto party = std::make_shared< QueuedContent >( getNextRegisterId(), contentId );
+  party->m_flags = flags;
+
+  for( auto& member : members )
+  {
+    party->addMember( member );
+    member->setActiveRegisterId( party->getRegisterId() );
+    if( member->isRandom() )
+      party->m_flags |= FindContentFlag::Random;
+  }
+
+  m_queuedContent[ party->getRegisterId() ] = party;
+  setContentState( *party, MatchingComplete );
+  return party;
+}
+
+void World::ContentFinder::dissolveParty( const QueuedContentPtr& party, const QueuedPlayerPtr& leaver )
+{
+  auto& server = Service< WorldServer >::ref();
+  auto& exdData = Service< Data::ExdData >::ref();
+
+  auto contentInfo = exdData.getRow< Excel::InstanceContent >( party->getInstanceId() );
+
+  Logger::info( "[{1}][ContentFinder] registerId#{0} dissolved, player left before entering", party->getRegisterId(), leaver->getEntityId() );
+
+  std::set< uint32_t > contentIds;
+  for( auto& member : party->m_players )
   {
-    auto contentList = getMatchingContentList( player, contentId );
+    if( member == leaver )
+      continue;
+
+    auto qPlayerIt = m_queuedPlayer.find( member->getEntityId() );
+    if( qPlayerIt == m_queuedPlayer.end() || qPlayerIt->second != member )
+      continue;
 
-    if( contentList.empty() )
+    if( contentInfo )
     {
-      Logger::error( "[ContentFinder] No matching content could be found or generated." );
-      return;
+      auto updatePacket = makeUpdateFindContent( member->getEntityId(), contentInfo->data().TerritoryType,
+                                                 ReturnMatching, 1, member->m_classJob );
+      server.queueForPlayer( member->getCharacterId(), updatePacket );
     }
 
-    for( auto &content : contentList )
-    {
-      Logger::info( "[{2}][ContentFinder] Content registered, contentId#{0} registerId#{1}", contentId, content->getRegisterId(), player.getId() );
-      PlayerMgr::sendDebug( player, "Content registered, contentId#{0} registerId#{1}", contentId, content->getRegisterId() );
-      m_queuedContent[ content->getRegisterId() ] = content;
+    // back to the front of the line
+    queueForContent( member, true );
+    contentIds.insert( member->m_contentIds.begin(), member->m_contentIds.end() );
+  }
 
-      auto qPlayerIt = m_queuedPlayer.find( player.getId() );
-      if( qPlayerIt == m_queuedPlayer.end() )
-      {
-        auto pQPlayer = std::make_shared< QueuedPlayer >( player, content->getRegisterId() );
-        m_queuedPlayer[ player.getId() ] = pQPlayer;
-      }
-      else
-      {
-        m_queuedPlayer[ player.getId() ]->setActiveRegisterId( content->getRegisterId() );
-      }
-      content->queuePlayer( m_queuedPlayer[ player.getId() ] );
-    }
+  party->m_players.clear();
+  setContentState( *party, ToBeRemoved );
+
+  for( auto contentId : contentIds )
+  {
+    auto queueIt = m_matchingQueues.find( contentId );
+    if( queueIt != m_matchingQueues.end() )
+      tryMatch( queueIt->second );
   }
 }
 
-void World::QueuedContent::queuePlayer( const std::shared_ptr< QueuedPlayer >& pQPlayer )
+void World::ContentFinder::removeIfEmpty( const QueuedContentPtr& queue )
 {
-  m_players.push_back( pQPlayer );
-  m_partyMemberCount++;
-  switch( pQPlayer->getRole() )
+  if( queue->getState() != MatchingInProgress || queue->getWaitingCount() > 0 )
+    return;
+
+  auto queueIt = m_matchingQueues.find( queue->getInstanceId() );
+  if( queueIt != m_matchingQueues.end() && queueIt->second == queue )
+    m_matchingQueues.erase( queueIt );
+
+  removeContentByRegisterId( queue->getRegisterId() );
+}
+
+void World::ContentFinder::setContentState( QueuedContent& content, QueuedContentState state )
+{
+  content.setState( state );
+
+  switch( state )
   {
-    case Role::Tank:
-      m_tankCount++;
+    case MatchingComplete:
+    case Accepted:
+    case ToBeRemoved:
+      m_pendingRegisterIds.push_back( content.getRegisterId() );
       break;
-    case Role::Healer:
-      m_healerCount++;
-      break;
-    case Role::RangedPhysical:
-    case Role::RangedMagical:
-      m_rangeCount++;
-      break;
-    case Role::Melee:
-      m_attackerCount++;
-      break;
-    case Role::None:
-    case Role::Crafter:
-    case Role::Gatherer:
+    default:
       break;
   }
 }
 
-bool World::QueuedContent::withdrawPlayer( const std::shared_ptr< QueuedPlayer >& pQPlayer )
+void World::ContentFinder::sendMatchingStatus( const QueuedContent& queue, uint8_t status, uint32_t exceptId )
 {
-  auto preSize = m_players.size();
-  auto it = m_players.begin();
-  for( ; it != m_players.end(); ++it )
+  auto& server = Service< WorldServer >::ref();
+  auto& exdData = Service< Data::ExdData >::ref();
+
+  auto contentInfo = exdData.getRow< Excel::InstanceContent >( queue.getInstanceId() );
+  if( !contentInfo )
+    return;
+
+  for( const auto& bucket : queue.m_buckets )
   {
-    if( it->get()->getCharacterId() == pQPlayer->getCharacterId() )
+    for( const auto& playerList : bucket )
     {
-      m_players.erase( it );
-      break;
+      for( const auto& pPlayer : playerList )
+      {
+        // only update players which have this content active (shown in UI)
+        if( pPlayer->getEntityId() == exceptId || pPlayer->getActiveRegisterId() != queue.getRegisterId() )
+          continue;
+
+        auto statusPacket = makeNotifyFindContentStatus( pPlayer->getEntityId(), contentInfo->data().TerritoryType, status,
+                                                         queue.getShownCount( RoleBucket::Dps ), queue.getShownCount( RoleBucket::Healer ),
+                                                         queue.getShownCount( RoleBucket::Tank ), 0xFF );
+        server.queueForPlayer( pPlayer->getCharacterId(), statusPacket );
+      }
     }
   }
+}
+
+bool World::ContentFinder::popContent( uint32_t registerId )
+{
+  auto queue = findContentByRegisterId( registerId );
+  if( !queue || queue->getState() != MatchingInProgress || queue->getWaitingCount() == 0 )
+    return false;
+
+  matchParty( queue, FindContentFlag::Undersized );
+  removeIfEmpty( queue );
+  return true;
+}
+
+void World::QueuedContent::queuePlayer( const QueuedPlayerPtr& pQPlayer, bool front )
+{
+  auto bucket = pQPlayer->getRoleBucket();
+  if( bucket == RoleBucket::Invalid || pQPlayer->m_tickets.count( m_registerId ) )
+    return;
+
+  auto& playerList = m_buckets[ bucketIndex( bucket ) ][ pQPlayer->isRandom() ? 0 : 1 ];
+  pQPlayer->m_tickets[ m_registerId ] = playerList.insert( front ? playerList.begin() : playerList.end(), pQPlayer );
+  ++m_waiting[ bucketIndex( bucket ) ];
+}
+
+bool World::QueuedContent::withdrawPlayer( const QueuedPlayerPtr& pQPlayer )
+{
+  auto ticketIt = pQPlayer->m_tickets.find( m_registerId );
+  if( ticketIt != pQPlayer->m_tickets.end() )
+  {
+    auto bucket = bucketIndex( pQPlayer->getRoleBucket() );
+    m_buckets[ bucket ][ pQPlayer->isRandom() ? 0 : 1 ].erase( ticketIt->second );
+    pQPlayer->m_tickets.erase( ticketIt );
+    --m_waiting[ bucket ];
+    return true;
+  }
 
-  auto postSize = m_players.size();
-  if( preSize == postSize )
+  auto it = std::find( m_players.begin(), m_players.end(), pQPlayer );
+  if( it == m_players.end() )
     return false;
 
+  m_players.erase( it );
+
   m_partyMemberCount--;
   switch( pQPlayer->getRole() )
   {
@@ -283,83 +575,83 @@ bool World::QueuedContent::withdrawPlayer( const std::shared_ptr< QueuedPlayer >
   return true;
 }
 
-uint32_t World::ContentFinder::getNextRegisterId()
+bool World::QueuedContent::canFillParty() const
 {
-  return ++m_nextRegisterId;
+  for( size_t bucket = 0; bucket < m_waiting.size(); ++bucket )
+  {
+    if( m_waiting[ bucket ] < m_required[ bucket ] )
+      return false;
+  }
+  return getWaitingCount() > 0;
 }
 
-World::ContentFinder::QueuedContentPtrList World::ContentFinder::getMatchingContentList( Entity::Player &player, uint32_t contentFinderId )
+std::vector< World::QueuedPlayerPtr > World::QueuedContent::takeParty()
 {
-  QueuedContentPtrList outVec;
-  for( auto& it : m_queuedContent )
-  {
-    auto& foundContent = it.second;
-    uint32_t leftContentId = foundContent->getInstanceId();
-    if( leftContentId != contentFinderId )
-      continue;
-
-    auto& exdData = Common::Service< Data::ExdData >::ref();
-    auto content = exdData.getRow< Excel::ContentFinderCondition >( contentFinderId );
-    if( !content )
-      continue;
-
-    // make sure the player has at least the required level
-    if( player.getLevel() < content->data().LevelMin )
-      continue;
+  std::vector< QueuedPlayerPtr > party;
 
-    if( foundContent->getState() != QueuedContentState::MatchingInProgress )
-      continue;
+  for( size_t bucket = 0; bucket < m_buckets.size(); ++bucket )
+  {
+    auto slots = std::min< uint32_t >( m_waiting[ bucket ], m_required[ bucket ] );
+    for( uint32_t i = 0; i < slots; ++i )
+    {
+      // roulette registrations go first
+      auto& playerList = m_buckets[ bucket ][ 0 ].empty() ? m_buckets[ bucket ][ 1 ] : m_buckets[ bucket ][ 0 ];
+      auto pQPlayer = playerList.front();
+      withdrawPlayer( pQPlayer );
+      party.push_back( pQPlayer );
+    }
+  }
 
-    auto contentMember = exdData.getRow< Excel::ContentMemberType >( content->data().ContentMemberType );
-    if( !contentMember )
-      continue;
+  return party;
+}
 
-    // skip if the party is already full
-    if( foundContent->m_partyMemberCount >= contentMember->data().PartyMemberCount )
-      continue;
+size_t World::QueuedContent::getWaitingCount() const
+{
+  size_t count = 0;
+  for( auto waiting : m_waiting )
+    count += waiting;
+  return count;
+}
 
-    switch( player.getRole() )
-    {
-      case Role::Tank:
-      {
-        if( contentMember->data().TankCount <= foundContent->m_tankCount )
-          continue;
-        break;
-      }
-      case Role::Healer:
-      {
-        if( contentMember->data().HealerCount <= foundContent->m_healerCount )
-          continue;
-        break;
-      }
-      case Role::RangedPhysical:
-      case Role::RangedMagical:
-      {
-        if( contentMember->data().RangeCount <= foundContent->m_rangeCount )
-          continue;
-        break;
-      }
-      case Role::Melee:
-      {
-        if( contentMember->data().AttackerCount <= foundContent->m_attackerCount )
-          continue;
-        break;
-      }
-      case Role::Crafter:
-      case Role::Gatherer:
-      case Role::None:
-        continue;
-    }
+void World::QueuedContent::setRequired( RoleBucket bucket, uint8_t count )
+{
+  m_required[ bucketIndex( bucket ) ] = count;
+}
 
-    outVec.push_back( foundContent );
-  }
+uint8_t World::QueuedContent::getShownCount( RoleBucket bucket ) const
+{
+  return static_cast< uint8_t >( std::min< uint32_t >( m_waiting[ bucketIndex( bucket ) ], m_required[ bucketIndex( bucket ) ] ) );
+}
 
-  if( outVec.empty() )
+void World::QueuedContent::addMember( const QueuedPlayerPtr& pQPlayer )
+{
+  m_players.push_back( pQPlayer );
+  m_partyMemberCount++;
+  switch( pQPlayer->getRole() )
   {
-    auto queuedContent = std::make_shared< QueuedContent >( getNextRegisterId(), contentFinderId );
-    outVec.push_back( queuedContent );
+    case Role::Tank:
+      m_tankCount++;
+      break;
+    case Role::Healer:
+      m_healerCount++;
+      break;
+    case Role::RangedPhysical:
+    case Role::RangedMagical:
+      m_rangeCount++;
+      break;
+    case Role::Melee:
+      m_attackerCount++;
+      break;
+    case Role::None:
+    case Role::Crafter:
+    case Role::Gatherer:
+      break;
   }
-  return outVec;
+}
+
+uint32_t World::ContentFinder::getNextRegisterId()
+{
+  return ++m_nextRegisterId;
 }
 
 void World::ContentFinder::accept( Entity::Player& player )
@@ -367,13 +659,19 @@ void World::ContentFinder::accept( Entity::Player& player )
   auto& server = Service< WorldServer >::ref();
   auto& exdData = Service< Data::ExdData >::ref();
 
-  auto queuedPlayer = m_queuedPlayer[ player.getId() ];
-  auto queuedContent = m_queuedContent[ queuedPlayer->getActiveRegisterId() ];
+  auto qPlayerIt = m_queuedPlayer.find( player.getId() );
+  if( qPlayerIt == m_queuedPlayer.end() )
+    return;
 
-  auto content = exdData.getRow< Excel::InstanceContent >( queuedContent->getInstanceId() );
+  auto queuedPlayer = qPlayerIt->second;
+  auto queuedContent = findContentByRegisterId( queuedPlayer->getActiveRegisterId() );
 
   // Something has gone quite wrong..
-  if( queuedContent->getState() != WaitingForAccept )
+  if( !queuedContent || queuedContent->getState() != WaitingForAccept )
+    return;
+
+  auto content = exdData.getRow< Excel::InstanceContent >( queuedContent->getInstanceId() );
+  if( !content )
     return;
 
   switch( queuedPlayer->getRole() )
@@ -406,7 +704,7 @@ void World::ContentFinder::accept( Entity::Player& player )
   }
 
   if( ( queuedContent->m_tankAccepted + queuedContent->m_healerAccepted + queuedContent->m_dpsAccepted ) == queuedContent->m_partyMemberCount )
-    queuedContent->setState( Accepted );
+    setContentState( *queuedContent, Accepted );
 }
 
 void World::ContentFinder::withdraw( Entity::Player& player )
@@ -414,62 +712,40 @@ void World::ContentFinder::withdraw( Entity::Player& player )
   auto& server = Service< WorldServer >::ref();
   auto& exdData = Service< Data::ExdData >::ref();
 
-  auto queuedPlayer = m_queuedPlayer[ player.getId() ];
-
-  auto contentInfo = exdData.getRow< Excel::InstanceContent >( m_queuedContent[ queuedPlayer->getActiveRegisterId() ]->getInstanceId() );
-  if( !contentInfo )
-  {
-    Logger::error( "[{2}] Content withdraw failed, contentId#{0} registerId#{1}",
-                   m_queuedContent[ queuedPlayer->getActiveRegisterId() ]->getInstanceId(),
-                   m_queuedContent[ queuedPlayer->getActiveRegisterId() ]->getRegisterId(), player.getId() );
+  auto qPlayerIt = m_queuedPlayer.find( player.getId() );
+  if( qPlayerIt == m_queuedPlayer.end() )
     return;
-  }
+
+  auto queuedPlayer = qPlayerIt->second;
+  auto activeContent = findContentByRegisterId( queuedPlayer->getActiveRegisterId() );
 
   // remove the player from the global CF list
-  m_queuedPlayer.erase( player.getId() );
+  m_queuedPlayer.erase( qPlayerIt );
 
-  // send packet to clear CF in the client. TODO needs to be moved elsewhere
-  auto updatePacket = makeUpdateFindContent( player.getId(), contentInfo->data().TerritoryType, SetResultFailed2 );
-  server.queueForPlayer( queuedPlayer->getCharacterId(), updatePacket );
+  // leave every matching queue, players still waiting are updated if the shown role counts changed
+  dequeue( queuedPlayer );
 
-  // check all queued contents for the player and remove if needed
-  std::set< uint32_t > updateRegisterIdSet;
-  for( auto& content : m_queuedContent )
+  if( activeContent && activeContent->getState() != MatchingInProgress )
   {
-    if( content.second->withdrawPlayer( queuedPlayer ) )
-    {
+    // a popped party falls apart, everyone else goes back in line
+    if( activeContent->getState() == MatchingComplete || activeContent->getState() == WaitingForAccept )
+      dissolveParty( activeContent, queuedPlayer );
+    else if( activeContent->withdrawPlayer( queuedPlayer ) )
       Logger::info( "[{2}] Content withdrawn, contentId#{0} registerId#{1}",
-                    content.second->getInstanceId(), content.second->getRegisterId(), player.getId() );
-      updateRegisterIdSet.insert( content.second->getRegisterId() );
-    }
+                    activeContent->getInstanceId(), activeContent->getRegisterId(), player.getId() );
   }
 
-  // check for each queued content if players need to be updated
-  for( auto& content : m_queuedContent )
+  auto contentInfo = activeContent ? exdData.getRow< Excel::InstanceContent >( activeContent->getInstanceId() ) : nullptr;
+  if( !contentInfo )
   {
-    auto regId = content.second->getRegisterId();
-    // if this content does not require an update, skip.
-    if( updateRegisterIdSet.count( regId ) == 0 )
-      continue;
-
-    auto queuedContentInfo = exdData.getRow< Excel::InstanceContent >( content.second->getInstanceId() );
-
-    auto& playerList = content.second->m_players;
-    for( const auto& pPlayer : playerList )
-    {
-      // only update players which have this content active (shown in UI)
-      if( pPlayer->getActiveRegisterId() != regId )
-        continue;
-
-      auto statusPacket = makeNotifyFindContentStatus( player.getId(), queuedContentInfo->data().TerritoryType, 3,
-                                                       content.second->m_attackerCount + content.second->m_rangeCount,
-                                                       content.second->m_healerCount, content.second->m_tankCount, 0xff );
-
-      server.queueForPlayer( pPlayer->getCharacterId(), statusPacket );
-    }
-
+    Logger::error( "[{1}] Content withdraw incomplete, registerId#{0} has no content info",
+                   queuedPlayer->getActiveRegisterId(), player.getId() );
+    return;
   }
 
+  // send packet to clear CF in the client. TODO needs to be moved elsewhere
+  auto updatePacket = makeUpdateFindContent( player.getId(), contentInfo->data().TerritoryType, SetResultFailed2 );
+  server.queueForPlayer( queuedPlayer->getCharacterId(), updatePacket );
 }
 
 std::shared_ptr< World::QueuedContent > World::ContentFinder::findContentByRegisterId( uint32_t registerId )
@@ -547,14 +823,22 @@ void World::QueuedContent::setState( World::QueuedContentState state )
 //////////////////////////////////////////////////////////////////////
 
 
-World::QueuedPlayer::QueuedPlayer( const Entity::Player &player, uint8_t registerId  )
+World::QueuedPlayer::QueuedPlayer( const Entity::Player &player, uint32_t registerId  ) :
+  QueuedPlayer( player.getCharacterId(), player.getId(), static_cast< uint32_t >( player.getClass() ),
+                player.getRole(), player.getLevel(), registerId )
+{
+}
+
+World::QueuedPlayer::QueuedPlayer( uint64_t characterId, uint32_t entityId, uint32_t classJob, Common::Role role,
+                                   uint8_t level, uint32_t registerId ) :
+  m_characterId( characterId ),
+  m_entityId( entityId ),
+  m_classJob( classJob ),
+  m_role( role ),
+  m_level( level ),
+  m_allowInProgress( false ),
+  m_activeRegisterId( registerId )
 {
-  m_characterId = player.getCharacterId();
-  m_classJob = static_cast< uint32_t >( player.getClass() );
-  m_level = player.getLevel();
-  m_activeRegisterId = registerId;
-  m_role = player.getRole();
-  m_entityId = player.getId();
 }
 
 Common::Role World::QueuedPlayer::getRole() const
@@ -562,12 +846,32 @@ Common::Role World::QueuedPlayer::getRole() const
   return m_role;
 }
 
-void World::QueuedPlayer::setActiveRegisterId( uint8_t registerId )
+World::RoleBucket World::QueuedPlayer::getRoleBucket() const
+{
+  switch( m_role )
+  {
+    case Role::Tank:
+      return RoleBucket::Tank;
+    case Role::Healer:
+      return RoleBucket::Healer;
+    case Role::Melee:
+    case Role::RangedPhysical:
+    case Role::RangedMagical:
+      return RoleBucket::Dps;
+    case Role::Crafter:
+    case Role::Gatherer:
+    case Role::None:
+      return RoleBucket::Invalid;
+  }
+  return RoleBucket::Invalid;
+}
+
+void World::QueuedPlayer::setActiveRegisterId( uint32_t registerId )
 {
   m_activeRegisterId = registerId;
 }
 
-uint8_t World::QueuedPlayer::getActiveRegisterId() const
+uint32_t World::QueuedPlayer::getActiveRegisterId() const
 {
   return m_activeRegisterId;
 }
@@ -581,3 +885,8 @@ uint32_t World::QueuedPlayer::getEntityId() const
 {
   return m_entityId;
 }
+
+bool World::QueuedPlayer::isRandom() const
+{
+  return m_random;
+}
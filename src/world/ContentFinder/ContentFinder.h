@@ -3,6 +3,10 @@
 #include <nlohmann/json.hpp>
 #include "../ForwardsZone.h"
 
+#include <array>
+#include <list>
+#include <unordered_map>
+
 namespace Sapphire::World
 {
 
@@ -42,21 +46,40 @@ namespace Sapphire::World
     ToBeRemoved = 7
   };
 
+  // role slots a party is filled by, melee and ranged share the dps slots
+  enum class RoleBucket : uint8_t
+  {
+    Tank = 0,
+    Healer = 1,
+    Dps = 2,
+    Count = 3,
+    Invalid = 0xFF
+  };
+
+  class QueuedPlayer;
+  using QueuedPlayerPtr = std::shared_ptr< QueuedPlayer >;
+  using QueuedPlayerList = std::list< QueuedPlayerPtr >;
+
   class QueuedPlayer
   {
     friend class ContentFinder;
+    friend class QueuedContent;
   public:
-    explicit QueuedPlayer( const Entity::Player& player, uint8_t registerId );
+    explicit QueuedPlayer( const Entity::Player& player, uint32_t registerId );
+    QueuedPlayer( uint64_t characterId, uint32_t entityId, uint32_t classJob, Common::Role role, uint8_t level, uint32_t registerId );
     ~QueuedPlayer() = default;
 
     Sapphire::Common::Role getRole() const;
+    RoleBucket getRoleBucket() const;
 
-    void setActiveRegisterId( uint8_t registerId );
-    uint8_t getActiveRegisterId() const;
+    void setActiveRegisterId( uint32_t registerId );
+    uint32_t getActiveRegisterId() const;
 
     uint64_t getCharacterId() const;
     uint32_t getEntityId() const;
 
+    bool isRandom() const;
+
   private:
     uint64_t m_characterId;
     uint32_t m_entityId;
@@ -64,9 +87,25 @@ namespace Sapphire::World
     Common::Role m_role;
     uint8_t m_level;
     bool m_allowInProgress;
-    uint8_t m_activeRegisterId;
+    uint32_t m_activeRegisterId;
+
+    // registered through a roulette, taken before regular registrations
+    bool m_random{ false };
+    uint64_t m_registerTime{ 0 };
+    // contents the player registered for, used to put the player back in line if a match falls apart
+    std::vector< uint32_t > m_contentIds;
+    // position in the role bucket of every matching queue the player waits in, keyed by register id
+    std::unordered_map< uint32_t, QueuedPlayerList::iterator > m_tickets;
   };
 
+  /*!
+   * A queued content is either the matching queue of one content or a party formed from it.
+   *
+   * The matching queue keeps waiting players in per role FIFO buckets, roulette registrations in front
+   * of regular ones, and counts them as they come and go, so checking for a full party is O(1).
+   * A party is taken out of the queue as soon as every role slot can be filled and lives on as its own
+   * queued content until the duty is entered.
+   */
   class QueuedContent
   {
     friend class ContentFinder;
@@ -76,8 +115,21 @@ namespace Sapphire::World
     uint32_t getRegisterId() const;
     uint32_t getInstanceId() const;
     uint8_t getRoleCount( Sapphire::Common::Role role ) const;
-    void queuePlayer( const std::shared_ptr< QueuedPlayer >& pQPlayer );
-    bool withdrawPlayer( const std::shared_ptr< QueuedPlayer >& pQPlayer );
+
+    // matching queue, front puts the player ahead of everyone in its bucket
+    void queuePlayer( const QueuedPlayerPtr& pQPlayer, bool front = false );
+    bool withdrawPlayer( const QueuedPlayerPtr& pQPlayer );
+    bool canFillParty() const;
+    // takes the players at the front of every bucket, as many as the slots of one party
+    std::vector< QueuedPlayerPtr > takeParty();
+    size_t getWaitingCount() const;
+    // players of the bucket one party takes
+    void setRequired( RoleBucket bucket, uint8_t count );
+    // role counts shown to waiting players, capped by the slots of one party
+    uint8_t getShownCount( RoleBucket bucket ) const;
+
+    // formed party
+    void addMember( const QueuedPlayerPtr& pQPlayer );
 
     QueuedContentState getState() const;
     void setState( QueuedContentState state );
@@ -99,13 +151,18 @@ namespace Sapphire::World
     uint8_t m_healerAccepted{};
     uint8_t m_dpsAccepted{};
 
-    uint8_t m_flags{};
+    uint32_t m_flags{};
 
     QueuedContentState m_state;
 
     bool m_isInProgress{ false };
 
     std::vector< std::shared_ptr < QueuedPlayer > > m_players;
+
+    // matching queue only, [ bucket ][ 0 = roulette, 1 = regular ]
+    std::array< std::array< QueuedPlayerList, 2 >, static_cast< size_t >( RoleBucket::Count ) > m_buckets;
+    std::array< uint32_t, static_cast< size_t >( RoleBucket::Count ) > m_waiting{};
+    std::array< uint8_t, static_cast< size_t >( RoleBucket::Count ) > m_required{};
   };
 
   class ContentFinder
@@ -119,14 +176,13 @@ namespace Sapphire::World
     ContentFinder() = default;
     ~ContentFinder() = default;
 
+    // progresses formed parties, matching itself happens when players register or withdraw
     void update();
 
     void registerContentRequest( Entity::Player& player, uint32_t contentId, uint8_t flags );
     void registerContentsRequest( Entity::Player& player, const std::vector< uint32_t >& contentIds );
     void registerRandomContentRequest( Entity::Player& player, uint32_t randomContentTypeId );
 
-    QueuedContentPtrList getMatchingContentList( Sapphire::Entity::Player &player, uint32_t contentId );
-
     void accept( Entity::Player& player );
     void withdraw( Entity::Player& player );
 
@@ -135,14 +191,48 @@ namespace Sapphire::World
     std::shared_ptr< QueuedContent > findContentByRegisterId( uint32_t registerId );
     bool removeContentByRegisterId( uint32_t registerId );
 
+    // forms an undersized party from everyone waiting in the given matching queue
+    bool popContent( uint32_t registerId );
+
   private:
     uint32_t m_nextRegisterId{ 0 };
     std::unordered_map< uint32_t, std::shared_ptr< QueuedContent > > m_queuedContent;
     std::unordered_map< uint32_t, std::shared_ptr< QueuedPlayer > > m_queuedPlayer;
+    // matching queue of every content with players waiting, keyed by content id
+    std::unordered_map< uint32_t, QueuedContentPtr > m_matchingQueues;
+    // parties with a state change update() has to act on
+    std::vector< uint32_t > m_pendingRegisterIds;
 
-    void queueForContent( Entity::Player &player, const std::vector< uint32_t >& contentIds );
+    void registerRequest( Entity::Player& player, const std::vector< uint32_t >& contentIds, bool random, uint8_t flags = 0 );
+
+    QueuedContentPtr getMatchingQueue( uint32_t contentId );
+
+    void queueForContent( const QueuedPlayerPtr& pQPlayer, bool front );
+
+    void dequeue( const QueuedPlayerPtr& pQPlayer );
+
+    // forms parties from the queue for as long as every role slot can be filled
+    void tryMatch( const QueuedContentPtr& queue );
+
+    // takes the next party out of the queue, undersized if not every slot can be filled
+    QueuedContentPtr matchParty( const QueuedContentPtr& queue, uint32_t flags );
+
+    QueuedContentPtr formParty( uint32_t contentId, const std::vector< QueuedPlayerPtr >& members, uint32_t flags );
+
+    // puts the other members of a party back in line after one of them left before entering
+    void dissolveParty( const QueuedContentPtr& party, const QueuedPlayerPtr& leaver );
+
+    void removeIfEmpty( const QueuedContentPtr& queue );
+
+    void setContentState( QueuedContent& content, QueuedContentState state );
+
+    // sends the role counts of the queue to everyone waiting in it except the given entity
+    void sendMatchingStatus( const QueuedContent& queue, uint8_t status, uint32_t exceptId = 0 );
 
     void completeRegistration( const Entity::Player &player, uint8_t flags = 0 );
+
+    // tells the client a request could not be queued at all
+    void rejectRegistration( const Entity::Player& player );
   };
 
 
@@ -10,12 +10,13 @@
 #include "ItemContainer.h"
 
 Sapphire::ItemContainer::ItemContainer( uint16_t storageId, uint16_t maxSize, const std::string& tableName,
-                                        bool isMultiStorage, bool isPersistentStorage ) :
+                                        bool isMultiStorage, bool isPersistentStorage, uint64_t ownerId ) :
   m_id( storageId ),
   m_size( maxSize ),
   m_tableName( tableName ),
   m_bMultiStorage( isMultiStorage ),
-  m_isPersistentStorage( isPersistentStorage )
+  m_isPersistentStorage( isPersistentStorage ),
+  m_ownerId( ownerId )
 {
 
 }
@@ -45,7 +46,7 @@ void Sapphire::ItemContainer::removeItem( uint16_t slotId, bool removeFromDb )
       auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
       auto stmt = db.getPreparedStatement( Db::CHARA_ITEMGLOBAL_DELETE );
       stmt->setUInt64( 1, it->second->getUId() );
-      db.execute( stmt );
+      db.execute( stmt, m_ownerId );
     }
 
     m_itemMap.erase( it );
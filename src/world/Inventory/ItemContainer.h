@@ -14,7 +14,7 @@ namespace Sapphire
 
   public:
     ItemContainer( uint16_t storageId, uint16_t maxSize, const std::string& tableName, bool isMultiStorage,
-                   bool isPersistentStorage = true );
+                   bool isPersistentStorage = true, uint64_t ownerId = 0 );
 
     ~ItemContainer();
 
@@ -48,6 +48,8 @@ namespace Sapphire
     std::string m_tableName;
     bool m_bMultiStorage;
     bool m_isPersistentStorage;
+    // character id of the owner, item rows are written in its order
+    uint64_t m_ownerId;
     ItemMap m_itemMap;
     Entity::PlayerPtr m_pOwner;
   };
@@ -36,9 +36,7 @@ const uint64_t ChatChannelMgr::createChatChannel( Common::ChatChannelType type )
 
   // create our new chat channel
 
-  Data::ChatChannelMembers newChatChannel = {};
-
-  m_channels[ cId.ChannelID ] = newChatChannel;
+  m_channels[ cId.ChannelID ] = {};
 
   Logger::debug( "Chat channel ID "
     + std::to_string( cId.ChannelID )
@@ -63,11 +61,14 @@ void ChatChannelMgr::addToChannel( uint64_t channelId, Entity::Player& player )
     return;
   }
 
-  auto& channelMembers = m_channels[ channelId ];
+  auto& channel = m_channels[ channelId ];
   auto id = player.getId();
 
-  if( std::find( channelMembers.begin(), channelMembers.end(), id ) == channelMembers.end() )
-    m_channels[ channelId ].emplace_back( id );
+  if( std::find( channel.members.begin(), channel.members.end(), id ) == channel.members.end() )
+  {
+    channel.members.emplace_back( id );
+    channel.connections.emplace_back( player.getChatConnection() );
+  }
 }
 
 void ChatChannelMgr::removeFromChannel( uint64_t channelId, Entity::Player& player )
@@ -85,12 +86,19 @@ void ChatChannelMgr::removeFromChannel( uint64_t channelId, Entity::Player& play
     return;
   }
 
-  auto& channelMembers = m_channels[ channelId ];
+  auto& channel = m_channels[ channelId ];
   auto id = player.getId();
 
-  auto it = std::find( channelMembers.begin(), channelMembers.end(), id );
-  if( it != channelMembers.end() )
-    channelMembers.erase( it );
+  auto it = std::find( channel.members.begin(), channel.members.end(), id );
+  if( it == channel.members.end() )
+    return;
+
+  // member order does not matter, move the last one into the gap
+  const auto index = static_cast< size_t >( it - channel.members.begin() );
+  channel.members[ index ] = channel.members.back();
+  channel.connections[ index ] = std::move( channel.connections.back() );
+  channel.members.pop_back();
+  channel.connections.pop_back();
 }
 
 void ChatChannelMgr::sendMessageToChannel( uint64_t channelId, Entity::Player& sender, const std::string& message )
@@ -108,27 +116,43 @@ void ChatChannelMgr::sendMessageToChannel( uint64_t channelId, Entity::Player& s
     return;
   }
 
-  auto& channelMembers = m_channels[ channelId ];
+  // source and target are filled in by the packet container of each connection, so one packet serves everyone
+  auto chatToChannelPacket = std::make_shared< Packets::Server::ChatToChannelPacket >( sender, channelId, message );
+
+  // skip sender from getting their own message
+  broadcastToChannel( channelId, chatToChannelPacket, sender.getId() );
+}
+
+void ChatChannelMgr::broadcastToChannel( uint64_t channelId, Network::Packets::FFXIVPacketBasePtr pPacket, uint32_t exceptId )
+{
+  auto it = m_channels.find( channelId );
+  if( it == m_channels.end() )
+    return;
 
+  auto& channel = it->second;
   auto& server = Common::Service< World::WorldServer >::ref();
-  auto& playerMgr = Common::Service< World::Manager::PlayerMgr >::ref();
 
-  // send message to all players in chat channel
-  for( const auto id : channelMembers )
+  // serialized once here, every connection only patches the segment header in its send buffer
+  auto pShared = std::make_shared< Network::Packets::FFXIVSharedPacket >( *pPacket );
+
+  for( size_t i = 0; i < channel.members.size(); ++i )
   {
-    // skip sender from getting their own message
-    if( id == sender.getId() )
+    const auto id = channel.members[ i ];
+    if( id == exceptId )
       continue;
 
-    auto pPlayer = playerMgr.getPlayer( id );
+    auto pChatCon = channel.connections[ i ].lock();
+    if( !pChatCon )
+    {
+      // member (re)connected since we last saw them, offline members have no session
+      auto pSession = server.getSession( id );
+      if( !pSession || !( pChatCon = pSession->getChatConnection() ) )
+        continue;
 
-    // check if player is online to recv message
-    if( !pPlayer || !pPlayer->isConnected() )
-      continue;
+      channel.connections[ i ] = pChatCon;
+    }
 
-    // prepare message packet, associating message and sender info with channel data
-    auto chatToChannelPacket = std::make_shared< Packets::Server::ChatToChannelPacket >( *pPlayer, sender, channelId, message );
-    server.queueChatForPlayer( pPlayer->getCharacterId(), chatToChannelPacket );
+    pChatCon->queueOutPacket( pShared );
   }
 }
 
@@ -142,5 +166,5 @@ const Data::ChatChannelMembers& ChatChannelMgr::getChatChannel( uint64_t channel
   bool channelValid = isChannelValid( channelId );
   assert( channelValid );
 
-  return m_channels[ channelId ];
+  return m_channels[ channelId ].members;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 #include "ForwardsZone.h"
 
@@ -34,12 +35,22 @@ namespace Sapphire::World::Manager
     void removeFromChannel( uint64_t channelId, Entity::Player& player );
 
     void sendMessageToChannel( uint64_t channelId, Entity::Player& sender, const std::string& message );
-    
+
+    // serializes the packet once and queues it on the chat connection of every member but exceptId, the recipient id is set per connection
+    void broadcastToChannel( uint64_t channelId, Network::Packets::FFXIVPacketBasePtr pPacket, uint32_t exceptId = 0 );
+
     bool isChannelValid( uint64_t channelId ) const;
     const Data::ChatChannelMembers& getChatChannel( uint64_t channelId );
 
   private:
-    std::map< uint64_t, Data::ChatChannelMembers > m_channels;
+    struct Channel
+    {
+      Data::ChatChannelMembers members;
+      // chat connection of members[ i ], looked up again through the session once it expired
+      std::vector< std::weak_ptr< Network::GameConnection > > connections;
+    };
+
+    std::map< uint64_t, Channel > m_channels;
     uint32_t m_lastChatNo = 0x1000;
   };
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "ClockMgr.h"
+
+#include <Util/Util.h>
+
+using namespace Sapphire;
+using namespace Sapphire::World::Manager;
+
+ClockMgr::ClockMgr() :
+  m_time( Common::Util::getTimeSeconds() ),
+  m_bell( m_time / BELL_SECONDS )
+{
+}
+
+void ClockMgr::update()
+{
+  m_time = Common::Util::getTimeSeconds();
+
+  auto bell = m_time / BELL_SECONDS;
+  if( bell == m_bell )
+    return;
+
+  // a stalled tick can skip bells, listeners only get the latest one
+  const bool newWeatherPeriod = bell / 8 != m_bell / 8;
+  m_bell = bell;
+
+  for( const auto& [ id, listener ] : m_bellListeners )
+    listener( m_bell );
+
+  if( !newWeatherPeriod )
+    return;
+
+  auto weatherPeriod = getWeatherPeriod();
+  for( const auto& [ id, listener ] : m_weatherPeriodListeners )
+    listener( weatherPeriod );
+}
+
+uint32_t ClockMgr::getTime() const
+{
+  return m_time;
+}
+
+uint32_t ClockMgr::getBell() const
+{
+  return m_bell;
+}
+
+uint32_t ClockMgr::getWeatherPeriod() const
+{
+  return m_bell / 8;
+}
+
+uint32_t ClockMgr::getWeatherPeriod( uint32_t unixTime )
+{
+  return unixTime / WEATHER_PERIOD_SECONDS;
+}
+
+uint8_t ClockMgr::getWeatherChance( uint32_t weatherPeriod )
+{
+  // Do the magic 'cause for calculations 16:00 is 0, 00:00 is 8 and 08:00 is 16
+  uint32_t increment = ( weatherPeriod * 8 + 8 ) % 24;
+
+  // Take Eorzea days since unix epoch, a day is 3 weather periods
+  uint32_t totalDays = weatherPeriod / 3;
+
+  uint32_t calcBase = ( totalDays * 0x64 ) + increment;
+
+  uint32_t step1 = ( calcBase << 0xB ) ^ calcBase;
+  uint32_t step2 = ( step1 >> 8 ) ^ step1;
+
+  return static_cast< uint8_t >( step2 % 0x64 );
+}
+
+uint32_t ClockMgr::subscribeBell( Listener listener )
+{
+  auto id = m_nextListenerId++;
+  m_bellListeners.emplace( id, std::move( listener ) );
+  return id;
+}
+
+uint32_t ClockMgr::subscribeWeatherPeriod( Listener listener )
+{
+  auto id = m_nextListenerId++;
+  m_weatherPeriodListeners.emplace( id, std::move( listener ) );
+  return id;
+}
+
+void ClockMgr::unsubscribe( uint32_t listenerId )
+{
+  m_bellListeners.erase( listenerId );
+  m_weatherPeriodListeners.erase( listenerId );
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+
+namespace Sapphire::World::Manager
+{
+  /*!
+   * @brief Eorzea time for the whole server, advanced once per tick
+   *
+   * Anything depending on Eorzea time subscribes to the boundary it cares about instead of checking the time every tick.
+   * Between boundaries update() is one division and a compare, no matter how many subscribers there are.
+   * Listeners are called on the tick thread and must not subscribe or unsubscribe from inside a callback.
+   */
+  class ClockMgr
+  {
+  public:
+    // one Eorzea hour in real seconds
+    static const uint32_t BELL_SECONDS = 175;
+    // weather changes every 8 bells
+    static const uint32_t WEATHER_PERIOD_SECONDS = 8 * BELL_SECONDS;
+    static const uint32_t EORZEA_DAY_SECONDS = 24 * BELL_SECONDS;
+
+    // called with the bell or weather period that just started, both counted from the unix epoch
+    using Listener = std::function< void( uint32_t ) >;
+
+    ClockMgr();
+
+    void update();
+
+    // unix time in seconds as of the last update. real time limits like cell activity and session timeouts
+    // are checked against this every tick, they are seconds long and fall between bells
+    uint32_t getTime() const;
+
+    uint32_t getBell() const;
+
+    uint32_t getWeatherPeriod() const;
+
+    static uint32_t getWeatherPeriod( uint32_t unixTime );
+
+    // the roll the weather rate tables are checked against for a weather period, 0 to 99
+    static uint8_t getWeatherChance( uint32_t weatherPeriod );
+
+    // returns an id for unsubscribe, never 0
+    uint32_t subscribeBell( Listener listener );
+    uint32_t subscribeWeatherPeriod( Listener listener );
+
+    void unsubscribe( uint32_t listenerId );
+
+  private:
+    uint32_t m_time;
+    uint32_t m_bell;
+
+    uint32_t m_nextListenerId{ 1 };
+    std::map< uint32_t, Listener > m_bellListeners;
+    std::map< uint32_t, Listener > m_weatherPeriodListeners;
+  };
+
+}
@@ -5,6 +5,7 @@
 #include <Network/GamePacket.h>
 #include <Util/Util.h>
 #include <Util/UtilMath.h>
+#include <Util/Profiler.h>
 #include <Network/PacketContainer.h>
 #include <Logging/Logger.h>
 #include <Exd/ExdData.h>
@@ -45,6 +46,8 @@
 #include "Manager/AchievementMgr.h"
 #include "Manager/WarpMgr.h"
 #include "Manager/LinkshellMgr.h"
+#include "Manager/MarketMgr.h"
+#include "Manager/InterestMgr.h"
 #include <Random/RNGMgr.h>
 #include "Manager/MgrUtil.h"
 
@@ -128,6 +131,9 @@ DebugCommandMgr::DebugCommandMgr()
   registerCommand( "ew", &DebugCommandMgr::easyWarp, "Easy warping", 1 );
   registerCommand( "reload", &DebugCommandMgr::hotReload, "Reloads a resource", 1 );
   registerCommand( "facing", &DebugCommandMgr::facing, "Checks if you are facing an actor", 1 );
+  registerCommand( "opstats", &DebugCommandMgr::opcodeStats, "Shows per opcode packet handling stats", 1 );
+  registerCommand( "profile", &DebugCommandMgr::profile, "Shows server tick timings", 1 );
+  registerCommand( "market", &DebugCommandMgr::market, "Market board listings", 1 );
   registerCommand( "cbt", &DebugCommandMgr::cbt, "Create, bind and teleport to an instance", 1 );
 }
 
@@ -250,7 +256,7 @@ void DebugCommandMgr::set( char* data, Entity::Player& player, std::shared_ptr<
     setActorPosPacket->data().z = player.getPos().z;
     setActorPosPacket->data().Dir = player.getRotUInt16();
 
-    server.queueForPlayers( player.getInRangePlayerIds( true ), setActorPosPacket );
+    server.queueForInRangePlayers( player, true, setActorPosPacket );
   }
   else if( ( subCommand == "tele" ) && ( !params.empty() ) )
   {
@@ -506,7 +512,7 @@ void DebugCommandMgr::add( char* data, Entity::Player& player, std::shared_ptr<
     actorControl->data().param2 = param2;
     actorControl->data().param3 = param3;
     actorControl->data().param4 = param4;
-    server().queueForPlayers( player.getInRangePlayerIds( true ), actorControl );
+    server().queueForInRangePlayers( player, true, actorControl );
 
 
     /*sscanf(params.c_str(), "%x %x %x %x %x %x %x", &opcode, &param1, &param2, &param3, &param4, &param5, &param6, &playerId);
@@ -741,6 +747,32 @@ void DebugCommandMgr::get( char* data, Entity::Player& player, std::shared_ptr<
 
     PlayerMgr::sendServerNotice( player, "Facing: {0} NaviLos: {1}\n", los ? "true" : "false", naviLos ? "true" : "false" );
   }
+  else if( subCommand == "navi" )
+  {
+    auto& teriMgr = Common::Service< Manager::TerritoryMgr >::ref();
+    auto pTeri = teriMgr.getTerritoryByGuId( player.getTerritoryId() );
+    auto pNavi = pTeri ? pTeri->getNaviProvider() : nullptr;
+    if( !pNavi )
+    {
+      PlayerMgr::sendUrgent( player, "No navimesh loaded for this zone." );
+      return;
+    }
+
+    const auto& queryCache = pNavi->getQueryCache();
+    PlayerMgr::sendServerNotice( player, "Agents: {0}\nQuery cache hits: {1} misses: {2}",
+                                 pNavi->getAgentCount(), queryCache.getHits(), queryCache.getMisses() );
+  }
+  else if( subCommand == "interest" )
+  {
+    auto& interestMgr = Common::Service< InterestMgr >::ref();
+    const auto& full = interestMgr.getMoveDetailStats( Entity::MoveDetail::Full );
+    const auto& reduced = interestMgr.getMoveDetailStats( Entity::MoveDetail::Reduced );
+    const auto& suppressed = interestMgr.getMoveDetailStats( Entity::MoveDetail::Suppressed );
+
+    PlayerMgr::sendServerNotice( player, "Visible actor budget: {0}\nMove updates sent/skipped\nFull: {1}/{2}\nReduced: {3}/{4}\nSuppressed: {5}/{6}",
+                                 interestMgr.getVisibleActorBudget(), full.sent, full.skipped, reduced.sent, reduced.skipped,
+                                 suppressed.sent, suppressed.skipped );
+  }
   else
   {
     PlayerMgr::sendUrgent( player, "{0} is not a valid GET command.", subCommand );
@@ -1476,13 +1508,11 @@ void DebugCommandMgr::contentFinder( char *data, Sapphire::Entity::Player &playe
     uint32_t registerId;
     sscanf( params.c_str(), "%d", &registerId );
 
-    auto content = cf.findContentByRegisterId( registerId );
-    if( !content )
+    if( !cf.popContent( registerId ) )
     {
-      PlayerMgr::sendDebug( player, "Content for registerId#{0} not found!", registerId );
+      PlayerMgr::sendDebug( player, "No players waiting for registerId#{0}!", registerId );
       return;
     }
-    content->setState( QueuedContentState::MatchingComplete );
   }
 
 }
@@ -1628,3 +1658,178 @@ void DebugCommandMgr::facing( char* data, Sapphire::Entity::Player& player, std:
     }
   }
 }
+
+void DebugCommandMgr::opcodeStats( char* data, Sapphire::Entity::Player& player, std::shared_ptr< DebugCommand > command )
+{
+  std::string subCommand;
+  std::string params;
+  const auto tmpCommand = extractCommandArgs( data, command->getName() );
+  splitSubCommand( tmpCommand, subCommand, params );
+
+  if( subCommand == "dump" )
+  {
+    GameConnection::dumpOpcodeStats();
+    PlayerMgr::sendDebug( player, "Opcode stats written to the server log." );
+  }
+  else if( subCommand == "reset" )
+  {
+    GameConnection::resetOpcodeStats();
+    PlayerMgr::sendDebug( player, "Opcode stats reset." );
+  }
+  else if( subCommand.empty() || subCommand == "zone" || subCommand == "chat" )
+  {
+    const auto type = subCommand == "chat" ? ConnectionType::Chat : ConnectionType::Zone;
+    const auto stats = GameConnection::getOpcodeStats( type );
+
+    uint32_t limit = 10;
+    if( !params.empty() )
+      sscanf( params.c_str(), "%u", &limit );
+
+    PlayerMgr::sendDebug( player, "Top {0} of {1} opcodes by handler time:", std::min< size_t >( limit, stats.size() ), stats.size() );
+    for( size_t i = 0; i < stats.size() && i < limit; ++i )
+    {
+      const auto& entry = stats[ i ];
+      PlayerMgr::sendDebug( player, "{0} ( {1:04X} ) n: {2} bytes: {3} avg: {4}us p99: <{5}us max: {6}us",
+                            entry.name, entry.opcode, entry.count, entry.bytes, entry.totalUs / entry.count,
+                            entry.percentileUs( 0.99 ), entry.maxUs );
+    }
+  }
+  else
+  {
+    PlayerMgr::sendDebug( player, "Usage: opstats [zone|chat] [count] / opstats dump / opstats reset" );
+  }
+}
+
+void DebugCommandMgr::profile( char* data, Sapphire::Entity::Player& player, std::shared_ptr< DebugCommand > command )
+{
+  std::string subCommand;
+  std::string params;
+  const auto tmpCommand = extractCommandArgs( data, command->getName() );
+  splitSubCommand( tmpCommand, subCommand, params );
+
+  auto& server = Common::Service< World::WorldServer >::ref();
+
+  if( subCommand == "dump" )
+  {
+    auto path = params.empty() ? server.getConfig().profiler.dumpPath : params;
+    if( path.empty() )
+      path = "profile.json";
+
+    if( Common::Util::Profiler::dumpJson( path ) )
+      PlayerMgr::sendDebug( player, "Tick profile written to {0}.", path );
+    else
+      PlayerMgr::sendDebug( player, "Unable to write tick profile to {0}.", path );
+  }
+  else if( subCommand == "reset" )
+  {
+    Common::Util::Profiler::reset();
+    PlayerMgr::sendDebug( player, "Tick profile reset." );
+  }
+  else if( subCommand.empty() || subCommand == "territory" )
+  {
+    auto& terriMgr = Common::Service< TerritoryMgr >::ref();
+    auto stats = Common::Util::Profiler::getStats();
+
+    // managers and phases only, or territories only, slowest first
+    const bool territories = subCommand == "territory";
+    stats.erase( std::remove_if( stats.begin(), stats.end(), [ territories ]( const Common::Util::ProfileStats& entry )
+    {
+      return territories ? entry.zone != "territory" : entry.key != 0;
+    } ), stats.end() );
+
+    std::sort( stats.begin(), stats.end(), []( const Common::Util::ProfileStats& left, const Common::Util::ProfileStats& right )
+    {
+      return left.p99Us > right.p99Us;
+    } );
+
+    uint32_t limit = 10;
+    if( territories && !params.empty() )
+      sscanf( params.c_str(), "%u", &limit );
+
+    PlayerMgr::sendDebug( player, "Top {0} of {1} by p99 ( last {2} samples each ):", std::min< size_t >( limit, stats.size() ),
+                          stats.size(), Common::Util::ProfileWindowSize );
+    for( size_t i = 0; i < stats.size() && i < limit; ++i )
+    {
+      const auto& entry = stats[ i ];
+
+      std::string name = entry.zone;
+      if( territories )
+      {
+        auto pTerritory = terriMgr.getTerritoryByGuId( static_cast< uint32_t >( entry.key ) );
+        name = fmt::format( "{0}#{1}", pTerritory ? pTerritory->getInternalName() : "removed", entry.key );
+      }
+
+      PlayerMgr::sendDebug( player, "{0} n: {1} p50: {2}us p99: {3}us max: {4}us",
+                            name, entry.count, entry.p50Us, entry.p99Us, entry.maxUs );
+    }
+
+    if( Common::Util::Profiler::getDropped() != 0 )
+      PlayerMgr::sendDebug( player, "{0} samples dropped.", Common::Util::Profiler::getDropped() );
+  }
+  else
+  {
+    PlayerMgr::sendDebug( player, "Usage: profile / profile territory [count] / profile dump [path] / profile reset" );
+  }
+}
+
+void DebugCommandMgr::market( char* data, Sapphire::Entity::Player& player, std::shared_ptr< DebugCommand > command )
+{
+  std::string subCommand;
+  std::string params;
+  const auto tmpCommand = extractCommandArgs( data, command->getName() );
+  splitSubCommand( tmpCommand, subCommand, params );
+
+  auto& marketMgr = Common::Service< MarketMgr >::ref();
+
+  if( subCommand == "add" )
+  {
+    uint32_t catalogId = 0;
+    uint32_t unitPrice = 0;
+    uint32_t stack = 1;
+    uint32_t hq = 0;
+    sscanf( params.c_str(), "%u %u %u %u", &catalogId, &unitPrice, &stack, &hq );
+
+    MarketListing listing;
+    listing.catalogId = catalogId;
+    listing.unitPrice = unitPrice;
+    listing.stack = stack;
+    listing.hq = hq != 0;
+    listing.sellerCharacterId = player.getCharacterId();
+    listing.retainerName = player.getName();
+
+    auto listingId = marketMgr.addListing( std::move( listing ) );
+    if( listingId == 0 )
+      PlayerMgr::sendDebug( player, "Item {0} can not be listed.", catalogId );
+    else
+      PlayerMgr::sendDebug( player, "Listed {0}x {1} at {2} gil as listing #{3}.", stack, catalogId, unitPrice, listingId );
+  }
+  else if( subCommand == "remove" || subCommand == "sell" )
+  {
+    uint64_t listingId = 0;
+    sscanf( params.c_str(), "%" SCNu64, &listingId );
+
+    const bool done = subCommand == "sell" ? marketMgr.completeSale( listingId, player.getName() ) : marketMgr.removeListing( listingId );
+    if( done )
+      PlayerMgr::sendDebug( player, "Listing #{0} {1}.", listingId, subCommand == "sell" ? "sold" : "removed" );
+    else
+      PlayerMgr::sendDebug( player, "Listing #{0} not found.", listingId );
+  }
+  else if( subCommand == "info" )
+  {
+    uint32_t catalogId = 0;
+    sscanf( params.c_str(), "%u", &catalogId );
+
+    PlayerMgr::sendDebug( player, "Item {0}: {1} listings, {2} listings in total.", catalogId,
+                          marketMgr.getListingCount( catalogId ), marketMgr.getListingCount() );
+    for( auto pListing : marketMgr.getListings( catalogId, 10 ) )
+    {
+      PlayerMgr::sendDebug( player, "#{0} {1}x at {2} gil{3} by {4}", pListing->listingId, pListing->stack,
+                            pListing->unitPrice, pListing->hq ? " ( hq )" : "", pListing->retainerName );
+    }
+  }
+  else
+  {
+    PlayerMgr::sendDebug( player, "Usage: market add <catalogId> <unitPrice> [stack] [hq] / market remove <listingId> / "
+                                  "market sell <listingId> / market info <catalogId>" );
+  }
+}
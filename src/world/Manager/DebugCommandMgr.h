@@ -69,6 +69,12 @@ namespace Sapphire::World::Manager
 
     void facing( char* data, Sapphire::Entity::Player& player, std::shared_ptr< DebugCommand > command );
 
+    void opcodeStats( char* data, Sapphire::Entity::Player& player, std::shared_ptr< DebugCommand > command );
+
+    void profile( char* data, Sapphire::Entity::Player& player, std::shared_ptr< DebugCommand > command );
+
+    void market( char* data, Sapphire::Entity::Player& player, std::shared_ptr< DebugCommand > command );
+
   };
 
 }
\ No newline at end of file
@@ -334,7 +334,7 @@ void FreeCompanyMgr::dbInsertMember( uint64_t fcId, uint64_t characterId, uint8_
   stmt->setUInt64( 2, characterId );
   stmt->setUInt( 3, hierarchyId );
   stmt->setUInt( 4, 0 );
-  db.directExecute( stmt );
+  db.execute( stmt, fcId );
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -364,7 +364,8 @@ void FreeCompanyMgr::dbInsertFc( const FreeCompany& fc )
   stmt->setUInt( 13, static_cast< uint8_t >( Common::FreeCompanyStatus::InviteStart ) );
   stmt->setString( 14, std::string( "" ) );
   stmt->setString( 15, std::string( "" ) );
-  db.directExecute( stmt );
+  // queued under the free company id so it lands before its members and any update of it
+  db.execute( stmt, fc.getId() );
 }
 
 void FreeCompanyMgr::dbUpdateFc( const FreeCompany& fc )
@@ -401,7 +402,7 @@ void FreeCompanyMgr::dbUpdateFc( const FreeCompany& fc )
   query->setBinary( 17, stockActionList );
 
   query->setInt64( 18, static_cast< int64_t >( fc.getId() ) );
-  db.execute( query );
+  db.execute( query, fc.getId() );
 
 }
 
@@ -671,7 +671,7 @@ void HousingMgr::createHouse( Sapphire::HousePtr house ) const
   stmt->setUInt( 2, house->getId() );
   stmt->setString( 3, house->getHouseName() );
 
-  db.execute( stmt );
+  db.execute( stmt, house->getId() );
 }
 
 void HousingMgr::deleteHouse( Sapphire::HousePtr house ) const
@@ -679,7 +679,7 @@ void HousingMgr::deleteHouse( Sapphire::HousePtr house ) const
   auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
   auto stmt = db.getPreparedStatement( Db::HOUSING_HOUSE_DEL );
   stmt->setUInt( 1, house->getId() );
-  db.execute( stmt );
+  db.execute( stmt, house->getId() );
 }
 
 void HousingMgr::buildPresetEstate( Entity::Player& player, HousingZone& zone, uint8_t plotNum, uint32_t presetCatalogId )
@@ -0,0 +1,127 @@
+#include "InterestMgr.h"
+
+#include <Common.h>
+#include <Util/UtilMath.h>
+
+#include <algorithm>
+
+#include "Actor/BNpc.h"
+#include "Actor/Player.h"
+
+using namespace Sapphire;
+using namespace Sapphire::World::Manager;
+
+InterestMgr::InterestMgr( uint32_t visibleActorBudget ) :
+  // slot 0 of the spawn index allocator is the player itself
+  m_visibleActorBudget( std::clamp< uint32_t >( visibleActorBudget, 1, Common::MAX_DISPLAYED_ACTORS - 1 ) )
+{
+}
+
+uint32_t InterestMgr::getVisibleActorBudget() const
+{
+  return m_visibleActorBudget;
+}
+
+void InterestMgr::countMoveUpdate( Entity::MoveDetail detail, bool sent )
+{
+  auto& stats = m_moveDetailStats[ static_cast< uint8_t >( detail ) ];
+  if( sent )
+    ++stats.sent;
+  else
+    ++stats.skipped;
+}
+
+const InterestMgr::MoveDetailStats& InterestMgr::getMoveDetailStats( Entity::MoveDetail detail ) const
+{
+  return m_moveDetailStats[ static_cast< uint8_t >( detail ) ];
+}
+
+InterestMgr::Relevance InterestMgr::getRelevance( Entity::Player& player, Entity::Chara& chara )
+{
+  if( chara.getTargetId() == player.getId() || player.getTargetId() == chara.getId() )
+    return Important;
+
+  if( chara.isPlayer() )
+  {
+    auto& other = static_cast< Entity::Player& >( chara );
+    if( player.getPartyId() != 0 && other.getPartyId() == player.getPartyId() )
+      return Important;
+
+    return other.isInCombat() ? Combat : Ambient;
+  }
+
+  if( chara.isBattleNpc() )
+  {
+    for( const auto& entry : static_cast< const Entity::BNpc& >( chara ).getHateList() )
+    {
+      if( entry.m_entityId == player.getId() )
+        return Combat;
+    }
+  }
+
+  return Ambient;
+}
+
+void InterestMgr::update( Entity::Player& player, uint64_t tickCount )
+{
+  if( !player.isInterestDirty() && tickCount - player.getLastInterestUpdate() < UPDATE_INTERVAL )
+    return;
+
+  player.setInterestDirty( false );
+  player.setLastInterestUpdate( tickCount );
+
+  if( !player.isLoadingComplete() )
+    return;
+
+  auto pPlayer = player.getAsPlayer();
+  const auto& pos = player.getPos();
+
+  m_candidates.clear();
+  for( const auto& pActor : player.getInRangeActorSet() )
+  {
+    if( !pActor->isChara() )
+      continue;
+
+    const auto& actorPos = pActor->getPos();
+    auto distanceSq = Common::Util::distanceSq( pos.x, pos.y, pos.z, actorPos.x, actorPos.y, actorPos.z );
+
+    if( pActor->isShownTo( pPlayer ) )
+      distanceSq *= SHOWN_DISTANCE_BONUS * SHOWN_DISTANCE_BONUS;
+
+    m_candidates.push_back( { pActor.get(), getRelevance( player, static_cast< Entity::Chara& >( *pActor ) ), distanceSq } );
+  }
+
+  auto shownCount = std::min< size_t >( m_candidates.size(), m_visibleActorBudget );
+  if( shownCount < m_candidates.size() )
+    std::nth_element( m_candidates.begin(), m_candidates.begin() + shownCount, m_candidates.end() );
+
+  // hide first, the freed spawn indexes are needed by the actors moving into the budget
+  for( auto it = m_candidates.begin() + shownCount; it != m_candidates.end(); ++it )
+    it->pActor->hideFrom( pPlayer );
+
+  // closest first, the reduced detail cap keeps the closest of the unrelated actors
+  std::sort( m_candidates.begin(), m_candidates.begin() + shownCount );
+
+  const auto reducedDistanceSq = REDUCED_DETAIL_DISTANCE * REDUCED_DETAIL_DISTANCE;
+  uint32_t reducedCount = 0;
+  for( auto it = m_candidates.begin(); it != m_candidates.begin() + shownCount; ++it )
+  {
+    if( !it->pActor->isShownTo( pPlayer ) )
+      it->pActor->showTo( pPlayer );
+
+    auto detail = Entity::MoveDetail::Full;
+    if( it->relevance == Ambient && it->distanceSq > reducedDistanceSq )
+    {
+      auto& chara = static_cast< Entity::Chara& >( *it->pActor );
+      if( reducedCount < MAX_REDUCED_ACTORS && player.isFacingTarget( chara, VIEW_CONE_COS ) )
+      {
+        detail = Entity::MoveDetail::Reduced;
+        ++reducedCount;
+      }
+      else
+        detail = Entity::MoveDetail::Suppressed;
+    }
+
+    it->pActor->setMoveDetailFor( pPlayer, detail );
+  }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ForwardsZone.h"
+#include "Actor/GameObject.h"
+
+namespace Sapphire::World::Manager
+{
+  /*!
+   * @brief Decides which of the charas in range of a player are spawned for it
+   *
+   * Candidates are the charas in the in range set of the player. They are ranked by relevance first,
+   * party members and anything targeting or targeted by the player, then anything fighting the player,
+   * and by distance within the same relevance. Only the best ranked up to the visible actor budget are spawned,
+   * so spawn packets and the fan-out of everything the actors broadcast grow with the budget, not with the population.
+   * Event and area objects are not ranked, they have their own spawn index space and are always spawned.
+   *
+   * Spawned actors also get a movement detail level per player. Anything related to the player or closer than
+   * REDUCED_DETAIL_DISTANCE gets every movement update. Unrelated actors further away get every REDUCED_MOVE_DIVISOR-th,
+   * and only if they moved to another coarse cell since, unless they are behind the player or past the closest
+   * MAX_REDUCED_ACTORS, then they get every SUPPRESSED_MOVE_DIVISOR-th.
+   */
+  class InterestMgr
+  {
+  public:
+    // re-rank at least this often even if no actor entered or left the in range set, distances and combat state change
+    static const uint64_t UPDATE_INTERVAL = 1000;
+
+    static constexpr float REDUCED_DETAIL_DISTANCE = 40.f;
+    static const uint32_t REDUCED_MOVE_DIVISOR = 3;
+    static const uint32_t SUPPRESSED_MOVE_DIVISOR = 9;
+
+    // the server only knows where the character faces, not the camera, so the cone is wide and only cuts what is behind
+    static constexpr float VIEW_CONE_COS = -0.5f;
+
+    static const uint32_t MAX_REDUCED_ACTORS = 24;
+
+    // spawned actors are ranked as if this much closer, so actors at the edge of the budget do not flicker
+    static constexpr float SHOWN_DISTANCE_BONUS = 0.8f;
+
+    explicit InterestMgr( uint32_t visibleActorBudget );
+
+    void update( Entity::Player& player, uint64_t tickCount );
+
+    uint32_t getVisibleActorBudget() const;
+
+    struct MoveDetailStats
+    {
+      uint64_t sent;
+      uint64_t skipped;
+    };
+
+    void countMoveUpdate( Entity::MoveDetail detail, bool sent );
+
+    const MoveDetailStats& getMoveDetailStats( Entity::MoveDetail detail ) const;
+
+  private:
+    enum Relevance : uint8_t
+    {
+      Important,
+      Combat,
+      Ambient
+    };
+
+    struct Candidate
+    {
+      Entity::GameObject* pActor;
+      Relevance relevance;
+      float distanceSq;
+
+      bool operator<( const Candidate& other ) const
+      {
+        return relevance != other.relevance ? relevance < other.relevance : distanceSq < other.distanceSq;
+      }
+    };
+
+    static Relevance getRelevance( Entity::Player& player, Entity::Chara& chara );
+
+    uint32_t m_visibleActorBudget;
+
+    std::array< MoveDetailStats, 3 > m_moveDetailStats{};
+
+    // reused between updates, all players are updated on the tick thread
+    std::vector< Candidate > m_candidates;
+  };
+
+}
@@ -120,7 +120,7 @@ void InventoryMgr::removeItemFromHousingContainer( Common::LandIdent ident, uint
   stmt->setUInt( 2, containerId );
   stmt->setUInt( 3, slotId );
 
-  db.directExecute( stmt );
+  db.execute( stmt, u64ident );
 }
 
 void InventoryMgr::saveHousingContainerItem( uint64_t ident, uint16_t containerId, uint16_t slotId, uint64_t itemId )
@@ -139,7 +139,7 @@ void InventoryMgr::saveHousingContainerItem( uint64_t ident, uint16_t containerI
   // the second time is for the ON DUPLICATE KEY UPDATE condition
   stmt->setUInt64( 5, itemId );
 
-  db.directExecute( stmt );
+  db.execute( stmt, ident );
 }
 
 void InventoryMgr::updateHousingItemPosition( Inventory::HousingItemPtr item )
@@ -165,7 +165,8 @@ void InventoryMgr::updateHousingItemPosition( Inventory::HousingItemPtr item )
   stmt->setDouble( 8, pos.z );
   stmt->setDouble( 9, rot );
 
-  db.execute( stmt );
+  // placed item rows are ordered by item id, same as the item itself
+  db.execute( stmt, item->getUId() );
 }
 
 void InventoryMgr::removeHousingItemPosition( Inventory::HousingItem& item )
@@ -176,7 +177,7 @@ void InventoryMgr::removeHousingItemPosition( Inventory::HousingItem& item )
 
   stmt->setUInt64( 1, item.getUId() );
 
-  db.directExecute( stmt );
+  db.execute( stmt, item.getUId() );
 }
 
 void InventoryMgr::saveItem( Entity::Player& player, ItemPtr item )
@@ -189,5 +190,5 @@ void InventoryMgr::saveItem( Entity::Player& player, ItemPtr item )
   stmt->setUInt( 3, item->getId() );
   stmt->setUInt( 4, item->getStackSize() );
 
-  db.directExecute( stmt );
+  db.execute( stmt, player.getCharacterId() );
 }
@@ -180,18 +180,19 @@ Common::ContainerType ItemMgr::getContainerType( uint32_t containerId )
 
 uint64_t ItemMgr::getNextUId()
 {
-  // todo: fix crosstalk bug here, we're possibly creating two items of the same id
-  uint64_t charId;
+  std::lock_guard< std::mutex > lock( m_uIdMutex );
 
-  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
-  auto pQR = db.query( "SELECT MAX(ItemId) FROM charaglobalitem" );
+  // the inserts are queued, reading MAX( ItemId ) every time would hand out ids of rows still in flight
+  if( m_nextUId == 0 )
+  {
+    m_nextUId = 0x00500001;
 
-  if( !pQR || !pQR->next() )
-    return 0x00500001;
+    auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+    auto pQR = db.query( "SELECT MAX(ItemId) FROM charaglobalitem" );
 
-  charId = pQR->getUInt64( 1 ) + 1;
-  if( charId < 0x00500001 )
-    return 0x00500001;
+    if( pQR && pQR->next() )
+      m_nextUId = std::max< uint64_t >( m_nextUId, pQR->getUInt64( 1 ) + 1 );
+  }
 
-  return charId;
+  return m_nextUId++;
 }
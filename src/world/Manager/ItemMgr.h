@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Common.h>
+#include <mutex>
 #include "ForwardsZone.h"
 
 namespace Sapphire::World::Manager
@@ -13,6 +14,7 @@ namespace Sapphire::World::Manager
 
     ItemPtr loadItem( uint64_t uId );
 
+    // thread safe, item rows are inserted through the async db queues
     uint64_t getNextUId();
 
     /*! check if weapon category qualifies the weapon as onehanded */
@@ -21,6 +23,10 @@ namespace Sapphire::World::Manager
     static bool isEquipment( uint16_t containerId );
     static uint16_t getCharaEquipSlotCategoryToArmoryId( uint8_t slotId );
     static Common::ContainerType getContainerType( uint32_t containerId );
+
+  private:
+    std::mutex m_uIdMutex;
+    uint64_t m_nextUId{ 0 };
   };
 
 }
\ No newline at end of file
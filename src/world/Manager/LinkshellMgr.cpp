@@ -129,7 +129,7 @@ void LinkshellMgr::writeLinkshell( uint64_t lsId )
   query->setBinary( 4, inviteBin );
   query->setUInt64( 5, ls->getMasterId() );
   query->setInt64( 6, static_cast< int64_t >( lsId ) );
-  db.execute( query );
+  db.execute( query, lsId );
 
 }
 
@@ -213,7 +213,8 @@ LinkshellPtr LinkshellMgr::createLinkshell( const std::string& name, Entity::Pla
   stmt->setBinary( 5, leadVec );
   stmt->setBinary( 6, invVec );
 
-  db.directExecute( stmt );
+  // queued under the linkshell id so it lands before any update of it
+  db.execute( stmt, linkshellId );
 
   return lsPtr;
 }
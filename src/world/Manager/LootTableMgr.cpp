@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <iterator>
+#include <limits>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
@@ -15,11 +17,11 @@ using namespace Sapphire::World::Loot;
 using namespace Sapphire::World::Manager;
 namespace fs = std::filesystem;
 
-bool LootTableMgr::cacheLootTables()
+bool LootTableMgr::cacheLootTables( const std::string& path )
 {
   std::fstream f;
 
-  for( auto& p : fs::recursive_directory_iterator( "data/lootTables/" ) )
+  for( auto& p : fs::recursive_directory_iterator( path ) )
   {
     if( p.path().extension() == ".json" )
     {
@@ -36,6 +38,9 @@ bool LootTableMgr::cacheLootTables()
     }
   }
 
+  compileLootTables();
+  Logger::info( "LootTableMgr: Compiled {0} loot tables", m_compiledTables.size() );
+
   return true;
 }
 
@@ -48,71 +53,237 @@ LootTablePtr LootTableMgr::getLootTableByName( const std::string& name )
     return it->second;
 }
 
-LootTableResult LootTableMgr::rollLoot( const std::string& name )
+LootTableId LootTableMgr::getLootTableId( const std::string& name ) const
 {
-  auto& RNGMgr = Common::Service< Common::Random::RNGMgr >::ref();
+  auto it = m_lootTableIds.find( name );
+  if( it == m_lootTableIds.end() )
+    return InvalidLootTableId;
+  return it->second;
+}
 
-  LootTableResult result;
+void LootTableMgr::compileLootTables()
+{
+  m_compiledTables.clear();
+  m_lootTableIds.clear();
+  m_compiledTables.reserve( m_lootTableMap.size() );
 
-  if( auto pLootTable = getLootTableByName( name ); pLootTable )
+  // the map is sorted by name, so ids stay the same for the same set of tables
+  for( const auto& [ name, pLootTable ] : m_lootTableMap )
   {
-    Logger::info( "LootTableMgr: Rolling for " + name );
-    result.name = pLootTable->lootTable;
+    CompiledTable table;
+    table.name = pLootTable->lootTable;
 
     for( const auto& pool : pLootTable->pools )
     {
       if( !pool.enabled )
         continue;
 
-      auto pickCountGen = RNGMgr.getRandGenerator< uint32_t >( pool.pick.min, pool.pick.max );
-      uint32_t picks = pickCountGen.next();
+      auto compiledPool = compilePool( pool );
+      if( compiledPool.items.empty() )
+      {
+        Logger::warn( "LootTableMgr: {0} pool '{1}' has no weighted items, skipping", name, pool.name );
+        continue;
+      }
+
+      table.pools.push_back( std::move( compiledPool ) );
+    }
+
+    m_lootTableIds[ name ] = static_cast< LootTableId >( m_compiledTables.size() );
+    m_compiledTables.push_back( std::move( table ) );
+  }
+}
+
+LootTableMgr::CompiledPool LootTableMgr::compilePool( const LootTablePool& pool )
+{
+  CompiledPool compiled;
+  compiled.name = pool.name;
+  compiled.duplicates = pool.duplicates;
+  compiled.pick = pool.pick;
+
+  uint64_t totalWeight = 0;
+  for( const auto& item : pool.items )
+  {
+    if( item.weight == 0 )
+      continue;
+
+    compiled.items.push_back( item );
+    totalWeight += item.weight;
+  }
+
+  const auto count = compiled.items.size();
+  if( count == 0 )
+    return compiled;
+
+  std::vector< uint32_t > ids;
+  for( const auto& item : compiled.items )
+    ids.push_back( item.id );
+  std::sort( ids.begin(), ids.end() );
+  compiled.distinctIds = static_cast< uint32_t >( std::unique( ids.begin(), ids.end() ) - ids.begin() );
+
+  // Vose: scale weights so the average column is 1, then pair every small column with a large one
+  std::vector< double > scaled( count );
+  std::vector< uint32_t > small;
+  std::vector< uint32_t > large;
+
+  for( size_t i = 0; i < count; ++i )
+  {
+    scaled[ i ] = static_cast< double >( compiled.items[ i ].weight ) * count / totalWeight;
+    if( scaled[ i ] < 1.0 )
+      small.push_back( static_cast< uint32_t >( i ) );
+    else
+      large.push_back( static_cast< uint32_t >( i ) );
+  }
+
+  compiled.threshold.assign( count, std::numeric_limits< uint32_t >::max() );
+  compiled.alias.resize( count );
+  for( size_t i = 0; i < count; ++i )
+    compiled.alias[ i ] = static_cast< uint32_t >( i );
+
+  while( !small.empty() && !large.empty() )
+  {
+    const auto less = small.back();
+    small.pop_back();
+    const auto more = large.back();
+
+    compiled.threshold[ less ] = static_cast< uint32_t >( scaled[ less ] * 4294967296.0 );
+    compiled.alias[ less ] = more;
+
+    scaled[ more ] = ( scaled[ more ] + scaled[ less ] ) - 1.0;
+    if( scaled[ more ] < 1.0 )
+    {
+      large.pop_back();
+      small.push_back( more );
+    }
+  }
+
+  // whatever is left is 1 up to rounding and keeps its own column
+
+  return compiled;
+}
+
+uint32_t LootTableMgr::pickWeightedItem( const CompiledPool& pool, Common::Random::RNGMgr::Engine& engine )
+{
+  const auto column = static_cast< uint32_t >( ( static_cast< uint64_t >( engine.next32() ) * pool.items.size() ) >> 32 );
+  return engine.next32() < pool.threshold[ column ] ? column : pool.alias[ column ];
+}
+
+namespace
+{
+  // uniform in [ min, max ], max below min yields min
+  uint32_t rollRange( Common::Random::RNGMgr::Engine& engine, const LootTableRange& range )
+  {
+    if( range.max <= range.min )
+      return range.min;
+
+    const uint64_t span = static_cast< uint64_t >( range.max - range.min ) + 1;
+    return range.min + static_cast< uint32_t >( ( static_cast< uint64_t >( engine.next32() ) * span ) >> 32 );
+  }
+}
+
+void LootTableMgr::rollPool( const CompiledPool& pool, Common::Random::RNGMgr::Engine& engine, LootTableResult& result )
+{
+  auto picks = rollRange( engine, pool.pick );
+  if( !pool.duplicates )
+    picks = std::min( picks, pool.distinctIds );
 
-      std::vector< LootTableItem > available = pool.items;
+  const auto firstPick = result.items.size();
+
+  for( uint32_t i = 0; i < picks; ++i )
+  {
+    auto index = pickWeightedItem( pool, engine );
 
-      for( auto i = 0; i < picks && !available.empty(); ++i )
+    if( !pool.duplicates )
+    {
+      // reroll items already picked, this samples the remaining weights exactly
+      auto isPicked = [ & ]( uint32_t itemIndex )
       {
-        const auto& item = pickWeightedItem( available );
+        const auto id = pool.items[ itemIndex ].id;
+        return std::any_of( result.items.begin() + firstPick, result.items.end(),
+                            [ id ]( const LootTableResultItem& picked ) { return picked.id == id; } );
+      };
 
-        auto itemCountGen = RNGMgr.getRandGenerator< uint32_t >( item.quantity.min, item.quantity.max );
-        uint32_t qty = itemCountGen.next();
+      constexpr int MaxRerolls = 16;
+      int rerolls = 0;
+      while( isPicked( index ) && rerolls++ < MaxRerolls )
+        index = pickWeightedItem( pool, engine );
 
-        result.items.push_back( { item.id, qty, item.isHq } );
+      // heavy items are gone, fall back to a scan over what is left
+      if( isPicked( index ) )
+      {
+        uint64_t remaining = 0;
+        for( uint32_t j = 0; j < pool.items.size(); ++j )
+          if( !isPicked( j ) )
+            remaining += pool.items[ j ].weight;
 
-        if( !pool.duplicates )
+        auto roll = ( static_cast< uint64_t >( engine.next32() ) * remaining ) >> 32;
+        for( uint32_t j = 0; j < pool.items.size(); ++j )
         {
-          available.erase( std::remove_if( available.begin(), available.end(),
-                  [ & ]( const auto& x ) { return x.id == item.id; } ),
-                  available.end() );
+          if( isPicked( j ) )
+            continue;
+
+          if( roll < pool.items[ j ].weight )
+          {
+            index = j;
+            break;
+          }
+          roll -= pool.items[ j ].weight;
         }
       }
     }
 
-    Logger::debug( "LootTableMgr: Rolled total of {0} item results", result.count() );
+    const auto& item = pool.items[ index ];
+    result.items.push_back( { item.id, rollRange( engine, item.quantity ), item.isHq } );
+  }
+}
+
+LootTableResult LootTableMgr::rollLoot( const std::string& name )
+{
+  LootTableResult result;
+
+  auto id = getLootTableId( name );
+  if( id == InvalidLootTableId )
+  {
+    Logger::warn( "LootTableMgr: Loot table {0} not found", name );
+    return result;
   }
-    
+
+  rollLoot( id, result );
+  Logger::debug( "LootTableMgr: Rolled total of {0} item results", result.count() );
+
   return result;
 }
 
-const LootTableItem& LootTableMgr::pickWeightedItem( const std::vector< LootTableItem >& items )
+void LootTableMgr::rollLoot( LootTableId id, LootTableResult& result )
 {
+  if( id >= m_compiledTables.size() )
+    return;
+
   auto& RNGMgr = Common::Service< Common::Random::RNGMgr >::ref();
-  // calc total weight
-  uint32_t totalWeight = 0;
-  for( const auto& it : items )
-    totalWeight += it.weight;
-
-  // roll for [1, totalWeight]
-  auto randGen = RNGMgr.getRandGenerator< uint32_t >( 1, totalWeight );
-  uint32_t roll = randGen.next();
-
-  // get item pick
-  uint32_t cumulative = 0;
-  for( const auto& it : items )
+  auto& engine = RNGMgr.getRNGEngine();
+
+  const auto& table = m_compiledTables[ id ];
+  result.name = table.name;
+
+  for( const auto& pool : table.pools )
+    rollPool( pool, engine, result );
+}
+
+std::vector< LootTableResult > LootTableMgr::rollLoot( LootTableId id, size_t count )
+{
+  std::vector< LootTableResult > results( count );
+  if( id >= m_compiledTables.size() )
+    return results;
+
+  auto& RNGMgr = Common::Service< Common::Random::RNGMgr >::ref();
+  auto& engine = RNGMgr.getRNGEngine();
+
+  const auto& table = m_compiledTables[ id ];
+  for( auto& result : results )
   {
-    cumulative += it.weight;
-    if( roll <= cumulative )
-      return it;
+    result.name = table.name;
+    for( const auto& pool : table.pools )
+      rollPool( pool, engine, result );
   }
 
-  throw std::runtime_error( "LootTableMgr: pickWeightedItem roll exceeded total weight" );
+  return results;
 }
@@ -2,9 +2,12 @@
 
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include "ForwardsZone.h"
 
+#include <Random/RNGMgr.h>
+
 #include <nlohmann/json.hpp>
 
 namespace Sapphire::World::Loot
@@ -57,6 +60,10 @@ namespace Sapphire::World::Loot
   };
 
   using LootTablePtr = std::shared_ptr< LootTable >;
+
+  // index of a compiled loot table, tables are numbered in name order when cached
+  using LootTableId = uint32_t;
+  constexpr LootTableId InvalidLootTableId = 0xFFFFFFFF;
 }
 
 
@@ -72,7 +79,8 @@ namespace Sapphire::World::Manager
     /// <summary>
     /// initialize loot tables from JSON into a map
     /// </summary>
-    bool cacheLootTables();
+    /// <param name="path">directory searched recursively for .json tables</param>
+    bool cacheLootTables( const std::string& path = "data/lootTables/" );
 
     /// <summary>
     /// returns LootTable ptr by its name
@@ -81,27 +89,80 @@ namespace Sapphire::World::Manager
     /// <returns>ptr to LootTable or null</returns>
     Loot::LootTablePtr getLootTableByName( const std::string& name );
 
+    /// <summary>
+    /// returns the id of the compiled loot table with the given name
+    /// </summary>
+    /// <param name="name"></param>
+    /// <returns>table id or InvalidLootTableId</returns>
+    Loot::LootTableId getLootTableId( const std::string& name ) const;
+
     /// <summary>
     /// rolls a given loot table by name
     /// internally processes given pools and items
     /// returns a LootTableStruct with resolved loot table results
-    /// may throw if loot table is not found
     /// </summary>
     /// <param name="name"></param>
     /// <returns>struct of loot table rolls</returns>
     Loot::LootTableResult rollLoot( const std::string& name );
 
+    /// <summary>
+    /// rolls a compiled loot table, appending the picks to result
+    /// every item pick is O(1) and nothing is allocated once result has capacity
+    /// </summary>
+    /// <param name="id"></param>
+    /// <param name="result"></param>
+    void rollLoot( Loot::LootTableId id, Loot::LootTableResult& result );
+
+    /// <summary>
+    /// rolls a compiled loot table count times in one go, e.g. once per player of a group kill
+    /// </summary>
+    /// <param name="id"></param>
+    /// <param name="count"></param>
+    /// <returns>one result per roll</returns>
+    std::vector< Loot::LootTableResult > rollLoot( Loot::LootTableId id, size_t count );
+
   private:
+    // Walker / Vose alias table over the items of a pool
+    struct CompiledPool
+    {
+      std::string name;
+      bool duplicates;
+      Loot::LootTableRange pick;
+      std::vector< Loot::LootTableItem > items;
+      // chance of keeping the rolled column, scaled to 2^32
+      std::vector< uint32_t > threshold;
+      // item picked instead when the column is not kept
+      std::vector< uint32_t > alias;
+      // upper bound of picks for pools without duplicates
+      uint32_t distinctIds;
+    };
+
+    struct CompiledTable
+    {
+      std::string name;
+      std::vector< CompiledPool > pools;
+    };
+
     std::map< std::string, Loot::LootTablePtr > m_lootTableMap;
+    std::unordered_map< std::string, Loot::LootTableId > m_lootTableIds;
+    std::vector< CompiledTable > m_compiledTables;
+
+    /// <summary>
+    /// builds the alias tables of every cached loot table
+    /// </summary>
+    void compileLootTables();
+
+    static CompiledPool compilePool( const Loot::LootTablePool& pool );
+
+    void rollPool( const CompiledPool& pool, Common::Random::RNGMgr::Engine& engine, Loot::LootTableResult& result );
 
     /// <summary>
-    /// picks a single item per weight out of a total weight of vector of items
-    /// uses weighted system and RNGMgr to select a roll
-    /// may throw if roll > total weight
+    /// picks a single item index out of the pool alias table in constant time
     /// </summary>
-    /// <param name="items"></param>
-    /// <returns>singular item pick from given items</returns>
-    const Loot::LootTableItem& pickWeightedItem( const std::vector< Loot::LootTableItem >& items );
+    /// <param name="pool"></param>
+    /// <param name="engine"></param>
+    /// <returns>index into pool items</returns>
+    static uint32_t pickWeightedItem( const CompiledPool& pool, Common::Random::RNGMgr::Engine& engine );
   };
 
 }
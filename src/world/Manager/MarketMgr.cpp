@@ -2,16 +2,24 @@
 
 #include <Network/GamePacket.h>
 #include <Network/PacketDef/Zone/ServerZoneDef.h>
+#include <Exd/ExdData.h>
+#include <Database/ZoneDbConnection.h>
+#include <Database/DbWorkerPool.h>
+#include <Database/PreparedStatement.h>
+#include <Logging/Logger.h>
+#include <Util/Util.h>
 
 #include "Actor/Player.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include <Service.h>
 #include "WorldServer.h"
 #include "Session.h"
 #include "Network/GameConnection.h"
 #include "Manager/MgrUtil.h"
+#include "Manager/PlayerMgr.h"
 
 using namespace Sapphire;
 using namespace Sapphire::World::Manager;
@@ -21,70 +29,329 @@ using namespace Sapphire::Network::Packets::WorldPackets::Server;
 
 bool MarketMgr::init()
 {
-//  Logger::info( "MarketMgr: warming up marketable item cache..." );
-//
-//  // build item cache
-//  auto& exdData = Common::Service< Sapphire::Data::ExdDataGenerated >::ref();
-//  auto idList = exdData.getItemIdList();
-//
-//  for( auto id : idList )
-//  {
-//    if( id > 10000 )
-//      break;
-//
-//    auto item = exdData.get< Sapphire::Data::Item >( id );
-//    if( !item )
-//      continue;
-//
-//    if( item->isUntradable )
-//      continue;
-//
-//    MarketableItem cacheEntry {};
-//    cacheEntry.catalogId = id;
-//    cacheEntry.itemSearchCategory = item->itemSearchCategory;
-//    cacheEntry.maxEquipLevel = item->levelEquip;
-//    cacheEntry.name = item->name;
-//    cacheEntry.classJob = item->classJobUse;
-//    cacheEntry.itemLevel = item->levelItem;
-//
-//    m_marketItemCache.push_back( std::move( cacheEntry ) );
-//  }
-//
-//  std::sort( m_marketItemCache.begin(), m_marketItemCache.end(), []( const MarketableItem& a, const MarketableItem& b )
-//  {
-//    return a.itemLevel > b.itemLevel;
-//  } );
-//
-//  Logger::info( "MarketMgr: Cached " + std::to_string( m_marketItemCache.size() ) + " marketable items" );
+  Logger::info( "MarketMgr: warming up marketable item cache..." );
+
+  buildItemIndex();
+
+  Logger::info( "MarketMgr: Cached {0} marketable items, {1} name trigrams", m_board.getItemCount(), m_board.getTrigramCount() );
+
+  if( !loadListings() )
+    return false;
+
+  Logger::info( "MarketMgr: Loaded {0} listings", m_board.getListingCount() );
+
+  return true;
+}
+
+void MarketMgr::buildItemIndex()
+{
+  auto& exdData = Common::Service< Data::ExdData >::ref();
+
+  std::unordered_map< uint32_t, std::bitset< 64 > > classJobCategories;
+  for( const auto& [ id, category ] : exdData.getRows< Excel::ClassJobCategory >() )
+  {
+    std::bitset< 64 > classJobs;
+    for( size_t i = 0; i < std::size( category->data().ClassJob ); ++i )
+      classJobs[ i ] = category->data().ClassJob[ i ];
+
+    classJobCategories[ id ] = classJobs;
+  }
+
+  std::vector< MarketBoard::Item > items;
+  for( const auto& [ id, item ] : exdData.getRows< Excel::Item >() )
+  {
+    const auto& data = item->data();
+
+    // only items with a search category show up on the market board
+    if( data.SearchCategory == 0 )
+      continue;
+
+    auto name = item->getString( data.Text.SGL );
+    if( name.empty() )
+      continue;
+
+    MarketBoard::Item entry{};
+    entry.catalogId = id;
+    entry.itemSearchCategory = data.SearchCategory;
+    entry.maxEquipLevel = data.EquipLevel;
+    entry.itemLevel = data.Level;
+    entry.name = Common::Util::toLowerCopy( name );
+
+    auto classJobs = classJobCategories.find( data.Class );
+    if( classJobs != classJobCategories.end() && !classJobs->second.all() )
+      entry.classJobs = classJobs->second;
+
+    items.push_back( std::move( entry ) );
+  }
+
+  m_board.setItems( std::move( items ) );
+}
+
+bool MarketMgr::loadListings()
+{
+  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+
+  auto query = db.getPreparedStatement( Db::MARKET_LISTING_SEL_ALL );
+  auto res = db.query( query );
+  if( !res )
+    return false;
+
+  while( res->next() )
+  {
+    MarketListing listing;
+    listing.listingId = res->getUInt64( 1 );
+    listing.catalogId = res->getUInt( 2 );
+    listing.sellerCharacterId = res->getUInt64( 3 );
+    listing.retainerId = res->getUInt64( 4 );
+    listing.retainerName = res->getString( 5 );
+    listing.itemId = res->getUInt64( 6 );
+    listing.stack = res->getUInt( 7 );
+    listing.unitPrice = res->getUInt( 8 );
+    listing.hq = res->getBoolean( 9 );
+    listing.stain = res->getUInt8( 10 );
+    listing.listDate = res->getUInt( 11 );
+
+    m_nextListingId = std::max( m_nextListingId, listing.listingId + 1 );
+    m_board.insertListing( std::move( listing ) );
+  }
+
+  return true;
+}
+
+void MarketMgr::loadHistory( uint32_t catalogId )
+{
+  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+
+  auto query = db.getPreparedStatement( Db::MARKET_HISTORY_SEL_ITEM );
+  query->setUInt( 1, catalogId );
+
+  auto sales = std::make_shared< std::vector< MarketSale > >();
+
+  // same key as the history inserts of this item, sales recorded before now are included
+  db.queryAsync( query, [ sales ]( std::shared_ptr< Mysql::PreparedResultSet > res )
+  {
+    if( !res )
+      return;
+
+    while( res->next() )
+    {
+      MarketSale sale;
+      sale.catalogId = res->getUInt( 1 );
+      sale.unitPrice = res->getUInt( 2 );
+      sale.stack = res->getUInt( 3 );
+      sale.hq = res->getBoolean( 4 );
+      sale.buyerName = res->getString( 5 );
+      sale.saleDate = res->getUInt( 6 );
+      sales->push_back( std::move( sale ) );
+    }
+  },
+  [ this, catalogId, sales ]()
+  {
+    server().queueTickTask( [ this, catalogId, sales ]() { onHistoryLoaded( catalogId, std::move( *sales ) ); } );
+  }, catalogId );
+}
+
+void MarketMgr::onHistoryLoaded( uint32_t catalogId, std::vector< MarketSale > sales )
+{
+  auto& history = m_histories[ catalogId ];
+
+  // sales made while loading are queued behind the query and already at the front
+  for( auto& sale : sales )
+  {
+    if( history.sales.size() >= MaxHistory )
+      break;
+    history.sales.push_back( std::move( sale ) );
+  }
+
+  history.state = HistoryState::Loaded;
+
+  auto waiters = std::move( history.waiters );
+  history.waiters.clear();
+
+  for( auto characterId : waiters )
+  {
+    if( auto pPlayer = playerMgr().findPlayer( characterId ) )
+      sendHistory( *pPlayer, catalogId, history );
+  }
+}
+
+void MarketMgr::addSale( MarketSale sale )
+{
+  // the db has it, it is part of the page once the history is loaded
+  auto it = m_histories.find( sale.catalogId );
+  if( it == m_histories.end() || it->second.state == HistoryState::NotLoaded )
+    return;
+
+  auto& sales = it->second.sales;
+  sales.push_front( std::move( sale ) );
+
+  if( sales.size() > MaxHistory )
+    sales.pop_back();
+}
+
+uint64_t MarketMgr::addListing( MarketListing listing )
+{
+  if( !isMarketable( listing.catalogId ) || listing.stack == 0 )
+    return 0;
+
+  listing.listingId = m_nextListingId++;
+  if( listing.listDate == 0 )
+    listing.listDate = Common::Util::getTimeSeconds();
+
+  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+  auto stmt = db.getPreparedStatement( Db::MARKET_LISTING_INS );
+  stmt->setUInt64( 1, listing.listingId );
+  stmt->setUInt( 2, listing.catalogId );
+  stmt->setUInt64( 3, listing.sellerCharacterId );
+  stmt->setUInt64( 4, listing.retainerId );
+  stmt->setString( 5, listing.retainerName );
+  stmt->setUInt64( 6, listing.itemId );
+  stmt->setUInt( 7, listing.stack );
+  stmt->setUInt( 8, listing.unitPrice );
+  stmt->setBool( 9, listing.hq );
+  stmt->setUInt( 10, listing.stain );
+  stmt->setUInt( 11, listing.listDate );
+  // ordered by listing, a later update or removal of the same listing can never overtake the insert
+  db.execute( stmt, listing.listingId );
+
+  const auto listingId = listing.listingId;
+  m_board.insertListing( std::move( listing ) );
+
+  return listingId;
+}
+
+bool MarketMgr::updateListing( uint64_t listingId, uint32_t stack, uint32_t unitPrice )
+{
+  if( stack == 0 || !m_board.updateListing( listingId, stack, unitPrice ) )
+    return false;
+
+  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+  auto stmt = db.getPreparedStatement( Db::MARKET_LISTING_UP );
+  stmt->setUInt( 1, stack );
+  stmt->setUInt( 2, unitPrice );
+  stmt->setUInt64( 3, listingId );
+  db.execute( stmt, listingId );
+
+  return true;
+}
+
+bool MarketMgr::removeListing( uint64_t listingId )
+{
+  if( !m_board.eraseListing( listingId ) )
+    return false;
+
+  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+  auto stmt = db.getPreparedStatement( Db::MARKET_LISTING_DEL );
+  stmt->setUInt64( 1, listingId );
+  db.execute( stmt, listingId );
 
   return true;
 }
 
+bool MarketMgr::completeSale( uint64_t listingId, const std::string& buyerName )
+{
+  auto pListing = m_board.getListing( listingId );
+  if( !pListing )
+    return false;
+
+  MarketSale sale;
+  sale.catalogId = pListing->catalogId;
+  sale.unitPrice = pListing->unitPrice;
+  sale.stack = pListing->stack;
+  sale.hq = pListing->hq;
+  sale.buyerName = buyerName;
+  sale.saleDate = Common::Util::getTimeSeconds();
+
+  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+  auto stmt = db.getPreparedStatement( Db::MARKET_HISTORY_INS );
+  stmt->setUInt( 1, sale.catalogId );
+  stmt->setUInt( 2, sale.unitPrice );
+  stmt->setUInt( 3, sale.stack );
+  stmt->setBool( 4, sale.hq );
+  stmt->setString( 5, sale.buyerName );
+  stmt->setUInt( 6, sale.saleDate );
+  // keyed by item, so a history query for it sees every sale queued before
+  db.execute( stmt, sale.catalogId );
+
+  addSale( std::move( sale ) );
+  return removeListing( listingId );
+}
+
+const MarketListing* MarketMgr::getListing( uint64_t listingId ) const
+{
+  return m_board.getListing( listingId );
+}
+
+std::vector< const MarketListing* > MarketMgr::getListings( uint32_t catalogId, size_t limit ) const
+{
+  return m_board.getListings( catalogId, limit );
+}
+
+size_t MarketMgr::getListingCount( uint32_t catalogId ) const
+{
+  return m_board.getListingCount( catalogId );
+}
+
+size_t MarketMgr::getListingCount() const
+{
+  return m_board.getListingCount();
+}
+
+bool MarketMgr::isMarketable( uint32_t catalogId ) const
+{
+  return m_board.isMarketable( catalogId );
+}
+
 void MarketMgr::requestItemListingInfo( Entity::Player& player, uint32_t catalogId, uint32_t requestId )
 {
+  // the id comes from the client, only items of the market board have listings and a history to load
+  if( !isMarketable( catalogId ) )
+    return;
+
   auto countPkt = makeZonePacket< FFFXIVIpcItemSearchResult >( player.getId() );
-  countPkt->data().Count = 0;
+  countPkt->data().Count = static_cast< uint8_t >( std::min< size_t >( getListingCount( catalogId ), 0xFF ) );
   countPkt->data().CatalogID = catalogId;
   countPkt->data().Result = requestId;
 
   server().queueForPlayer( player.getCharacterId(), countPkt );
 
+  auto it = m_histories.find( catalogId );
+  if( it == m_histories.end() )
+    it = m_histories.emplace( catalogId, ItemHistory{} ).first;
+
+  auto& history = it->second;
+  if( history.state == HistoryState::Loaded )
+  {
+    sendHistory( player, catalogId, history );
+    return;
+  }
+
+  history.waiters.push_back( player.getCharacterId() );
+  if( history.state == HistoryState::NotLoaded )
+  {
+    history.state = HistoryState::Loading;
+    loadHistory( catalogId );
+  }
+}
+
+void MarketMgr::sendHistory( Entity::Player& player, uint32_t catalogId, const ItemHistory& history )
+{
   auto historyPkt = makeZonePacket< FFXIVIpcGetItemHistoryResult >( player.getId() );
   historyPkt->data().CatalogID = catalogId;
 
-  std::string name = "fix game pls se :(((";
-
-  for( int i = 0; i < 10; i++ )
+  const auto& sales = history.sales;
+  for( size_t i = 0; i < sales.size() && i < MaxHistory; ++i )
   {
-    auto& listing = historyPkt->data().ItemHistoryList[ i ];
+    auto& entry = historyPkt->data().ItemHistoryList[ i ];
+    const auto& sale = sales[ i ];
 
-    listing.CatalogID = catalogId;
-    listing.Stack = i + 1;
-    listing.BuyRealDate = Common::Util::getTimeSeconds();
-    listing.SellPrice = 69420420;
-    listing.SubQuality = 1;
+    entry.CatalogID = catalogId;
+    entry.Stack = sale.stack;
+    entry.BuyRealDate = sale.saleDate;
+    entry.SellPrice = sale.unitPrice;
+    entry.SubQuality = sale.hq ? 1 : 0;
 
-    strcpy( listing.BuyCharacterName, name.c_str() );
+    strncpy( entry.BuyCharacterName, sale.buyerName.c_str(), sizeof( entry.BuyCharacterName ) - 1 );
   }
 
   server().queueForPlayer( player.getCharacterId(), historyPkt );
@@ -94,8 +361,7 @@ void MarketMgr::requestItemListingInfo( Entity::Player& player, uint32_t catalog
 void MarketMgr::searchMarketboard( Entity::Player& player, uint8_t itemSearchCategory,  uint8_t maxEquipLevel, uint8_t classJob,
                                    const std::string_view& searchStr, uint32_t requestId, uint32_t startIdx )
 {
-  ItemSearchResultList resultList;
-  findItems( searchStr, itemSearchCategory, maxEquipLevel, classJob, resultList );
+  const auto resultList = m_board.findItems( searchStr, itemSearchCategory, maxEquipLevel, classJob );
 
   auto numResults = resultList.size();
 
@@ -116,7 +382,7 @@ void MarketMgr::searchMarketboard( Entity::Player& player, uint8_t itemSearchCat
 
     data.CatalogID = item.catalogId;
     data.StockCount = item.quantity;
-    data.RequestItemCount = 420;
+    data.RequestItemCount = 0;
   }
 
   if( size < 20 )
@@ -129,23 +395,41 @@ void MarketMgr::searchMarketboard( Entity::Player& player, uint8_t itemSearchCat
 
 void MarketMgr::requestItemListings( Sapphire::Entity::Player& player, uint16_t catalogId )
 {
+  const auto listings = getListings( catalogId, MaxListingsSent );
 
-}
+  auto resultPkt = makeZonePacket< FFXIVIpcGetItemSearchListResult >( player.getId() );
+  const auto pageSize = std::size( resultPkt->data().ItemSearchList );
 
-void MarketMgr::findItems( const std::string_view& searchStr, uint8_t itemSearchCat, uint8_t maxEquipLevel, uint8_t classJob,
-                           MarketMgr::ItemSearchResultList& resultList )
-{
-  for( const auto& item : m_marketItemCache )
+  // always answer with at least one page, an empty one tells the client there is nothing for sale
+  for( size_t start = 0; start == 0 || start < listings.size(); start += pageSize )
   {
-    if( item.itemSearchCategory != itemSearchCat )
-      continue;
+    if( start != 0 )
+      resultPkt = makeZonePacket< FFXIVIpcGetItemSearchListResult >( player.getId() );
 
-    if( maxEquipLevel > 0 && item.maxEquipLevel > maxEquipLevel )
-      continue;
+    auto& data = resultPkt->data();
+    data.Index = static_cast< uint8_t >( start );
+    data.NextIndex = start + pageSize < listings.size() ? static_cast< uint8_t >( start + pageSize ) : 0;
 
-    if( classJob > 0 && item.classJob != classJob )
-      continue;
+    for( size_t i = 0; i < pageSize && start + i < listings.size(); ++i )
+    {
+      const auto& listing = *listings[ start + i ];
+      auto& entry = data.ItemSearchList[ i ];
+
+      entry.ItemID = listing.itemId;
+      entry.SellRetainerID = listing.retainerId;
+      entry.OwnerCharacterID = listing.sellerCharacterId;
+      entry.SellPrice = listing.unitPrice;
+      // 5% market tax on the total
+      entry.BuyTax = static_cast< uint32_t >( static_cast< uint64_t >( listing.unitPrice ) * listing.stack / 20 );
+      entry.Stack = listing.stack;
+      entry.CatalogID = listing.catalogId;
+      entry.SellRealDate = listing.listDate;
+      entry.SubQuality = listing.hq ? 1 : 0;
+      entry.Stain = listing.stain;
+
+      strncpy( entry.SellRetainerName, listing.retainerName.c_str(), sizeof( entry.SellRetainerName ) - 1 );
+    }
 
-    resultList.push_back( { item.catalogId, 1 } );
+    server().queueForPlayer( player.getCharacterId(), resultPkt );
   }
 }
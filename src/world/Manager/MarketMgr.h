@@ -2,10 +2,27 @@
 
 #include "ForwardsZone.h"
 
+#include "Market/MarketBoard.h"
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace Sapphire::World::Manager
 {
+  using World::MarketListing;
+  using World::MarketSale;
+
+  /*!
+   * Market board engine.
+   *
+   * Marketable items from the item sheet and every listing are held by a MarketBoard.
+   * Listings live in memory, changes are written behind through the async db queue,
+   * ordered per listing, so callers never wait on the database.
+   * Sale history is fetched per item the first time someone looks at it and kept from then on.
+   */
   class MarketMgr
   {
   public:
@@ -22,34 +39,68 @@ namespace Sapphire::World::Manager
 
     void requestItemListings( Entity::Player& player, uint16_t catalogId );
 
+    // returns the id of the new listing, 0 if the item can not be sold on the market board
+    uint64_t addListing( MarketListing listing );
+
+    bool updateListing( uint64_t listingId, uint32_t stack, uint32_t unitPrice );
+
+    // takes a listing down without selling it
+    bool removeListing( uint64_t listingId );
+
+    // removes the listing and records the sale in the item history
+    bool completeSale( uint64_t listingId, const std::string& buyerName );
+
+    const MarketListing* getListing( uint64_t listingId ) const;
+
+    // cheapest first, nq and hq merged
+    std::vector< const MarketListing* > getListings( uint32_t catalogId, size_t limit ) const;
+
+    size_t getListingCount( uint32_t catalogId ) const;
+
+    size_t getListingCount() const;
+
+    bool isMarketable( uint32_t catalogId ) const;
+
   private:
-    struct ItemSearchResult
+    // sales kept per item, the history packet holds this many
+    static constexpr size_t MaxHistory = 20;
+
+    // listings sent when opening an item, in packets of 10
+    static constexpr size_t MaxListingsSent = 100;
+
+    enum class HistoryState : uint8_t
     {
-      uint32_t catalogId;
-      uint16_t quantity;
+      NotLoaded,
+      Loading,
+      Loaded
     };
 
-    struct MarketableItem
+    struct ItemHistory
     {
-      uint32_t catalogId;
-      uint8_t itemSearchCategory;
-      uint8_t maxEquipLevel;
-      uint16_t itemLevel;
-      uint8_t classJob;
-      std::string name;
+      // newest first, only complete once loaded
+      std::deque< MarketSale > sales;
+      HistoryState state{ HistoryState::NotLoaded };
+      // characters waiting for the history while it loads
+      std::vector< uint64_t > waiters;
     };
 
-    using ItemSearchResultList = std::vector< ItemSearchResult >;
-    using MarketableItemCacheList = std::vector< MarketableItem >;
+    MarketBoard m_board;
+    // only marketable items, created when someone first looks at one
+    std::unordered_map< uint32_t, ItemHistory > m_histories;
+    uint64_t m_nextListingId{ 1 };
 
-    MarketableItemCacheList m_marketItemCache;
+    void buildItemIndex();
 
+    bool loadListings();
 
+    // queries the newest page of sales for the item, the waiters get it on the tick
+    void loadHistory( uint32_t catalogId );
 
-    void findItems( const std::string_view& searchStr, uint8_t itemSearchCat, uint8_t maxEquipLevel, uint8_t classJob,
-                    ItemSearchResultList& resultList );
+    void onHistoryLoaded( uint32_t catalogId, std::vector< MarketSale > sales );
 
-  };
-}
+    void sendHistory( Entity::Player& player, uint32_t catalogId, const ItemHistory& history );
 
+    void addSale( MarketSale sale );
 
+  };
+}
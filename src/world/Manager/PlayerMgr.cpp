@@ -7,6 +7,7 @@
 #include <Territory/Land.h>
 
 #include <Manager/AchievementMgr.h>
+#include <Manager/InterestMgr.h>
 #include <Manager/TerritoryMgr.h>
 #include <Manager/HousingMgr.h>
 #include <Manager/QuestMgr.h>
@@ -193,41 +194,69 @@ bool PlayerMgr::loadPlayers()
   return true;
 }
 
-Sapphire::Entity::PlayerPtr PlayerMgr::syncPlayer( uint64_t characterId )
+void PlayerMgr::syncPlayer( uint32_t entityId, std::function< void( Entity::PlayerPtr ) > onSynced )
 {
-  auto pPlayer = getPlayer( characterId );
-  if( !pPlayer )
-    return nullptr;
-
-  // get our cached last db write
-  auto lastCacheSync = pPlayer->getLastDBWrite();
+  if( auto pPlayer = findPlayer( entityId ) )
+  {
+    reloadPlayer( pPlayer, pPlayer->getCharacterId(), std::move( onSynced ) );
+    return;
+  }
 
-  // update this player's last db write
-  if( !pPlayer->syncLastDBWrite() )
-    return nullptr;
+  // not loaded yet (new character?), look up its character id first
+  auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
+  auto stmt = db.getPreparedStatement( Db::ZoneDbStatements::CHARA_SEL_BY_ENTITYID );
+  stmt->setUInt( 1, entityId );
 
-  // get db last write
-  auto dbSync = pPlayer->getLastDBWrite();
+  auto characterId = std::make_shared< uint64_t >( 0 );
+  db.queryAsync( stmt, [ characterId ]( std::shared_ptr< Mysql::PreparedResultSet > res )
+  {
+    if( res && res->next() )
+      *characterId = res->getUInt64( 1 );
+  },
+  [ this, characterId, onSynced = std::move( onSynced ) ]()
+  {
+    auto& server = Common::Service< World::WorldServer >::ref();
+    server.queueTickTask( [ this, characterId, onSynced ]()
+    {
+      if( *characterId == 0 )
+      {
+        onSynced( nullptr );
+        return;
+      }
 
+      // someone else may have loaded it in the meantime
+      reloadPlayer( findPlayer( *characterId ), *characterId, onSynced );
+    } );
+  } );
+}
 
-  // db was updated and we lost track of it  - update
+void PlayerMgr::reloadPlayer( Entity::PlayerPtr pPlayer, uint64_t characterId,
+                              std::function< void( Entity::PlayerPtr ) > onSynced )
+{
   // @todo for now, always reload the player on login.
-  //if( dbSync != lastCacheSync )
+  // the workers fill a fresh player, the one in the maps is only read and replaced on the tick
+  auto pLoaded = Entity::make_Player();
+
+  pLoaded->loadFromDbAsync( characterId, [ this, pPlayer, pLoaded, onSynced ]( bool loaded )
   {
-    // clear current maps
-    m_playerMapById[ pPlayer->getId() ] = nullptr;
-    m_playerMapByName[ pPlayer->getName() ] = nullptr;
-    m_playerMapByCharacterId[ pPlayer->getCharacterId() ] = nullptr;
+    if( !loaded )
+    {
+      onSynced( nullptr );
+      return;
+    }
 
-    if( !pPlayer->loadFromDb( characterId ) )
-      return nullptr;
+    // pPlayer is null when the character was not loaded before
+    if( pPlayer && findPlayer( pPlayer->getId() ) == pPlayer )
+      m_playerMapById.erase( pPlayer->getId() );
+    if( pPlayer && findPlayer( pPlayer->getName() ) == pPlayer )
+      m_playerMapByName.erase( pPlayer->getName() );
 
-    m_playerMapById[ pPlayer->getId() ] = pPlayer;
-    m_playerMapByCharacterId[ pPlayer->getCharacterId() ] = pPlayer;
-    m_playerMapByName[ pPlayer->getName() ] = pPlayer;
-  }
+    m_playerMapById[ pLoaded->getId() ] = pLoaded;
+    m_playerMapByCharacterId[ pLoaded->getCharacterId() ] = pLoaded;
+    m_playerMapByName[ pLoaded->getName() ] = pLoaded;
 
-  return pPlayer;
+    onSynced( pLoaded );
+  } );
 }
 
 void PlayerMgr::onMobKill( Entity::Player& player, Entity::BNpc& bnpc )
@@ -334,6 +363,12 @@ void PlayerMgr::onMoveZone( Sapphire::Entity::Player& player )
 
 void PlayerMgr::onUpdate( Entity::Player& player, uint64_t tickCount )
 {
+  Common::Service< InterestMgr >::ref().update( player, tickCount );
+
+  // clients send nothing once they stopped, players with less move detail are caught up after a short pause
+  if( player.getPendingMove() && tickCount - player.m_lastMoveTime > 500 )
+    server().flushMoveForInRangePlayers( player );
+
   // todo: shouldnt all this be in Player::update()?
   if( player.getHp() <= 0 && player.getStatus() != Common::ActorStatus::Dead )
   {
@@ -24,7 +24,8 @@ namespace Sapphire::World::Manager
     Entity::PlayerPtr loadPlayer( uint64_t characterId );
     Entity::PlayerPtr loadPlayer( const std::string& playerName );
     bool loadPlayers();
-    Entity::PlayerPtr syncPlayer( uint64_t characterId );
+    // reloads the player on the db workers, onSynced is called on the tick with the player or nullptr if it failed
+    void syncPlayer( uint32_t entityId, std::function< void( Entity::PlayerPtr ) > onSynced );
 
     void onMobKill( Sapphire::Entity::Player& player, Sapphire::Entity::BNpc& bnpc );
 
@@ -91,6 +92,9 @@ namespace Sapphire::World::Manager
     std::map< std::string, Entity::PlayerPtr > m_playerMapByName;
 
     void checkAutoAttack( Entity::Player& player, uint64_t tickCount ) const;
+
+    void reloadPlayer( Entity::PlayerPtr pPlayer, uint64_t characterId,
+                       std::function< void( Entity::PlayerPtr ) > onSynced );
   };
 
 
@@ -0,0 +1,272 @@
+#include "MarketBoard.h"
+
+#include <Util/Util.h>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace Sapphire;
+using namespace Sapphire::World;
+
+void MarketBoard::setItems( std::vector< Item > items )
+{
+  m_items.clear();
+  m_categoryIndex.clear();
+  m_trigramIndex.clear();
+  m_itemsByOrder.clear();
+
+  std::vector< IndexedItem* > sorted;
+  sorted.reserve( items.size() );
+  for( auto& item : items )
+  {
+    const auto catalogId = item.catalogId;
+    auto result = m_items.emplace( catalogId, IndexedItem{ std::move( item ), 0 } );
+    if( result.second )
+      sorted.push_back( &result.first->second );
+  }
+
+  std::sort( sorted.begin(), sorted.end(), []( const IndexedItem* a, const IndexedItem* b )
+  {
+    return a->item.itemLevel != b->item.itemLevel ? a->item.itemLevel > b->item.itemLevel
+                                                  : a->item.catalogId < b->item.catalogId;
+  } );
+
+  m_itemsByOrder.assign( sorted.begin(), sorted.end() );
+
+  for( uint32_t i = 0; i < sorted.size(); ++i )
+  {
+    auto pItem = sorted[ i ];
+    pItem->order = i;
+
+    m_categoryIndex[ pItem->item.itemSearchCategory ].push_back( pItem );
+
+    // posting lists are built in default order, so lookups never have to sort them
+    auto& name = pItem->item.name;
+    for( size_t pos = 0; pos + 3 <= name.size(); ++pos )
+    {
+      auto& postings = m_trigramIndex[ makeTrigram( name.c_str() + pos ) ];
+      if( postings.empty() || postings.back() != pItem )
+        postings.push_back( pItem );
+    }
+  }
+}
+
+size_t MarketBoard::getItemCount() const
+{
+  return m_items.size();
+}
+
+size_t MarketBoard::getTrigramCount() const
+{
+  return m_trigramIndex.size();
+}
+
+bool MarketBoard::isMarketable( uint32_t catalogId ) const
+{
+  return m_items.find( catalogId ) != m_items.end();
+}
+
+std::vector< MarketBoard::SearchResult > MarketBoard::findItems( std::string_view searchStr, uint8_t itemSearchCat,
+                                                                 uint8_t maxEquipLevel, uint8_t classJob ) const
+{
+  std::vector< SearchResult > resultList;
+
+  auto matches = [ & ]( const Item& item )
+  {
+    if( itemSearchCat != 0 && item.itemSearchCategory != itemSearchCat )
+      return false;
+
+    if( maxEquipLevel > 0 && item.maxEquipLevel > maxEquipLevel )
+      return false;
+
+    if( classJob > 0 && item.classJobs.any() && ( classJob >= item.classJobs.size() || !item.classJobs[ classJob ] ) )
+      return false;
+
+    return true;
+  };
+
+  auto addResult = [ & ]( const Item& item )
+  {
+    const auto stock = std::min< size_t >( getListingCount( item.catalogId ), 0xFFFF );
+    resultList.push_back( { item.catalogId, static_cast< uint16_t >( stock ) } );
+  };
+
+  if( searchStr.empty() )
+  {
+    // category 0 lists everything
+    const std::vector< const IndexedItem* >* pItems = &m_itemsByOrder;
+    if( itemSearchCat != 0 )
+    {
+      auto category = m_categoryIndex.find( itemSearchCat );
+      if( category == m_categoryIndex.end() )
+        return resultList;
+      pItems = &category->second;
+    }
+
+    for( auto pItem : *pItems )
+    {
+      if( matches( pItem->item ) )
+        addResult( pItem->item );
+    }
+    return resultList;
+  }
+
+  for( auto pItem : findByName( Common::Util::toLowerCopy( std::string( searchStr ) ) ) )
+  {
+    if( matches( pItem->item ) )
+      addResult( pItem->item );
+  }
+
+  return resultList;
+}
+
+void MarketBoard::insertListing( MarketListing listing )
+{
+  auto& book = m_orderBooks[ listing.catalogId ];
+  book.sides[ listing.hq ? 1 : 0 ].emplace( listing.unitPrice, listing.listingId );
+
+  const auto listingId = listing.listingId;
+  m_listings.emplace( listingId, std::move( listing ) );
+}
+
+bool MarketBoard::updateListing( uint64_t listingId, uint32_t stack, uint32_t unitPrice )
+{
+  auto it = m_listings.find( listingId );
+  if( it == m_listings.end() )
+    return false;
+
+  auto& listing = it->second;
+  if( listing.unitPrice != unitPrice )
+  {
+    auto& side = m_orderBooks[ listing.catalogId ].sides[ listing.hq ? 1 : 0 ];
+    side.erase( { listing.unitPrice, listingId } );
+    side.emplace( unitPrice, listingId );
+  }
+
+  listing.stack = stack;
+  listing.unitPrice = unitPrice;
+
+  return true;
+}
+
+bool MarketBoard::eraseListing( uint64_t listingId )
+{
+  auto it = m_listings.find( listingId );
+  if( it == m_listings.end() )
+    return false;
+
+  const auto& listing = it->second;
+
+  auto book = m_orderBooks.find( listing.catalogId );
+  if( book != m_orderBooks.end() )
+  {
+    auto& sides = book->second.sides;
+    sides[ listing.hq ? 1 : 0 ].erase( { listing.unitPrice, listingId } );
+
+    if( sides[ 0 ].empty() && sides[ 1 ].empty() )
+      m_orderBooks.erase( book );
+  }
+
+  m_listings.erase( it );
+  return true;
+}
+
+const MarketListing* MarketBoard::getListing( uint64_t listingId ) const
+{
+  auto it = m_listings.find( listingId );
+  return it != m_listings.end() ? &it->second : nullptr;
+}
+
+std::vector< const MarketListing* > MarketBoard::getListings( uint32_t catalogId, size_t limit ) const
+{
+  std::vector< const MarketListing* > result;
+
+  auto book = m_orderBooks.find( catalogId );
+  if( book == m_orderBooks.end() )
+    return result;
+
+  // merge both sides, they are sorted already
+  const auto& nq = book->second.sides[ 0 ];
+  const auto& hq = book->second.sides[ 1 ];
+  auto nqIt = nq.begin();
+  auto hqIt = hq.begin();
+
+  while( result.size() < limit && ( nqIt != nq.end() || hqIt != hq.end() ) )
+  {
+    auto& it = hqIt == hq.end() || ( nqIt != nq.end() && *nqIt < *hqIt ) ? nqIt : hqIt;
+    result.push_back( &m_listings.at( it->second ) );
+    ++it;
+  }
+
+  return result;
+}
+
+size_t MarketBoard::getListingCount( uint32_t catalogId ) const
+{
+  auto book = m_orderBooks.find( catalogId );
+  if( book == m_orderBooks.end() )
+    return 0;
+
+  return book->second.sides[ 0 ].size() + book->second.sides[ 1 ].size();
+}
+
+size_t MarketBoard::getListingCount() const
+{
+  return m_listings.size();
+}
+
+uint32_t MarketBoard::makeTrigram( const char* str )
+{
+  return static_cast< uint8_t >( str[ 0 ] ) << 16 | static_cast< uint8_t >( str[ 1 ] ) << 8 | static_cast< uint8_t >( str[ 2 ] );
+}
+
+std::vector< const MarketBoard::IndexedItem* > MarketBoard::findByName( const std::string& needle ) const
+{
+  std::vector< const IndexedItem* > result;
+
+  // too short for the index, fall back to a scan
+  if( needle.size() < 3 )
+  {
+    for( auto pItem : m_itemsByOrder )
+    {
+      if( pItem->item.name.find( needle ) != std::string::npos )
+        result.push_back( pItem );
+    }
+    return result;
+  }
+
+  std::vector< const std::vector< const IndexedItem* >* > postings;
+  for( size_t pos = 0; pos + 3 <= needle.size(); ++pos )
+  {
+    auto it = m_trigramIndex.find( makeTrigram( needle.c_str() + pos ) );
+    if( it == m_trigramIndex.end() )
+      return result;
+
+    postings.push_back( &it->second );
+  }
+
+  // start from the rarest trigram and narrow down, every list is in default order
+  std::sort( postings.begin(), postings.end(), []( auto a, auto b ) { return a->size() < b->size(); } );
+  postings.erase( std::unique( postings.begin(), postings.end() ), postings.end() );
+
+  auto byOrder = []( const IndexedItem* a, const IndexedItem* b ) { return a->order < b->order; };
+
+  std::vector< const IndexedItem* > candidates = *postings.front();
+  std::vector< const IndexedItem* > narrowed;
+  for( size_t i = 1; i < postings.size() && !candidates.empty(); ++i )
+  {
+    narrowed.clear();
+    std::set_intersection( candidates.begin(), candidates.end(), postings[ i ]->begin(), postings[ i ]->end(),
+                           std::back_inserter( narrowed ), byOrder );
+    candidates.swap( narrowed );
+  }
+
+  // trigrams can match out of sequence, confirm the actual substring
+  for( auto pItem : candidates )
+  {
+    if( pItem->item.name.find( needle ) != std::string::npos )
+      result.push_back( pItem );
+  }
+
+  return result;
+}
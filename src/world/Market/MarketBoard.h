@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Sapphire::World
+{
+  struct MarketListing
+  {
+    uint64_t listingId{ 0 };
+    uint32_t catalogId{ 0 };
+    uint64_t sellerCharacterId{ 0 };
+    uint64_t retainerId{ 0 };
+    std::string retainerName;
+    uint64_t itemId{ 0 };
+    uint32_t stack{ 1 };
+    uint32_t unitPrice{ 0 };
+    bool hq{ false };
+    uint8_t stain{ 0 };
+    uint32_t listDate{ 0 };
+  };
+
+  struct MarketSale
+  {
+    uint32_t catalogId{ 0 };
+    uint32_t unitPrice{ 0 };
+    uint32_t stack{ 0 };
+    bool hq{ false };
+    std::string buyerName;
+    uint32_t saleDate{ 0 };
+  };
+
+  /*!
+   * In memory part of the market board.
+   *
+   * Marketable items are indexed by search category and name trigrams, every item with listings has an
+   * order book with separate nq / hq sides sorted by unit price.
+   * Nothing here touches the database or the network, MarketMgr writes changes behind and answers the client.
+   */
+  class MarketBoard
+  {
+  public:
+    struct Item
+    {
+      uint32_t catalogId{ 0 };
+      uint8_t itemSearchCategory{ 0 };
+      uint8_t maxEquipLevel{ 0 };
+      uint16_t itemLevel{ 0 };
+      // class jobs that can equip or use the item, empty if anyone can
+      std::bitset< 64 > classJobs;
+      // lower case, searched by trigram
+      std::string name;
+    };
+
+    struct SearchResult
+    {
+      uint32_t catalogId;
+      uint16_t quantity;
+    };
+
+    /*!
+     * @brief Replaces the marketable items and rebuilds the search indexes
+     * @param items every item that can be listed, the name lower case
+     */
+    void setItems( std::vector< Item > items );
+
+    size_t getItemCount() const;
+
+    size_t getTrigramCount() const;
+
+    bool isMarketable( uint32_t catalogId ) const;
+
+    // items passing the filters, highest item level first, with the number of listings of each
+    std::vector< SearchResult > findItems( std::string_view searchStr, uint8_t itemSearchCat, uint8_t maxEquipLevel,
+                                           uint8_t classJob ) const;
+
+    void insertListing( MarketListing listing );
+
+    bool updateListing( uint64_t listingId, uint32_t stack, uint32_t unitPrice );
+
+    bool eraseListing( uint64_t listingId );
+
+    const MarketListing* getListing( uint64_t listingId ) const;
+
+    // cheapest first, nq and hq merged
+    std::vector< const MarketListing* > getListings( uint32_t catalogId, size_t limit ) const;
+
+    size_t getListingCount( uint32_t catalogId ) const;
+
+    size_t getListingCount() const;
+
+  private:
+    struct IndexedItem
+    {
+      Item item;
+      // position in the default result order ( item level, highest first )
+      uint32_t order;
+    };
+
+    // ( unit price, listing id )
+    using PriceKey = std::pair< uint32_t, uint64_t >;
+
+    struct OrderBook
+    {
+      // indexed by hq
+      std::array< std::set< PriceKey >, 2 > sides;
+    };
+
+    std::unordered_map< uint32_t, IndexedItem > m_items;
+    std::unordered_map< uint8_t, std::vector< const IndexedItem* > > m_categoryIndex;
+    std::unordered_map< uint32_t, std::vector< const IndexedItem* > > m_trigramIndex;
+    std::vector< const IndexedItem* > m_itemsByOrder;
+
+    std::unordered_map< uint32_t, OrderBook > m_orderBooks;
+    std::unordered_map< uint64_t, MarketListing > m_listings;
+
+    static uint32_t makeTrigram( const char* str );
+
+    // items whose name contains the given lower case string, in default order
+    std::vector< const IndexedItem* > findByName( const std::string& needle ) const;
+  };
+
+}
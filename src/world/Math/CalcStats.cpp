@@ -1,4 +1,5 @@
 #include <cmath>
+#include <vector>
 
 #include <Exd/ExdData.h>
 #include <Common.h>
@@ -85,8 +86,6 @@ const int levelTable[61][6] =
   { 218, 354, 858, 2600, 282, 215 },
 };
 
-std::unique_ptr< Sapphire::Common::Random::RandGenerator< float > > CalcStats::rnd = nullptr;
-
 /*
    Class used for battle-related formulas and calculations.
    Big thanks to the Theoryjerks group!
@@ -103,6 +102,64 @@ std::unique_ptr< Sapphire::Common::Random::RandGenerator< float > > CalcStats::r
    Reduce repeated code (more specifically the data we pull from exd)
 */
 
+std::array< CalcStats::JobParams, 256 > CalcStats::m_jobParams{};
+std::array< CalcStats::LevelParams, 256 > CalcStats::m_levelParams{};
+
+bool CalcStats::init()
+{
+  auto& exdData = Common::Service< Data::ExdData >::ref();
+
+  m_jobParams = {};
+  m_levelParams = {};
+
+  for( const auto& [ id, classJob ] : exdData.getRows< Excel::ClassJob >() )
+  {
+    if( id >= m_jobParams.size() )
+      continue;
+
+    const auto& data = classJob->data();
+    auto& entry = m_jobParams[ id ];
+    entry.hp = data.Hp;
+    entry.mp = data.Mp;
+    entry.statMod = { 100, data.STR, data.DEX, data.VIT, data.INT_, data.MND, data.PIE };
+    entry.valid = true;
+  }
+
+  size_t levelCount = 0;
+  for( const auto& [ id, paramGrow ] : exdData.getRows< Excel::ParamGrow >() )
+  {
+    if( id >= m_levelParams.size() )
+      continue;
+
+    const auto& data = paramGrow->data();
+    auto& entry = m_levelParams[ id ];
+    entry.paramBase = data.ParamBase;
+    entry.mp = data.Mp;
+    entry.valid = true;
+    ++levelCount;
+  }
+
+  if( levelCount == 0 )
+  {
+    Logger::error( "CalcStats: no ParamGrow rows found" );
+    return false;
+  }
+
+  return true;
+}
+
+const CalcStats::JobParams* CalcStats::getJobParams( const Chara& chara )
+{
+  const auto& entry = m_jobParams[ static_cast< uint8_t >( chara.getClass() ) ];
+  return entry.valid ? &entry : nullptr;
+}
+
+const CalcStats::LevelParams* CalcStats::getLevelParams( uint8_t level )
+{
+  const auto& entry = m_levelParams[ level ];
+  return entry.valid ? &entry : nullptr;
+}
+
 // 3 Versions. SB and HW are linear, ARR is polynomial.
 // Originally from Player.cpp, calculateStats().
 
@@ -122,13 +179,12 @@ float CalcStats::calculateBaseStat( const Chara& chara )
 
 uint32_t CalcStats::calculateMaxHp( Entity::Player& player )
 {
-  auto& exdData = Common::Service< Data::ExdData >::ref();
   // TODO: Replace ApproxBaseHP with something that can get us an accurate BaseHP.
   // Is there any way to pull reliable BaseHP without having to manually use a pet for every level, and using the values from a table?
   // More info here: https://docs.google.com/spreadsheets/d/1de06KGT0cNRUvyiXNmjNgcNvzBCCQku7jte5QxEQRbs/edit?usp=sharing
 
-  auto classInfo = exdData.getRow< Excel::ClassJob >( static_cast< uint8_t >( player.getClass() ) );
-  auto paramGrowthInfo = exdData.getRow< Excel::ParamGrow >( player.getLevel() );
+  auto classInfo = getJobParams( player );
+  auto paramGrowthInfo = getLevelParams( player.getLevel() );
 
   if( !classInfo || !paramGrowthInfo )
     return 0;
@@ -139,8 +195,8 @@ uint32_t CalcStats::calculateMaxHp( Entity::Player& player )
   float baseStat = calculateBaseStat( player );
   auto baseParamVit = player.getStatValue( Common::BaseParam::Vitality );
   auto vitStat = player.getStatValue( Common::BaseParam::Vitality ) + vitMod;
-  uint16_t hpMod = paramGrowthInfo->data().ParamBase;
-  uint16_t jobModHp = classInfo->data().Hp;
+  uint16_t hpMod = paramGrowthInfo->paramBase;
+  uint16_t jobModHp = classInfo->hp;
   float approxBaseHp = 0.0f; // Read above
   float hpModPercent = player.getModifier( Common::ParamModifier::HPPercent );
 
@@ -156,13 +212,12 @@ uint32_t CalcStats::calculateMaxHp( Entity::Player& player )
 
 uint32_t CalcStats::calculateMaxHp( Chara& chara )
 {
-  auto& exdData = Common::Service< Data::ExdData >::ref();
   // TODO: Replace ApproxBaseHP with something that can get us an accurate BaseHP.
   // Is there any way to pull reliable BaseHP without having to manually use a pet for every level, and using the values from a table?
   // More info here: https://docs.google.com/spreadsheets/d/1de06KGT0cNRUvyiXNmjNgcNvzBCCQku7jte5QxEQRbs/edit?usp=sharing
 
-  auto classInfo = exdData.getRow< Excel::ClassJob >( static_cast< uint8_t >( chara.getClass() ) );
-  auto paramGrowthInfo = exdData.getRow< Excel::ParamGrow >( chara.getLevel() );
+  auto classInfo = getJobParams( chara );
+  auto paramGrowthInfo = getLevelParams( chara.getLevel() );
 
   if( !classInfo || !paramGrowthInfo )
     return 0;
@@ -172,8 +227,8 @@ uint32_t CalcStats::calculateMaxHp( Chara& chara )
   auto vitMod = chara.getBonusStat( Common::BaseParam::Vitality );
   float baseStat = calculateBaseStat( chara );
   uint16_t vitStat = static_cast< uint16_t >( chara.getStatValue( Common::BaseParam::Vitality ) ) + static_cast< uint16_t >( vitMod );
-  uint16_t hpMod = paramGrowthInfo->data().ParamBase;
-  uint16_t jobModHp = classInfo->data().Hp;
+  uint16_t hpMod = paramGrowthInfo->paramBase;
+  uint16_t jobModHp = classInfo->hp;
   float approxBaseHp = 0.0f; // Read above
 
   approxBaseHp = static_cast< float >( levelTable[ level ][ Common::LevelTableEntry::HP ] );
@@ -186,19 +241,17 @@ uint32_t CalcStats::calculateMaxHp( Chara& chara )
 
 uint32_t CalcStats::calculateMaxMp( Entity::Player& player )
 {
-  auto& exdData = Common::Service< Data::ExdData >::ref();
-
-  auto classInfo = exdData.getRow< Excel::ClassJob >( static_cast< uint8_t >( player.getClass() ) );
-  auto paramGrowthInfo = exdData.getRow< Excel::ParamGrow >( player.getLevel() );
+  auto classInfo = getJobParams( player );
+  auto paramGrowthInfo = getLevelParams( player.getLevel() );
 
   if( !classInfo || !paramGrowthInfo )
     return 0;
 
   float baseStat = calculateBaseStat( player );
   uint16_t piety = player.getStats()[ static_cast< uint32_t >( Common::BaseParam::Piety ) ];
-  uint16_t pietyScalar = paramGrowthInfo->data().ParamBase;
-  uint16_t jobModMp = classInfo->data().Mp;
-  uint16_t baseMp = paramGrowthInfo->data().Mp;
+  uint16_t pietyScalar = paramGrowthInfo->paramBase;
+  uint16_t jobModMp = classInfo->mp;
+  uint16_t baseMp = paramGrowthInfo->mp;
 
   uint16_t result = static_cast< uint16_t >( std::floor( floor( piety - baseStat ) * ( pietyScalar / 100 ) + baseMp ) *
                                              jobModMp / 100 );
@@ -208,12 +261,11 @@ uint32_t CalcStats::calculateMaxMp( Entity::Player& player )
 
 uint16_t CalcStats::calculateMpCost( const Sapphire::Entity::Chara& chara, uint16_t baseCost )
 {
-  auto& exdData = Common::Service< Data::ExdData >::ref();
-  auto paramGrowthInfo = exdData.getRow< Excel::ParamGrow >( chara.getLevel() );
+  auto paramGrowthInfo = getLevelParams( chara.getLevel() );
   if( !paramGrowthInfo )
     return 0;
 
-  uint16_t mpMod = paramGrowthInfo->data().Mp;
+  uint16_t mpMod = paramGrowthInfo->mp;
   return baseCost * mpMod / 100;
 }
 
@@ -272,52 +324,12 @@ float CalcStats::weaponDamage( const Sapphire::Entity::Chara& chara, Common::Bas
 
   auto mainVal = static_cast< float >( levelTable[ level ][ Common::LevelTableEntry::MAIN ] );
 
-  uint32_t jobMod = 1;
-
-  auto& exdData = Common::Service< Data::ExdData >::ref();
-  auto classInfo = exdData.getRow< Excel::ClassJob >( static_cast< uint8_t >( chara.getClass() ) );
-
+  auto classInfo = getJobParams( chara );
   if( !classInfo )
     return 0.f;
 
-  switch( calcStat )
-  {
-    case Common::BaseParam::Intelligence:
-    {
-      jobMod = classInfo->data().INT_;
-      break;
-    }
-    case Common::BaseParam::Mind:
-    {
-      jobMod = classInfo->data().MND;
-      break;
-    }
-    case Common::BaseParam::Strength:
-    {
-      jobMod = classInfo->data().STR;
-      break;
-    }
-    case Common::BaseParam::Dexterity:
-    {
-      jobMod = classInfo->data().DEX;
-      break;
-    }
-    case Common::BaseParam::Vitality:
-    {
-      jobMod = classInfo->data().VIT;
-      break;
-    }
-    case Common::BaseParam::Piety:
-    {
-      jobMod = classInfo->data().PIE;
-      break;
-    }
-    default:
-    {
-      jobMod = 100;
-      break;
-    }
-  }
+  auto statIndex = static_cast< uint8_t >( calcStat );
+  uint32_t jobMod = statIndex < classInfo->statMod.size() ? classInfo->statMod[ statIndex ] : classInfo->statMod[ 0 ];
 
   return ( std::floor( mainVal * jobMod / 1000.f ) + weaponDamage );
 }
@@ -493,7 +505,38 @@ float CalcStats::healingMagicPotency( const Sapphire::Entity::Chara& chara )
   return std::floor( 100.f * ( chara.getStatValue( Common::BaseParam::HealingMagicPotency ) - 292.f ) / 264.f + 100.f ) / 100.f;
 }
 
-std::pair< float, Sapphire::Common::CalcResultType > CalcStats::calcAutoAttackDamage( const Sapphire::Entity::Chara& chara, Common::BaseParam calcStat, float wepDmg )
+void CalcStats::rollDamage( const Sapphire::Entity::Chara& chara, float baseDamage, float damageMod, DamageResult* pResults, size_t count )
+{
+  // two rolls per target, critical hit and variance
+  thread_local std::vector< float > rolls;
+  rolls.resize( count * 2 );
+
+  auto& RNGMgr = Common::Service< Common::Random::RNGMgr >::ref();
+  RNGMgr.fill( rolls.data(), rolls.size(), 0.f, 100.f );
+
+  auto critProbability = criticalHitProbability( chara );
+  auto critBonus = criticalHitBonus( chara );
+
+  for( size_t i = 0; i < count; ++i )
+  {
+    auto factor = baseDamage;
+    auto hitType = Sapphire::Common::CalcResultType::TypeDamageHp;
+
+    if( critProbability > rolls[ i * 2 ] )
+    {
+      factor *= critBonus;
+      hitType = Sapphire::Common::CalcResultType::TypeCriticalDamageHp;
+    }
+
+    factor *= 1.0f + ( ( rolls[ i * 2 + 1 ] - 50.0f ) / 1000.0f );
+
+    // todo: buffs
+
+    pResults[ i ] = { factor * damageMod, hitType };
+  }
+}
+
+CalcStats::DamageResult CalcStats::calcAutoAttackDamage( const Sapphire::Entity::Chara& chara, Common::BaseParam calcStat, float wepDmg )
 {
   // D = ⌊ f(ptc) × f(aa) × f(ap) × f(det) × f(tnc) × traits ⌋ × f(ss) ⌋ ×
   // f(chr) ⌋ × f(dhr) ⌋ × rand[ 0.95, 1.05 ] ⌋ × buff_1 ⌋ × buff... ⌋
@@ -508,39 +551,42 @@ std::pair< float, Sapphire::Common::CalcResultType > CalcStats::calcAutoAttackDa
   // todo: everything after tenacity
   auto factor = std::floor( std::floor( pot * ap * det ) / 1000 );
   factor = std::floor( std::floor( std::floor( std::floor( factor * spd ) / 1000 ) * aa ) / 100 );
-  Sapphire::Common::CalcResultType hitType = Sapphire::Common::CalcResultType::TypeDamageHp;
 
   // todo: traits
 
-  if( criticalHitProbability( chara ) > getRandomNumber0To100() )
-  {
-    factor *= criticalHitBonus( chara );
-    hitType = Sapphire::Common::CalcResultType::TypeCriticalDamageHp;
-  }
-
-  factor *= 1.0f + ( ( getRandomNumber0To100() - 50.0f ) / 1000.0f );
-
-  // todo: buffs
+  DamageResult result;
+  rollDamage( chara, factor, 1.f, &result, 1 );
 
   constexpr auto format = "auto attack: pot: {} aa: {} ap: {} det: {} ten: {} = {}";
 
   if( auto player = const_cast< Entity::Chara& >( chara ).getAsPlayer() )
   {
-    PlayerMgr::sendDebug( *player, format, pot, aa, ap, det, 1, factor );
+    PlayerMgr::sendDebug( *player, format, pot, aa, ap, det, 1, result.first );
   }
   else
   {
-  //  Logger::debug( format, pot, aa, ap, det, ten, factor );
+  //  Logger::debug( format, pot, aa, ap, det, ten, result.first );
   }
 
-  return std::pair( factor, hitType );
+  return result;
 }
 
-std::pair< float, Sapphire::Common::CalcResultType > CalcStats::calcActionDamage( const Sapphire::Entity::Chara& chara, uint32_t ptc, Common::BaseParam calcStat, float wepDmg )
+CalcStats::DamageResult CalcStats::calcActionDamage( const Sapphire::Entity::Chara& chara, uint32_t ptc, Common::BaseParam calcStat, float wepDmg )
+{
+  DamageResult result;
+  calcActionDamage( chara, ptc, calcStat, wepDmg, &result, 1 );
+  return result;
+}
+
+void CalcStats::calcActionDamage( const Sapphire::Entity::Chara& chara, uint32_t ptc, Common::BaseParam calcStat, float wepDmg,
+                                  DamageResult* pResults, size_t count )
 {
   // D = ⌊ f(pot) × f(wd) × f(ap) × f(det) × f(tnc) × traits ⌋
   // × f(chr) ⌋ × f(dhr) ⌋ × rand[ 0.95, 1.05 ] ⌋ buff_1 ⌋ × buff_1 ⌋ × buff... ⌋
 
+  if( count == 0 )
+    return;
+
   auto pot = potency( static_cast< uint16_t >( ptc ) );
   auto ap = getPrimaryPower( chara, calcStat );
   auto det = determination( chara );
@@ -549,33 +595,20 @@ std::pair< float, Sapphire::Common::CalcResultType > CalcStats::calcActionDamage
 
   auto factor = std::floor( std::floor( pot * ap * det ) / 1000 );
   factor = std::floor( std::floor( factor * wd ) / 100 ); // todo: add traits
-  Sapphire::Common::CalcResultType hitType = Sapphire::Common::CalcResultType::TypeDamageHp;
 
-  if( criticalHitProbability( chara ) > getRandomNumber0To100() )
-  {
-    factor *= criticalHitBonus( chara );
-    hitType = Sapphire::Common::CalcResultType::TypeCriticalDamageHp;
-  }
-
-  factor *= 1.0f + ( ( getRandomNumber0To100() - 50.0f ) / 1000.0f );
-
-  // todo: buffs
-
-  factor *= damageDealtMod;
+  rollDamage( chara, factor, damageDealtMod, pResults, count );
 
   constexpr auto format = "dmg: pot: {} ({}) wd: {} ({}) ap: {} det: {}  = {}";
 
   if( auto player = const_cast< Entity::Chara& >( chara ).getAsPlayer() )
   {
-    PlayerMgr::sendDebug( *player, format, pot, ptc, wd, wepDmg, ap, det, factor );
+    PlayerMgr::sendDebug( *player, format, pot, ptc, wd, wepDmg, ap, det, pResults[ 0 ].first );
     PlayerMgr::sendDebug( *player, "DamageDealtPercent: {}", damageDealtMod );
   }
   else
   {
-  //  Logger::debug( format, pot, ptc, wd, wepDmg, ap, det, factor );
+  //  Logger::debug( format, pot, ptc, wd, wepDmg, ap, det, pResults[ 0 ].first );
   }
-
-  return std::pair( factor, hitType );
 }
 
 std::pair< float, Sapphire::Common::CalcResultType > CalcStats::calcActionHealing( const Sapphire::Entity::Chara& chara, uint32_t ptc, float wepDmg )
@@ -615,9 +648,7 @@ int32_t CalcStats::calcStatusAggro( const Sapphire::Entity::Chara& source )
 
 uint32_t CalcStats::calcMpRefresh(uint32_t potency, uint8_t level)
 {
-  auto& exdData = Common::Service< Data::ExdData >::ref();
-
-  auto paramGrowthInfo = exdData.getRow< Excel::ParamGrow >( level );
+  auto paramGrowthInfo = getLevelParams( level );
 
   if (!paramGrowthInfo)
   {
@@ -626,7 +657,7 @@ uint32_t CalcStats::calcMpRefresh(uint32_t potency, uint8_t level)
     return std::floor( potency * 0.884f );
   }
 
-  uint32_t mpMod = paramGrowthInfo->data().Mp;
+  uint32_t mpMod = paramGrowthInfo->mp;
   return std::floor( potency * mpMod / 1000 );
 }
 
@@ -637,9 +668,6 @@ uint32_t CalcStats::primaryStatValue( const Sapphire::Entity::Chara& chara )
 
 float CalcStats::getRandomNumber0To100()
 {
-  if( !rnd )
-  {
-    rnd = std::make_unique< Common::Random::RandGenerator< float > >( Common::Service< Common::Random::RNGMgr >::ref().getRandGenerator< float >( 0, 100 ) );
-  }
-  return rnd->next();
+  auto& RNGMgr = Common::Service< Common::Random::RNGMgr >::ref();
+  return Common::Random::RNGMgr::sample( RNGMgr.getRNGEngine(), 0.f, 100.f );
 }
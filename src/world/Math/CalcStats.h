@@ -4,6 +4,8 @@
 #include "Forwards.h"
 #include <Random/RNGMgr.h>
 
+#include <array>
+
 namespace Sapphire::Math
 {
   using namespace Sapphire::World::Manager;
@@ -14,6 +16,15 @@ namespace Sapphire::Math
     static const uint32_t AUTO_ATTACK_POTENCY = 110;
     static const uint32_t RANGED_AUTO_ATTACK_POTENCY = 100;
 
+    using DamageResult = std::pair< float, Common::CalcResultType >;
+
+    /*!
+     * @brief Flattens the ClassJob and ParamGrow rows the formulas need into lookup tables
+     *
+     * Has to be called once after the exd data is loaded, the formulas never touch the exd data afterwards.
+     */
+    static bool init();
+
     static float calculateBaseStat( const Entity::Chara& chara );
 
     static uint32_t calculateMaxHp( Sapphire::Entity::Player& player );
@@ -136,9 +147,19 @@ namespace Sapphire::Math
 
     ////////////////////////////////////////////
 
-    static std::pair< float, Common::CalcResultType > calcAutoAttackDamage( const Sapphire::Entity::Chara& chara, Common::BaseParam calcStat, float wepDmg );
+    static DamageResult calcAutoAttackDamage( const Sapphire::Entity::Chara& chara, Common::BaseParam calcStat, float wepDmg );
+
+    static DamageResult calcActionDamage( const Sapphire::Entity::Chara& chara, uint32_t ptc, Common::BaseParam calcStat, float wepDmg );
 
-    static std::pair< float, Common::CalcResultType > calcActionDamage( const Sapphire::Entity::Chara& chara, uint32_t ptc, Common::BaseParam calcStat, float wepDmg );
+    /*!
+     * @brief Rolls the damage of one action against count targets
+     *
+     * The source dependent part of the formula is computed once, only the critical hit and variance rolls are done per target.
+     *
+     * @param pResults Receives one result per target
+     */
+    static void calcActionDamage( const Sapphire::Entity::Chara& chara, uint32_t ptc, Common::BaseParam calcStat, float wepDmg,
+                                  DamageResult* pResults, size_t count );
 
     static std::pair< float, Common::CalcResultType > calcActionHealing( const Sapphire::Entity::Chara& chara, uint32_t ptc, float wepDmg );
 
@@ -162,6 +183,36 @@ namespace Sapphire::Math
 
     static uint32_t primaryStatValue( const Sapphire::Entity::Chara& chara );
   private:
+    // ClassJob values of one class job
+    struct JobParams
+    {
+      uint16_t hp;
+      uint16_t mp;
+      // weapon damage modifier indexed by primary stat ( Strength to Piety ), 0 is the default of 100
+      std::array< uint16_t, 7 > statMod;
+      bool valid;
+    };
+
+    // ParamGrow values of one level
+    struct LevelParams
+    {
+      uint16_t paramBase;
+      uint16_t mp;
+      bool valid;
+    };
+
+    // indexed by class job id and level, both are uint8_t so any value is in range
+    static std::array< JobParams, 256 > m_jobParams;
+    static std::array< LevelParams, 256 > m_levelParams;
+
+    static const JobParams* getJobParams( const Sapphire::Entity::Chara& chara );
+
+    static const LevelParams* getLevelParams( uint8_t level );
+
+    /*!
+     * @brief Applies the critical hit and variance rolls to an already computed base damage
+     */
+    static void rollDamage( const Sapphire::Entity::Chara& chara, float baseDamage, float damageMod, DamageResult* pResults, size_t count );
 
     /*!
      * @brief Has the main attack power calculation allowing for de-duplication of functions.
@@ -171,7 +222,6 @@ namespace Sapphire::Math
     static float calcAttackPower( const Sapphire::Entity::Chara& chara, uint32_t attackPower );
 
     static float getRandomNumber0To100();
-    static std::unique_ptr< Common::Random::RandGenerator< float > > rnd;
   };
 
 }
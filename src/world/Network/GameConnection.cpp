@@ -4,6 +4,8 @@
 #include <Logging/Logger.h>
 #include <utility>
 #include <charconv>
+#include <chrono>
+#include <algorithm>
 
 #include <Network/Acceptor.h>
 #include <Network/PacketContainer.h>
@@ -27,148 +29,162 @@ using namespace Sapphire::Network::Packets::WorldPackets;
 using namespace Sapphire::Network::Packets::WorldPackets::Client;
 using namespace Sapphire::Network::Packets::WorldPackets::Server;
 
+namespace
+{
+  // dispatch counters indexed by dispatch table slot, shared by all connections
+  OpcodeStatsTable zoneOpcodeStats;
+  OpcodeStatsTable chatOpcodeStats;
+}
+
 GameConnection::GameConnection( Sapphire::Network::HivePtr pHive, Sapphire::Network::AcceptorPtr pAcceptor ) :
   Connection( std::move( pHive ) ),
   m_pAcceptor( std::move( pAcceptor ) ),
   m_conType( ConnectionType::None )
 {
-  auto setZoneHandler = [ = ]( uint16_t opcode, std::string handlerName, GameConnection::Handler pHandler )
-  {
-    m_zoneHandlerMap[ opcode ] = pHandler;
-    m_zoneHandlerStrMap[ opcode ] = std::move( handlerName );
-  };
+}
 
-  auto setChatHandler = [ = ]( uint16_t opcode, std::string handlerName, GameConnection::Handler pHandler )
+const GameConnection::DispatchTable& GameConnection::zoneDispatchTable()
+{
+  static constexpr DispatchTable::Entry handlers[] =
   {
-    m_chatHandlerMap[ opcode ] = pHandler;
-    m_chatHandlerStrMap[ opcode ] = std::move( handlerName );
-  };
+    { Sync, "syncHandler", &GameConnection::syncHandler },
+    { ClientZoneIpcType::Login, "loginHandler", &GameConnection::loginHandler },
+    { ChatHandler, "ChatHandler", &GameConnection::chatHandler },
+    { JoinChatChannel, "JoinChatChannel", &GameConnection::joinChatChannelHandler },
+
+    { SetLanguage, "SetLanguage", &GameConnection::setLanguageHandler },
 
-  setZoneHandler( Sync, "syncHandler", &GameConnection::syncHandler );
-  setZoneHandler( ClientZoneIpcType::Login, "loginHandler", &GameConnection::loginHandler );
-  setZoneHandler( ChatHandler, "ChatHandler", &GameConnection::chatHandler );
-  setZoneHandler( JoinChatChannel, "JoinChatChannel", &GameConnection::joinChatChannelHandler );
+    { StartLogoutCountdown, "StartLogoutCountdown", &GameConnection::logoutHandler },
 
-  setZoneHandler( SetLanguage, "SetLanguage", &GameConnection::setLanguageHandler );
+    { SetProfile, "SetProfile", &GameConnection::setProfileHandler },
+    { GetProfile, "GetProfile", &GameConnection::getProfileHandler },
+    { GetSearchComment, "GetSearchComment", &GameConnection::getSearchCommentHandler },
+    { PcSearch, "PcSearch", &GameConnection::pcSearchHandler },
 
-  setZoneHandler( StartLogoutCountdown, "StartLogoutCountdown", &GameConnection::logoutHandler );
+    { GetCommonlist, "GetCommonlist", &GameConnection::getCommonlistHandler },
+    { GetCommonlistDetail, "GetCommonlistDetail", &GameConnection::getCommonlistDetailHandler },
 
-  setZoneHandler( SetProfile, "SetProfile", &GameConnection::setProfileHandler );
-  setZoneHandler( GetProfile, "GetProfile", &GameConnection::getProfileHandler );
-  setZoneHandler( GetSearchComment, "GetSearchComment", &GameConnection::getSearchCommentHandler );
-  setZoneHandler( PcSearch, "PcSearch", &GameConnection::pcSearchHandler );
+    { GetLinkshellList, "GetLinkshellList", &GameConnection::linkshellListHandler },
+    { LinkshellJoin, "LinkshellJoin", &GameConnection::linkshellJoinHandler },
+    { LinkshellKick, "LinkshellKick", &GameConnection::linkshellKickHandler },
+    { LinkshellLeave, "LinkshellLeave", &GameConnection::linkshellLeaveHandler },
+    { LinkshellChangeMaster, "LinkshellChangeMaster", &GameConnection::linkshellChangeMasterHandler },
+    { LinkshellJoinOfficial, "LinkshellJoinOfficial", &GameConnection::linkshellJoinOfficialHandler },
+    { LinkshellAddLeader, "LinkshellAddLeader", &GameConnection::linkshellAddLeaderHandler },
+    { LinkshellRemoveLeader, "LinkshellRemoveLeader", &GameConnection::linkshellRemoveLeaderHandler },
+    { LinkshellDeclineLeader, "LinkshellDeclineLeader", &GameConnection::linkshellDeclineLeaderHandler },
 
-  setZoneHandler( GetCommonlist, "GetCommonlist", &GameConnection::getCommonlistHandler );
-  setZoneHandler( GetCommonlistDetail, "GetCommonlistDetail", &GameConnection::getCommonlistDetailHandler );
+    { ReqExamineFcInfo, "ReqExamineFcInfo", &GameConnection::reqExamineFcInfo },
+    { ZoneJump, "ZoneJump", &GameConnection::zoneJumpHandler },
+    { Command, "Command", &GameConnection::commandHandler },
 
-  setZoneHandler( GetLinkshellList, "GetLinkshellList", &GameConnection::linkshellListHandler );
-  setZoneHandler( LinkshellJoin, "LinkshellJoin", &GameConnection::linkshellJoinHandler );
-  setZoneHandler( LinkshellKick, "LinkshellKick", &GameConnection::linkshellKickHandler );
-  setZoneHandler( LinkshellLeave, "LinkshellLeave", &GameConnection::linkshellLeaveHandler );
-  setZoneHandler( LinkshellChangeMaster, "LinkshellChangeMaster", &GameConnection::linkshellChangeMasterHandler );
-  setZoneHandler( LinkshellJoinOfficial, "LinkshellJoinOfficial", &GameConnection::linkshellJoinOfficialHandler );
-  setZoneHandler( LinkshellAddLeader, "LinkshellAddLeader", &GameConnection::linkshellAddLeaderHandler );
-  setZoneHandler( LinkshellRemoveLeader, "LinkshellRemoveLeader", &GameConnection::linkshellRemoveLeaderHandler );
-  setZoneHandler( LinkshellDeclineLeader, "LinkshellDeclineLeader", &GameConnection::linkshellDeclineLeaderHandler );
+    { NewDiscovery, "NewDiscovery", &GameConnection::newDiscoveryHandler },
 
-  setZoneHandler( ReqExamineFcInfo, "ReqExamineFcInfo", &GameConnection::reqExamineFcInfo );
-  setZoneHandler( ZoneJump, "ZoneJump", &GameConnection::zoneJumpHandler );
-  setZoneHandler( Command, "Command", &GameConnection::commandHandler );
+    { ActionRequest, "ActionRequest", &GameConnection::actionRequest },
+    { SelectGroundActionRequest, "SelectGroundActionRequest", &GameConnection::selectGroundActionRequest },
 
-  setZoneHandler( NewDiscovery, "NewDiscovery", &GameConnection::newDiscoveryHandler );
+    { GMCommand, "GMCommand", &GameConnection::gmCommandHandler },
+    { GMCommandName, "GMCommandName", &GameConnection::gmCommandNameHandler },
 
-  setZoneHandler( ActionRequest, "ActionRequest", &GameConnection::actionRequest );
-  setZoneHandler( SelectGroundActionRequest, "SelectGroundActionRequest", &GameConnection::selectGroundActionRequest );
+    { Move, "Move", &GameConnection::moveHandler },
 
-  setZoneHandler( GMCommand, "GMCommand", &GameConnection::gmCommandHandler );
-  setZoneHandler( GMCommandName, "GMCommandName", &GameConnection::gmCommandNameHandler );
+    { ClientItemOperation, "ItemOperation", &GameConnection::itemOperation },
 
-  setZoneHandler( Move, "Move", &GameConnection::moveHandler );
+    { BuildPresetHandler, "BuildPresetHandler", &GameConnection::buildPresetHandler },
+    { ClientZoneIpcType::HousingHouseName, "HousingHouseName", &GameConnection::landRenameHandler },
+    { ClientZoneIpcType::HousingGreeting, "HousingUpdateHouseGreeting", &GameConnection::housingUpdateGreetingHandler },
+    { HousingPlaceYardItem, "HousingPlaceYardItem", &GameConnection::reqPlaceHousingItem },
+    { HousingChangeLayout, "HousingChangeLayout", &GameConnection::reqMoveHousingItem },
 
-  setZoneHandler( ClientItemOperation, "ItemOperation", &GameConnection::itemOperation );
+    { StartTalkEvent, "StartTalkEvent", &GameConnection::eventHandlerTalk },
+    { StartEmoteEvent, "StartEmoteEvent", &GameConnection::eventHandlerEmote },
+    { StartWithinRangeEvent, "StartWithinRangeEvent", &GameConnection::eventHandlerWithinRange },
+    { StartOutsideRangeEvent, "StartOutsideRangeEvent", &GameConnection::eventHandlerOutsideRange },
+    { StartEnterTerritoryEvent, "StartEnterTerritoryEvent", &GameConnection::eventHandlerEnterTerritory },
 
-  setZoneHandler( BuildPresetHandler, "BuildPresetHandler", &GameConnection::buildPresetHandler );
-  setZoneHandler( ClientZoneIpcType::HousingHouseName, "HousingHouseName", &GameConnection::landRenameHandler );
-  setZoneHandler( ClientZoneIpcType::HousingGreeting, "HousingUpdateHouseGreeting", &GameConnection::housingUpdateGreetingHandler );
-  setZoneHandler( HousingPlaceYardItem, "HousingPlaceYardItem", &GameConnection::reqPlaceHousingItem );
-  setZoneHandler( HousingChangeLayout, "HousingChangeLayout", &GameConnection::reqMoveHousingItem );
+    { ReturnEventSceneHeader, "ReturnEventSceneHeader", &GameConnection::returnEventSceneHeader },
+    { ReturnEventScene2, "ReturnEventScene2", &GameConnection::returnEventScene2 },
+    { ReturnEventScene4, "ReturnEventScene4", &GameConnection::returnEventScene4 },
+    { ReturnEventScene8, "ReturnEventScene8", &GameConnection::returnEventScene8 },
+    { ReturnEventScene16, "ReturnEventScene16", &GameConnection::returnEventScene16 },
+    { ReturnEventScene32, "ReturnEventScene32", &GameConnection::returnEventScene32 },
+    { ReturnEventScene64, "ReturnEventScene64", &GameConnection::returnEventScene64 },
+    { ReturnEventScene128, "ReturnEventScene128", &GameConnection::returnEventScene128 },
+    { ReturnEventScene255, "ReturnEventScene255", &GameConnection::returnEventScene255 },
 
-  setZoneHandler( StartTalkEvent, "StartTalkEvent", &GameConnection::eventHandlerTalk );
-  setZoneHandler( StartEmoteEvent, "StartEmoteEvent", &GameConnection::eventHandlerEmote );
-  setZoneHandler( StartWithinRangeEvent, "StartWithinRangeEvent", &GameConnection::eventHandlerWithinRange );
-  setZoneHandler( StartOutsideRangeEvent, "StartOutsideRangeEvent", &GameConnection::eventHandlerOutsideRange );
-  setZoneHandler( StartEnterTerritoryEvent, "StartEnterTerritoryEvent", &GameConnection::eventHandlerEnterTerritory );
+    { YieldEventSceneHeader, "YieldEventSceneHeader", &GameConnection::yieldEventSceneHeader },
+    { YieldEventScene2, "YieldEventScene2", &GameConnection::yieldEventScene2 },
+    { YieldEventScene4, "YieldEventScene4", &GameConnection::yieldEventScene4 },
+    { YieldEventScene8, "YieldEventScene8", &GameConnection::yieldEventScene8 },
+    { YieldEventScene16, "YieldEventScene16", &GameConnection::yieldEventScene16 },
+    { YieldEventScene32, "YieldEventScene32", &GameConnection::yieldEventScene32 },
+    { YieldEventScene64, "YieldEventScene64", &GameConnection::yieldEventScene64 },
+    { YieldEventScene128, "YieldEventScene128", &GameConnection::yieldEventScene128 },
+    { YieldEventScene255, "YieldEventScene255", &GameConnection::yieldEventScene255 },
 
-  setZoneHandler( ReturnEventSceneHeader, "ReturnEventSceneHeader", &GameConnection::returnEventSceneHeader );
-  setZoneHandler( ReturnEventScene2, "ReturnEventScene2", &GameConnection::returnEventScene2 );
-  setZoneHandler( ReturnEventScene4, "ReturnEventScene4", &GameConnection::returnEventScene4 );
-  setZoneHandler( ReturnEventScene8, "ReturnEventScene8", &GameConnection::returnEventScene8 );
-  setZoneHandler( ReturnEventScene16, "ReturnEventScene16", &GameConnection::returnEventScene16 );
-  setZoneHandler( ReturnEventScene32, "ReturnEventScene32", &GameConnection::returnEventScene32 );
-  setZoneHandler( ReturnEventScene64, "ReturnEventScene64", &GameConnection::returnEventScene64 );
-  setZoneHandler( ReturnEventScene128, "ReturnEventScene128", &GameConnection::returnEventScene128 );
-  setZoneHandler( ReturnEventScene255, "ReturnEventScene255", &GameConnection::returnEventScene255 );
+    { StartUIEvent, "StartUIEvent", &GameConnection::startUiEvent },
 
-  setZoneHandler( YieldEventSceneHeader, "YieldEventSceneHeader", &GameConnection::yieldEventSceneHeader );
-  setZoneHandler( YieldEventScene2, "YieldEventScene2", &GameConnection::yieldEventScene2 );
-  setZoneHandler( YieldEventScene4, "YieldEventScene4", &GameConnection::yieldEventScene4 );
-  setZoneHandler( YieldEventScene8, "YieldEventScene8", &GameConnection::yieldEventScene8 );
-  setZoneHandler( YieldEventScene16, "YieldEventScene16", &GameConnection::yieldEventScene16 );
-  setZoneHandler( YieldEventScene32, "YieldEventScene32", &GameConnection::yieldEventScene32 );
-  setZoneHandler( YieldEventScene64, "YieldEventScene64", &GameConnection::yieldEventScene64 );
-  setZoneHandler( YieldEventScene128, "YieldEventScene128", &GameConnection::yieldEventScene128 );
-  setZoneHandler( YieldEventScene255, "YieldEventScene255", &GameConnection::yieldEventScene255 );
+    { YieldEventSceneString8, "YieldEventSceneString8", &GameConnection::yieldEventString },
+    { YieldEventSceneString16, "YieldEventSceneString16", &GameConnection::yieldEventString },
+    { YieldEventSceneString32, "YieldEventSceneString32", &GameConnection::yieldEventString },
 
-  setZoneHandler( StartUIEvent, "StartUIEvent", &GameConnection::startUiEvent );
+    { YieldEventSceneIntAndString, "YieldEventSceneIntAndString", &GameConnection::yieldEventSceneIntAndString },
 
-  setZoneHandler( YieldEventSceneString8, "YieldEventSceneString8", &GameConnection::yieldEventString );
-  setZoneHandler( YieldEventSceneString16, "YieldEventSceneString16", &GameConnection::yieldEventString );
-  setZoneHandler( YieldEventSceneString32, "YieldEventSceneString32", &GameConnection::yieldEventString );
+    { RequestPenalties, "RequestPenalties", &GameConnection::cfRequestPenalties },
+    { RequestBonus, "RequestBonus", &GameConnection::requestBonus },
+    { FindContent, "FindContent", &GameConnection::findContent },
+    { Find5Contents, "Find5Contents", &GameConnection::find5Contents },
+    { FindContentAsRandom, "FindContentAsRandom", &GameConnection::findContentAsRandom },
+    { CFCommenceHandler, "CFDutyAccepted", &GameConnection::cfDutyAccepted },
+    { CancelFindContent, "CancelFindContent", &GameConnection::cancelFindContent },
+    { AcceptContent, "AcceptContent", &GameConnection::acceptContent },
 
-  setZoneHandler( YieldEventSceneIntAndString, "YieldEventSceneIntAndString", &GameConnection::yieldEventSceneIntAndString );
+    { ClientZoneIpcType::Config, "Config", &GameConnection::configHandler },
 
-  setZoneHandler( RequestPenalties, "RequestPenalties", &GameConnection::cfRequestPenalties );
-  setZoneHandler( RequestBonus, "RequestBonus", &GameConnection::requestBonus );
-  setZoneHandler( FindContent, "FindContent", &GameConnection::findContent );
-  setZoneHandler( Find5Contents, "Find5Contents", &GameConnection::find5Contents );
-  setZoneHandler( FindContentAsRandom, "FindContentAsRandom", &GameConnection::findContentAsRandom );
-  setZoneHandler( CFCommenceHandler, "CFDutyAccepted", &GameConnection::cfDutyAccepted );
-  setZoneHandler( CancelFindContent, "CancelFindContent", &GameConnection::cancelFindContent );
-  setZoneHandler( AcceptContent, "AcceptContent", &GameConnection::acceptContent );
+    { CatalogSearch, "CatalogSearch", &GameConnection::catalogSearch },
 
-  setZoneHandler( ClientZoneIpcType::Config, "Config", &GameConnection::configHandler );
+    { GearSetEquip, "GearSetEquip", &GameConnection::gearSetEquip },
 
-  setZoneHandler( CatalogSearch, "CatalogSearch", &GameConnection::catalogSearch );
+    { MarketBoardRequestItemListingInfo, "MarketBoardRequestItemListingInfo", &GameConnection::marketBoardRequestItemInfo },
+    { MarketBoardRequestItemListings, "MarketBoardRequestItemListings", &GameConnection::marketBoardRequestItemListings },
 
-  setZoneHandler( GearSetEquip, "GearSetEquip", &GameConnection::gearSetEquip );
+    { GetFcStatus, "GetFcStatus", &GameConnection::getFcStatus },
+    { GetFcProfile, "GetFcProfile", &GameConnection::getFcProfile },
 
-  setZoneHandler( MarketBoardRequestItemListingInfo, "MarketBoardRequestItemListingInfo", &GameConnection::marketBoardRequestItemInfo );
-  setZoneHandler( MarketBoardRequestItemListings, "MarketBoardRequestItemListings", &GameConnection::marketBoardRequestItemListings );
+    { GetRequestItemList, "GetRequestItemList", &GameConnection::getRequestItemListHandler },
 
-  setChatHandler( ClientChatIpcType::ChatTo, "ChatTo", &GameConnection::tellHandler );
-  setChatHandler( ClientChatIpcType::ChatToChannel, "ChatToChannel", &GameConnection::chatToChannelHandler );
+    { Invite, "Invite", &GameConnection::inviteHandler },
+    { InviteReply, "InviteReply", &GameConnection::inviteReplyHandler },
 
-  setZoneHandler( GetFcStatus, "GetFcStatus", &GameConnection::getFcStatus );
-  setZoneHandler( GetFcProfile, "GetFcProfile", &GameConnection::getFcProfile );
+    { PcPartyLeave, "PcPartyLeave", &GameConnection::pcPartyLeaveHandler },
+    { PcPartyDisband, "PcPartyDisband", &GameConnection::pcPartyDisbandHandler },
+    { PcPartyKick, "PcPartyKick", &GameConnection::pcPartyKickHandler },
+    { PcPartyChangeLeader, "PcPartyChangeLeader", &GameConnection::pcPartyChangeLeaderHandler },
 
-  setZoneHandler( GetRequestItemList, "GetRequestItemList", &GameConnection::getRequestItemListHandler );
+    { FriendlistRemove, "FriendlistRemove", &GameConnection::friendlistRemoveHandler },
+    { SetFriendlistGroup, "SetFriendlistGroup", &GameConnection::setFriendlistGroupHandler },
 
-  setZoneHandler( Invite, "Invite", &GameConnection::inviteHandler );
-  setZoneHandler( InviteReply, "InviteReply", &GameConnection::inviteReplyHandler );
+    { GetBlacklist, "GetBlacklist", &GameConnection::getBlacklistHandler },
+    { BlacklistAdd, "BlacklistAdd", &GameConnection::blacklistAddHandler },
+    { BlacklistRemove, "BlacklistRemove", &GameConnection::blacklistRemoveHandler },
 
-  setZoneHandler( PcPartyLeave, "PcPartyLeave", &GameConnection::pcPartyLeaveHandler );
-  setZoneHandler( PcPartyDisband, "PcPartyDisband", &GameConnection::pcPartyDisbandHandler );
-  setZoneHandler( PcPartyKick, "PcPartyKick", &GameConnection::pcPartyKickHandler );
-  setZoneHandler( PcPartyChangeLeader, "PcPartyChangeLeader", &GameConnection::pcPartyChangeLeaderHandler );
+    { GetFcInviteList, "GetFcInviteList", &GameConnection::getFcInviteListHandler }
+  };
 
-  setZoneHandler( FriendlistRemove, "FriendlistRemove", &GameConnection::friendlistRemoveHandler );
-  setZoneHandler( SetFriendlistGroup, "SetFriendlistGroup", &GameConnection::setFriendlistGroupHandler );
+  static constexpr DispatchTable table( handlers );
+  return table;
+}
 
-  setZoneHandler( GetBlacklist, "GetBlacklist", &GameConnection::getBlacklistHandler );
-  setZoneHandler( BlacklistAdd, "BlacklistAdd", &GameConnection::blacklistAddHandler );
-  setZoneHandler( BlacklistRemove, "BlacklistRemove", &GameConnection::blacklistRemoveHandler );
+const GameConnection::DispatchTable& GameConnection::chatDispatchTable()
+{
+  static constexpr DispatchTable::Entry handlers[] =
+  {
+    { ClientChatIpcType::ChatTo, "ChatTo", &GameConnection::tellHandler },
+    { ClientChatIpcType::ChatToChannel, "ChatToChannel", &GameConnection::chatToChannelHandler }
+  };
 
-  setZoneHandler( GetFcInviteList, "GetFcInviteList", &GameConnection::getFcInviteListHandler );
+  static constexpr DispatchTable table( handlers );
+  return table;
 }
 
 GameConnection::~GameConnection() = default;
@@ -195,38 +211,47 @@ void GameConnection::onDisconnect()
 void GameConnection::onRecv( std::vector< uint8_t >& buffer )
 {
   m_packets.insert( std::end( m_packets ), std::begin( buffer ), std::end( buffer ) );
-  // This is assumed packet always start with valid FFXIVARR_PACKET_HEADER for now.
-  Packets::FFXIVARR_PACKET_HEADER packetHeader{};
-  const auto headerResult = Packets::getHeader( m_packets, 0, packetHeader );
-
-  if( headerResult == Incomplete )
-    return;
 
-  if( headerResult == Malformed )
+  // consider multiple frames in single tcp recv
+  while( !m_packets.empty() )
   {
-    Logger::info( "Dropping connection due to malformed packet header." );
-    disconnect();
-    return;
-  }
+    // This is assumed packet always start with valid FFXIVARR_PACKET_HEADER for now.
+    Packets::FFXIVARR_PACKET_HEADER packetHeader{};
+    const auto headerResult = Packets::getHeader( m_packets, 0, packetHeader );
 
-  // Dissect packet list
-  std::vector< Packets::FFXIVARR_PACKET_RAW > packetList;
-  const auto packetResult = Packets::getPackets( m_packets, sizeof( struct FFXIVARR_PACKET_HEADER ), packetHeader, packetList );
+    if( headerResult == Incomplete )
+      return;
 
-  if( packetResult == Incomplete )
-    return;
+    if( headerResult == Malformed )
+    {
+      Logger::info( "Dropping connection due to malformed packet header." );
+      disconnect();
+      return;
+    }
 
-  if( packetResult == Malformed )
-  {
-    Logger::info( "Dropping connection due to malformed packets." );
-    disconnect();
-    return;
-  }
+    // Dissect packet list
+    std::vector< Packets::FFXIVARR_PACKET_RAW > packetList;
+    const auto packetResult = Packets::getPackets( m_packets, sizeof( struct FFXIVARR_PACKET_HEADER ), packetHeader, packetList );
 
-  // consider multiple frames in single tcp recv
-  const auto consumed = static_cast< size_t >( packetHeader.size );
-  handlePackets( packetHeader, packetList );
-  m_packets.erase( m_packets.begin(), m_packets.begin() + consumed );
+    if( packetResult == Incomplete )
+      return;
+
+    if( packetResult == Malformed )
+    {
+      Logger::info( "Dropping connection due to malformed packets." );
+      disconnect();
+      return;
+    }
+
+    const auto consumed = static_cast< size_t >( packetHeader.size );
+    handlePackets( packetHeader, packetList );
+
+    // handlePackets drops the connection on invalid sessions, don't process what is left
+    if( !m_socket.is_open() )
+      return;
+
+    m_packets.erase( m_packets.begin(), m_packets.begin() + consumed );
+  }
 }
 
 void GameConnection::onError( const asio::error_code& error )
@@ -252,23 +277,35 @@ void GameConnection::queueOutPacket( std::vector< Packets::FFXIVPacketBasePtr >
   }
 }
 
+void GameConnection::dispatch( const DispatchTable::Entry& entry, OpcodeStats& stats, Packets::FFXIVARR_PACKET_RAW& pPacket )
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  ( this->*( entry.handler ) )( pPacket, *m_pSession->getPlayer() );
+
+  const auto elapsed = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - start );
+  stats.record( pPacket.data.size(), static_cast< uint64_t >( elapsed.count() ) );
+}
+
 void GameConnection::handleZonePacket( Packets::FFXIVARR_PACKET_RAW& pPacket )
 {
   uint16_t opcode = Util::getOpCode( pPacket );
-  auto it = m_zoneHandlerMap.find( opcode );
+  const auto& table = zoneDispatchTable();
+  const auto slot = table.getSlot( opcode );
 
-  if( it != m_zoneHandlerMap.end() )
+  if( slot != DispatchTable::Unhandled )
   {
-    auto itStr = m_zoneHandlerStrMap.find( opcode );
-    std::string name = itStr != m_zoneHandlerStrMap.end() ? itStr->second : "unknown";
+    const auto& entry = table.getEntry( slot );
     // dont display packet notification if it is a ping or pos update, don't want the spam
     if( opcode != Sync && opcode != Client::Move )
-      Logger::debug( "[{0}] Zone IPC : {1} ( {2:04X} )", m_pSession->getId(), name, opcode );
+      Logger::debug( "[{0}] Zone IPC : {1} ( {2:04X} )", m_pSession->getId(), entry.name, opcode );
 
-    ( this->*( it->second ) )( pPacket, *m_pSession->getPlayer() );
+    dispatch( entry, zoneOpcodeStats[ slot ], pPacket );
   }
   else
   {
+    zoneOpcodeStats[ DispatchTable::Unhandled ].record( pPacket.data.size(), 0 );
+
     auto packetName = zonePacketToString( opcode );
     auto player = m_pSession->getPlayer();
     PlayerMgr::sendUrgent( *player, "Unimplemented zone IPC: {} ({:04X}) len: {}", packetName, opcode, pPacket.data.size() );
@@ -286,20 +323,21 @@ void GameConnection::handleZonePacket( Packets::FFXIVARR_PACKET_RAW& pPacket )
 void GameConnection::handleChatPacket( Packets::FFXIVARR_PACKET_RAW& pPacket )
 {
   uint16_t opcode = Util::getOpCode( pPacket );
-  auto it = m_chatHandlerMap.find( opcode );
+  const auto& table = chatDispatchTable();
+  const auto slot = table.getSlot( opcode );
 
-  if( it != m_chatHandlerMap.end() )
+  if( slot != DispatchTable::Unhandled )
   {
-    auto itStr = m_chatHandlerStrMap.find( opcode );
-    std::string name = itStr != m_chatHandlerStrMap.end() ? itStr->second : "Unknown";
-    // dont display packet notification if it is a ping or pos update, don't want the spam
+    const auto& entry = table.getEntry( slot );
 
-    Logger::debug( "[{0}] Handling Chat IPC : {1} ( {2:04X} )", m_pSession->getId(), name, opcode );
+    Logger::debug( "[{0}] Handling Chat IPC : {1} ( {2:04X} )", m_pSession->getId(), entry.name, opcode );
 
-    ( this->*( it->second ) )( pPacket, *m_pSession->getPlayer() );
+    dispatch( entry, chatOpcodeStats[ slot ], pPacket );
   }
   else
   {
+    chatOpcodeStats[ DispatchTable::Unhandled ].record( pPacket.data.size(), 0 );
+
     Logger::debug( "[{0}] Undefined Chat IPC : Unknown ( {1:04X} )", m_pSession->getId(), opcode );
 
     Logger::debug(
@@ -310,6 +348,59 @@ void GameConnection::handleChatPacket( Packets::FFXIVARR_PACKET_RAW& pPacket )
   }
 }
 
+std::vector< OpcodeStatsSnapshot > GameConnection::getOpcodeStats( ConnectionType type )
+{
+  const bool isChat = type == ConnectionType::Chat;
+  const auto& table = isChat ? chatDispatchTable() : zoneDispatchTable();
+  const auto& stats = isChat ? chatOpcodeStats : zoneOpcodeStats;
+
+  std::vector< OpcodeStatsSnapshot > result;
+
+  if( stats[ DispatchTable::Unhandled ].count > 0 )
+    result.emplace_back( 0, "unhandled", stats[ DispatchTable::Unhandled ] );
+
+  for( size_t slot = 1; slot <= table.size(); ++slot )
+  {
+    if( stats[ slot ].count == 0 )
+      continue;
+
+    const auto& entry = table.getEntry( static_cast< uint8_t >( slot ) );
+    result.emplace_back( entry.opcode, entry.name, stats[ slot ] );
+  }
+
+  // most expensive first
+  std::sort( result.begin(), result.end(), []( const OpcodeStatsSnapshot& a, const OpcodeStatsSnapshot& b )
+  {
+    return a.totalUs > b.totalUs;
+  } );
+
+  return result;
+}
+
+void GameConnection::resetOpcodeStats()
+{
+  for( auto& stats : zoneOpcodeStats )
+    stats.reset();
+
+  for( auto& stats : chatOpcodeStats )
+    stats.reset();
+}
+
+void GameConnection::dumpOpcodeStats()
+{
+  for( auto type : { ConnectionType::Zone, ConnectionType::Chat } )
+  {
+    Logger::info( "{0} opcode stats:", type == ConnectionType::Zone ? "Zone" : "Chat" );
+
+    for( const auto& entry : getOpcodeStats( type ) )
+    {
+      Logger::info( "  {0} ( {1:04X} ) count: {2} bytes: {3} total: {4}us avg: {5}us p50: <{6}us p99: <{7}us max: {8}us",
+                    entry.name, entry.opcode, entry.count, entry.bytes, entry.totalUs, entry.totalUs / entry.count,
+                    entry.percentileUs( 0.5 ), entry.percentileUs( 0.99 ), entry.maxUs );
+    }
+  }
+}
+
 void GameConnection::handlePacket( Packets::FFXIVARR_PACKET_RAW& pPacket )
 {
   if( !m_pSession )
@@ -438,6 +529,53 @@ void GameConnection::injectPacket( const std::string& packetpath, Entity::Player
   }
 }
 
+void GameConnection::onSessionReady( const World::SessionPtr& session, uint32_t entityId, uint16_t connectionType )
+{
+  auto pCon = std::static_pointer_cast< GameConnection, Connection >( shared_from_this() );
+
+  // if not set, set the session for this connection
+  if( !m_pSession && session )
+    m_pSession = session;
+
+  auto pe = std::make_shared< FFXIVRawPacket >( 0x07, 0x18, 0, 0 );
+  *reinterpret_cast< unsigned int* >( &pe->data()[ 0 ] ) = 0xE00392b0;
+  *reinterpret_cast< unsigned int* >( &pe->data()[ 4 ] ) = Common::Util::getTimeSeconds();
+  sendSinglePacket( pe );
+
+  // main connection, assinging it to the session
+  if( connectionType == ConnectionType::Zone )
+  {
+    auto pe1 = std::make_shared< FFXIVRawPacket >( 0x02, 0x38, 0, 0 );
+    *reinterpret_cast< unsigned int* >( &pe1->data()[ 0 ] ) = entityId;
+    *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x08 ] ) = 0x90000b60;
+    *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x0C ] ) = 0x00007f8B;
+    *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x10 ] ) = 0x7b201bf0;
+    *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x14 ] ) = 0x00007f8b;
+    *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x20 ] ) = 0x00005e4c;
+    //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x24 ] ) = Common::Util::getTimeSeconds();
+    //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x0C ] ) = Common::Util::getTimeSeconds();
+    //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x1C ] ) = Common::Util::getTimeSeconds();
+    //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x18 ] ) = Common::Util::getTimeSeconds();
+    sendSinglePacket( pe1 );
+    Logger::info( "[{0}] Setting session for world connection", entityId );
+    session->setZoneConnection( pCon );
+  }
+    // chat connection, assinging it to the session
+  else if( connectionType == ConnectionType::Chat )
+  {
+    auto pe2 = std::make_shared< FFXIVRawPacket >( 0x02, 0x38, 0, 0 );
+    *reinterpret_cast< unsigned int* >( &pe2->data()[ 0 ] ) = entityId;
+    sendSinglePacket( pe2 );
+
+    auto pe3 = std::make_shared< FFXIVRawPacket >( 0x03, 0x28, entityId, entityId );
+    *reinterpret_cast< unsigned short* >( &pe3->data()[ 2 ] ) = 0x02;
+    sendSinglePacket( pe3 );
+
+    Logger::info( "[{0}] Setting session for chat connection", entityId );
+    session->setChatConnection( pCon );
+  }
+}
+
 void GameConnection::handlePackets( const Packets::FFXIVARR_PACKET_HEADER& ipcHeader, const std::vector< Packets::FFXIVARR_PACKET_RAW >& packetData )
 {
   auto& server = Common::Service< World::WorldServer >::ref();
@@ -467,21 +605,28 @@ void GameConnection::handlePackets( const Packets::FFXIVARR_PACKET_HEADER& ipcHe
           return;
         }
         
-        auto pCon = std::static_pointer_cast< GameConnection, Connection >( shared_from_this() );
-
         // try to retrieve the session for this id
         auto session = server.getSession( entityId );
 
         if( !session )
         {
           Logger::info( "[{0}] Session not registered, creating", entityId );
-          // return;
-          if( !server.createSession( entityId ) )
+          // the player loads on the db workers, the handshake continues on this connection's strand once it is done
+          auto self = std::static_pointer_cast< GameConnection, Connection >( shared_from_this() );
+          auto connectionType = ipcHeader.connectionType;
+          server.createSession( entityId, [ self, entityId, connectionType ]( World::SessionPtr pSession )
           {
-            disconnect();
-            return;
-          }
-          session = server.getSession( entityId );
+            self->getStrand().post( [ self, pSession, entityId, connectionType ]()
+            {
+              if( !pSession )
+              {
+                self->disconnect();
+                return;
+              }
+              self->onSessionReady( pSession, entityId, connectionType );
+            } );
+          } );
+          break;
         }
           //TODO: Catch more things in lobby and send real errors
         else if( !session->isValid() || ( session->getPlayer() && session->getLastPing() != 0 ) )
@@ -491,48 +636,7 @@ void GameConnection::handlePackets( const Packets::FFXIVARR_PACKET_HEADER& ipcHe
           return;
         }
 
-        // if not set, set the session for this connection
-        if( !m_pSession && session )
-          m_pSession = session;
-
-        auto pe = std::make_shared< FFXIVRawPacket >( 0x07, 0x18, 0, 0 );
-        *reinterpret_cast< unsigned int* >( &pe->data()[ 0 ] ) = 0xE00392b0;
-        *reinterpret_cast< unsigned int* >( &pe->data()[ 4 ] ) = Common::Util::getTimeSeconds();
-        sendSinglePacket( pe );
-
-        // main connection, assinging it to the session
-        if( ipcHeader.connectionType == ConnectionType::Zone )
-        {
-          auto pe1 = std::make_shared< FFXIVRawPacket >( 0x02, 0x38, 0, 0 );
-          *reinterpret_cast< unsigned int* >( &pe1->data()[ 0 ] ) = entityId;
-          *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x08 ] ) = 0x90000b60;
-          *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x0C ] ) = 0x00007f8B;
-          *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x10 ] ) = 0x7b201bf0;
-          *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x14 ] ) = 0x00007f8b;
-          *reinterpret_cast< unsigned int* >( &pe1->data()[ 0x20 ] ) = 0x00005e4c;
-          //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x24 ] ) = Common::Util::getTimeSeconds();
-          //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x0C ] ) = Common::Util::getTimeSeconds();
-          //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x1C ] ) = Common::Util::getTimeSeconds();
-          //*reinterpret_cast< unsigned int* >( &pe1->data()[ 0x18 ] ) = Common::Util::getTimeSeconds();
-          sendSinglePacket( pe1 );
-          Logger::info( "[{0}] Setting session for world connection", entityId );
-          session->setZoneConnection( pCon );
-        }
-          // chat connection, assinging it to the session
-        else if( ipcHeader.connectionType == ConnectionType::Chat )
-        {
-          auto pe2 = std::make_shared< FFXIVRawPacket >( 0x02, 0x38, 0, 0 );
-          *reinterpret_cast< unsigned int* >( &pe2->data()[ 0 ] ) = entityId;
-          sendSinglePacket( pe2 );
-
-          auto pe3 = std::make_shared< FFXIVRawPacket >( 0x03, 0x28, entityId, entityId );
-          *reinterpret_cast< unsigned short* >( &pe3->data()[ 2 ] ) = 0x02;
-          sendSinglePacket( pe3 );
-
-          Logger::info( "[{0}] Setting session for chat connection", entityId );
-          session->setChatConnection( pCon );
-        }
-
+        onSessionReady( session, entityId, ipcHeader.connectionType );
         break;
 
       }
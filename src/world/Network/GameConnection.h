@@ -5,9 +5,10 @@
 
 #include <Network/CommonNetwork.h>
 #include <Util/LockedQueue.h>
-#include <map>
+#include <vector>
 
 #include "ForwardsZone.h"
+#include "OpcodeDispatch.h"
 
 #define DECLARE_HANDLER( x ) void x( const Sapphire::Network::Packets::FFXIVARR_PACKET_RAW& inPacket, Entity::Player& player )
 
@@ -35,18 +36,20 @@ namespace Sapphire::Network
     typedef void ( GameConnection::* Handler )( const Network::Packets::FFXIVARR_PACKET_RAW& inPacket,
                                                 Entity::Player& player );
 
-    using HandlerMap = std::map< uint16_t, Handler >;
-    using HandlerStrMap = std::map< uint16_t, std::string >;
+    using DispatchTable = OpcodeDispatchTable< Handler >;
 
-    AcceptorPtr m_pAcceptor;
+    // handler for game packets ( main type 0x03, connection type 1 ), shared by all connections
+    static const DispatchTable& zoneDispatchTable();
+
+    // handler for game packets ( main type 0x03, connection type 2 ), shared by all connections
+    static const DispatchTable& chatDispatchTable();
 
-    // handler for game packets ( main type 0x03, connection type 1 )
-    HandlerMap m_zoneHandlerMap;
-    HandlerStrMap m_zoneHandlerStrMap;
+    void dispatch( const DispatchTable::Entry& entry, OpcodeStats& stats, Network::Packets::FFXIVARR_PACKET_RAW& pPacket );
 
-    // handler for game packets ( main type 0x03, connection type 2 )
-    HandlerMap m_chatHandlerMap;
-    HandlerStrMap m_chatHandlerStrMap;
+    // sends the rest of the session handshake and attaches this connection to the session
+    void onSessionReady( const World::SessionPtr& session, uint32_t entityId, uint16_t connectionType );
+
+    AcceptorPtr m_pAcceptor;
 
     World::SessionPtr m_pSession;
 
@@ -96,6 +99,14 @@ namespace Sapphire::Network
 
     static const char* zonePacketToString( uint32_t opcode );
 
+    // dispatch counters of every opcode seen so far, collected across all connections
+    static std::vector< OpcodeStatsSnapshot > getOpcodeStats( ConnectionType type );
+
+    static void resetOpcodeStats();
+
+    // writes the counters of every opcode seen so far to the log
+    static void dumpOpcodeStats();
+
     DECLARE_HANDLER( loginHandler );
 
     DECLARE_HANDLER( setLanguageHandler );
@@ -138,14 +138,10 @@ void Sapphire::Network::GameConnection::gmCommandHandler( const Packets::FFXIVAR
       targetPlayer->setLookAt( CharaLook::Race, static_cast< uint8_t >( param1 ) );
       PlayerMgr::sendServerNotice( player, "Race for {0} was set to {1}", targetPlayer->getName(), param1 );
       targetPlayer->spawn( targetPlayer );
-      auto inRange = targetPlayer->getInRangeActors();
-      for( const auto& actor : inRange )
+      for( const auto& pObserver : targetPlayer->getInRangePlayers() )
       {
-        if( actor->isPlayer() )
-        {
-          targetPlayer->despawn( actor->getAsPlayer() );
-          targetPlayer->spawn( actor->getAsPlayer() );
-        }
+        targetPlayer->despawn( pObserver );
+        targetPlayer->spawn( pObserver );
       }
       break;
     }
@@ -154,14 +150,10 @@ void Sapphire::Network::GameConnection::gmCommandHandler( const Packets::FFXIVAR
       targetPlayer->setLookAt( CharaLook::Tribe, static_cast< uint8_t >( param1 ) );
       PlayerMgr::sendServerNotice( player, "Tribe for {0} was set to ", targetPlayer->getName(), param1 );
       targetPlayer->spawn( targetPlayer );
-      auto inRange = targetPlayer->getInRangeActors();
-      for( const auto& actor : inRange )
+      for( const auto& pObserver : targetPlayer->getInRangePlayers() )
       {
-        if( actor->isPlayer() )
-        {
-          targetPlayer->despawn( actor->getAsPlayer() );
-          targetPlayer->spawn( actor->getAsPlayer() );
-        }
+        targetPlayer->despawn( pObserver );
+        targetPlayer->spawn( pObserver );
       }
       break;
     }
@@ -170,14 +162,10 @@ void Sapphire::Network::GameConnection::gmCommandHandler( const Packets::FFXIVAR
       targetPlayer->setLookAt( CharaLook::Gender, static_cast< uint8_t >( param1 ) );
       PlayerMgr::sendServerNotice( player, "Sex for {0} was set to ", targetPlayer->getName(), param1 );
       targetPlayer->spawn( targetPlayer );
-      auto inRange = targetActor->getInRangeActors();
-      for( const auto& actor : inRange )
+      for( const auto& pObserver : targetPlayer->getInRangePlayers() )
       {
-        if( actor->isPlayer() )
-        {
-          targetPlayer->despawn( actor->getAsPlayer() );
-          targetPlayer->spawn( actor->getAsPlayer() );
-        }
+        targetPlayer->despawn( pObserver );
+        targetPlayer->spawn( pObserver );
       }
       break;
     }
@@ -241,13 +229,10 @@ void Sapphire::Network::GameConnection::gmCommandHandler( const Packets::FFXIVAR
       player.setGmInvis( !player.getGmInvis() );
       PlayerMgr::sendServerNotice( player, "Invisibility flag for {0} was toggled to {1}", player.getName(), !player.getGmInvis());
 
-      for( const auto& actor : player.getInRangeActors() )
+      for( const auto& pObserver : targetPlayer->getInRangePlayers() )
       {
-        if( actor->isPlayer() )
-        {
-          targetPlayer->despawn( actor->getAsPlayer() );
-          targetPlayer->spawn( actor->getAsPlayer() );
-        }
+        targetPlayer->despawn( pObserver );
+        targetPlayer->spawn( pObserver );
       }
       break;
     }
@@ -271,7 +256,7 @@ void Sapphire::Network::GameConnection::gmCommandHandler( const Packets::FFXIVAR
       strcpy( searchInfoPacket->data().SearchComment, targetPlayer->getSearchMessage() );
       server().queueForPlayer( targetPlayer->getCharacterId(), searchInfoPacket );
 
-      server().queueForPlayers( targetPlayer->getInRangePlayerIds( true ), makeActorControl( player.getId(), SetStatusIcon,
+      server().queueForInRangePlayers( *targetPlayer, true, makeActorControl( player.getId(), SetStatusIcon,
                                                                            static_cast< uint8_t >( player.getOnlineStatus() ) ) );
       PlayerMgr::sendServerNotice( player, "Icon for {0} was set to {1}", targetPlayer->getName(), param1 );
       break;
@@ -630,8 +615,8 @@ void Sapphire::Network::GameConnection::gmCommandNameHandler( const Packets::FFX
       targetPlayer->resetMp();
       targetPlayer->setStatus( Common::ActorStatus::Idle );
 
-      server().queueForPlayers( targetPlayer->getInRangePlayerIds( true ), makeActorControlSelf( player.getId(), Appear, 0x01, 0x01, 0, 113 ) );
-      server().queueForPlayers( targetPlayer->getInRangePlayerIds( true ), makeActorControl( player.getId(), SetStatus,
+      server().queueForInRangePlayers( *targetPlayer, true, makeActorControlSelf( player.getId(), Appear, 0x01, 0x01, 0, 113 ) );
+      server().queueForInRangePlayers( *targetPlayer, true, makeActorControl( player.getId(), SetStatus,
                                                                            static_cast< uint8_t >( Common::ActorStatus::Idle ) ) );
 
       PlayerMgr::sendServerNotice( player, "Raised {0}", targetPlayer->getName());
@@ -249,7 +249,7 @@ void Sapphire::Network::GameConnection::moveHandler( const Packets::FFXIVARR_PAC
   // todo: probably move this into a builder and send the packet on Player::update if( m_dirtyFlags & DirtyFlag::Position )
   //auto movePacket = std::make_shared< MoveActorPacket >( player, headRotation, animationType, animationState, animationSpeed, unknownRotation );
   auto movePacket = std::make_shared< MoveActorPacket >( player, headRotation, data.flag, data.flag2, animationSpeed, unknownRotation );
-  server().queueForPlayers( player.getInRangePlayerIds(), movePacket );
+  server().queueMoveForInRangePlayers( player, movePacket );
 }
 
 void Sapphire::Network::GameConnection::configHandler( const Packets::FFXIVARR_PACKET_RAW& inPacket, Entity::Player& player )
@@ -376,7 +376,7 @@ void Sapphire::Network::GameConnection::setLanguageHandler( const Packets::FFXIV
   player.spawn( player.getAsPlayer() );
 
   // notify the zone of a change in position to force an "inRangeActor" update
-  pCurrentZone->updateActorPosition( player );
+  pCurrentZone->updateActorPosition( player, true );
 }
 
 void Sapphire::Network::GameConnection::pcSearchHandler( const Packets::FFXIVARR_PACKET_RAW& inPacket, Entity::Player& player )
@@ -0,0 +1,66 @@
+#include "OpcodeDispatch.h"
+
+using namespace Sapphire::Network;
+
+void OpcodeStats::record( size_t size, uint64_t us )
+{
+  count.fetch_add( 1, std::memory_order_relaxed );
+  bytes.fetch_add( size, std::memory_order_relaxed );
+  totalUs.fetch_add( us, std::memory_order_relaxed );
+
+  auto prevMax = maxUs.load( std::memory_order_relaxed );
+  while( us > prevMax && !maxUs.compare_exchange_weak( prevMax, us, std::memory_order_relaxed ) )
+  {
+  }
+
+  size_t bucket = 0;
+  while( bucket < OpcodeLatencyBuckets - 1 && ( us >> bucket ) != 0 )
+    ++bucket;
+
+  latency[ bucket ].fetch_add( 1, std::memory_order_relaxed );
+}
+
+void OpcodeStats::reset()
+{
+  count = 0;
+  bytes = 0;
+  totalUs = 0;
+  maxUs = 0;
+
+  for( auto& bucket : latency )
+    bucket = 0;
+}
+
+OpcodeStatsSnapshot::OpcodeStatsSnapshot( uint16_t opcode, const char* name, const OpcodeStats& stats ) :
+  opcode( opcode ),
+  name( name ),
+  count( stats.count.load( std::memory_order_relaxed ) ),
+  bytes( stats.bytes.load( std::memory_order_relaxed ) ),
+  totalUs( stats.totalUs.load( std::memory_order_relaxed ) ),
+  maxUs( stats.maxUs.load( std::memory_order_relaxed ) )
+{
+  for( size_t i = 0; i < OpcodeLatencyBuckets; ++i )
+    latency[ i ] = stats.latency[ i ].load( std::memory_order_relaxed );
+}
+
+uint64_t OpcodeStatsSnapshot::percentileUs( double percentile ) const
+{
+  uint64_t total = 0;
+  for( auto bucket : latency )
+    total += bucket;
+
+  if( total == 0 )
+    return 0;
+
+  const auto target = static_cast< uint64_t >( percentile * static_cast< double >( total ) );
+  uint64_t seen = 0;
+
+  for( size_t i = 0; i < OpcodeLatencyBuckets - 1; ++i )
+  {
+    seen += latency[ i ];
+    if( seen > target || seen == total )
+      return uint64_t{ 1 } << i;
+  }
+
+  return maxUs;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace Sapphire::Network
+{
+  // handlers a single dispatch table can hold, slot 0 is reserved for opcodes without a handler
+  constexpr size_t MaxOpcodeHandlers = 255;
+
+  // bucket i counts handler calls that took less than 2^i microseconds, the last bucket takes the rest
+  constexpr size_t OpcodeLatencyBuckets = 20;
+
+  struct OpcodeStats
+  {
+    std::atomic< uint64_t > count{ 0 };
+    std::atomic< uint64_t > bytes{ 0 };
+    std::atomic< uint64_t > totalUs{ 0 };
+    std::atomic< uint64_t > maxUs{ 0 };
+    std::array< std::atomic< uint64_t >, OpcodeLatencyBuckets > latency{};
+
+    void record( size_t size, uint64_t us );
+
+    void reset();
+  };
+
+  using OpcodeStatsTable = std::array< OpcodeStats, MaxOpcodeHandlers + 1 >;
+
+  // plain copy of the counters of one opcode for reporting
+  struct OpcodeStatsSnapshot
+  {
+    uint16_t opcode{ 0 };
+    const char* name{ nullptr };
+    uint64_t count{ 0 };
+    uint64_t bytes{ 0 };
+    uint64_t totalUs{ 0 };
+    uint64_t maxUs{ 0 };
+    std::array< uint64_t, OpcodeLatencyBuckets > latency{};
+
+    OpcodeStatsSnapshot() = default;
+
+    OpcodeStatsSnapshot( uint16_t opcode, const char* name, const OpcodeStats& stats );
+
+    // upper bound in microseconds of the latency bucket holding the given percentile ( 0.0 - 1.0 )
+    uint64_t percentileUs( double percentile ) const;
+  };
+
+  /*!
+   * Opcode -> handler lookup built at compile time.
+   * Every possible opcode maps straight to a slot, so dispatch is a single array index
+   * and the slot doubles as index into an OpcodeStatsTable.
+   */
+  template< typename Handler >
+  class OpcodeDispatchTable
+  {
+  public:
+    struct Entry
+    {
+      uint16_t opcode;
+      const char* name;
+      Handler handler;
+    };
+
+    static constexpr uint8_t Unhandled = 0;
+
+    template< size_t N >
+    constexpr explicit OpcodeDispatchTable( const Entry ( &entries )[ N ] ) :
+      m_entries{},
+      m_slots{},
+      m_size( N )
+    {
+      static_assert( N <= MaxOpcodeHandlers, "Too many handlers for a single dispatch table" );
+
+      for( size_t i = 0; i < N; ++i )
+      {
+        m_entries[ i + 1 ] = entries[ i ];
+        m_slots[ entries[ i ].opcode ] = static_cast< uint8_t >( i + 1 );
+      }
+    }
+
+    constexpr uint8_t getSlot( uint16_t opcode ) const
+    {
+      return m_slots[ opcode ];
+    }
+
+    constexpr const Entry& getEntry( uint8_t slot ) const
+    {
+      return m_entries[ slot ];
+    }
+
+    constexpr size_t size() const
+    {
+      return m_size;
+    }
+
+  private:
+    std::array< Entry, MaxOpcodeHandlers + 1 > m_entries;
+    std::array< uint8_t, 0x10000 > m_slots;
+    size_t m_size;
+  };
+
+}
@@ -23,6 +23,17 @@ namespace Sapphire::Network::Packets::Server
       initialize( sender, channelId, msg );
     };
 
+    // no fixed recipient, used when one packet is queued for a whole channel.
+    // the packet container of each connection sets source and target to its recipient, as the per member packets had
+    ChatToChannelPacket( Entity::Player& sender,
+                         uint64_t channelId,
+                         const std::string& msg ) :
+      ChatChannelPacket< FFXIVChatToChannel >( 0, 0 )
+    {
+      setSourceIsRecipient( true );
+      initialize( sender, channelId, msg );
+    };
+
   private:
     void initialize( Entity::Player& sender, uint64_t channelId, const std::string& msg )
     {
@@ -33,7 +33,7 @@ void Util::Packet::sendConfigFlags( Entity::Player& player )
 {
   auto paramPacket = makeZonePacket< FFXIVIpcConfig >( player.getId() );
   paramPacket->data().flag = player.getConfigFlags();
-  server().queueForPlayers( player.getInRangePlayerIds( true ), paramPacket );
+  server().queueForInRangePlayers( player, true, paramPacket );
 }
 
 void Util::Packet::sendOnlineStatus( Entity::Player& player )
@@ -42,7 +42,7 @@ void Util::Packet::sendOnlineStatus( Entity::Player& player )
   statusPacket->data().onlineStatusFlags = player.getFullOnlineStatusMask();
   server().queueForPlayer( player.getCharacterId(), statusPacket );
 
-  server().queueForPlayers( player.getInRangePlayerIds( true ),
+  server().queueForInRangePlayers( player, true,
                             makeActorControl( player.getId(), SetStatusIcon, static_cast< uint8_t >( player.getOnlineStatus() ) ) );
 }
 
@@ -70,11 +70,11 @@ void Util::Packet::sendBaseParams( Entity::Player& player )
 void Util::Packet::sendHudParam( Entity::Chara& source )
 {
   if( source.isPlayer() )
-    server().queueForPlayers( source.getInRangePlayerIds( true ), makeHudParam( *source.getAsPlayer() ) );
+    server().queueForInRangePlayers( source, true, makeHudParam( *source.getAsPlayer() ) );
   else if( source.isBattleNpc() )
-    server().queueForPlayers( source.getInRangePlayerIds( false ), makeHudParam( *source.getAsBNpc() ) );
+    server().queueForInRangePlayers( source, false, makeHudParam( *source.getAsBNpc() ) );
   else
-    server().queueForPlayers( source.getInRangePlayerIds( false ), makeHudParam( source ) );
+    server().queueForInRangePlayers( source, false, makeHudParam( source ) );
 }
 
 void Util::Packet::sendStatusUpdate( Entity::Player& player )
@@ -286,7 +286,7 @@ void Util::Packet::sendMount( Entity::Player& player )
 
 void Util::Packet::sendEquip( Entity::Player& player )
 {
-  server().queueForPlayers( player.getInRangePlayerIds( true ), std::make_shared< ModelEquipPacket >( player ) );
+  server().queueForInRangePlayers( player, true, std::make_shared< ModelEquipPacket >( player ) );
 }
 
 void Util::Packet::sendCondition( Entity::Player& player )
@@ -315,7 +315,7 @@ void Util::Packet::sendAchievementList( Entity::Player& player )
 
 void Util::Packet::sendRestingUpdate( Entity::Player& player )
 {
-  server().queueForPlayers( player.getInRangePlayerIds( true ), std::make_shared< RestingPacket >( player ) );
+  server().queueForInRangePlayers( player, true, std::make_shared< RestingPacket >( player ) );
 }
 
 void Util::Packet::sendLogin( Entity::Player& player )
@@ -1,6 +1,13 @@
 #include "NativeScriptMgr.h"
 
 #include <Crypt/md5.h>
+#include <Logging/Logger.h>
+#include <Util/Profiler.h>
+#include <Util/Util.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <thread>
 
 namespace Sapphire::Scripting
 {
@@ -8,40 +15,160 @@ namespace Sapphire::Scripting
   {
     std::scoped_lock lock( m_mutex );
 
-    auto module = m_loader.loadModule( path );
-    if( !module )
-      return false;
-
-    auto scripts = m_loader.getScripts( module->handle );
-    if( !scripts )
+    auto name = std::filesystem::path( path ).stem().string();
+    if( m_loader.isModuleLoaded( name ) )
     {
-      m_loader.unloadScript( module );
+      Logger::error( "Unable to load module '{0}' as it is already loaded", name );
       return false;
     }
 
-    //
-    bool success = false;
+    std::vector< PreparedModule > modules;
+    modules.push_back( prepareModule( path, {} ) );
+
+    return installModules( modules ) == 1;
+  }
+
+  uint32_t NativeScriptMgr::loadScripts( const std::set< std::string >& paths )
+  {
+    std::scoped_lock lock( m_mutex );
+
+    std::vector< std::string > pathList( paths.begin(), paths.end() );
+    std::vector< PreparedModule > modules( pathList.size() );
 
-    for( int i = 0;; i++ )
+    // copying and opening is independent per module, the workers only write their own slot
+    std::atomic< size_t > next{ 0 };
+    auto worker = [ & ]()
     {
-      if( scripts[ i ] == nullptr )
-        break;
+      for( auto i = next++; i < pathList.size(); i = next++ )
+        modules[ i ] = prepareModule( pathList[ i ], {} );
+    };
+
+    const auto workerCount = std::min< size_t >( pathList.size(), std::max( 1u, std::thread::hardware_concurrency() ) );
+
+    std::vector< std::future< void > > workers;
+    for( size_t i = 1; i < workerCount; ++i )
+      workers.push_back( std::async( std::launch::async, worker ) );
+
+    worker();
+
+    for( auto& future : workers )
+      future.get();
+
+    return installModules( modules );
+  }
+
+  NativeScriptMgr::PreparedModule NativeScriptMgr::prepareModule( const std::string& path, const std::string& cacheSuffix )
+  {
+    PreparedModule module;
+    module.path = path;
+    module.info = m_loader.prepareModule( path, cacheSuffix, &module.building );
+
+    if( module.info )
+      module.scripts = m_loader.getScripts( module.info->handle );
 
-      auto script = scripts[ i ];
-      module->scripts.push_back( script );
+    return module;
+  }
 
-      m_scripts[ script->getType() ][ script->getId() ] = script;
+  uint32_t NativeScriptMgr::installModules( std::vector< PreparedModule >& modules )
+  {
+    std::scoped_lock lock( m_mutex );
 
-      success = true;
+    std::array< bool, ScriptKindCount > changed{};
+    std::vector< ScriptInfo * > installed;
+    std::vector< ScriptInfo * > replaced;
+
+    for( auto& module : modules )
+    {
+      if( !module.info )
+        continue;
+
+      auto info = module.info;
+      std::array< bool, ScriptKindCount > added{};
+
+      for( int i = 0; module.scripts && module.scripts[ i ] != nullptr; i++ )
+      {
+        auto script = module.scripts[ i ];
+        info->scripts.push_back( script );
+
+        auto kind = getScriptKind( script->getType() );
+        if( kind == ScriptKind::Count )
+        {
+          Logger::warn( "Script {0} in {1} is not of a known script type", script->getId(), info->library_name );
+          continue;
+        }
+
+        added[ static_cast< size_t >( kind ) ] = true;
+      }
+
+      if( std::find( added.begin(), added.end(), true ) == added.end() )
+      {
+        for( auto script : info->scripts )
+          delete script;
+
+        m_loader.discardModule( info );
+        module.info = nullptr;
+        continue;
+      }
+
+      // an older version of the module is replaced, its scripts go first so the new ones win every id
+      if( auto old = m_loader.getScriptInfo( info->library_name ) )
+      {
+        removeScripts( old, changed );
+        replaced.push_back( old );
+      }
+
+      for( auto script : info->scripts )
+      {
+        auto kind = getScriptKind( script->getType() );
+        if( kind == ScriptKind::Count )
+          continue;
+
+        m_scripts[ static_cast< size_t >( kind ) ][ script->getId() ] = script;
+        changed[ static_cast< size_t >( kind ) ] = true;
+      }
+
+      installed.push_back( info );
     }
 
-    if( !success )
+    for( size_t kind = 0; kind < ScriptKindCount; ++kind )
     {
-      m_loader.unloadScript( module->handle );
-      return false;
+      if( changed[ kind ] )
+        rebuildRegistry( static_cast< ScriptKind >( kind ) );
+    }
+
+    // nothing points at the old scripts anymore
+    for( auto old : replaced )
+    {
+      for( auto script : old->scripts )
+        delete script;
+
+      m_loader.unloadScript( old );
     }
 
-    return true;
+    for( auto info : installed )
+      m_loader.registerModule( info );
+
+    return static_cast< uint32_t >( installed.size() );
+  }
+
+  void NativeScriptMgr::removeScripts( ScriptInfo *info, std::array< bool, ScriptKindCount >& changed )
+  {
+    for( auto& script : info->scripts )
+    {
+      auto kind = getScriptKind( script->getType() );
+      if( kind == ScriptKind::Count )
+        continue;
+
+      auto& scripts = m_scripts[ static_cast< size_t >( kind ) ];
+
+      // another module may have taken over the id since
+      auto it = scripts.find( script->getId() );
+      if( it != scripts.end() && it->second == script )
+      {
+        scripts.erase( it );
+        changed[ static_cast< size_t >( kind ) ] = true;
+      }
+    }
   }
 
   const std::string NativeScriptMgr::getModuleExtension()
@@ -66,12 +193,18 @@ namespace Sapphire::Scripting
   {
     std::scoped_lock lock( m_mutex );
 
-    for( auto& script : info->scripts )
+    std::array< bool, ScriptKindCount > changed{};
+    removeScripts( info, changed );
+
+    // swap the tables before the scripts they point to are freed
+    for( size_t kind = 0; kind < ScriptKindCount; ++kind )
     {
-      m_scripts[ script->getType() ].erase( script->getId() );
+      if( changed[ kind ] )
+        rebuildRegistry( static_cast< ScriptKind >( kind ) );
+    }
 
+    for( auto& script : info->scripts )
       delete script;
-    }
 
     return m_loader.unloadScript( info );
   }
@@ -84,13 +217,14 @@ namespace Sapphire::Scripting
     if( !info )
       return;
 
-    // backup actual lib path
-    std::string libPath( info->library_path );
+    m_scriptLoadQueue.push( info->library_path );
+  }
 
-    if( !unloadScript( info ) )
-      return;
+  void NativeScriptMgr::queueScriptLoad( const std::string& path )
+  {
+    std::scoped_lock lock( m_mutex );
 
-    m_scriptLoadQueue.push( libPath );
+    m_scriptLoadQueue.push( path );
   }
 
   void NativeScriptMgr::processLoadQueue()
@@ -102,19 +236,76 @@ namespace Sapphire::Scripting
     while( !m_scriptLoadQueue.empty() )
     {
       auto item = m_scriptLoadQueue.front();
+      m_scriptLoadQueue.pop();
 
-      // if it fails, we defer the loading to the next tick
-      if( !loadScript( item ) )
-        deferredLoads.push_back( item );
+      // a module that failed is not prepared again until the file changes
+      std::error_code ec;
+      auto writeTime = std::filesystem::last_write_time( item, ec );
+      auto failed = m_failedLoads.find( item );
+      if( failed != m_failedLoads.end() && !ec && failed->second == writeTime )
+        continue;
+
+      if( !m_pendingPaths.insert( item ).second )
+        continue;
+
+      // the module currently in use keeps its cache file until the new one is swapped in
+      std::string cacheSuffix;
+      if( m_loader.isModuleLoaded( std::filesystem::path( item ).stem().string() ) )
+        cacheSuffix = "_" + std::to_string( ++m_cacheGeneration );
+
+      m_pendingLoads.push_back( std::async( std::launch::async, [ this, item, cacheSuffix ]()
+      {
+        return prepareModule( item, cacheSuffix );
+      } ) );
+    }
 
-      m_scriptLoadQueue.pop();
+    if( m_pendingLoads.empty() )
+      return;
+
+    std::vector< PreparedModule > ready;
+    for( auto it = m_pendingLoads.begin(); it != m_pendingLoads.end(); )
+    {
+      if( it->wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+      {
+        ++it;
+        continue;
+      }
+
+      auto module = it->get();
+      it = m_pendingLoads.erase( it );
+      m_pendingPaths.erase( module.path );
+
+      // the build holds the lock until the module is fully written, try again on the next tick
+      if( module.building )
+      {
+        deferredLoads.push_back( module.path );
+        continue;
+      }
+
+      // if it fails, it is tried again once the watcher reports the next change to the file
+      if( !module.info )
+      {
+        std::error_code ec;
+        m_failedLoads[ module.path ] = std::filesystem::last_write_time( module.path, ec );
+        Logger::warn( "Could not prepare {0}, waiting for the module to change", module.path );
+        continue;
+      }
+
+      m_failedLoads.erase( module.path );
+      ready.push_back( std::move( module ) );
     }
 
-    if( !deferredLoads.empty() )
+    if( !ready.empty() )
     {
-      for( auto& item : deferredLoads )
-        m_scriptLoadQueue.push( item );
+      SAPPHIRE_PROFILE_SCOPE( "script.install" );
+
+      auto start = Common::Util::getTimeMs();
+      auto installed = installModules( ready );
+      Logger::debug( "Installed {0} reloaded module(s) in {1}ms", installed, Common::Util::getTimeMs() - start );
     }
+
+    for( auto& item : deferredLoads )
+      m_scriptLoadQueue.push( item );
   }
 
   void NativeScriptMgr::findScripts( std::set< Sapphire::Scripting::ScriptInfo * >& scripts, const std::string& search )
@@ -131,9 +322,43 @@ namespace Sapphire::Scripting
     return m_loader.isModuleLoaded( name );
   }
 
+  ScriptKind NativeScriptMgr::getScriptKind( std::size_t type )
+  {
+    static const std::array< std::size_t, ScriptKindCount > types =
+    {
+      typeid( Sapphire::ScriptAPI::StatusEffectScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::ActionScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::EventScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::QuestScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::EventObjectScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::BattleNpcScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::ZoneScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::InstanceContentScript ).hash_code(),
+      typeid( Sapphire::ScriptAPI::QuestBattleScript ).hash_code()
+    };
+
+    for( size_t kind = 0; kind < types.size(); ++kind )
+    {
+      if( types[ kind ] == type )
+        return static_cast< ScriptKind >( kind );
+    }
+
+    return ScriptKind::Count;
+  }
+
+  void NativeScriptMgr::rebuildRegistry( ScriptKind kind )
+  {
+    const auto index = static_cast< size_t >( kind );
+    auto registry = std::make_unique< const ScriptRegistry >( m_scripts[ index ] );
+    m_registries[ index ].swap( registry );
+  }
+
   NativeScriptMgr::NativeScriptMgr( const std::string& cachePath )
   {
     m_loader.setCachePath( cachePath );
+
+    for( auto& registry : m_registries )
+      registry = std::make_unique< const ScriptRegistry >();
   }
 
   void NativeScriptMgr::unloadAll()
@@ -151,11 +376,31 @@ namespace Sapphire::Scripting
         unloadScript( info );
     }
 
-    // Clear any leftover type->id map entries (should be empty after unloadScript loop, but ensure)
-    m_scripts.clear();
+    // Clear any leftover id map entries (should be empty after unloadScript loop, but ensure)
+    for( size_t kind = 0; kind < ScriptKindCount; ++kind )
+    {
+      m_scripts[ kind ].clear();
+      rebuildRegistry( static_cast< ScriptKind >( kind ) );
+    }
 
-    // Clear pending reload queue
+    // Clear pending reload queue, modules still being prepared are closed again
     while( !m_scriptLoadQueue.empty() ) m_scriptLoadQueue.pop();
+
+    for( auto& pending : m_pendingLoads )
+    {
+      auto module = pending.get();
+      if( !module.info )
+        continue;
+
+      for( int i = 0; module.scripts && module.scripts[ i ] != nullptr; i++ )
+        delete module.scripts[ i ];
+
+      m_loader.discardModule( module.info );
+    }
+
+    m_pendingLoads.clear();
+    m_pendingPaths.clear();
+    m_failedLoads.clear();
   }
 
 
@@ -1,13 +1,18 @@
 #ifndef NATIVE_SCRIPT_MGR_H
 #define NATIVE_SCRIPT_MGR_H
 
+#include <atomic>
+#include <filesystem>
+#include <future>
 #include <unordered_map>
 #include <set>
 #include <queue>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "ScriptLoader.h"
+#include "ScriptRegistry.h"
 
 namespace Sapphire::Scripting
 {
@@ -18,9 +23,26 @@ namespace Sapphire::Scripting
   {
   protected:
     /*!
-     * @brief An internal list that maps script types to another list containing scripts indexed by their assoicated id
+     * @brief A module that has been copied, opened and asked for its scripts, but is not in use yet
      */
-    std::unordered_map< std::size_t, std::unordered_map< uint32_t, Sapphire::ScriptAPI::ScriptObject * > > m_scripts;
+    struct PreparedModule
+    {
+      std::string path;
+      ScriptInfo *info{ nullptr };
+      Sapphire::ScriptAPI::ScriptObject **scripts{ nullptr };
+      // the build was still writing the module, nothing failed yet
+      bool building{ false };
+    };
+
+    /*!
+     * @brief Scripts of every kind indexed by their associated id, changed by loading and unloading modules
+     */
+    std::array< std::unordered_map< uint32_t, Sapphire::ScriptAPI::ScriptObject * >, ScriptKindCount > m_scripts;
+
+    /*!
+     * @brief Lookup tables built from m_scripts, replaced as a whole whenever a module of that kind is (un)loaded
+     */
+    std::array< std::unique_ptr< const ScriptRegistry >, ScriptKindCount > m_registries;
 
 
     ScriptLoader m_loader;
@@ -30,6 +52,26 @@ namespace Sapphire::Scripting
      */
     std::queue< std::string > m_scriptLoadQueue;
 
+    /*!
+     * @brief Modules being prepared in the background, installed by processLoadQueue once done.
+     */
+    std::vector< std::future< PreparedModule > > m_pendingLoads;
+
+    /*!
+     * @brief Paths of m_pendingLoads, a path is never prepared twice at the same time.
+     */
+    std::set< std::string > m_pendingPaths;
+
+    /*!
+     * @brief Write times of modules that could not be prepared, they are skipped until the file changes.
+     */
+    std::unordered_map< std::string, std::filesystem::file_time_type > m_failedLoads;
+
+    /*!
+     * @brief Counter for unique cache file names, the old copy of a module stays open until the new one is installed.
+     */
+    std::atomic< uint32_t > m_cacheGeneration{ 0 };
+
     std::recursive_mutex m_mutex;
 
     /*!
@@ -42,6 +84,38 @@ namespace Sapphire::Scripting
      */
     bool unloadScript( ScriptInfo *info );
 
+    /*!
+     * @brief Copies and opens a module and gets its scripts, touches no shared state and runs on any thread
+     */
+    PreparedModule prepareModule( const std::string& path, const std::string& cacheSuffix );
+
+    /*!
+     * @brief Makes the scripts of prepared modules available, replacing older versions of the same modules
+     *
+     * The lookup tables of every touched script kind are rebuilt once and swapped in,
+     * old modules are only closed after that.
+     *
+     * @return The number of modules installed
+     */
+    uint32_t installModules( std::vector< PreparedModule >& modules );
+
+    /*!
+     * @brief Removes the scripts of a module from m_scripts, unless another module took over their id
+     */
+    void removeScripts( ScriptInfo *info, std::array< bool, ScriptKindCount >& changed );
+
+    /*!
+     * @brief Maps the type hash a script was constructed with to its kind
+     *
+     * @return ScriptKind::Count if the type is not one of the script base classes
+     */
+    static ScriptKind getScriptKind( std::size_t type );
+
+    /*!
+     * @brief Builds a new lookup table for a script kind and swaps it in
+     */
+    void rebuildRegistry( ScriptKind kind );
+
   public:
     explicit NativeScriptMgr( const std::string& cachePath );
 
@@ -58,6 +132,23 @@ namespace Sapphire::Scripting
      */
     bool loadScript( const std::string& path );
 
+    /*!
+     * @brief Loads several modules at once, copying and opening them in parallel
+     *
+     * @param paths The paths of the modules to load
+     * @return The number of modules loaded
+     */
+    uint32_t loadScripts( const std::set< std::string >& paths );
+
+    /*!
+     * @brief Queues a module to be loaded in the background, it is installed by processLoadQueue once ready
+     *
+     * Loading a module that is already loaded replaces it.
+     *
+     * @param path The path to the module to load
+     */
+    void queueScriptLoad( const std::string& path );
+
     /*!
      * @brief Unloads a script
      *
@@ -70,7 +161,8 @@ namespace Sapphire::Scripting
      * @brief Queues a script module to be reloaded
      *
      * Due to the nature of how this works, there's no return.
-     * It will just silently fail over and over again to infinity and beyond until the server restarts... not that should ever happen under normal circumstances.
+     * A module that fails to load is logged and only tried again once its file changes.
+     * The old version stays in use until the new one has been prepared in the background.
      *
      * @param name The name of the module to be reloaded.
      */
@@ -85,7 +177,7 @@ namespace Sapphire::Scripting
     void findScripts( std::set< Sapphire::Scripting::ScriptInfo * >& scripts, const std::string& search );
 
     /*!
-     * @brief Called on a regular interval, allows for scripts to be loaded from the internal load queue.
+     * @brief Called on a regular interval, starts preparing queued modules and installs the ones that are ready.
      */
     void processLoadQueue();
 
@@ -112,15 +204,11 @@ namespace Sapphire::Scripting
      * @return T* if successful, nullptr if the script doesn't exist
      */
     template< typename T >
-    T *getScript( uint32_t scriptId )
+    T *getScript( uint32_t scriptId ) const
     {
-      auto type = typeid( T ).hash_code();
-
-      auto script = m_scripts[ type ].find( scriptId );
-      if( script == m_scripts[ type ].end() )
-        return nullptr;
-
-      return dynamic_cast< T * >( script->second );
+      // registries only ever hold scripts of their own kind, no need to check the type again
+      const auto& registry = m_registries[ static_cast< size_t >( ScriptKindOf< T >::value ) ];
+      return static_cast< T * >( registry->get( scriptId ) );
     }
   };
 
@@ -71,18 +71,36 @@ Sapphire::Scripting::ScriptInfo* Sapphire::Scripting::ScriptLoader::loadModule(
     return nullptr;
   }
 
+  auto info = prepareModule( path, {} );
+  if( !info )
+    return nullptr;
+
+  registerModule( info );
+  return info;
+}
+
+Sapphire::Scripting::ScriptInfo* Sapphire::Scripting::ScriptLoader::prepareModule( const std::string& path,
+                                                                                 const std::string& cacheSuffix,
+                                                                                 bool* pBuilding ) const
+{
+  fs::path f( path );
+
   // copy to temp dir
   fs::path cacheDir( f.parent_path() /= m_cachePath );
-  fs::create_directories( cacheDir );
-  fs::path dest( cacheDir /= f.filename().string() );
+  fs::path dest( cacheDir / ( f.stem().string() + cacheSuffix + f.extension().string() ) );
 
   // make sure the module has finished building before trying to copy it
   const std::string readyFile( ( f.parent_path() / f.stem() ).string() + "_LOCK" );
   if( fs::exists( readyFile ) )
+  {
+    if( pBuilding )
+      *pBuilding = true;
     return nullptr;
+  }
 
   try
   {
+    fs::create_directories( cacheDir );
     fs::copy_file( f, dest, fs::copy_options::overwrite_existing );
   }
   catch( const fs::filesystem_error& err )
@@ -114,10 +132,24 @@ Sapphire::Scripting::ScriptInfo* Sapphire::Scripting::ScriptLoader::loadModule(
   info->cache_path = dest.string();
   info->library_path = f.string();
 
-  m_scriptMap.insert( std::make_pair( f.stem().string(), info ) );
   return info;
 }
 
+void Sapphire::Scripting::ScriptLoader::registerModule( ScriptInfo* info )
+{
+  m_scriptMap.insert( std::make_pair( info->library_name, info ) );
+}
+
+void Sapphire::Scripting::ScriptLoader::discardModule( ScriptInfo* info )
+{
+  if( !unloadModule( info->handle ) )
+    Logger::error( "failed to unload module: {0}", info->library_name );
+
+  fs::remove( info->cache_path );
+
+  delete info;
+}
+
 Sapphire::ScriptAPI::ScriptObject** Sapphire::Scripting::ScriptLoader::getScripts( ModuleHandle handle )
 {
   using getScripts = Sapphire::ScriptAPI::ScriptObject** ( * )();
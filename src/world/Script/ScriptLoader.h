@@ -44,7 +44,7 @@ namespace Sapphire::Scripting
      *
      * @return true if the unload was successful, false if not
      */
-    bool unloadModule( ModuleHandle );
+    static bool unloadModule( ModuleHandle );
 
   public:
     ScriptLoader() = default;
@@ -65,6 +65,28 @@ namespace Sapphire::Scripting
      */
     ScriptInfo* loadModule( const std::string& );
 
+    /*!
+     * @brief Copies a module into the cache folder and opens it without registering it
+     *
+     * Does not touch the list of loaded modules, so it can run on any thread and for several modules at once.
+     *
+     * @param path The path of the module to load
+     * @param cacheSuffix Appended to the cached file name, needed while an older copy of the same module is still open
+     * @param pBuilding Set to true if nothing was loaded because the module is still being written by the build
+     * @return A pointer to ScriptInfo if the load was successful, nullptr if it failed
+     */
+    ScriptInfo* prepareModule( const std::string& path, const std::string& cacheSuffix, bool* pBuilding = nullptr ) const;
+
+    /*!
+     * @brief Adds a module returned by prepareModule to the list of loaded modules
+     */
+    void registerModule( ScriptInfo* info );
+
+    /*!
+     * @brief Closes a module returned by prepareModule that was never registered
+     */
+    void discardModule( ScriptInfo* info );
+
     /*!
      * @brief Unload a script from it's ScriptInfo object
      *
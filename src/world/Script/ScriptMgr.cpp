@@ -3,6 +3,7 @@
 
 #include <watchdog/Watchdog.h>
 #include <Service.h>
+#include <Util/Util.h>
 
 #include "Territory/Territory.h"
 #include "Territory/InstanceContent.h"
@@ -80,20 +81,10 @@ bool Sapphire::Scripting::ScriptMgr::init()
     return false;
   }
 
-  uint32_t scriptsFound = 0;
-  uint32_t scriptsLoaded = 0;
+  auto start = Common::Util::getTimeMs();
+  auto scriptsLoaded = m_nativeScriptMgr->loadScripts( files );
 
-  for( auto itr = files.begin(); itr != files.end(); ++itr )
-  {
-    auto& path = *itr;
-
-    scriptsFound++;
-
-    if( m_nativeScriptMgr->loadScript( path ) )
-      scriptsLoaded++;
-  }
-
-  Logger::info( "ScriptMgr: Loaded {0}/{1} modules", scriptsLoaded, scriptsFound );
+  Logger::info( "ScriptMgr: Loaded {0}/{1} modules in {2}ms", scriptsLoaded, files.size(), Common::Util::getTimeMs() - start );
 
   watchDirectories();
 
@@ -131,7 +122,7 @@ void Sapphire::Scripting::ScriptMgr::watchDirectories()
                            {
                              Logger::debug( "Loading new script: {0}", path.stem().string() );
 
-                             m_nativeScriptMgr->loadScript( path.string() );
+                             m_nativeScriptMgr->queueScriptLoad( path.string() );
                            }
                          }
                        } );
@@ -0,0 +1,117 @@
+#ifndef SCRIPT_REGISTRY_H
+#define SCRIPT_REGISTRY_H
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "NativeScriptApi.h"
+
+namespace Sapphire::Scripting
+{
+  /*!
+   * @brief The script base classes, every kind has its own id space and registry
+   */
+  enum class ScriptKind : uint8_t
+  {
+    StatusEffect,
+    Action,
+    Event,
+    Quest,
+    EventObject,
+    BattleNpc,
+    Zone,
+    InstanceContent,
+    QuestBattle,
+    Count
+  };
+
+  constexpr size_t ScriptKindCount = static_cast< size_t >( ScriptKind::Count );
+
+  template< typename T >
+  struct ScriptKindOf;
+
+  template<> struct ScriptKindOf< ScriptAPI::StatusEffectScript > { static constexpr ScriptKind value = ScriptKind::StatusEffect; };
+  template<> struct ScriptKindOf< ScriptAPI::ActionScript > { static constexpr ScriptKind value = ScriptKind::Action; };
+  template<> struct ScriptKindOf< ScriptAPI::EventScript > { static constexpr ScriptKind value = ScriptKind::Event; };
+  template<> struct ScriptKindOf< ScriptAPI::QuestScript > { static constexpr ScriptKind value = ScriptKind::Quest; };
+  template<> struct ScriptKindOf< ScriptAPI::EventObjectScript > { static constexpr ScriptKind value = ScriptKind::EventObject; };
+  template<> struct ScriptKindOf< ScriptAPI::BattleNpcScript > { static constexpr ScriptKind value = ScriptKind::BattleNpc; };
+  template<> struct ScriptKindOf< ScriptAPI::ZoneScript > { static constexpr ScriptKind value = ScriptKind::Zone; };
+  template<> struct ScriptKindOf< ScriptAPI::InstanceContentScript > { static constexpr ScriptKind value = ScriptKind::InstanceContent; };
+  template<> struct ScriptKindOf< ScriptAPI::QuestBattleScript > { static constexpr ScriptKind value = ScriptKind::QuestBattle; };
+
+  /*!
+   * @brief Immutable id -> script table of one script kind
+   *
+   * Ids are stored relative to the lowest registered id in pages of PageSize slots, pages without any script are not allocated.
+   * Quest, action and status ids end up in a handful of pages, sparse spaces like event handler ids only pay for the pages they use.
+   * A lookup is a bounds check and two loads.
+   */
+  class ScriptRegistry
+  {
+  public:
+    static constexpr uint32_t PageBits = 10;
+    static constexpr uint32_t PageSize = 1u << PageBits;
+
+    ScriptRegistry() = default;
+
+    explicit ScriptRegistry( const std::unordered_map< uint32_t, ScriptAPI::ScriptObject* >& scripts )
+    {
+      if( scripts.empty() )
+        return;
+
+      auto minId = scripts.begin()->first;
+      auto maxId = minId;
+      for( const auto& [ id, script ] : scripts )
+      {
+        minId = std::min( minId, id );
+        maxId = std::max( maxId, id );
+      }
+
+      m_baseId = minId;
+      m_pages.resize( ( ( maxId - minId ) >> PageBits ) + 1 );
+
+      for( const auto& [ id, script ] : scripts )
+      {
+        const auto offset = id - m_baseId;
+        auto& page = m_pages[ offset >> PageBits ];
+        if( !page )
+          page = std::make_unique< Page >();
+
+        ( *page )[ offset & ( PageSize - 1 ) ] = script;
+      }
+
+      m_size = scripts.size();
+    }
+
+    ScriptAPI::ScriptObject* get( uint32_t id ) const
+    {
+      // ids below the base wrap around and fail the bounds check as well
+      const auto offset = id - m_baseId;
+      const auto pageIndex = offset >> PageBits;
+      if( pageIndex >= m_pages.size() )
+        return nullptr;
+
+      const auto& page = m_pages[ pageIndex ];
+      return page ? ( *page )[ offset & ( PageSize - 1 ) ] : nullptr;
+    }
+
+    size_t size() const
+    {
+      return m_size;
+    }
+
+  private:
+    using Page = std::array< ScriptAPI::ScriptObject*, PageSize >;
+
+    uint32_t m_baseId{ 0 };
+    size_t m_size{ 0 };
+    std::vector< std::unique_ptr< Page > > m_pages;
+  };
+
+}
+
+#endif
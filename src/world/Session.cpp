@@ -1,6 +1,7 @@
 #include <filesystem>
 
 #include <Util/Util.h>
+#include <Util/Profiler.h>
 #include <Network/PacketContainer.h>
 #include <Logging/Logger.h>
 #include <Service.h>
@@ -32,12 +33,18 @@ void Sapphire::World::Session::setZoneConnection( Network::GameConnectionPtr pZo
 {
   pZoneCon->m_conType = Network::ConnectionType::Zone;
   m_pZoneConnection = pZoneCon;
+
+  if( m_pPlayer )
+    m_pPlayer->setZoneConnection( pZoneCon );
 }
 
 void Sapphire::World::Session::setChatConnection( Network::GameConnectionPtr pChatCon )
 {
   pChatCon->m_conType = Network::ConnectionType::Chat;
   m_pChatConnection = pChatCon;
+
+  if( m_pPlayer )
+    m_pPlayer->setChatConnection( pChatCon );
 }
 
 Sapphire::Network::GameConnectionPtr Sapphire::World::Session::getZoneConnection() const
@@ -50,23 +57,19 @@ Sapphire::Network::GameConnectionPtr Sapphire::World::Session::getChatConnection
   return m_pChatConnection;
 }
 
-bool Sapphire::World::Session::loadPlayer()
+void Sapphire::World::Session::loadPlayer( std::function< void( bool ) > onLoaded )
 {
   auto& playerMgr = Common::Service< World::Manager::PlayerMgr >::ref();
 
   m_isValid = false;
 
-  m_pPlayer = playerMgr.getPlayer( m_entityId );
-
-  if( !m_pPlayer )
-    return false;
-
   // check and sync player data on login
-  if( !playerMgr.syncPlayer( m_pPlayer->getCharacterId() ) )
-    return false;
-
-  m_isValid = true;
-  return true;
+  playerMgr.syncPlayer( m_entityId, [ self = shared_from_this(), onLoaded = std::move( onLoaded ) ]( Entity::PlayerPtr pPlayer )
+  {
+    self->m_pPlayer = pPlayer;
+    self->m_isValid = pPlayer != nullptr;
+    onLoaded( self->m_isValid );
+  } );
 }
 
 void Sapphire::World::Session::close()
@@ -87,6 +90,8 @@ void Sapphire::World::Session::close()
     fcMgr.onFcLogout( m_pPlayer->getCharacterId() );
     partyMgr.onMemberDisconnect( *m_pPlayer );
     m_pPlayer->unload();
+    m_pPlayer->setZoneConnection( nullptr );
+    m_pPlayer->setChatConnection( nullptr );
   }
 }
 
@@ -231,6 +236,8 @@ void Sapphire::World::Session::processInQueue()
 
 void Sapphire::World::Session::update()
 {
+  SAPPHIRE_PROFILE_SCOPE( "session.update" );
+
   if( m_isReplaying )
     processReplay();
 
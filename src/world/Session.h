@@ -42,7 +42,8 @@ namespace Sapphire::World
 
     uint32_t getId() const;
 
-    bool loadPlayer();
+    // called on the tick, the player is loaded on the db workers and onLoaded is called on the tick again
+    void loadPlayer( std::function< void( bool ) > onLoaded );
 
     void update();
 
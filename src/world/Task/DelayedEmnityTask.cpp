@@ -22,7 +22,7 @@ void DelayedEmnityTask::onQueue()
 
 void DelayedEmnityTask::execute()
 {
-  m_pBNpc->hateListAdd( m_pChara, m_hateAmount );
+  m_pBNpc->hateListUpdate( m_pChara, m_hateAmount );
 }
 
 std::string DelayedEmnityTask::toString()
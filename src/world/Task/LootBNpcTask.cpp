@@ -11,10 +11,10 @@
 using namespace Sapphire::World;
 using namespace Sapphire::World::Manager;
 
-LootBNpcTask::LootBNpcTask( Entity::Player& player, std::string lootTable, uint64_t delayTime ) : Task( delayTime )
+LootBNpcTask::LootBNpcTask( Entity::Player& player, Loot::LootTableResult loot, uint64_t delayTime ) : Task( delayTime )
 {
   m_playerId = player.getId();
-  m_lootTable = lootTable;
+  m_loot = std::move( loot );
 }
 
 void LootBNpcTask::onQueue()
@@ -26,15 +26,13 @@ void LootBNpcTask::execute()
 {
   auto& server = Common::Service< WorldServer >::ref();
   auto& playerMgr = Common::Service< World::Manager::PlayerMgr >::ref();
-  auto& lootTableMgr = Common::Service< World::Manager::LootTableMgr >::ref();
 
   auto pPlayer = playerMgr.getPlayer( m_playerId );
   if( !pPlayer )
     return;
 
-  auto lootResult = lootTableMgr.rollLoot( m_lootTable );
   // todo: make this a task? it's too fast and good to be retail-like
-  for( auto resultItem : lootResult.items )
+  for( const auto& resultItem : m_loot.items )
   {
     auto item = pPlayer->addItem( resultItem.id, resultItem.quantity, resultItem.isHq, false, true );
   }
@@ -42,7 +40,7 @@ void LootBNpcTask::execute()
 
 std::string LootBNpcTask::toString()
 {
-  return fmt::format( "LootBNpcTask: PlayerId#{}, LootTable {}, ElapsedTimeMs: {}", m_playerId, m_lootTable, getDelayTimeMs() );
+  return fmt::format( "LootBNpcTask: PlayerId#{}, LootTable {}, ElapsedTimeMs: {}", m_playerId, m_loot.name, getDelayTimeMs() );
 }
 
 
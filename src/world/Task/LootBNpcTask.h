@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <string>
 #include <ForwardsZone.h>
+#include <Manager/LootTableMgr.h>
 #include "Task.h"
 
 namespace Sapphire::World
@@ -10,7 +11,8 @@ namespace Sapphire::World
   class LootBNpcTask : public Task
   {
   public:
-    LootBNpcTask( Entity::Player& player, std::string lootTable, uint64_t delayTime );
+    // loot is rolled up front, so a group kill can roll every player at once
+    LootBNpcTask( Entity::Player& player, Loot::LootTableResult loot, uint64_t delayTime );
 
     void onQueue() override;
     void execute() override;
@@ -18,7 +20,7 @@ namespace Sapphire::World
 
   private:
     uint32_t m_playerId;
-    std::string m_lootTable;
+    Loot::LootTableResult m_loot;
   };
 
   template< typename... Args >
@@ -36,7 +36,7 @@ void Sapphire::House::updateHouseDb()
 
   stmt->setUInt64( 5, 0 );
 
-  db.execute( stmt );
+  db.execute( stmt, m_houseId );
 }
 
 uint32_t Sapphire::House::getLandSetId() const
@@ -1,11 +1,13 @@
 #include <stdio.h>
 #include <vector>
 #include <time.h>
+#include <algorithm>
 #include <random>
 
 #include <Logging/Logger.h>
 #include <Util/Util.h>
 #include <Util/UtilMath.h>
+#include <Util/Profiler.h>
 #include <Network/GamePacket.h>
 #include <Exd/ExdData.h>
 #include <Network/CommonNetwork.h>
@@ -20,6 +22,7 @@
 #include "InstanceContent.h"
 #include "QuestBattle.h"
 #include "Manager/TerritoryMgr.h"
+#include "Manager/ClockMgr.h"
 #include "Navi/NaviProvider.h"
 
 #include "Session.h"
@@ -170,13 +173,18 @@ Territory::Territory( uint16_t territoryTypeId, uint32_t guId, const std::string
   m_bgPath = m_territoryTypeInfo->getString( m_territoryTypeInfo->data().LVB );
 
   m_ident.territoryTypeId = territoryTypeId;
+  // TODO: make sure gms can overwrite this. Potentially temporary solution
+  m_isPrivateTerritory = teriMgr.isPrivateTerritory( territoryTypeId );
   loadWeatherRates();
 
   loadBNpcs();
 
   loadServerPaths();
 
-  m_currentWeather = getNextWeather();
+  auto& clockMgr = Common::Service< ClockMgr >::ref();
+  updateWeatherForecast( clockMgr.getWeatherPeriod() );
+  m_currentWeather = m_weatherForecast.front();
+  m_weatherListenerId = clockMgr.subscribeWeatherPeriod( [ this ]( uint32_t weatherPeriod ) { onWeatherPeriod( weatherPeriod ); } );
 }
 
 void Territory::loadWeatherRates()
@@ -209,7 +217,11 @@ void Territory::loadWeatherRates()
   }
 }
 
-Territory::~Territory() = default;
+Territory::~Territory()
+{
+  if( m_weatherListenerId != 0 && !Common::Service< ClockMgr >::empty() )
+    Common::Service< ClockMgr >::ref().unsubscribe( m_weatherListenerId );
+}
 
 bool Territory::init()
 {
@@ -245,6 +257,24 @@ bool Territory::init()
 void Territory::setWeatherOverride( Common::Weather weather )
 {
   m_weatherOverride = weather;
+  setCurrentWeather( weather != Common::Weather::None ? weather : getWeatherForecast( 0 ) );
+}
+
+void Territory::setCurrentWeather( Common::Weather weather )
+{
+  if( weather == m_currentWeather )
+    return;
+
+  m_currentWeather = weather;
+
+  auto& server = Common::Service< World::WorldServer >::ref();
+  for( const auto& [ id, pPlayer ] : m_playerMap )
+  {
+    auto weatherChangePacket = makeZonePacket< FFXIVIpcWeatherId >( pPlayer->getId() );
+    weatherChangePacket->data().WeatherId = static_cast< uint8_t >( m_currentWeather );
+    weatherChangePacket->data().TransitionTime = 5.0f;
+    server.queueForPlayer( pPlayer->getCharacterId(), weatherChangePacket );
+  }
 }
 
 Common::Weather Territory::getCurrentWeather() const
@@ -271,23 +301,22 @@ void Territory::setCurrentFestival( uint16_t festivalId, uint16_t additionalFest
   }
 }
 
-Common::Weather Territory::getNextWeather()
+Common::Weather Territory::getNextWeather() const
 {
-  uint32_t unixTime = Common::Util::getTimeSeconds();
-  // Get Eorzea hour for weather start
-  uint32_t bell = unixTime / 175;
-  // Do the magic 'cause for calculations 16:00 is 0, 00:00 is 8 and 08:00 is 16
-  uint32_t increment = ( ( bell + 8 - ( bell % 8 ) ) ) % 24;
-
-  // Take Eorzea days since unix epoch
-  uint32_t totalDays = ( unixTime / 4200 );
+  return getWeatherForecast( 1 );
+}
 
-  uint32_t calcBase = ( totalDays * 0x64 ) + increment;
+Common::Weather Territory::getWeatherForecast( uint32_t periodOffset ) const
+{
+  if( m_weatherForecast.empty() )
+    return Common::Weather::FairSkies;
 
-  uint32_t step1 = ( calcBase << 0xB ) ^ calcBase;
-  uint32_t step2 = ( step1 >> 8 ) ^ step1;
+  return m_weatherForecast[ std::min( periodOffset, WEATHER_FORECAST_PERIODS - 1 ) ];
+}
 
-  auto rate = static_cast< uint8_t >( step2 % 0x64 );
+Common::Weather Territory::calculateWeather( uint32_t weatherPeriod ) const
+{
+  auto rate = ClockMgr::getWeatherChance( weatherPeriod );
 
   for( auto entry : m_weatherRateMap )
   {
@@ -301,6 +330,28 @@ Common::Weather Territory::getNextWeather()
   return Common::Weather::FairSkies;
 }
 
+void Territory::updateWeatherForecast( uint32_t weatherPeriod )
+{
+  // a stalled server can miss periods, anything out of date is dropped
+  if( weatherPeriod - m_weatherForecastPeriod >= m_weatherForecast.size() )
+    m_weatherForecast.clear();
+  else
+    m_weatherForecast.erase( m_weatherForecast.begin(), m_weatherForecast.begin() + ( weatherPeriod - m_weatherForecastPeriod ) );
+
+  m_weatherForecastPeriod = weatherPeriod;
+
+  while( m_weatherForecast.size() < WEATHER_FORECAST_PERIODS )
+    m_weatherForecast.push_back( calculateWeather( weatherPeriod + static_cast< uint32_t >( m_weatherForecast.size() ) ) );
+}
+
+void Territory::onWeatherPeriod( uint32_t weatherPeriod )
+{
+  updateWeatherForecast( weatherPeriod );
+
+  if( m_weatherOverride == Common::Weather::None )
+    setCurrentWeather( m_weatherForecast.front() );
+}
+
 void Territory::pushActor( const Entity::GameObjectPtr& pActor )
 {
   float mx = pActor->getPos().x;
@@ -318,26 +369,7 @@ void Territory::pushActor( const Entity::GameObjectPtr& pActor )
   pCell->addActor( pActor );
 
   pActor->setCellId( { cx, cy } );
-
-  uint32_t cellX = getPosX( pActor->getPos().x );
-  uint32_t cellY = getPosY( pActor->getPos().z );
-
-  uint32_t endX = ( cellX + 1 < _sizeX ) ? cellX + 1 : ( _sizeX - 1 );
-  uint32_t endY = ( cellY + 1 < _sizeY ) ? cellY + 1 : ( _sizeY - 1 );
-
-  uint32_t startX = cellX > 0 ? cellX - 1 : 0;
-  uint32_t startY = cellY > 0 ? cellY - 1 : 0;
-  uint32_t posX, posY;
-
-  for( posX = startX; posX <= endX; ++posX )
-  {
-    for( posY = startY; posY <= endY; ++posY )
-    {
-      pCell = getCellPtr( posX, posY );
-      if( pCell )
-        updateInRangeSet( pActor, pCell );
-    }
-  }
+  updateInRangeCells( pActor );
 
   int32_t agentId = -1;
 
@@ -358,11 +390,11 @@ void Territory::pushActor( const Entity::GameObjectPtr& pActor )
 
     if( m_pNaviProvider && !pBNpc->hasFlag( Entity::Immobile ) )
     {
-      auto state = pBNpc->getState();
-      bool isRunning = state == Entity::BNpcState::Retreat || state == Entity::BNpcState::Combat;
-      agentId = m_pNaviProvider->addAgent( pBNpc->getPos(), pBNpc->getRadius(), pBNpc->getCurrentSpeed() );
+      // bnpcs nobody is near stay dormant, updateBNpcs gives them an agent once their cell becomes active
       pBNpc->setAgentId( agentId );
       pBNpc->setPathingActive( true );
+      if( isCellActive( cx, cy ) )
+        pBNpc->wakeNaviAgent( *m_pNaviProvider );
     }
     else
     {
@@ -448,8 +480,7 @@ void Territory::removeActor( const Entity::GameObjectPtr& pActor )
 void Territory::queuePacketForRange( Entity::Player& sourcePlayer, float range,
                                      Network::Packets::FFXIVPacketBasePtr pPacketEntry )
 {
-  auto& teriMgr = Common::Service< TerritoryMgr >::ref();
-  if( teriMgr.isPrivateTerritory( getTerritoryTypeId() ) )
+  if( m_isPrivateTerritory )
     return;
 
   auto& server = Common::Service< World::WorldServer >::ref();
@@ -469,8 +500,7 @@ void Territory::queuePacketForRange( Entity::Player& sourcePlayer, float range,
 void Territory::queuePacketForZone( Entity::Player& sourcePlayer, Network::Packets::FFXIVPacketBasePtr pPacketEntry,
                                     bool forSelf )
 {
-  auto& teriMgr = Common::Service< TerritoryMgr >::ref();
-  if( teriMgr.isPrivateTerritory( getTerritoryTypeId() ) )
+  if( m_isPrivateTerritory )
     return;
 
   auto& server = Common::Service< World::WorldServer >::ref();
@@ -515,35 +545,14 @@ std::size_t Territory::getPopCount() const
   return m_playerMap.size();
 }
 
-bool Territory::checkWeather()
-{
-  if( m_weatherOverride != Common::Weather::None )
-  {
-    if( m_weatherOverride != m_currentWeather )
-    {
-      m_currentWeather = m_weatherOverride;
-      return true;
-    }
-  }
-  else
-  {
-    auto nextWeather = getNextWeather();
-    if( nextWeather != m_currentWeather )
-    {
-      m_currentWeather = nextWeather;
-      return true;
-    }
-  }
-  return false;
-}
-
 void Territory::updateBNpcs( uint64_t tickCount )
 {
+  SAPPHIRE_PROFILE_SCOPE_KEY( "territory.bnpcs", m_guId );
+
   //if( ( tickCount - m_lastMobUpdate ) <= 250 )
   //  return;
 
   m_lastMobUpdate = tickCount;
-  uint64_t currTime = Common::Util::getTimeSeconds();
 
   // Update loop may move actors from cell to cell, breaking iterator validity
   std::vector< Entity::BNpcPtr > activeBNpc;
@@ -573,7 +582,36 @@ void Territory::updateBNpcs( uint64_t tickCount )
 
   // iterate the cached active bnpcs
   for( const auto& actor : activeBNpc )
+  {
+    if( m_pNaviProvider && actor->pathingActive() && actor->getAgentId() == -1 )
+      actor->wakeNaviAgent( *m_pNaviProvider );
+
     actor->update( tickCount );
+  }
+
+  sleepNaviAgents( tickCount );
+}
+
+void Territory::sleepNaviAgents( uint64_t tickCount )
+{
+  // cells stay active for a while after the last player left, no need to check every tick
+  if( !m_pNaviProvider || tickCount - m_lastNaviAgentCheck < 1000 )
+    return;
+
+  m_lastNaviAgentCheck = tickCount;
+
+  if( m_pNaviProvider->getAgentCount() == 0 )
+    return;
+
+  for( const auto& [ id, pBNpc ] : m_bNpcMap )
+  {
+    if( pBNpc->getAgentId() == -1 )
+      continue;
+
+    auto cellId = pBNpc->getCellId();
+    if( !isCellActive( cellId.x, cellId.y ) )
+      pBNpc->sleepNaviAgent( *m_pNaviProvider );
+  }
 }
 
 uint64_t Territory::getLastActivityTime() const
@@ -592,16 +630,16 @@ std::shared_ptr< Common::CachedServerPath > Territory::getServerPath( uint32_t i
 
 bool Territory::update( uint64_t tickCount )
 {
-  //TODO: this should be moved to a updateWeather call and pulled out of updateSessions
-  bool changedWeather = checkWeather();
+  SAPPHIRE_PROFILE_SCOPE_KEY( "territory", m_guId );
 
   auto dt = static_cast< float >( std::difftime( tickCount, m_lastUpdate ) / 1000.f );
 
   if( m_pNaviProvider )
     m_pNaviProvider->update( dt );
 
-  updateSessions( tickCount, changedWeather );
+  updateSessions( tickCount );
   onUpdate( tickCount );
+  sweepInRangeSets( tickCount );
 
   if( !m_playerMap.empty() )
     m_lastActivityTime = tickCount;
@@ -618,8 +656,10 @@ bool Territory::update( uint64_t tickCount )
   return true;
 }
 
-void Territory::updateSessions( uint64_t tickCount, bool changedWeather )
+void Territory::updateSessions( uint64_t tickCount )
 {
+  SAPPHIRE_PROFILE_SCOPE_KEY( "territory.sessions", m_guId );
+
   auto& server = Common::Service< World::WorldServer >::ref();
   // update sessions in this zone
   for( auto it = m_playerMap.begin(); it != m_playerMap.end(); )
@@ -640,14 +680,6 @@ void Territory::updateSessions( uint64_t tickCount, bool changedWeather )
       return;
     }
 
-    if( changedWeather )
-    {
-      auto weatherChangePacket = makeZonePacket< FFXIVIpcWeatherId >( pPlayer->getId() );
-      weatherChangePacket->data().WeatherId = static_cast< uint8_t >( m_currentWeather );
-      weatherChangePacket->data().TransitionTime = 5.0f;
-      server.queueForPlayer( pPlayer->getCharacterId(), weatherChangePacket );
-    }
-
     // perform session duties
     auto playerSession = server.getSession( pPlayer->getCharacterId() );
     if( playerSession )
@@ -674,7 +706,7 @@ bool Territory::isCellActive( uint32_t x, uint32_t y )
   uint32_t posY;
 
   CellPtr pCell;
-  uint32_t time = Common::Util::getTimeSeconds();
+  uint32_t time = Common::Service< ClockMgr >::ref().getTime();
 
   for( posX = startX; posX <= endX; posX++ )
   {
@@ -700,6 +732,7 @@ void Territory::updateCellActivity( uint32_t x, uint32_t y, int32_t radius )
   uint32_t posX, posY;
 
   CellPtr pCell;
+  uint32_t time = Common::Service< ClockMgr >::ref().getTime();
 
   for( posX = startX; posX <= endX; posX++ )
   {
@@ -714,12 +747,12 @@ void Territory::updateCellActivity( uint32_t x, uint32_t y, int32_t radius )
           pCell = create( posX, posY );
           pCell->init( posX, posY );
           pCell->setActivity( true );
-          pCell->setLastActiveTime( Common::Util::getTimeSeconds() );
+          pCell->setLastActiveTime( time );
         }
       }
       else
       {
-        pCell->setLastActiveTime( Common::Util::getTimeSeconds() );
+        pCell->setLastActiveTime( time );
         //Cell is now active
         if( isCellActive( posX, posY ) && !pCell->isActive() )
         {
@@ -732,7 +765,7 @@ void Territory::updateCellActivity( uint32_t x, uint32_t y, int32_t radius )
   }
 }
 
-void Territory::updateActorPosition( Entity::GameObject& actor )
+void Territory::updateActorPosition( Entity::GameObject& actor, bool forceInRangeUpdate )
 {
   if( actor.getTerritoryTypeId() != getTerritoryTypeId() )
     return;
@@ -754,8 +787,10 @@ void Territory::updateActorPosition( Entity::GameObject& actor )
     pCell->init( cellX, cellY );
   }
 
+  const bool cellChanged = pCell != pOldCell;
+
   // If object moved cell
-  if( pCell != pOldCell )
+  if( cellChanged )
   {
     if( pOldCell )
     {
@@ -764,7 +799,6 @@ void Territory::updateActorPosition( Entity::GameObject& actor )
 
     pCell->addActor( actor.shared_from_this() );
     actor.setCellId( { cellX, cellY } );
-    pOldCell = pCell;
 
     // if player we need to update cell activity
     // radius = 2 is used in order to update both
@@ -775,14 +809,18 @@ void Territory::updateActorPosition( Entity::GameObject& actor )
       if( pOldCell )
       {
         // only do the second check if theres -/+ 2 difference
-        if( abs( ( int32_t ) cellX - ( int32_t ) pOldCell->m_posX ) > 2 ||
-            abs( ( int32_t ) cellY - ( int32_t ) pOldCell->m_posY ) > 2 )
-          updateCellActivity( pOldCell->m_posX, pOldCell->m_posY, 2 );
+        if( abs( ( int32_t ) cellX - ( int32_t ) oldCellId.x ) > 2 ||
+            abs( ( int32_t ) cellY - ( int32_t ) oldCellId.y ) > 2 )
+          updateCellActivity( oldCellId.x, oldCellId.y, 2 );
       }
     }
   }
 
-  // update in range actor set
+  if( m_isPrivateTerritory )
+    return;
+
+  auto pActor = actor.shared_from_this();
+
   uint32_t endX = ( cellX + 1 < _sizeX ) ? cellX + 1 : ( _sizeX - 1 );
   uint32_t endY = ( cellY + 1 < _sizeY ) ? cellY + 1 : ( _sizeY - 1 );
 
@@ -790,13 +828,59 @@ void Territory::updateActorPosition( Entity::GameObject& actor )
   uint32_t startY = cellY > 0 ? cellY - 1 : 0;
   uint32_t posX, posY;
 
-  for( posX = startX; posX <= endX; ++posX )
+  const auto& pos = actor.getPos();
+  const auto& lastPos = actor.getInRangeUpdatePos();
+  const bool movedFar = forceInRangeUpdate || Common::Util::distanceSq( pos.x, pos.y, pos.z, lastPos.x, lastPos.y, lastPos.z ) >=
+                                                IN_RANGE_UPDATE_DISTANCE * IN_RANGE_UPDATE_DISTANCE;
+
+  if( cellChanged )
   {
-    for( posY = startY; posY <= endY; ++posY )
+    // everything in the cells left behind is further away than a cell, so out of range
+    if( pOldCell )
+      removeInRangeOutsideCells( actor, { cellX, cellY } );
+
+    if( !movedFar )
     {
-      pCell = getCellPtr( posX, posY );
+      // only the cells that were not around the old cell can have anything new
+      for( posX = startX; posX <= endX; ++posX )
+      {
+        for( posY = startY; posY <= endY; ++posY )
+        {
+          if( pOldCell && abs( ( int32_t ) posX - ( int32_t ) oldCellId.x ) <= 1 &&
+              abs( ( int32_t ) posY - ( int32_t ) oldCellId.y ) <= 1 )
+            continue;
+
+          pCell = getCellPtr( posX, posY );
+          if( pCell )
+            updateInRangeSet( pActor, pCell );
+        }
+      }
+    }
+  }
+
+  if( movedFar )
+    updateInRangeCells( pActor );
+}
+
+void Territory::updateInRangeCells( const Entity::GameObjectPtr& pActor )
+{
+  auto cellId = pActor->getCellId();
+
+  uint32_t endX = ( cellId.x + 1 < _sizeX ) ? cellId.x + 1 : ( _sizeX - 1 );
+  uint32_t endY = ( cellId.y + 1 < _sizeY ) ? cellId.y + 1 : ( _sizeY - 1 );
+
+  uint32_t startX = cellId.x > 0 ? cellId.x - 1 : 0;
+  uint32_t startY = cellId.y > 0 ? cellId.y - 1 : 0;
+
+  pActor->setInRangeUpdatePos( pActor->getPos() );
+
+  for( uint32_t posX = startX; posX <= endX; ++posX )
+  {
+    for( uint32_t posY = startY; posY <= endY; ++posY )
+    {
+      auto pCell = getCellPtr( posX, posY );
       if( pCell )
-        updateInRangeSet( actor.shared_from_this(), pCell );
+        updateInRangeSet( pActor, pCell );
     }
   }
 }
@@ -809,18 +893,16 @@ float Territory::getInRangeDistance()
 
 void Territory::updateInRangeSet( Entity::GameObjectPtr pActor, CellPtr pCell )
 {
-  if( pCell == nullptr )
-    return;
-
-  auto& teriMgr = Common::Service< TerritoryMgr >::ref();
-  // TODO: make sure gms can overwrite this. Potentially temporary solution
-  if( teriMgr.isPrivateTerritory( getTerritoryTypeId() ) )
+  if( pCell == nullptr || m_isPrivateTerritory )
     return;
 
   auto iter = pCell->m_actors.begin();
 
   float fRange = getInRangeDistance();
-  int32_t count = 0;
+  const float addRangeSq = ( fRange + IN_RANGE_ADD_MARGIN ) * ( fRange + IN_RANGE_ADD_MARGIN );
+  const float removeRangeSq = ( fRange + IN_RANGE_REMOVE_MARGIN ) * ( fRange + IN_RANGE_REMOVE_MARGIN );
+  const auto& pos = pActor->getPos();
+
   while( iter != pCell->m_actors.end() )
   {
     auto pCurAct = *iter;
@@ -829,14 +911,13 @@ void Territory::updateInRangeSet( Entity::GameObjectPtr pActor, CellPtr pCell )
     if( !pCurAct || pCurAct == pActor )
       continue;
 
-    float distance = Common::Util::distance( pCurAct->getPos(), pActor->getPos() );
-
-    bool isInRange = ( fRange == 0.0f || distance <= fRange );
+    const auto& curPos = pCurAct->getPos();
+    float distanceSq = Common::Util::distanceSq( pos.x, pos.y, pos.z, curPos.x, curPos.y, curPos.z );
 
     bool isInRangeSet = pActor->isInRangeSet( pCurAct );
 
-    // Add if range == 0 or distance is withing range.
-    if( isInRange && !isInRangeSet )
+    // Add if range == 0 or distance is within range, with the margin for moves that skip the rescan
+    if( !isInRangeSet && ( fRange == 0.0f || distanceSq <= addRangeSq ) )
     {
       if( pActor->isPlayer() && !pActor->getAsPlayer()->isLoadingComplete() )
         continue;
@@ -847,7 +928,7 @@ void Territory::updateInRangeSet( Entity::GameObjectPtr pActor, CellPtr pCell )
       pActor->addInRangeActor( pCurAct );
       pCurAct->addInRangeActor( pActor );
     }
-    else if( !isInRange && isInRangeSet )
+    else if( isInRangeSet && fRange != 0.0f && distanceSq > removeRangeSq )
     {
       pCurAct->removeInRangeActor( *pActor );
       pActor->removeInRangeActor( *pCurAct );
@@ -855,6 +936,79 @@ void Territory::updateInRangeSet( Entity::GameObjectPtr pActor, CellPtr pCell )
   }
 }
 
+void Territory::removeInRangeOutsideCells( Entity::GameObject& actor, const Common::CellId& cellId )
+{
+  // with no range limit everything in the territory stays in range
+  if( getInRangeDistance() == 0.0f )
+    return;
+
+  m_staleInRange.clear();
+  for( const auto& pOther : actor.getInRangeActorSet() )
+  {
+    auto otherCellId = pOther->getCellId();
+    if( abs( ( int32_t ) otherCellId.x - ( int32_t ) cellId.x ) > 1 || abs( ( int32_t ) otherCellId.y - ( int32_t ) cellId.y ) > 1 )
+      m_staleInRange.push_back( pOther );
+  }
+
+  for( const auto& pOther : m_staleInRange )
+  {
+    pOther->removeInRangeActor( actor );
+    actor.removeInRangeActor( *pOther );
+  }
+  m_staleInRange.clear();
+}
+
+void Territory::sweepInRangeSet( Entity::GameObject& actor )
+{
+  float fRange = getInRangeDistance();
+  const float removeRangeSq = ( fRange + IN_RANGE_REMOVE_MARGIN ) * ( fRange + IN_RANGE_REMOVE_MARGIN );
+  const auto& pos = actor.getPos();
+
+  m_staleInRange.clear();
+  for( const auto& pOther : actor.getInRangeActorSet() )
+  {
+    if( pOther->getTerritoryId() != m_guId )
+    {
+      m_staleInRange.push_back( pOther );
+      continue;
+    }
+
+    const auto& otherPos = pOther->getPos();
+    if( fRange != 0.0f && Common::Util::distanceSq( pos.x, pos.y, pos.z, otherPos.x, otherPos.y, otherPos.z ) > removeRangeSq )
+      m_staleInRange.push_back( pOther );
+  }
+
+  for( const auto& pOther : m_staleInRange )
+  {
+    pOther->removeInRangeActor( actor );
+    actor.removeInRangeActor( *pOther );
+  }
+  m_staleInRange.clear();
+}
+
+void Territory::sweepInRangeSets( uint64_t tickCount )
+{
+  if( m_isPrivateTerritory || tickCount - m_lastInRangeSweep < IN_RANGE_SWEEP_INTERVAL )
+    return;
+
+  SAPPHIRE_PROFILE_SCOPE_KEY( "territory.inRangeSweep", m_guId );
+
+  m_lastInRangeSweep = tickCount;
+
+  // pairs without a player or bnpc are between objects that do not move, they do not go stale
+  for( const auto& [ id, pPlayer ] : m_playerMap )
+  {
+    sweepInRangeSet( *pPlayer );
+
+    // two actors both moving short of a rescan can come into range unnoticed, players see them at the latest now
+    if( pPlayer->isLoadingComplete() )
+      updateInRangeCells( pPlayer );
+  }
+
+  for( const auto& [ id, pBNpc ] : m_bNpcMap )
+    sweepInRangeSet( *pBNpc );
+}
+
 void Territory::onPlayerZoneIn( Entity::Player& player )
 {
   Logger::debug( "[{2}] Territory::onEnterTerritory: Territory#{0}|{1}", getGuId(), getTerritoryTypeId(),
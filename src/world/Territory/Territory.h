@@ -11,6 +11,8 @@
 
 #include <set>
 #include <map>
+#include <deque>
+#include <vector>
 #include <memory>
 
 #include <cstdio>
@@ -59,8 +61,19 @@ namespace Sapphire
     Common::Weather m_currentWeather;
     Common::Weather m_weatherOverride;
     std::map< uint8_t, int32_t > m_weatherRateMap;
+    /*! natural weather of the current and the following weather periods, front is the current one */
+    std::deque< Common::Weather > m_weatherForecast;
+    /*! weather period of the front of m_weatherForecast */
+    uint32_t m_weatherForecastPeriod{};
+    uint32_t m_weatherListenerId{};
+
+    bool m_isPrivateTerritory{ false };
+    uint64_t m_lastInRangeSweep{};
+    // reused by the in range set updates, they only run on the tick thread
+    std::vector< Entity::GameObjectPtr > m_staleInRange;
 
     uint64_t m_lastMobUpdate;
+    uint64_t m_lastNaviAgentCheck{};
     uint64_t m_lastUpdate{};
 
     uint64_t m_lastActivityTime{};
@@ -83,6 +96,21 @@ namespace Sapphire
     float m_inRangeDistance;
 
   public:
+    // weather periods the natural weather is calculated for in advance, including the current one
+    static const uint32_t WEATHER_FORECAST_PERIODS = 4;
+
+    // an actor moving less than this since its last in range set update does not check its cells again
+    static constexpr float IN_RANGE_UPDATE_DISTANCE = 4.f;
+    // actors are added this much past the in range distance, two actors that both move up to IN_RANGE_UPDATE_DISTANCE
+    // toward each other without checking their cells again are in each others set before they get within range
+    static constexpr float IN_RANGE_ADD_MARGIN = 2 * IN_RANGE_UPDATE_DISTANCE;
+    // actors are only taken out of the in range set this much past the in range distance,
+    // far enough past the add margin that actors moving around its edge are not added and removed over and over
+    static constexpr float IN_RANGE_REMOVE_MARGIN = 3 * IN_RANGE_UPDATE_DISTANCE;
+    // in range sets of players and bnpcs are checked for actors that went away without it being noticed this often,
+    // players also check their cells again for actors that came into range while both were moving
+    static const uint64_t IN_RANGE_SWEEP_INTERVAL = 5000;
+
     Territory();
 
     void loadServerPaths();
@@ -135,13 +163,18 @@ namespace Sapphire
 
     virtual float getInRangeDistance();
 
-    Common::Weather getNextWeather();
+    // natural weather of the following weather period
+    Common::Weather getNextWeather() const;
+
+    // natural weather periodOffset weather periods from now, periodOffset < WEATHER_FORECAST_PERIODS
+    Common::Weather getWeatherForecast( uint32_t periodOffset ) const;
 
     void pushActor( const Entity::GameObjectPtr& pActor );
 
     void removeActor( const Entity::GameObjectPtr &pActor );
 
-    void updateActorPosition( Entity::GameObject& pActor );
+    // forceInRangeUpdate checks the surrounding cells for the in range set even if the actor barely moved
+    void updateActorPosition( Entity::GameObject& pActor, bool forceInRangeUpdate = false );
 
     bool isCellActive( uint32_t x, uint32_t y );
 
@@ -149,6 +182,17 @@ namespace Sapphire
 
     void updateInRangeSet( Entity::GameObjectPtr pActor, CellPtr pCell );
 
+    // checks the 3x3 cells around the cell of pActor for its in range set
+    void updateInRangeCells( const Entity::GameObjectPtr& pActor );
+
+    // removes everything from the in range set of actor that is not in the 3x3 cells around cellId
+    void removeInRangeOutsideCells( Entity::GameObject& actor, const Common::CellId& cellId );
+
+    // removes everything from the in range set of actor that left the territory or is out of range
+    void sweepInRangeSet( Entity::GameObject& actor );
+
+    void sweepInRangeSets( uint64_t tickCount );
+
     void queuePacketForRange( Entity::Player& sourcePlayer, float range,
                               Network::Packets::FFXIVPacketBasePtr pPacketEntry );
 
@@ -171,14 +215,26 @@ namespace Sapphire
 
     void loadWeatherRates();
 
+    Common::Weather calculateWeather( uint32_t weatherPeriod ) const;
+
+    // drops passed weather periods and calculates the forecast up to WEATHER_FORECAST_PERIODS from weatherPeriod
+    void updateWeatherForecast( uint32_t weatherPeriod );
+
+    void onWeatherPeriod( uint32_t weatherPeriod );
+
+    // sends the weather to everyone in the zone if it changed
+    void setCurrentWeather( Common::Weather weather );
+
     bool loadBNpcs();
 
-    bool checkWeather();
     virtual void updateBNpcs( uint64_t tickCount );
 
+    // takes bnpcs outside of active cells out of the navi crowd
+    void sleepNaviAgents( uint64_t tickCount );
+
     bool update( uint64_t tickCount );
 
-    void updateSessions( uint64_t tickCount, bool changedWeather );
+    void updateSessions( uint64_t tickCount );
 
     Entity::EventObjectPtr addEObj( const std::string& name, uint32_t baseId, uint32_t boundInstanceId, uint32_t instanceId,
                                     uint8_t state, Common::Vector3 pos, float scale,
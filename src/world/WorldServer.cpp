@@ -31,12 +31,15 @@
 #include <Database/ZoneDbConnection.h>
 #include <Database/DbWorkerPool.h>
 #include <Service.h>
+#include <Util/Profiler.h>
 #include "Manager/AchievementMgr.h"
 #include "Manager/LinkshellMgr.h"
 #include "Manager/LootTableMgr.h"
 #include "Manager/HousingMgr.h"
 #include "Manager/DebugCommandMgr.h"
 #include "Manager/PlayerMgr.h"
+#include "Manager/InterestMgr.h"
+#include "Manager/ClockMgr.h"
 #include "Manager/ShopMgr.h"
 #include "Manager/InventoryMgr.h"
 #include "Manager/EventMgr.h"
@@ -56,6 +59,7 @@
 #include "Action/ActionShapeLutData.h"
 
 #include "ContentFinder/ContentFinder.h"
+#include "Math/CalcStats.h"
 
 #include "Territory/InstanceObjectCache.h"
 
@@ -77,15 +81,14 @@ WorldServer::WorldServer( const std::string& configName ) :
 std::vector< std::string > WorldServer::getLoggedInPlayersSnapshot()
 {
   std::vector< std::string > result;
-  std::lock_guard< std::mutex > lock( m_sessionMutex );
-  result.reserve( m_sessionMapByCharacterId.size() );
+  const auto sessions = m_sessionMapByCharacterId.values();
+  result.reserve( sessions.size() );
 
   const auto nowMs = Common::Util::getTimeMs();
   auto& teriMgr = Common::Service< World::Manager::TerritoryMgr >::ref();
 
-  for( const auto& kv : m_sessionMapByCharacterId )
+  for( const auto& pSession : sessions )
   {
-    const auto& pSession = kv.second;
     if( !pSession )
       continue;
     if( !pSession->isValid() )
@@ -167,12 +170,14 @@ bool WorldServer::loadSettings( int32_t argc, char *argv[ ] )
   m_config.scripts.cachePath = configMgr.getValue< std::string >( "Scripts", "CachePath", "./cache/" );
 
   m_config.navigation.meshPath = configMgr.getValue< std::string >( "Navigation", "MeshPath", "navi" );
+  m_config.navigation.pathWorkers = configMgr.getValue< uint32_t >( "Navigation", "PathWorkers", 2 );
   m_config.map.eagerENpcEObjCache = configMgr.getValue( "Map", "EagerENpcEObjCache", true );
 
   m_config.network.disconnectTimeout = configMgr.getValue< uint16_t >( "Network", "DisconnectTimeout", 20 );
   m_config.network.listenIp = configMgr.getValue< std::string >( "Network", "ListenIp", "0.0.0.0" );
   m_config.network.listenPort = configMgr.getValue< uint16_t >( "Network", "ListenPort", 54992 );
   m_config.network.inRangeDistance = configMgr.getValue< float >( "Network", "InRangeDistance", 80.f );
+  m_config.network.visibleActorBudget = configMgr.getValue< uint32_t >( "Network", "VisibleActorBudget", 60 );
 
   m_config.motd = configMgr.getValue< std::string >( "General", "MotD", "" );
   m_config.skipOpening = configMgr.getValue( "General", "SkipOpening", false );
@@ -180,6 +185,9 @@ bool WorldServer::loadSettings( int32_t argc, char *argv[ ] )
   m_config.housing.defaultEstateName = configMgr.getValue<
     std::string >( "Housing", "DefaultEstateName", "Estate #{}" );
 
+  m_config.profiler.logInterval = configMgr.getValue< uint32_t >( "Profiler", "LogInterval", 60 );
+  m_config.profiler.dumpPath = configMgr.getValue< std::string >( "Profiler", "DumpPath", "" );
+
   m_port = m_config.network.listenPort;
   m_ip = m_config.network.listenIp;
 
@@ -244,6 +252,13 @@ void WorldServer::init( int32_t argc, char *argv[ ] )
   Common::Service< Data::ExdData >::set( pExdData );
   logInitStep( "ExdData init + set" );
 
+  if( !Math::CalcStats::init() )
+  {
+    Logger::fatal( "Failed to build stat tables from EXD data" );
+    return;
+  }
+  logInitStep( "CalcStats tables" );
+
   auto pDb = std::make_shared< Db::DbWorkerPool< Db::ZoneDbConnection > >();
   Sapphire::Db::DbLoader loader;
   loader.addDb( *pDb, m_config.global.database );
@@ -353,10 +368,14 @@ void WorldServer::init( int32_t argc, char *argv[ ] )
   logInitStep( "MapMgr cache + set" );
 
   auto& cfg = getConfig();
-  auto pNaviMgr = std::make_shared< Common::Navi::NaviMgr >( cfg.navigation.meshPath );
+  auto pNaviMgr = std::make_shared< Common::Navi::NaviMgr >( cfg.navigation.meshPath, cfg.navigation.pathWorkers );
   Common::Service< Common::Navi::NaviMgr >::set( pNaviMgr );
   logInitStep( "NaviMgr set" );
 
+  // territories subscribe to the clock when they are created
+  auto pClockMgr = std::make_shared< Manager::ClockMgr >();
+  Common::Service< Manager::ClockMgr >::set( pClockMgr );
+
   Logger::info( "TerritoryMgr: Setting up zones" );
   auto territoryInitStart = Common::Util::getTimeMs();
   auto pTeriMgr = std::make_shared< Manager::TerritoryMgr >();
@@ -426,6 +445,7 @@ void WorldServer::init( int32_t argc, char *argv[ ] )
   auto pPartyMgr = std::make_shared< Manager::PartyMgr >();
   auto pFriendMgr = std::make_shared< Manager::FriendListMgr >();
   auto pBlacklistMgr = std::make_shared< Manager::BlacklistMgr >();
+  auto pInterestMgr = std::make_shared< Manager::InterestMgr >( m_config.network.visibleActorBudget );
   auto contentFinder = std::make_shared< ContentFinder >();
   auto taskMgr = std::make_shared< Manager::TaskMgr >();
 
@@ -439,6 +459,7 @@ void WorldServer::init( int32_t argc, char *argv[ ] )
   Common::Service< Manager::PartyMgr >::set( pPartyMgr );
   Common::Service< Manager::FriendListMgr >::set( pFriendMgr );
   Common::Service< Manager::BlacklistMgr >::set( pBlacklistMgr );
+  Common::Service< Manager::InterestMgr >::set( pInterestMgr );
   Common::Service< ContentFinder >::set( contentFinder );
   Common::Service< Manager::TaskMgr >::set( taskMgr );
   logInitStep( "Remaining managers set" );
@@ -474,18 +495,95 @@ void WorldServer::update( uint64_t tickCount )
   auto& scriptMgr = Common::Service< Scripting::ScriptMgr >::ref();
   auto& contentFinder = Common::Service< ContentFinder >::ref();
   auto& taskMgr = Common::Service< World::Manager::TaskMgr >::ref();
+  auto& clockMgr = Common::Service< World::Manager::ClockMgr >::ref();
+
+  {
+    SAPPHIRE_PROFILE_SCOPE( "world.tick" );
+
+    {
+      SAPPHIRE_PROFILE_SCOPE( "mgr.clock" );
+      clockMgr.update();
+    }
+
+    auto currTime = clockMgr.getTime();
+    {
+      SAPPHIRE_PROFILE_SCOPE( "world.tickTasks" );
+      while( auto task = m_tickTasks.pop() )
+        task();
+    }
+    {
+      SAPPHIRE_PROFILE_SCOPE( "mgr.task" );
+      taskMgr.update( tickCount );
+    }
+    {
+      SAPPHIRE_PROFILE_SCOPE( "world.sessions" );
+      updateSessions( currTime );
+    }
 
-  auto currTime = Common::Util::getTimeSeconds();
-  taskMgr.update( tickCount );
-  updateSessions( currTime );
+    m_lastServerTick = tickCount;
 
-  m_lastServerTick = tickCount;
+    {
+      SAPPHIRE_PROFILE_SCOPE( "mgr.territory" );
+      terriMgr.updateTerritoryInstances( tickCount );
+    }
+    {
+      SAPPHIRE_PROFILE_SCOPE( "mgr.script" );
+      scriptMgr.update();
+    }
+    {
+      SAPPHIRE_PROFILE_SCOPE( "mgr.contentFinder" );
+      contentFinder.update();
+    }
 
-  terriMgr.updateTerritoryInstances( tickCount );
-  scriptMgr.update();
-  contentFinder.update();
+    DbKeepAlive( currTime );
+  }
 
-  DbKeepAlive( currTime );
+  // drained after the tick scope closed so the tick itself is part of this collection
+  Common::Util::Profiler::collect();
+  reportProfile( tickCount );
+}
+
+void WorldServer::reportProfile( uint64_t tickCount )
+{
+  if( m_config.profiler.logInterval == 0 ||
+      tickCount - m_lastProfileReport < static_cast< uint64_t >( m_config.profiler.logInterval ) * 1000 )
+    return;
+
+  const bool first = m_lastProfileReport == 0;
+  m_lastProfileReport = tickCount;
+
+  // the first call only starts the interval
+  if( first )
+    return;
+
+  // forget territories that were destroyed since the last report
+  Common::Util::Profiler::prune( static_cast< uint64_t >( m_config.profiler.logInterval ) * 1000 );
+
+  const auto stats = Common::Util::Profiler::getStats();
+
+  std::string phases;
+  const Common::Util::ProfileStats* pSlowestTerritory = nullptr;
+
+  for( const auto& entry : stats )
+  {
+    if( entry.key != 0 )
+    {
+      if( entry.zone == "territory" && ( !pSlowestTerritory || entry.p99Us > pSlowestTerritory->p99Us ) )
+        pSlowestTerritory = &entry;
+      continue;
+    }
+
+    phases += fmt::format( " {0}: {1}/{2}/{3}us", entry.zone, entry.p50Us, entry.p99Us, entry.maxUs );
+  }
+
+  if( pSlowestTerritory )
+    phases += fmt::format( " slowest territory#{0}: {1}/{2}/{3}us", pSlowestTerritory->key,
+                           pSlowestTerritory->p50Us, pSlowestTerritory->p99Us, pSlowestTerritory->maxUs );
+
+  Logger::info( "Tick profile p50/p99/max:{0} dropped: {1}", phases, Common::Util::Profiler::getDropped() );
+
+  if( !m_config.profiler.dumpPath.empty() )
+    Common::Util::Profiler::dumpJson( m_config.profiler.dumpPath );
 }
 
 void WorldServer::shutdown()
@@ -511,7 +609,7 @@ void WorldServer::shutdown()
   // Close all sessions gracefully
   {
     std::lock_guard< std::mutex > lock( m_sessionMutex );
-    for( auto& [ id, session ] : m_sessionMapById )
+    for( auto& session : m_sessionMapById.values() )
     {
       if( session )
       {
@@ -522,6 +620,18 @@ void WorldServer::shutdown()
     m_sessionMapById.clear();
   }
 
+  // wait for the final saves of the closed sessions to be committed
+  if( auto pDb = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::get().lock() )
+    pDb->flush();
+
+  Network::GameConnection::dumpOpcodeStats();
+
+  if( !m_config.profiler.dumpPath.empty() )
+  {
+    Common::Util::Profiler::collect();
+    Common::Util::Profiler::dumpJson( m_config.profiler.dumpPath );
+  }
+
   // Join any background threads (e.g., network hive thread)
   for( auto& thread_entry : m_threadList )
   {
@@ -534,6 +644,8 @@ void WorldServer::shutdown()
 
 void WorldServer::DbKeepAlive( uint32_t currTime )
 {
+  SAPPHIRE_PROFILE_SCOPE( "db.keepAlive" );
+
   auto& db = Common::Service< Db::DbWorkerPool< Db::ZoneDbConnection > >::ref();
   if( currTime - m_lastDBPingTime > 3 )
   {
@@ -545,8 +657,7 @@ void WorldServer::DbKeepAlive( uint32_t currTime )
 void WorldServer::updateSessions( uint32_t currTime )
 {
   std::queue< uint32_t > sessionRemovalQueue;
-  std::lock_guard< std::mutex > lock( m_sessionMutex );
-  for( const auto& [ id, session ] : m_sessionMapById )
+  for( const auto& session : m_sessionMapById.values() )
   {
     if( !session || !session->getPlayer() )
       continue;
@@ -580,33 +691,64 @@ void WorldServer::updateSessions( uint32_t currTime )
   }
 }
 
-bool WorldServer::createSession( uint32_t sessionId )
+void WorldServer::createSession( uint32_t sessionId, SessionCallback onCreated )
 {
-  std::lock_guard< std::mutex > lock( m_sessionMutex );
-
-  const auto sessionIdStr = std::to_string( sessionId );
+  {
+    std::lock_guard< std::mutex > lock( m_sessionMutex );
 
-  auto pSession = getSession( sessionId );
+    // the other connection of this session may have finished creating it in the meantime
+    if( auto pSession = getSession( sessionId ) )
+    {
+      queueTickTask( [ pSession, onCreated = std::move( onCreated ) ]() { onCreated( pSession ); } );
+      return;
+    }
 
-  if( pSession )
-  {
-    Logger::error( "[{0}] Error creating session, already in list", sessionIdStr );
-    return false;
+    auto& callbacks = m_pendingSessions[ sessionId ];
+    callbacks.push_back( std::move( onCreated ) );
+    if( callbacks.size() > 1 )
+      return;
   }
 
-  Logger::info( "[{0}] Creating new session", sessionIdStr );
+  Logger::info( "[{0}] Creating new session", sessionId );
 
-  auto newSession = std::make_shared< Session >( sessionId );
-  if( !newSession->loadPlayer() )
+  // the player managers are only touched from the tick
+  queueTickTask( [ this, sessionId ]()
   {
-    Logger::error( "[{0}] Error loading player {0}", sessionIdStr );
-    return false;
+    auto pSession = std::make_shared< Session >( sessionId );
+    pSession->loadPlayer( [ this, pSession ]( bool loaded ) { onSessionLoaded( pSession, loaded ); } );
+  } );
+}
+
+void WorldServer::onSessionLoaded( const SessionPtr& pSession, bool loaded )
+{
+  std::vector< SessionCallback > callbacks;
+  {
+    std::lock_guard< std::mutex > lock( m_sessionMutex );
+
+    if( loaded )
+    {
+      m_sessionMapById.set( pSession->getId(), pSession );
+      m_sessionMapByCharacterId.set( pSession->getPlayer()->getCharacterId(), pSession );
+    }
+
+    auto it = m_pendingSessions.find( pSession->getId() );
+    if( it != m_pendingSessions.end() )
+    {
+      callbacks = std::move( it->second );
+      m_pendingSessions.erase( it );
+    }
   }
 
-  m_sessionMapById[ sessionId ] = newSession;
-  m_sessionMapByCharacterId[ newSession->getPlayer()->getCharacterId() ] = newSession;
+  if( !loaded )
+    Logger::error( "[{0}] Error loading player {0}", pSession->getId() );
 
-  return true;
+  for( auto& callback : callbacks )
+    callback( loaded ? pSession : nullptr );
+}
+
+void WorldServer::queueTickTask( std::function< void() > task )
+{
+  m_tickTasks.push( std::move( task ) );
 }
 
 void WorldServer::removeSession( uint32_t sessionId )
@@ -621,24 +763,12 @@ void WorldServer::removeSession( uint32_t sessionId )
 
 SessionPtr WorldServer::getSession( uint32_t id )
 {
-  //std::lock_guard<std::mutex> lock( m_sessionMutex );
-  auto it = m_sessionMapById.find( id );
-
-  if( it != m_sessionMapById.end() )
-    return ( it->second );
-
-  return nullptr;
+  return m_sessionMapById.find( id );
 }
 
 SessionPtr WorldServer::getSession( uint64_t id )
 {
-  //std::lock_guard<std::mutex> lock( m_sessionMutex );
-  auto it = m_sessionMapByCharacterId.find( id );
-
-  if( it != m_sessionMapByCharacterId.end() )
-    return ( it->second );
-
-  return nullptr;
+  return m_sessionMapByCharacterId.find( id );
 }
 
 void WorldServer::removeSession( const Entity::Player& player )
@@ -668,6 +798,85 @@ void WorldServer::queueForPlayer( uint64_t characterId, Sapphire::Network::Packe
     pZoneCon->queueOutPacket( pPacket );
 }
 
+void WorldServer::queueForPlayer( Entity::Player& player, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket )
+{
+  if( auto pZoneCon = player.getZoneConnection() )
+    pZoneCon->queueOutPacket( std::move( pPacket ) );
+}
+
+void WorldServer::queueForInRangePlayers( Entity::GameObject& source, bool includeSelf,
+                                          Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket )
+{
+  for( const auto& pPlayer : source.getInRangePlayers() )
+    queueForPlayer( *pPlayer, pPacket );
+
+  if( includeSelf && source.isPlayer() )
+    queueForPlayer( static_cast< Entity::Player& >( source ), pPacket );
+}
+
+void WorldServer::queueMoveForInRangePlayers( Entity::GameObject& source, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket )
+{
+  auto& interestMgr = Common::Service< Manager::InterestMgr >::ref();
+
+  const auto updateIndex = source.nextMoveUpdate();
+  const auto coarseKey = source.getCoarseMoveKey();
+
+  bool withheld = false;
+  for( const auto& pPlayer : source.getInRangePlayers() )
+  {
+    auto pObserver = source.getMoveObserver( pPlayer );
+    auto detail = pObserver ? pObserver->detail : Entity::MoveDetail::Full;
+
+    // players with less detail only get an update if the divisor picks it and the object left the coarse cell they last saw
+    bool send = true;
+    if( detail != Entity::MoveDetail::Full )
+    {
+      auto divisor = detail == Entity::MoveDetail::Reduced ? Manager::InterestMgr::REDUCED_MOVE_DIVISOR
+                                                           : Manager::InterestMgr::SUPPRESSED_MOVE_DIVISOR;
+      send = updateIndex % divisor == 0 && pObserver->lastCoarseKey != coarseKey;
+    }
+
+    interestMgr.countMoveUpdate( detail, send );
+    if( !send )
+    {
+      pObserver->withheld = true;
+      withheld = true;
+      continue;
+    }
+
+    if( pObserver )
+    {
+      pObserver->lastCoarseKey = coarseKey;
+      pObserver->withheld = false;
+    }
+
+    queueForPlayer( *pPlayer, pPacket );
+  }
+
+  source.setPendingMove( withheld ? std::move( pPacket ) : nullptr );
+}
+
+void WorldServer::flushMoveForInRangePlayers( Entity::GameObject& source )
+{
+  if( !source.getPendingMove() )
+    return;
+
+  // the object stopped, every player that missed its last update gets where it stopped
+  const auto coarseKey = source.getCoarseMoveKey();
+  for( const auto& pPlayer : source.getInRangePlayers() )
+  {
+    auto pObserver = source.getMoveObserver( pPlayer );
+    if( !pObserver || !pObserver->withheld )
+      continue;
+
+    queueForPlayer( *pPlayer, source.getPendingMove() );
+    pObserver->lastCoarseKey = coarseKey;
+    pObserver->withheld = false;
+  }
+
+  source.setPendingMove( nullptr );
+}
+
 void WorldServer::queueChatForPlayer( uint64_t characterId, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket )
 {
   auto pSession = getSession( characterId );
@@ -717,7 +926,7 @@ void WorldServer::queueForPlayers( const std::set< uint64_t >& characterIds,
 void WorldServer::queueForLinkshell( uint64_t lsId, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket,
                                      std::set< uint64_t > exceptionCharIdList )
 {
-  auto lsMgr = Common::Service< Manager::LinkshellMgr >::ref();
+  auto& lsMgr = Common::Service< Manager::LinkshellMgr >::ref();
 
   auto ls = lsMgr.getLinkshellById( lsId );
   if( !ls )
@@ -737,7 +946,7 @@ void WorldServer::queueForLinkshell( uint64_t lsId, Sapphire::Network::Packets::
 void WorldServer::queueForFreeCompany( uint64_t fcId, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket,
                                        std::set< uint64_t > exceptionCharIdList )
 {
-  auto fcMgr = Common::Service< Manager::FreeCompanyMgr >::ref();
+  auto& fcMgr = Common::Service< Manager::FreeCompanyMgr >::ref();
 
   auto fc = fcMgr.getFreeCompanyById( fcId );
   if( !fc )
@@ -7,8 +7,11 @@
 #include <map>
 #include <set>
 #include <thread>
+#include <vector>
 #include "ForwardsZone.h"
 #include <Config/ConfigDef.h>
+#include <Util/ConcurrentMap.h>
+#include <Util/LockedQueue.h>
 
 namespace Sapphire
 {
@@ -31,7 +34,12 @@ namespace Sapphire::World
 
     void init( int32_t argc, char *argv[ ] );
 
-    bool createSession( uint32_t sessionId );
+    using SessionCallback = std::function< void( SessionPtr ) >;
+
+    // loads the player of a new session on the db workers without blocking the caller. onCreated is called
+    // on the tick with the session, or nullptr if the player could not be loaded. Connections asking for
+    // a session that is still loading share its load
+    void createSession( uint32_t sessionId, SessionCallback onCreated );
 
     void removeSession( uint32_t sessionId );
 
@@ -49,6 +57,9 @@ namespace Sapphire::World
 
     void update( uint64_t tickCount );
 
+    // thread safe, task runs on the tick thread at the start of the next tick
+    void queueTickTask( std::function< void() > task );
+
     void shutdown();
 
     bool isRunning() const;
@@ -59,6 +70,19 @@ namespace Sapphire::World
 
     void queueForPlayer( uint64_t characterId, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket );
 
+    // queues straight onto the player's connection, no session lookup involved
+    void queueForPlayer( Entity::Player& player, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket );
+
+    // queues for every player in range of source, and source itself if includeSelf is set and it is a player
+    void queueForInRangePlayers( Entity::GameObject& source, bool includeSelf,
+                                 Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket );
+
+    // queueForInRangePlayers for movement, players get as many of the updates as the move detail the interest manager picked
+    void queueMoveForInRangePlayers( Entity::GameObject& source, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket );
+
+    // sends the last movement update withheld from players with less detail, call once the source stopped moving
+    void flushMoveForInRangePlayers( Entity::GameObject& source );
+
     void queueChatForPlayer( uint64_t characterId, Sapphire::Network::Packets::FFXIVPacketBasePtr pPacket );
 
     void queueForPlayers( const std::set< uint64_t >& characterIds,
@@ -86,10 +110,12 @@ namespace Sapphire::World
     std::string m_ip;
     int64_t m_lastDBPingTime;
     uint64_t m_lastServerTick{ 0 };
+    uint64_t m_lastProfileReport{ 0 };
     bool m_bRunning;
     uint16_t m_worldId;
 
     std::string m_configName;
+    // serialises session creation, lookups go through the session maps only
     std::mutex m_sessionMutex;
 
     std::vector< std::thread > m_threadList;
@@ -99,8 +125,17 @@ namespace Sapphire::World
 
     Sapphire::Common::Config::WorldConfig m_config;
 
-    std::map< uint32_t, SessionPtr > m_sessionMapById;
-    std::map< uint64_t, SessionPtr > m_sessionMapByCharacterId;
+    Common::Util::ConcurrentMap< uint32_t, SessionPtr > m_sessionMapById;
+    Common::Util::ConcurrentMap< uint64_t, SessionPtr > m_sessionMapByCharacterId;
+    // callbacks of sessions whose player is still loading, guarded by m_sessionMutex
+    std::map< uint32_t, std::vector< SessionCallback > > m_pendingSessions;
+
+    Common::Util::LockedQueue< std::function< void() > > m_tickTasks;
+
+    void onSessionLoaded( const SessionPtr& pSession, bool loaded );
+
+    // logs the rolling tick profile every Profiler.LogInterval seconds
+    void reportProfile( uint64_t tickCount );
 
   public:
     void updateSessions( uint32_t currTime );